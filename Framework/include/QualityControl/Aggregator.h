@@ -27,6 +27,7 @@
 #include "QualityControl/AggregatorSpec.h"
 #include "QualityControl/DataSourceSpec.h"
 #include "QualityControl/AggregatorSource.h"
+#include "QualityControl/LatencyHistogram.h"
 // config
 #include <boost/property_tree/ptree_fwd.hpp>
 #include <utility>
@@ -63,6 +64,11 @@ class Aggregator
    * \brief Initialize the aggregator
    */
   void init();
+  /**
+   * \brief Records the duration of aggregate() in a histogram of the given set.
+   * It has no effect if the latency histograms are disabled at compilation time.
+   */
+  void setLatencyHistograms(core::LatencyHistograms& histograms);
 
   o2::quality_control::core::QualityObjectsType aggregate(core::QualityObjectsMapType& qoMap);
 
@@ -87,6 +93,9 @@ class Aggregator
   AggregatorConfig mAggregatorConfig;
   AggregatorInterface* mAggregatorInterface = nullptr;
   std::vector<AggregatorSource> mSources;
+#ifdef QC_WITH_LATENCY_HISTOGRAMS
+  core::LatencyHistogram* mAggregateLatency = nullptr;
+#endif
 };
 
 } // namespace o2::quality_control::checker
@@ -27,6 +27,7 @@
 #include "QualityControl/Activity.h"
 #include "QualityControl/AggregatorRunnerConfig.h"
 #include "QualityControl/AggregatorConfig.h"
+#include "QualityControl/LatencyHistogram.h"
 
 namespace o2::framework
 {
@@ -180,6 +181,10 @@ class AggregatorRunner : public framework::Task
   std::string mDeviceName;
   core::Activity mActivity;
   std::vector<std::shared_ptr<Aggregator>> mAggregators;
+#ifdef QC_WITH_LATENCY_HISTOGRAMS
+  // the histograms of this runner, its aggregators and its database, declared first to outlive the database
+  std::unique_ptr<core::LatencyHistograms> mLatencyHistograms = std::make_unique<core::LatencyHistograms>();
+#endif
   std::shared_ptr<o2::quality_control::repository::DatabaseInterface> mDatabase;
   AggregatorRunnerConfig mRunnerConfig;
   std::vector<AggregatorConfig> mAggregatorsConfig;
@@ -193,6 +198,9 @@ class AggregatorRunner : public framework::Task
   std::shared_ptr<o2::monitoring::Monitoring> mCollector;
   AliceO2::Common::Timer mTimer;
   AliceO2::Common::Timer mTimerTotalDurationActivity;
+#ifdef QC_WITH_LATENCY_HISTOGRAMS
+  core::LatencyHistogram* mDeserializationLatency = &mLatencyHistograms->get("deserialize");
+#endif
   int mTotalNumberObjectsReceived;
   int mTotalNumberAggregatorExecuted;
   int mTotalNumberObjectsProduced;
@@ -0,0 +1,160 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   AsyncDatabase.h
+///
+
+#ifndef QC_REPOSITORY_ASYNCDATABASE_H
+#define QC_REPOSITORY_ASYNCDATABASE_H
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <thread>
+
+#include "QualityControl/DatabaseInterface.h"
+
+namespace o2::quality_control::repository
+{
+
+/// \brief Decorator which stores MonitorObjects and QualityObjects asynchronously.
+///
+/// storeMO and storeQO only put the object in a bounded queue and return. A pool of uploader threads, each with its
+/// own instance of the decorated backend, takes the objects out of the queue and stores them. If an object with the
+/// same path is still waiting in the queue, it is replaced by the new version (coalescing), so only the newest one is
+/// uploaded. All the other methods are forwarded synchronously to the backend.
+///
+/// storeMO and storeQO queue copies of the objects, so the caller can keep modifying them. The objects arriving while
+/// the uploaders are being stopped are stored synchronously.
+class AsyncDatabase : public DatabaseInterface
+{
+ public:
+  /// What to do when an object should be queued, but the queue is full.
+  enum class DropPolicy {
+    Block,      // wait until there is some space in the queue
+    DropOldest, // remove the oldest object from the queue
+    DropNewest  // do not queue the new object
+  };
+
+  struct Config {
+    size_t uploaderThreads = 1;
+    size_t queueDepth = 1000;
+    DropPolicy dropPolicy = DropPolicy::Block;
+    bool coalescing = true;
+  };
+
+  /// Statistics accumulated since the last call to getAndResetStatistics(), apart from the queue depth.
+  struct Statistics {
+    size_t queueDepth = 0;
+    size_t queued = 0;
+    size_t stored = 0;
+    size_t coalesced = 0;
+    size_t dropped = 0;
+    size_t failed = 0;
+    double meanQueueLatencyMs = 0;
+    double maxQueueLatencyMs = 0;
+  };
+
+  using BackendFactory = std::function<std::unique_ptr<DatabaseInterface>()>;
+
+  /// \brief Creates the decorator.
+  /// \param backendFactory creates instances of the decorated backend. It is called once for the synchronous calls
+  ///                       and once for each uploader thread, when connecting.
+  explicit AsyncDatabase(BackendFactory backendFactory, Config config = {});
+  ~AsyncDatabase() override;
+
+  /// \brief Parses the asynchronous storage parameters from the database configuration.
+  static Config extractConfig(const std::unordered_map<std::string, std::string>& databaseConfig);
+  /// \brief Tells if the asynchronous storage is enabled in the database configuration.
+  static bool isEnabled(const std::unordered_map<std::string, std::string>& databaseConfig);
+
+  void connect(std::string host, std::string database, std::string username, std::string password) override;
+  void connect(const std::unordered_map<std::string, std::string>& config) override;
+
+  // asynchronous storage
+  void storeMO(std::shared_ptr<const o2::quality_control::core::MonitorObject> mo, long from = -1, long to = -1) override;
+  void storeQO(std::shared_ptr<const o2::quality_control::core::QualityObject> qo, long from = -1, long to = -1) override;
+
+  // forwarded to the backend
+  void storeTRFC(std::shared_ptr<const o2::quality_control::TimeRangeFlagCollection> trfc) override;
+  void storeAny(const void* obj, std::type_info const& typeInfo, std::string const& path, std::map<std::string, std::string> const& metadata,
+                std::string const& detectorName, std::string const& taskName, long from = -1, long to = -1) override;
+  void* retrieveAny(std::type_info const& tinfo, std::string const& path,
+                    std::map<std::string, std::string> const& metadata, long timestamp = -1,
+                    std::map<std::string, std::string>* headers = nullptr,
+                    const std::string& createdNotAfter = "", const std::string& createdNotBefore = "") override;
+  std::shared_ptr<o2::quality_control::core::MonitorObject> retrieveMO(std::string objectPath, std::string objectName, long timestamp = -1, const core::Activity& activity = {}) override;
+  std::shared_ptr<o2::quality_control::core::QualityObject> retrieveQO(std::string qoPath, long timestamp = -1, const core::Activity& activity = {}) override;
+  std::shared_ptr<o2::quality_control::TimeRangeFlagCollection> retrieveTRFC(const std::string& name, const std::string& detector, int runNumber = 0,
+                                                                             const std::string& passName = "", const std::string& periodName = "",
+                                                                             const std::string& provenance = "", long timestamp = -1) override;
+  std::string retrieveJson(std::string path, long timestamp, const std::map<std::string, std::string>& metadata) override;
+  TObject* retrieveTObject(std::string path, const std::map<std::string, std::string>& metadata, long timestamp = -1, std::map<std::string, std::string>* headers = nullptr) override;
+  std::map<std::string, std::string> retrieveHeaders(const std::string& path, const std::map<std::string, std::string>& metadata, long timestamp = -1) override;
+  void prepareTaskDataContainer(std::string taskName) override;
+  std::vector<std::string> getPublishedObjectNames(std::string taskName) override;
+  void truncate(std::string taskName, std::string objectName) override;
+  void setMaxObjectSize(size_t maxObjectSize) override;
+  void setLatencyHistograms(core::LatencyHistograms& histograms) override;
+
+  /// \brief Stores all the queued objects and stops the uploader threads.
+  void disconnect() override;
+
+  /// \brief Blocks until all the objects queued so far have been stored (or dropped).
+  void flush();
+  /// \brief Enables or disables replacing queued objects with newer versions at the same path.
+  void setCoalescing(bool coalescing);
+  Statistics getAndResetStatistics();
+  /// \brief The backend used for the synchronous calls.
+  DatabaseInterface& getBackend() { return *mBackend; }
+
+ private:
+  struct Entry {
+    std::string path;
+    std::shared_ptr<const o2::quality_control::core::MonitorObject> mo;
+    std::shared_ptr<const o2::quality_control::core::QualityObject> qo;
+    long from;
+    long to;
+    std::chrono::steady_clock::time_point queuedAt;
+  };
+
+  void enqueue(Entry&& entry);
+  void storeNow(const Entry& entry);
+  void runUploader(DatabaseInterface& backend);
+  void startUploaders(const std::function<void(DatabaseInterface&)>& connector);
+  void stopUploaders();
+
+  BackendFactory mBackendFactory;
+  Config mConfig;
+  std::unique_ptr<DatabaseInterface> mBackend;
+  std::mutex mBackendMutex; // serializes the synchronous storage of the objects arriving after stop
+  std::vector<std::unique_ptr<DatabaseInterface>> mUploaderBackends;
+  std::vector<std::thread> mUploaders;
+
+  std::mutex mMutex;
+  std::condition_variable mQueueNotEmpty;
+  std::condition_variable mQueueNotFull;
+  std::condition_variable mQueueDrained;
+  std::list<Entry> mQueue;
+  std::unordered_map<std::string, std::list<Entry>::iterator> mQueueIndex; // only queued entries, not the ones being stored
+  size_t mInFlight = 0;
+  bool mStopping = false;
+
+  Statistics mStatistics;
+  double mTotalQueueLatencyMs = 0;
+};
+
+} // namespace o2::quality_control::repository
+
+#endif // QC_REPOSITORY_ASYNCDATABASE_H
@@ -0,0 +1,130 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   CachingDatabase.h
+///
+
+#ifndef QC_REPOSITORY_CACHINGDATABASE_H
+#define QC_REPOSITORY_CACHINGDATABASE_H
+
+#include <functional>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+#include "QualityControl/DatabaseInterface.h"
+
+namespace o2::quality_control::repository
+{
+
+/// \brief Decorator which keeps the retrieved MonitorObjects and QualityObjects in a read-through cache.
+///
+/// The objects are cached in memory together with their validity and ETag, in a bounded LRU list. When an object
+/// valid at the requested timestamp is in the cache, only its headers are retrieved from the backend to verify that
+/// it was not superseded by a newer version (this can be disabled). Optionally, the objects are also stored in a local
+/// directory, so they can be reused by later processes, e.g. when reprocessing the same timestamps again.
+/// All the other methods, including storage, are forwarded to the backend.
+///
+/// The retrieved objects are shared by all the callers requesting them, thus they must not be modified.
+class CachingDatabase : public DatabaseInterface
+{
+ public:
+  struct Config {
+    size_t maxObjects = 100;
+    std::string directory; // the on-disk tier is disabled if empty
+    bool revalidation = true;
+  };
+
+  /// Statistics accumulated since the last call to getAndResetStatistics(), apart from the cache size.
+  struct Statistics {
+    size_t size = 0;
+    size_t hits = 0;
+    size_t diskHits = 0;
+    size_t misses = 0;
+    size_t revalidations = 0; // number of retrieved headers
+    size_t stale = 0;         // cached objects replaced by a newer version
+    size_t evictions = 0;
+  };
+
+  CachingDatabase(std::unique_ptr<DatabaseInterface> backend, Config config = {});
+  ~CachingDatabase() override = default;
+
+  /// \brief Parses the cache parameters from the database configuration.
+  static Config extractConfig(const std::unordered_map<std::string, std::string>& databaseConfig);
+  /// \brief Tells if the cache is enabled in the database configuration.
+  static bool isEnabled(const std::unordered_map<std::string, std::string>& databaseConfig);
+
+  void connect(std::string host, std::string database, std::string username, std::string password) override;
+  void connect(const std::unordered_map<std::string, std::string>& config) override;
+
+  // cached
+  std::shared_ptr<o2::quality_control::core::MonitorObject> retrieveMO(std::string objectPath, std::string objectName, long timestamp = -1, const core::Activity& activity = {}) override;
+  std::shared_ptr<o2::quality_control::core::QualityObject> retrieveQO(std::string qoPath, long timestamp = -1, const core::Activity& activity = {}) override;
+
+  // forwarded to the backend
+  void storeMO(std::shared_ptr<const o2::quality_control::core::MonitorObject> mo, long from = -1, long to = -1) override;
+  void storeQO(std::shared_ptr<const o2::quality_control::core::QualityObject> qo, long from = -1, long to = -1) override;
+  void storeTRFC(std::shared_ptr<const o2::quality_control::TimeRangeFlagCollection> trfc) override;
+  void storeAny(const void* obj, std::type_info const& typeInfo, std::string const& path, std::map<std::string, std::string> const& metadata,
+                std::string const& detectorName, std::string const& taskName, long from = -1, long to = -1) override;
+  void* retrieveAny(std::type_info const& tinfo, std::string const& path,
+                    std::map<std::string, std::string> const& metadata, long timestamp = -1,
+                    std::map<std::string, std::string>* headers = nullptr,
+                    const std::string& createdNotAfter = "", const std::string& createdNotBefore = "") override;
+  std::shared_ptr<o2::quality_control::TimeRangeFlagCollection> retrieveTRFC(const std::string& name, const std::string& detector, int runNumber = 0,
+                                                                             const std::string& passName = "", const std::string& periodName = "",
+                                                                             const std::string& provenance = "", long timestamp = -1) override;
+  std::string retrieveJson(std::string path, long timestamp, const std::map<std::string, std::string>& metadata) override;
+  TObject* retrieveTObject(std::string path, const std::map<std::string, std::string>& metadata, long timestamp = -1, std::map<std::string, std::string>* headers = nullptr) override;
+  std::map<std::string, std::string> retrieveHeaders(const std::string& path, const std::map<std::string, std::string>& metadata, long timestamp = -1) override;
+  void disconnect() override;
+  void prepareTaskDataContainer(std::string taskName) override;
+  std::vector<std::string> getPublishedObjectNames(std::string taskName) override;
+  void truncate(std::string taskName, std::string objectName) override;
+  void setMaxObjectSize(size_t maxObjectSize) override;
+
+  /// \brief Removes all the objects from the in-memory cache.
+  void clear();
+  Statistics getAndResetStatistics();
+
+ private:
+  struct Entry {
+    std::string key;
+    long validFrom = -1;
+    long validUntil = -1;
+    std::string etag;
+    std::shared_ptr<o2::quality_control::core::MonitorObject> mo;
+    std::shared_ptr<o2::quality_control::core::QualityObject> qo;
+  };
+  using Fetcher = std::function<Entry()>;
+
+  /// Returns the cached object valid at the timestamp if it is up to date, otherwise fetches a new one.
+  Entry retrieve(const std::string& key, const std::string& fullPath, const std::map<std::string, std::string>& metadata, long timestamp, const Fetcher& fetch);
+  std::string getDiskPath(const std::string& key, const std::string& etag) const;
+  bool loadFromDisk(Entry& entry) const;
+  void storeOnDisk(const Entry& entry) const;
+  // insert and evict expect mMutex to be locked
+  void insert(Entry entry);
+  void evict(std::list<Entry>::iterator it);
+
+  std::unique_ptr<DatabaseInterface> mBackend;
+  Config mConfig;
+
+  std::mutex mMutex;
+  std::list<Entry> mEntries; // the most recently used first
+  std::unordered_multimap<std::string, std::list<Entry>::iterator> mIndex;
+  Statistics mStatistics;
+};
+
+} // namespace o2::quality_control::repository
+
+#endif // QC_REPOSITORY_CACHINGDATABASE_H
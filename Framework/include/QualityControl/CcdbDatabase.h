@@ -20,7 +20,12 @@
 #include <CCDB/CcdbApi.h>
 
 #include "QualityControl/DatabaseInterface.h"
+#include "QualityControl/DatabaseHelpers.h"
+#include "QualityControl/LatencyHistogram.h"
 #include <Common/Timer.h>
+#include <memory>
+#include <mutex>
+#include <vector>
 
 namespace o2::quality_control::repository
 {
@@ -81,6 +86,7 @@ class CcdbDatabase : public DatabaseInterface
   // retrieval - general
   std::string retrieveJson(std::string path, long timestamp, const std::map<std::string, std::string>& metadata) override;
   TObject* retrieveTObject(std::string path, const std::map<std::string, std::string>& metadata, long timestamp = -1, std::map<std::string, std::string>* headers = nullptr) override;
+  std::map<std::string, std::string> retrieveHeaders(const std::string& path, const std::map<std::string, std::string>& metadata, long timestamp = -1) override;
 
   void disconnect() override;
   void prepareTaskDataContainer(std::string taskName) override;
@@ -103,6 +109,14 @@ class CcdbDatabase : public DatabaseInterface
    */
   boost::property_tree::ptree getListingAsPtree(std::string path); // TODO allow to filter by metadata
 
+  /**
+   * \brief Returns the object versions in the path whose activity is accepted, without building a tree.
+   * \param path the object path.
+   * \param accept tells if a version should be kept.
+   * \return The accepted versions, in the order of the listing (as for today, from the newest to the oldest).
+   */
+  std::vector<database_helpers::ListedVersion> getListedVersions(std::string path, const std::function<bool(const core::Activity&)>& accept);
+
   /**
    * \brief Returns a vector of all 'valid from' timestamps for an object.
    * \path Path on an object.
@@ -111,6 +125,7 @@ class CcdbDatabase : public DatabaseInterface
   std::vector<uint64_t> getTimestampsForObject(std::string path);
 
   void setMaxObjectSize(size_t maxObjectSize) override;
+  void setLatencyHistograms(core::LatencyHistograms& histograms) override;
 
  private:
   /**
@@ -144,10 +159,22 @@ class CcdbDatabase : public DatabaseInterface
    */
   bool isDbInFailure();
 
-  o2::ccdb::CcdbApi ccdbApi;
+  /**
+   * Gives an instance of CcdbApi for a retrieval. CcdbApi is not thread-safe, so each concurrent retrieval uses its own
+   * instance. The instances are returned to a pool when released, to reuse their connections.
+   */
+  std::shared_ptr<o2::ccdb::CcdbApi> borrowApi();
+
+  o2::ccdb::CcdbApi ccdbApi; // for the storage and the deletion
+  std::mutex mApiPoolMutex;
+  std::vector<std::unique_ptr<o2::ccdb::CcdbApi>> mApiPool; // idle instances for the retrievals
   std::string mUrl;
   size_t mMaxObjectSize = 2097152; // 2MB by default
   int mFailureDelay = 60;          // 60 seconds delay between attempts to store things in the database
+#ifdef QC_WITH_LATENCY_HISTOGRAMS
+  core::LatencyHistogram* mStoreMOLatency = nullptr;
+  core::LatencyHistogram* mStoreQOLatency = nullptr;
+#endif
   bool mDatabaseFailure = false;
   AliceO2::Common::Timer mFailureTimer;
 };
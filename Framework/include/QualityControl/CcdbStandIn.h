@@ -0,0 +1,118 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   CcdbStandIn.h
+///
+
+#ifndef QUALITYCONTROL_CCDBSTANDIN_H
+#define QUALITYCONTROL_CCDBSTANDIN_H
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace o2::quality_control::repository
+{
+
+/// \brief A local HTTP server which implements the subset of the CCDB REST API used by the QC, in memory.
+///
+/// It stores (POST), retrieves (GET), gives the headers (HEAD), lists (/browse and /latest) and deletes (DELETE and
+/// /truncate) the versions of objects, so that the clients of the CCDB can be tested and profiled without a real
+/// server. A latency can be added to each answer and a fraction of the requests can be answered with an error.
+/// The objects are always served directly, without redirections to replicas. The "Content-MD5" header is a checksum
+/// of the content, but not an actual MD5.
+class CcdbStandIn
+{
+ public:
+  struct Config {
+    unsigned short port = 0;                // 0 to use any free port, see getPort()
+    std::chrono::milliseconds latency{ 0 }; // added before each answer
+    double errorRate = 0;                   // fraction of the requests answered with "503 Service Unavailable"
+    unsigned int seed = 42;                 // of the injected errors
+  };
+
+  struct Statistics {
+    size_t requests = 0;
+    size_t injectedErrors = 0;
+    size_t storedVersions = 0; // currently
+  };
+
+  /// \brief Starts serving in the background.
+  explicit CcdbStandIn(Config config);
+  CcdbStandIn() : CcdbStandIn(Config{}) {}
+  ~CcdbStandIn();
+
+  unsigned short getPort() const;
+  /// \brief Returns the URL to give to the CCDB clients.
+  std::string getUrl() const;
+  Statistics getStatistics() const;
+
+ private:
+  struct Version {
+    std::string path;
+    std::string id;
+    uint64_t validFrom;
+    uint64_t validUntil;
+    uint64_t created;
+    std::map<std::string, std::string> metadata;
+    std::string fileName;
+    std::string contentType;
+    std::string checksum;
+    std::string content;
+  };
+  struct Request;
+  struct Response;
+  struct Connection {
+    explicit Connection(boost::asio::ip::tcp::socket socket) : socket(std::move(socket)) {}
+    boost::asio::ip::tcp::socket socket;
+    std::thread thread;
+    std::atomic<bool> finished = false;
+  };
+
+  void acceptConnections();
+  void serve(Connection& connection);
+  bool injectError();
+  Response handle(const Request& request);
+  Response store(const Request& request);
+  Response retrieve(const Request& request, bool withContent);
+  Response browse(const Request& request, bool latestOnly);
+  Response remove(const Request& request);
+  Response truncate(const Request& request);
+
+  const Config mConfig;
+  boost::asio::io_context mContext;
+  boost::asio::ip::tcp::acceptor mAcceptor;
+  std::atomic<bool> mStopping = false;
+  std::thread mAcceptThread;
+  std::mutex mConnectionsMutex;
+  std::list<Connection> mConnections;
+
+  mutable std::mutex mMutex;
+  std::map<std::string, std::vector<std::shared_ptr<const Version>>> mObjects; // by path, the oldest version first
+  uint64_t mNextId = 1;
+  std::mt19937 mGenerator;
+  Statistics mStatistics;
+};
+
+} // namespace o2::quality_control::repository
+
+#endif // QUALITYCONTROL_CCDBSTANDIN_H
@@ -28,6 +28,7 @@
 #include "QualityControl/CheckConfig.h"
 #include "QualityControl/CommonSpec.h"
 #include "QualityControl/CheckSpec.h"
+#include "QualityControl/LatencyHistogram.h"
 
 namespace o2::quality_control::checker
 {
@@ -57,14 +58,30 @@ class Check
    * Expected to run in the init phase of the FairDevice
    */
   void init();
+  /**
+   * \brief Records the durations of check() and beautify() in the histograms of the given set.
+   * It has no effect if the latency histograms are disabled at compilation time.
+   */
+  void setLatencyHistograms(core::LatencyHistograms& histograms);
 
-  QualityObjectsType check(std::map<std::string, std::shared_ptr<o2::quality_control::core::MonitorObject>>& moMap);
+  /**
+   * \brief Checks the MonitorObjects and beautifies them if it is allowed.
+   *
+   * If beautifyObjects is false, the MonitorObjects are not modified and beautify() should be called later with
+   * the returned QualityObjects.
+   */
+  QualityObjectsType check(std::map<std::string, std::shared_ptr<o2::quality_control::core::MonitorObject>>& moMap, bool beautifyObjects = true);
+  /**
+   * \brief Beautifies the MonitorObjects which were checked to obtain the QualityObjects, if it is allowed.
+   */
+  void beautify(const QualityObjectsType& qualityObjects, std::map<std::string, std::shared_ptr<o2::quality_control::core::MonitorObject>>& moMap);
 
   const std::string& getName() const { return mCheckConfig.name; };
   o2::framework::OutputSpec getOutputSpec() const { return mCheckConfig.qoSpec; };
   o2::framework::Inputs getInputs() const { return mCheckConfig.inputSpecs; };
   const std::string& getDetector() const { return mCheckConfig.detectorName; };
   const CheckConfig& getConfig() const { return mCheckConfig; };
+  bool isThreadSafe() const { return mCheckConfig.threadSafe; };
 
   //TODO: Unique Input string
   static o2::header::DataDescription createCheckDataDescription(const std::string& checkName);
@@ -85,6 +102,10 @@ class Check
 
   CheckConfig mCheckConfig;
   CheckInterface* mCheckInterface = nullptr;
+#ifdef QC_WITH_LATENCY_HISTOGRAMS
+  core::LatencyHistogram* mCheckLatency = nullptr;
+  core::LatencyHistogram* mBeautifyLatency = nullptr;
+#endif
 };
 
 } // namespace o2::quality_control::checker
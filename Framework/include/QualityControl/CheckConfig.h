@@ -39,6 +39,7 @@ struct CheckConfig {
   bool allowBeautify = false;
   framework::Inputs inputSpecs{};
   framework::OutputSpec qoSpec{ "XXX", "INVALID" };
+  bool threadSafe = false; // the check can run concurrently with other checks
 };
 
 } // namespace o2::quality_control::checker
@@ -40,6 +40,8 @@
 #include "QualityControl/UpdatePolicyManager.h"
 #include "QualityControl/Activity.h"
 #include "QualityControl/CheckRunnerConfig.h"
+#include "QualityControl/ThreadPool.h"
+#include "QualityControl/LatencyHistogram.h"
 
 namespace o2::quality_control::core
 {
@@ -193,6 +195,17 @@ class CheckRunner : public framework::Task
    * @param ctx
    */
   void prepareCacheData(framework::InputRecord& inputRecord);
+  /**
+   * \brief Slot of mMonitorObjects for a given MonitorObject and its id in the updatePolicyManager.
+   */
+  struct CacheSlot {
+    std::shared_ptr<MonitorObject>* monitorObject;
+    size_t objectId;
+  };
+  /**
+   * \brief Finds (or creates) the cache slot of the MonitorObject, without building its full name if it is known.
+   */
+  CacheSlot& getCacheSlot(const MonitorObject& mo);
   /**
    * Send metrics to the monitoring system if the time has come.
    */
@@ -214,6 +227,10 @@ class CheckRunner : public framework::Task
   std::string mDetectorName;
   Activity mActivity;
   CheckRunnerConfig mConfig;
+#ifdef QC_WITH_LATENCY_HISTOGRAMS
+  // the histograms of this runner, its checks and its database, declared first to outlive the database
+  std::unique_ptr<core::LatencyHistograms> mLatencyHistograms = std::make_unique<core::LatencyHistograms>();
+#endif
   std::shared_ptr<o2::quality_control::repository::DatabaseInterface> mDatabase;
   std::unordered_set<std::string> mInputStoreSet;
   std::vector<std::shared_ptr<MonitorObject>> mMonitorObjectStoreVector;
@@ -225,6 +242,13 @@ class CheckRunner : public framework::Task
 
   // Checks cache
   std::map<std::string, std::shared_ptr<MonitorObject>> mMonitorObjects;
+  // task name -> object name -> slot, std::less<> allows to look up with the const char* names of the objects
+  std::map<std::string, std::map<std::string, CacheSlot, std::less<>>, std::less<>> mCacheIndex;
+  // histograms received alone on each input, which are not used anymore and can be deserialized into
+  std::vector<std::unique_ptr<TObject>> mSpareObjects;
+
+  // executes the thread-safe checks in parallel, if enabled
+  std::unique_ptr<core::ThreadPool> mCheckPool;
 
   // Service discovery
   std::shared_ptr<ServiceDiscovery> mServiceDiscovery;
@@ -239,6 +263,9 @@ class CheckRunner : public framework::Task
   int mTotalQOSent;
   AliceO2::Common::Timer mTimer;
   AliceO2::Common::Timer mTimerTotalDurationActivity;
+#ifdef QC_WITH_LATENCY_HISTOGRAMS
+  core::LatencyHistogram* mDeserializationLatency = &mLatencyHistograms->get("deserialize");
+#endif
 };
 
 } // namespace o2::quality_control::checker
@@ -34,6 +34,7 @@ struct CheckRunnerConfig {
   std::string fallbackPassName{};
   std::string fallbackProvenance{};
   framework::Options options{};
+  int checkThreads = 0; // thread-safe checks are executed in parallel if more than 1
 };
 
 } // namespace o2::quality_control::checker
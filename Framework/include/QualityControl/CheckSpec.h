@@ -51,6 +51,7 @@ struct CheckSpec {
   UpdatePolicyType updatePolicy = UpdatePolicyType::OnAny;
   // advanced
   bool active = true;
+  bool threadSafe = false;
   std::unordered_map<std::string, std::string> customParameters = {};
 };
 
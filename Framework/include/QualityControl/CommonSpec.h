@@ -40,6 +40,9 @@ struct CommonSpec {
   bool infologgerFilterDiscardDebug = false;
   int infologgerDiscardLevel = 21;
   double postprocessingPeriod = 10.0;
+  int checkRunnerThreads = 0;
+  bool fileSinkStreaming = false;
+  double fileSinkFlushPeriodSeconds = 0;
 };
 
 } // namespace o2::quality_control::core
@@ -0,0 +1,89 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   ConcurrentRetriever.h
+///
+
+#ifndef QUALITYCONTROL_CONCURRENTRETRIEVER_H
+#define QUALITYCONTROL_CONCURRENTRETRIEVER_H
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "QualityControl/Activity.h"
+
+namespace o2::quality_control::core
+{
+class MonitorObject;
+class QualityObject;
+class ThreadPool;
+} // namespace o2::quality_control::core
+
+namespace o2::quality_control::repository
+{
+class DatabaseInterface;
+}
+
+namespace o2::quality_control::postprocessing
+{
+
+/// \brief Retrieves a set of objects from the repository with a limited number of concurrent requests.
+///
+/// The objects are given to the callback in the calling thread as soon as each of them arrives, so their processing
+/// (e.g. by Reductors) overlaps with the retrieval of the other ones and it does not have to be thread-safe.
+/// The repository backend has to support concurrent retrievals, as CcdbDatabase does by giving each of them its own
+/// CcdbApi. With the concurrency of 1, the objects are retrieved one after another in the calling thread, in the order
+/// of requests.
+class ConcurrentRetriever
+{
+ public:
+  struct Request {
+    enum class Type {
+      MonitorObject,
+      QualityObject
+    };
+    Type type;
+    std::string path; // for QualityObjects it is the full path
+    std::string name; // used only for MonitorObjects
+    long timestamp = -1;
+    core::Activity activity = {};
+  };
+
+  /// Only the member corresponding to the request type can be set. Both are empty if the object was not found.
+  struct Result {
+    std::shared_ptr<core::MonitorObject> mo;
+    std::shared_ptr<core::QualityObject> qo;
+  };
+
+  using Callback = std::function<void(size_t requestIndex, Result& result)>;
+
+  explicit ConcurrentRetriever(size_t maxConcurrency = 1);
+  ~ConcurrentRetriever();
+
+  /// \brief Retrieves all the requested objects and invokes the callback for each of them in the order of arrival.
+  ///
+  /// If a retrieval or the callback throws, the exception is rethrown once all the started retrievals finish.
+  /// The remaining objects are not given to the callback in such case.
+  void retrieve(repository::DatabaseInterface& repository, const std::vector<Request>& requests, const Callback& callback);
+
+  size_t getMaxConcurrency() const { return mMaxConcurrency; }
+
+ private:
+  size_t mMaxConcurrency;
+  std::unique_ptr<core::ThreadPool> mPool;
+};
+
+} // namespace o2::quality_control::postprocessing
+
+#endif //QUALITYCONTROL_CONCURRENTRETRIEVER_H
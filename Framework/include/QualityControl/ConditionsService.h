@@ -0,0 +1,117 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   ConditionsService.h
+///
+
+#ifndef QUALITYCONTROL_CONDITIONSSERVICE_H
+#define QUALITYCONTROL_CONDITIONSSERVICE_H
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <typeinfo>
+
+namespace o2::quality_control::core
+{
+
+/// \brief Retrieves the conditions used by the tasks in the background and shares them.
+///
+/// All the tasks of a process which use the same database share one service (see getInstance()).
+/// A condition is retrieved once in a background thread and the same deserialized object is given to all the tasks
+/// which ask for it. When its validity ends, a new version is retrieved in the background and replaces it for the
+/// next callers, while the tasks which still hold the previous one keep it alive. Thus, the tasks wait for the
+/// database only if they ask for a condition which has never been retrieved yet, and at most for a given timeout.
+class ConditionsService
+{
+ public:
+  /// \brief Returns a new object of the given type, nullptr if it could not be found. It fills the headers.
+  using Retriever = std::function<void*(const std::type_info& type, const std::string& path, const std::map<std::string, std::string>& metadata,
+                                        std::map<std::string, std::string>& headers)>;
+
+  /// \brief Starts the background thread.
+  /// \param retriever is called only by the background thread. ROOT is made thread-safe, since it usually deserializes ROOT objects.
+  /// \param retryInterval is the delay before a failed retrieval is tried again.
+  explicit ConditionsService(Retriever retriever, std::chrono::milliseconds retryInterval = std::chrono::seconds(10));
+  ~ConditionsService();
+
+  /// \brief Returns the service of a CCDB instance, shared by all the tasks of the process.
+  static std::shared_ptr<ConditionsService> getInstance(const std::string& databaseUrl);
+
+  /// \brief Starts retrieving a condition in the background, if it was not requested yet.
+  template <typename T>
+  void prefetch(const std::string& path, const std::map<std::string, std::string>& metadata = {})
+  {
+    prefetch(typeid(T), path, metadata, &deleteObject<T>);
+  }
+
+  /// \brief Returns the latest version of a condition, nullptr if it could not be retrieved.
+  /// If the condition has never been retrieved yet, it blocks until the first retrieval ends, but not longer than the
+  /// timeout. After a timeout it returns nullptr, while the retrieval continues in the background for the next calls.
+  template <typename T>
+  std::shared_ptr<const T> get(const std::string& path, const std::map<std::string, std::string>& metadata = {},
+                               std::chrono::milliseconds timeout = defaultTimeout)
+  {
+    return std::static_pointer_cast<const T>(get(typeid(T), path, metadata, &deleteObject<T>, timeout));
+  }
+
+  static constexpr std::chrono::milliseconds defaultTimeout{ 10000 };
+
+  /// \brief Number of calls to the retriever, including the failed ones.
+  size_t getNumberRetrievals() const;
+
+ private:
+  using Deleter = void (*)(const void*);
+
+  template <typename T>
+  static void deleteObject(const void* object)
+  {
+    delete static_cast<const T*>(object);
+  }
+
+  struct Condition {
+    const std::type_info* type;
+    std::string path;
+    std::map<std::string, std::string> metadata;
+    Deleter deleter;
+    std::shared_ptr<const void> object;               // the latest version, might be null
+    bool retrieved = false;                           // true after the first attempt, successful or not
+    std::chrono::steady_clock::time_point nextUpdate; // when it should be retrieved again
+  };
+
+  void prefetch(const std::type_info& type, const std::string& path, const std::map<std::string, std::string>& metadata, Deleter deleter);
+  std::shared_ptr<const void> get(const std::type_info& type, const std::string& path, const std::map<std::string, std::string>& metadata, Deleter deleter,
+                                  std::chrono::milliseconds timeout);
+  /// \brief Returns the condition, after adding it if it is new. The mutex must be held.
+  Condition& request(const std::type_info& type, const std::string& path, const std::map<std::string, std::string>& metadata, Deleter deleter);
+  void run();
+  void retrieve(Condition& condition, std::unique_lock<std::mutex>& lock);
+
+  Retriever mRetriever;
+  const std::chrono::milliseconds mRetryInterval;
+
+  mutable std::mutex mMutex;
+  std::condition_variable mChanged; // new requests for the background thread and new versions for the tasks
+  bool mStopping = false;
+  size_t mNumberRetrievals = 0;
+  std::map<std::string, Condition> mConditions; // by type, path and metadata, never removed
+  std::thread mThread;
+};
+
+} // namespace o2::quality_control::core
+
+#endif // QUALITYCONTROL_CONDITIONSSERVICE_H
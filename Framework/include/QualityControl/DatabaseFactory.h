@@ -35,6 +35,12 @@ class DatabaseFactory
   /// \param name Possible values : "MySql", "CCDB"
   /// \author Barthelemy von Haller
   static std::unique_ptr<DatabaseInterface> create(std::string name);
+
+  /// \brief Create and connect a new instance of a DatabaseInterface based on the database configuration.
+  /// The backend is selected with the key "implementation". If "asyncStorage" is enabled, the backend is
+  /// wrapped in an AsyncDatabase, so that MonitorObjects and QualityObjects are stored in the background.
+  /// \param config The database configuration, as found in "qc.config.database".
+  static std::unique_ptr<DatabaseInterface> createAndConnect(const std::unordered_map<std::string, std::string>& config);
 };
 
 } // namespace o2::quality_control::repository
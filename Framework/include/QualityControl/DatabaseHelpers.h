@@ -17,8 +17,11 @@
 #ifndef QUALITYCONTROL_DATABASEHELPERS_H
 #define QUALITYCONTROL_DATABASEHELPERS_H
 
+#include <cstdint>
+#include <functional>
 #include <map>
 #include <string>
+#include <vector>
 #include <boost/property_tree/ptree_fwd.hpp>
 #include "QualityControl/Activity.h"
 
@@ -29,6 +32,18 @@ std::map<std::string, std::string> asDatabaseMetadata(const core::Activity&, boo
 core::Activity asActivity(const std::map<std::string, std::string>& metadata, const std::string& provenance = "qc");
 core::Activity asActivity(const boost::property_tree::ptree&, const std::string& provenance = "qc");
 
+/// \brief An object version in a listing, reduced to what is needed to iterate over versions.
+struct ListedVersion {
+  core::Activity activity; // including the validity of the version
+  uint64_t created = 0;
+};
+
+/// \brief Parses a JSON listing of a CCDB path, keeping only the versions whose activity is accepted.
+/// The listing is read as a stream, no tree is built, so the memory depends only on the accepted versions.
+/// The versions are returned in the order of the listing.
+/// \throw std::runtime_error if the listing is not valid JSON.
+std::vector<ListedVersion> parseListing(const std::string& listing, const std::function<bool(const core::Activity&)>& accept, const std::string& provenance = "qc");
+
 } // namespace o2::quality_control::repository::database_helpers
 
 #endif // QUALITYCONTROL_DATABASEHELPERS_H
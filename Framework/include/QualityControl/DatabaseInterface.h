@@ -33,6 +33,11 @@ namespace o2::quality_control
 class TimeRangeFlagCollection;
 }
 
+namespace o2::quality_control::core
+{
+class LatencyHistograms;
+}
+
 namespace o2::quality_control::repository
 {
 
@@ -167,6 +172,15 @@ class DatabaseInterface
    */
   virtual TObject* retrieveTObject(std::string path, const std::map<std::string, std::string>& metadata, long timestamp = -1, std::map<std::string, std::string>* headers = nullptr) = 0;
 
+  /**
+   * \brief Look up the headers of an object, without retrieving the object itself.
+   * \param path the path of the object
+   * \param metadata filters under the form of key-value pairs to select data
+   * \param timestamp the timestamp to query the object
+   * \return the headers of the object, or an empty map if it was not found or the backend does not provide headers.
+   */
+  virtual std::map<std::string, std::string> retrieveHeaders(const std::string& path, const std::map<std::string, std::string>& metadata, long timestamp = -1) = 0;
+
   /**
    * \brief Look up an object and return it in JSON format.
    * Look up an object and return it in JSON format if found or an empty string if not.
@@ -205,6 +219,12 @@ class DatabaseInterface
   virtual void truncate(std::string taskName, std::string objectName) = 0;
 
   virtual void setMaxObjectSize(size_t maxObjectSize) = 0;
+
+  /**
+   * \brief Gives the set of histograms where the implementation may record the latency of its operations.
+   * The set has to outlive the database. By default, nothing is recorded.
+   */
+  virtual void setLatencyHistograms(core::LatencyHistograms& /*histograms*/) {}
 };
 
 } // namespace o2::quality_control::repository
@@ -0,0 +1,68 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   DerivedObjects.h
+///
+
+#ifndef QUALITYCONTROL_DERIVEDOBJECTS_H
+#define QUALITYCONTROL_DERIVEDOBJECTS_H
+
+#include <functional>
+#include <string>
+#include <vector>
+
+class TObject;
+
+namespace o2::quality_control::core
+{
+class MonitorObject;
+class MonitorObjectCollection;
+} // namespace o2::quality_control::core
+
+/// Objects which are computed from other objects of the same collection, e.g. an efficiency out of two counters.
+///
+/// The function and the names of the sources are kept in the metadata of the derived MonitorObject, so the derived
+/// object can be recomputed wherever the collection goes: before the publication of a Task and after merging.
+/// The functions are referred to by names. "ratio" and "efficiency" (binomial errors) divide the first source
+/// histogram by the second one and are always available. Other functions can be registered by the modules, but they
+/// are known in Mergers only if they are registered when the library is loaded. Otherwise, the derived objects are
+/// merged as the other ones.
+namespace o2::quality_control::core::derived_objects
+{
+
+/// Computes the content of the derived object out of the sources, in the order they were declared.
+using Function = std::function<void(TObject& derived, const std::vector<const TObject*>& sources)>;
+
+extern const std::string gFunctionKey;
+extern const std::string gSourcesKey;
+
+/// \brief Makes the function available under the given name, replacing the previous one if any.
+void registerFunction(const std::string& name, Function function);
+bool isRegistered(const std::string& name);
+
+/// \brief Tells if the object is derived and its function is known, i.e. if it can be recomputed.
+bool isComputable(const MonitorObject& mo);
+
+/// \brief Declares the object as derived, by adding the corresponding metadata.
+void declare(MonitorObject& mo, const std::string& functionName, const std::vector<std::string>& sourceNames);
+
+/// \brief Computes the derived object out of the sources found in the collection.
+/// \return false if the object is not computable or some sources are missing.
+bool compute(MonitorObject& mo, const MonitorObjectCollection& collection);
+
+/// \brief Computes all the computable objects in the collection.
+/// \return the number of computed objects
+size_t computeAll(MonitorObjectCollection& collection);
+
+} // namespace o2::quality_control::core::derived_objects
+
+#endif // QUALITYCONTROL_DERIVEDOBJECTS_H
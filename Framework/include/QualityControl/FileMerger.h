@@ -0,0 +1,52 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   FileMerger.h
+///
+
+#ifndef QUALITYCONTROL_FILEMERGER_H
+#define QUALITYCONTROL_FILEMERGER_H
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class TFile;
+
+namespace o2::quality_control::core
+{
+class MonitorObjectCollection;
+}
+
+/// Merging the MonitorObjectCollections stored in ROOT files, as done by o2-qc-file-merger.
+namespace o2::quality_control::core::file_merger
+{
+
+using MonitorObjectCollectionMap = std::unordered_map<std::string, std::unique_ptr<MonitorObjectCollection>>;
+using ErrorHandler = std::function<void(const std::string&)>;
+
+/// \brief Merges the collections of the input files with the ones already stored in the output file.
+///
+/// The files are merged in the given order. With more than one thread, each thread merges a contiguous range of the
+/// files, then the partial results are merged pairwise. The result is the same as the one of merging the files one
+/// after another, apart from the rounding of floating point sums.
+/// The errors of reading are given to the handler, which can throw to stop. The exceptions thrown while merging are
+/// rethrown if exitOnError is true, otherwise they are logged.
+/// \return The merged collections, which are not written in the output file yet.
+MonitorObjectCollectionMap mergeFiles(const std::vector<std::string>& inputFilePaths, TFile& outputFile, size_t threads,
+                                      const ErrorHandler& handleError, bool exitOnError, size_t& filesRead);
+
+} // namespace o2::quality_control::core::file_merger
+
+#endif // QUALITYCONTROL_FILEMERGER_H
@@ -0,0 +1,115 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   FillBuffer.h
+///
+
+#ifndef QUALITYCONTROL_FILLBUFFER_H
+#define QUALITYCONTROL_FILLBUFFER_H
+
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+class TH1;
+
+namespace o2::quality_control::core
+{
+
+/// \brief Interface of the fill buffers, independent of the dimension of the histogram.
+class FillBufferBase
+{
+ public:
+  virtual ~FillBufferBase() = default;
+
+  /// \brief Fills the buffered entries into the histogram and empties the buffer.
+  virtual void flush() = 0;
+  /// \brief Drops the buffered entries.
+  virtual void clear() = 0;
+  virtual size_t size() const = 0;
+  virtual TH1* getHistogram() const = 0;
+};
+
+/// \brief Collects the entries of a histogram and fills them in bulk.
+///
+/// The coordinates and weights are appended to separate arrays. When the buffer is flushed, the bins of all the
+/// entries are computed in one loop, then the contents and the statistics are updated, which avoids a virtual call
+/// and a bin lookup per entry. This fast path is taken for TH1F, TH1D, TH2F and TH2D with fixed-width bins and no
+/// automatic extension of the axes. Other histograms are filled entry by entry with Fill(), so the result is
+/// always the same as with Fill(), except for the rounding of the statistics.
+///
+/// The buffer is flushed when it reaches its capacity. The buffers obtained with ObjectsManager::getFillBuffer() are
+/// also flushed by the framework before each endOfCycle() of the task and at the stop. The histogram does not show the buffered entries until they
+/// are flushed: call flush() before reading it or clear() before resetting it.
+template <int Dimension>
+class FillBuffer : public FillBufferBase
+{
+  static_assert(Dimension == 1 || Dimension == 2, "FillBuffer supports 1D and 2D histograms");
+
+ public:
+  /// \throw std::invalid_argument if the histogram is null, of another dimension, or a profile.
+  explicit FillBuffer(TH1* histogram, size_t capacity = 4096);
+  ~FillBuffer() override = default;
+
+  template <int D = Dimension, typename = std::enable_if_t<D == 1>>
+  void fill(double x, double weight = 1.0)
+  {
+    mX.push_back(x);
+    add(weight);
+  }
+
+  template <int D = Dimension, typename = std::enable_if_t<D == 2>>
+  void fill(double x, double y, double weight = 1.0)
+  {
+    mX.push_back(x);
+    mY.push_back(y);
+    add(weight);
+  }
+
+  void flush() override;
+  void clear() override;
+  size_t size() const override { return mX.size(); }
+  TH1* getHistogram() const override { return mHistogram; }
+  size_t getCapacity() const { return mCapacity; }
+
+ private:
+  void add(double weight)
+  {
+    mWeights.push_back(weight);
+    mWeighted |= weight != 1.0;
+    if (mX.size() >= mCapacity) {
+      flush();
+    }
+  }
+  bool canFillInBulk() const;
+  void fillInBulk();
+  void fillOneByOne();
+
+  TH1* mHistogram;
+  size_t mCapacity;
+  bool mWeighted = false;
+  std::vector<double> mX;
+  std::vector<double> mY;
+  std::vector<double> mWeights;
+  std::vector<int> mBins;
+  std::vector<int> mBinsY;
+};
+
+using FillBuffer1D = FillBuffer<1>;
+using FillBuffer2D = FillBuffer<2>;
+
+extern template class FillBuffer<1>;
+extern template class FillBuffer<2>;
+
+} // namespace o2::quality_control::core
+
+#endif // QUALITYCONTROL_FILLBUFFER_H
@@ -0,0 +1,105 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   HistogramTransport.h
+///
+
+#ifndef QC_CORE_HISTOGRAMTRANSPORT_H
+#define QC_CORE_HISTOGRAMTRANSPORT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+class TBuffer;
+class TObject;
+
+namespace o2::quality_control::core
+{
+
+class MonitorObjectCollection;
+
+/// \brief Encoding of MonitorObjectCollections which copies the bins of the histograms instead of streaming them.
+///
+/// ROOT streams the bins of a histogram element by element, converting each of them to big endian. For large
+/// histograms, it is most of the cost of sending and receiving the objects of a task. In this encoding, the bins of
+/// TH1F, TH1D, TH2F and TH2D are copied as they are in memory, directly into the message, which is allocated in the
+/// shared memory when the receiver runs on the same machine. Only the MonitorObjects without the bins (names, axes,
+/// metadata...) and the other objects are streamed by ROOT.
+///
+/// The payload starts with a small header followed, for each object, by its streamed part and its raw bins, aligned
+/// to 8 bytes. The bins are in the byte order of the sender, the receiver checks that it is the same.
+/// When most of the bins of a histogram are empty, only the runs of non-empty bins are written, each one preceded by
+/// its first bin and its length. Optionally, everything after the header is compressed with one of the algorithms
+/// of ROOT, which makes the encoding slower but the messages much smaller for detector maps.
+/// The O2 Mergers only read objects streamed by ROOT, so this encoding can be used only if the receiver is a
+/// CheckRunner or a RootFileSink. For the Mergers, the bins are copied by the Streamer of MonitorObjectCollection
+/// instead, with writeCollection() and readCollection(), in the message streamed by ROOT.
+namespace histogram_transport
+{
+
+/// \brief Compression of the encoded payloads.
+struct Compression {
+  enum class Algorithm : uint32_t {
+    None = 0,
+    Zlib = 1,
+    LZMA = 2,
+    LZ4 = 3,
+    ZSTD = 4
+  };
+
+  Algorithm algorithm = Algorithm::None;
+  int level = 1; // 1 (fastest) to 9 (smallest)
+
+  /// \brief Creates a Compression from the name of the algorithm ("none", "zlib", "lzma", "lz4" or "zstd").
+  /// \throw std::invalid_argument if the name or the level is not valid.
+  static Compression fromString(const std::string& algorithm, int level = 1);
+};
+
+/// \brief Sizes of an encoded payload.
+struct EncodedSize {
+  size_t payload = 0;      // what is sent
+  size_t uncompressed = 0; // what would have been sent without compression
+};
+
+/// \brief Tells if the bins of the object can be copied as they are, i.e. if it is a TH1F, TH1D, TH2F or TH2D.
+bool canCopyBins(const TObject* object);
+
+/// \brief Writes the collection in a buffer given by allocate(size).
+/// Without compression, everything is written directly in the buffer. With compression, the payload is first
+/// written in a temporary buffer and compressed, then the result is copied in the given buffer.
+EncodedSize encode(const MonitorObjectCollection& collection, const std::function<char*(size_t)>& allocate, const Compression& compression = {});
+
+/// \brief Tells if the payload has been written by encode().
+bool isEncoded(const char* payload, size_t size);
+
+/// \brief Reads a collection written by encode(). The collection owns the MonitorObjects, which own their objects.
+/// \throw std::runtime_error if the payload is not valid.
+std::unique_ptr<MonitorObjectCollection> decode(const char* payload, size_t size);
+
+/// \brief Streams the collection like TObjArray, except the bins of the histograms which can be copied. They are
+/// written after the streamed objects, as they are in memory, and optionally compressed.
+/// If copyBins is false, all the objects are streamed by ROOT.
+/// \return The number of bytes written in the buffer, and how many it would have been without compression.
+EncodedSize writeCollection(TBuffer& buffer, MonitorObjectCollection& collection, bool copyBins, const Compression& compression = {});
+
+/// \brief Reads a collection written by writeCollection().
+/// \throw std::runtime_error if the copied bins are not valid.
+void readCollection(TBuffer& buffer, MonitorObjectCollection& collection);
+
+} // namespace histogram_transport
+
+} // namespace o2::quality_control::core
+
+#endif // QC_CORE_HISTOGRAMTRANSPORT_H
@@ -0,0 +1,119 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   LatencyHistogram.h
+///
+
+#ifndef QC_CORE_LATENCYHISTOGRAM_H
+#define QC_CORE_LATENCYHISTOGRAM_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace o2::monitoring
+{
+class Monitoring;
+}
+
+namespace o2::quality_control::core
+{
+
+/// \brief Histogram of latencies with log-linear buckets, in the spirit of HdrHistogram.
+///
+/// Values are recorded in microseconds. Each power of two is divided in kSubBuckets linear buckets, which gives
+/// a relative precision of 1/kSubBuckets for any value, with a fixed memory footprint. Recording is lock-free, so it
+/// can be done from any thread.
+class LatencyHistogram
+{
+ public:
+  /// Values in microseconds. The percentiles are the upper bounds of the buckets containing them.
+  struct Summary {
+    uint64_t count = 0;
+    uint64_t p50 = 0;
+    uint64_t p99 = 0;
+    uint64_t max = 0;
+  };
+
+  void record(uint64_t microseconds);
+  /// \brief Returns the summary of the values recorded since the previous call and empties the histogram.
+  Summary getAndReset();
+
+  static size_t bucketIndex(uint64_t value);
+  static uint64_t bucketUpperBound(size_t index);
+
+  static constexpr size_t kSubBucketBits = 4;
+  static constexpr size_t kSubBuckets = 1 << kSubBucketBits;
+  static constexpr size_t kBuckets = (64 - kSubBucketBits + 1) * kSubBuckets;
+
+ private:
+  std::array<std::atomic<uint64_t>, kBuckets> mBuckets{};
+  std::atomic<uint64_t> mMax{ 0 };
+};
+
+/// \brief Records the time spent in its scope in a LatencyHistogram.
+class LatencyTimer
+{
+ public:
+  explicit LatencyTimer(LatencyHistogram* histogram) : mHistogram(histogram), mStart(std::chrono::steady_clock::now()) {}
+  ~LatencyTimer()
+  {
+    if (mHistogram != nullptr) {
+      mHistogram->record(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - mStart).count());
+    }
+  }
+
+ private:
+  LatencyHistogram* mHistogram;
+  std::chrono::steady_clock::time_point mStart;
+};
+
+/// \brief The named histograms of one actor, which reports them.
+///
+/// Each actor owns its set, so that reading the summaries of one actor does not reset the histograms of another one
+/// running in the same process.
+class LatencyHistograms
+{
+ public:
+  /// \brief Returns the histogram with the given name, creating it if needed.
+  /// The reference stays valid as long as the set, so it is meant to be obtained once and kept.
+  LatencyHistogram& get(const std::string& name);
+  /// \brief Returns the summaries of the histograms which recorded something since the previous call.
+  std::vector<std::pair<std::string, LatencyHistogram::Summary>> getAndResetSummaries();
+  /// \brief Sends the summaries as metrics named qc_latency_<histogram name>.
+  void send(o2::monitoring::Monitoring& collector);
+
+ private:
+  std::mutex mMutex;
+  std::map<std::string, std::unique_ptr<LatencyHistogram>> mHistograms;
+};
+
+} // namespace o2::quality_control::core
+
+// QC_LATENCY_SCOPE(histogram) records the time until the end of the current scope in the histogram (pointer).
+// It is compiled out, including the evaluation of its argument, if QC_WITH_LATENCY_HISTOGRAMS is not defined.
+#ifdef QC_WITH_LATENCY_HISTOGRAMS
+#define QC_LATENCY_CONCAT_IMPL(a, b) a##b
+#define QC_LATENCY_CONCAT(a, b) QC_LATENCY_CONCAT_IMPL(a, b)
+#define QC_LATENCY_SCOPE(histogram) o2::quality_control::core::LatencyTimer QC_LATENCY_CONCAT(qcLatencyTimer, __LINE__)(histogram)
+#else
+#define QC_LATENCY_SCOPE(histogram)
+#endif
+
+#endif // QC_CORE_LATENCYHISTOGRAM_H
@@ -17,12 +17,23 @@
 #ifndef QUALITYCONTROL_MONITOROBJECTCOLLECTION_H
 #define QUALITYCONTROL_MONITOROBJECTCOLLECTION_H
 
+#include "QualityControl/HistogramTransport.h"
 #include <TObjArray.h>
 #include <Mergers/MergeInterface.h>
+#include <string>
+#include <unordered_map>
 
 namespace o2::quality_control::core
 {
 
+/// \brief An array of MonitorObjects which can be merged.
+///
+/// The lookup by name is served by a transient hash index, which is built at the first lookup and kept up to date
+/// when objects are added. Removing or replacing objects, as well as reading the collection from a buffer, invalidates
+/// the index, so it is rebuilt at the next lookup. The streamed content is the one of TObjArray, optionally followed
+/// by the bins of the histograms copied as they are in memory (see setCopyHistogramBins()).
+/// Objects should not be renamed once added, otherwise they might not be found by their new name until the index is rebuilt.
+/// As the index is built lazily, concurrent lookups in the same collection are not safe.
 class MonitorObjectCollection : public TObjArray, public mergers::MergeInterface
 {
  public:
@@ -33,7 +44,40 @@ class MonitorObjectCollection : public TObjArray, public mergers::MergeInterface
 
   void postDeserialization() override;
 
-  ClassDefOverride(MonitorObjectCollection, 0);
+  using TObjArray::FindObject;
+  /// \brief Finds the first object with the given name in constant time.
+  /// The objects must not be renamed after they are added, a renamed object might not be found under its new name.
+  TObject* FindObject(const char* name) const override;
+
+  void AddFirst(TObject* obj) override;
+  void AddLast(TObject* obj) override;
+  void AddAt(TObject* obj, Int_t idx) override;
+  void AddAtAndExpand(TObject* obj, Int_t idx) override;
+  TObject* Remove(TObject* obj) override;
+  TObject* RemoveAt(Int_t idx) override;
+  void Clear(Option_t* option = "") override;
+  void Delete(Option_t* option = "") override;
+  void Changed() override;
+
+  /// \brief Makes the Streamer copy the bins of TH1F, TH1D, TH2F and TH2D instead of streaming them element by element.
+  /// It is meant for the objects sent to Mergers, which read the collection with ROOT. It is not kept when streamed.
+  void setCopyHistogramBins(bool copy, histogram_transport::Compression compression = {});
+  /// \brief Returns the number of bytes written by the last call of the Streamer.
+  histogram_transport::EncodedSize getLastStreamedSize() const;
+
+ private:
+  void buildIndex() const;
+  /// Indexes the object put at an empty slot, if the index was valid before.
+  template <typename Add>
+  void addIndexed(TObject* obj, Int_t idx, Add add);
+
+  mutable std::unordered_map<std::string, TObject*> mIndex; //! the first object with a given name
+  mutable bool mIndexValid = false;                         //!
+  bool mCopyHistogramBins = false;                          //!
+  histogram_transport::Compression mBinsCompression;        //!
+  histogram_transport::EncodedSize mLastStreamedSize;       //!
+
+  ClassDefOverride(MonitorObjectCollection, 1);
 };
 
 } // namespace o2::quality_control::core
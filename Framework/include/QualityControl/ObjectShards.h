@@ -0,0 +1,92 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   ObjectShards.h
+///
+
+#ifndef QC_CORE_OBJECTSHARDS_H
+#define QC_CORE_OBJECTSHARDS_H
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class TObject;
+
+namespace o2::quality_control::core
+{
+
+class ObjectsManager;
+
+/// \brief Empty copies of the published histograms, one set per thread, merged into the published ones.
+///
+/// Each thread filling the histograms concurrently works with its own shard, i.e. its own copies of the histograms,
+/// so that no locking is needed. The copies are merged into the published histograms with algorithm::merge() and
+/// emptied when merge() is called. The histograms (TH1 and THnBase) have copies, other objects cannot be filled
+/// concurrently.
+///
+/// Only get() is thread-safe, the other methods must not be called while a shard is in use.
+class ObjectShards
+{
+ public:
+  explicit ObjectShards(size_t shards);
+  ~ObjectShards();
+
+  ObjectShards(const ObjectShards&) = delete;
+  ObjectShards& operator=(const ObjectShards&) = delete;
+
+  /// \brief Creates the copies of the objects published since the last call and drops the ones of the unpublished objects.
+  void update(ObjectsManager& objectsManager);
+  /// \brief Merges the copies into the published objects and empties them.
+  void merge();
+  /// \brief Empties the copies without merging them.
+  void reset();
+
+  /// \brief Executes f with the given shard as the one of the calling thread.
+  template <typename F>
+  void runWith(size_t shard, F&& f)
+  {
+    ShardGuard guard(this, shard);
+    f();
+  }
+
+  /// \brief Returns the copy of the object in the shard of the calling thread.
+  /// Outside of runWith(), the object itself is returned.
+  /// \throw std::runtime_error if the object has no copy, e.g. because it is not published or not a histogram.
+  static TObject* get(TObject* object);
+
+  size_t size() const { return mShards; }
+  /// \brief Number of objects which have copies.
+  size_t getNumberObjects() const { return mObjects.size(); }
+
+ private:
+  struct Copies {
+    std::string name;
+    std::vector<std::unique_ptr<TObject>> shards;
+  };
+
+  class ShardGuard
+  {
+   public:
+    ShardGuard(const ObjectShards* owner, size_t shard);
+    ~ShardGuard();
+  };
+
+  size_t mShards;
+  std::unordered_map<TObject*, Copies> mObjects; // published object -> its copies
+};
+
+} // namespace o2::quality_control::core
+
+#endif // QC_CORE_OBJECTSHARDS_H
@@ -0,0 +1,103 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   ObjectWatcher.h
+///
+
+#ifndef QUALITYCONTROL_OBJECTWATCHER_H
+#define QUALITYCONTROL_OBJECTWATCHER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace o2::quality_control::postprocessing
+{
+
+/// \brief Watches the latest versions of objects in a database and tells the triggers when they change.
+///
+/// All the NewObject triggers of a process which use the same database share one watcher (see getInstance()).
+/// The headers of the watched objects are retrieved in a background thread, once per polling interval, and each
+/// object is checked only once even if many triggers watch it. The triggers only compare the version of their
+/// Watch with the last one they have seen, so they never wait for the database.
+class ObjectWatcher
+{
+ public:
+  /// \brief Returns the headers of the latest version of an object matching the metadata, empty if there is none.
+  using HeadersFetcher = std::function<std::map<std::string, std::string>(const std::string& path, const std::map<std::string, std::string>& metadata)>;
+
+  /// \brief An object watched by one or more triggers. It is not watched anymore when all of them release it.
+  class Watch
+  {
+   public:
+    struct State {
+      uint64_t version = 0;   // incremented each time the object changes, 0 as long as it was never found
+      uint64_t validFrom = 0; // of the latest version
+    };
+
+    Watch(std::string path, std::map<std::string, std::string> metadata);
+    State getState() const;
+    const std::string& getPath() const { return mPath; }
+    const std::map<std::string, std::string>& getMetadata() const { return mMetadata; }
+
+   private:
+    friend class ObjectWatcher;
+
+    const std::string mPath;
+    const std::map<std::string, std::string> mMetadata;
+    std::string mLastMD5; // accessed only while checking the objects
+    mutable std::mutex mStateMutex;
+    State mState;
+  };
+
+  /// \brief Starts watching in the background.
+  /// \param fetcher is called only by one thread at a time.
+  ObjectWatcher(HeadersFetcher fetcher, std::chrono::milliseconds interval);
+  ~ObjectWatcher();
+
+  /// \brief Returns the watcher of a CCDB instance, shared by all the triggers of the process.
+  /// If it already exists with a longer polling interval, the interval is shortened.
+  static std::shared_ptr<ObjectWatcher> getInstance(const std::string& databaseUrl, std::chrono::milliseconds interval);
+
+  /// \brief Starts watching an object, or returns the existing Watch if it is already watched.
+  /// A new object is checked right away, so that its current version is not seen as a change.
+  std::shared_ptr<Watch> watch(const std::string& path, const std::map<std::string, std::string>& metadata);
+  /// \brief Checks all the watched objects now, in the calling thread.
+  void refresh();
+  /// \brief Shortens the polling interval if the given one is shorter.
+  void requestInterval(std::chrono::milliseconds interval);
+  std::chrono::milliseconds getInterval() const;
+  size_t getNumberWatches();
+
+ private:
+  void run();
+  void check(Watch& watch);
+
+  HeadersFetcher mFetcher;
+  std::mutex mCheckMutex; // held while the objects are checked, the fetcher does not have to be thread-safe
+
+  mutable std::mutex mMutex;
+  std::condition_variable mWakeUp;
+  std::chrono::milliseconds mInterval;
+  bool mStopping = false;
+  std::map<std::string, std::weak_ptr<Watch>> mWatches; // by path and metadata
+  std::thread mThread;
+};
+
+} // namespace o2::quality_control::postprocessing
+
+#endif // QUALITYCONTROL_OBJECTWATCHER_H
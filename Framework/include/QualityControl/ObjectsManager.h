@@ -20,12 +20,18 @@
 // QC
 #include "QualityControl/MonitorObject.h"
 #include "QualityControl/MonitorObjectCollection.h"
+#include "QualityControl/FillBuffer.h"
 // stl
 #include <string>
 #include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 class TObject;
 class TObjArray;
+class TH1;
+class TH2;
 
 namespace o2::quality_control::core
 {
@@ -95,6 +101,78 @@ class ObjectsManager
 
   MonitorObjectCollection* getNonOwningArray() const;
 
+  /**
+   * \brief Returns the objects which have changed since they were last returned by this method.
+   * An object is considered as changed if the fingerprint of its content differs from the one it had when it was last
+   * returned, or if it was marked with setChanged(). The fingerprint covers the number of entries and the statistics
+   * of histograms (TH1 and THnBase). Objects of other types are always considered as changed.
+   * The collection is created by new and must be deleted by the caller. It does not own the objects.
+   */
+  MonitorObjectCollection* getNonOwningArrayOfChanged();
+
+  /**
+   * \brief Mark an object as changed.
+   * It will be returned by the next call to getNonOwningArrayOfChanged(), even if its fingerprint is the same.
+   * Use it when an object is modified in a way which is not reflected in its statistics.
+   * @param objectName Name of the object.
+   * @throw ObjectNotFoundError if object is not found.
+   */
+  void setChanged(const std::string& objectName);
+
+  /**
+   * \brief Forget the fingerprints of all the objects.
+   * The next call to getNonOwningArrayOfChanged() will return all the published objects.
+   */
+  void resetChangeTracking();
+
+  /**
+   * \brief Take the current content of the objects as the reference of the change tracking.
+   * To be called after the task reset its objects: the objects filled again afterwards are returned by the next call
+   * to getNonOwningArrayOfChanged(), even if they were filled exactly as before the reset, while the objects left
+   * empty are not. Without it, the new entries of an object refilled identically would be seen as unchanged.
+   */
+  void setChangeTrackingReference();
+
+  /**
+   * \brief Declare that the content of a published object is computed out of other published objects.
+   * Instead of recomputing the object each time the sources are filled, the framework computes it once before each
+   * publication. After merging, the object is computed again from the merged sources instead of being merged.
+   * The objects are computed in the order of their declaration, so a derived object can be a source of another one.
+   * @param objectName Name of the derived object.
+   * @param functionName Name of the function computing the object, e.g. "ratio" or "efficiency", see DerivedObjects.h.
+   * @param sourceNames Names of the published objects which are the arguments of the function.
+   * @throw ObjectNotFoundError if the object or any of the sources is not found.
+   */
+  void setDerived(const std::string& objectName, const std::string& functionName, const std::vector<std::string>& sourceNames);
+
+  /**
+   * \brief Compute all the derived objects.
+   * It is called by the framework before publishing the objects.
+   */
+  void computeDerivedObjects();
+
+  /**
+   * \brief Returns a buffer to fill a published histogram in bulk.
+   * The entries given to the buffer are filled into the histogram when the buffer is full and before each publication.
+   * The same buffer is returned for the same histogram, it is deleted when the histogram stops being published.
+   * Filling the histogram directly in the meantime is allowed, but the buffered entries are not visible until flushed.
+   * @param histogram A published 1D histogram.
+   * @return The buffer of the histogram.
+   * @throw ObjectNotFoundError if the histogram is not published.
+   */
+  FillBuffer1D& getFillBuffer(TH1* histogram);
+
+  /**
+   * See getFillBuffer(TH1* histogram).
+   */
+  FillBuffer2D& getFillBuffer(TH2* histogram);
+
+  /**
+   * \brief Fill the buffered entries of all the histograms.
+   * It is called by the framework before the task's endOfCycle() and at the stop of an activity.
+   */
+  void flushFillBuffers();
+
   /**
    * \brief Add metadata to a MonitorObject.
    * Add a metadata pair to a MonitorObject. This is propagated to the database.
@@ -185,6 +263,10 @@ class ObjectsManager
   std::unique_ptr<ServiceDiscovery> mServiceDiscovery;
   bool mUpdateServiceDiscovery;
   Activity mActivity;
+  std::unordered_map<std::string, size_t> mLastFingerprints; // fingerprints of objects when they were last returned as changed
+  std::unordered_set<std::string> mForcedChanges;
+  std::vector<std::string> mDerivedObjects;
+  std::unordered_map<std::string, std::unique_ptr<FillBufferBase>> mFillBuffers;
 };
 
 } // namespace o2::quality_control::core
@@ -44,6 +44,8 @@ struct PostProcessingConfig {
   std::string consulUrl;
   core::Activity activity;
   bool matchAnyRunNumber = false;
+  size_t retrievalConcurrency = 1; // the maximum number of objects retrieved at the same time by tasks which support it
+  double newObjectPollingSeconds = 10.0; // how often the objects watched by NewObject triggers are checked
 };
 
 } // namespace o2::quality_control::postprocessing
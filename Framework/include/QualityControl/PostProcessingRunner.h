@@ -20,6 +20,7 @@
 #include <memory>
 #include <functional>
 #include <Framework/ServiceRegistry.h>
+#include <Common/Timer.h>
 #include <boost/property_tree/ptree_fwd.hpp>
 #include "QualityControl/PostProcessingInterface.h"
 #include "QualityControl/PostProcessingConfig.h"
@@ -35,6 +36,11 @@ namespace o2::framework
 class DataAllocator;
 } // namespace o2::framework
 
+namespace o2::monitoring
+{
+class Monitoring;
+} // namespace o2::monitoring
+
 namespace o2::quality_control::core
 {
 struct CommonSpec;
@@ -89,6 +95,9 @@ class PostProcessingRunner
   void doInitialize(Trigger trigger);
   void doUpdate(Trigger trigger);
   void doFinalize(Trigger trigger);
+  void sendPeriodicMonitoring();
+  /// \brief Sends the statistics of the object cache accumulated since the previous call, if the cache is enabled.
+  void sendCacheStatistics();
 
   enum class TaskState {
     INVALID,
@@ -111,6 +120,8 @@ class PostProcessingRunner
   PostProcessingConfig mTaskConfig;
   PostProcessingRunnerConfig mRunnerConfig;
   std::shared_ptr<o2::quality_control::repository::DatabaseInterface> mDatabase;
+  std::shared_ptr<o2::monitoring::Monitoring> mCollector;
+  AliceO2::Common::Timer mTimer;
 };
 
 MOCPublicationCallback publishToDPL(o2::framework::DataAllocator&, std::string outputBinding);
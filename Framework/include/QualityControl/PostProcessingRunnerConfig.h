@@ -28,6 +28,7 @@ struct PostProcessingRunnerConfig {
   std::string taskName;
   std::unordered_map<std::string, std::string> database;
   std::string consulUrl{};
+  std::string monitoringUrl = "infologger:///debug?qc";
   bool infologgerFilterDiscardDebug = false;
   int infologgerDiscardLevel = 21;
   double periodSeconds = 10.0;
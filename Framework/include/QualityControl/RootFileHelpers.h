@@ -0,0 +1,63 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   RootFileHelpers.h
+///
+
+#ifndef QUALITYCONTROL_ROOTFILEHELPERS_H
+#define QUALITYCONTROL_ROOTFILEHELPERS_H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+class TDirectory;
+class TObject;
+
+namespace o2::quality_control::core
+{
+class MonitorObjectCollection;
+}
+
+/// Reading and writing MonitorObjectCollections in ROOT files.
+///
+/// A collection can be stored in two layouts:
+/// - as one key holding the whole MonitorObjectCollection,
+/// - as a directory named after the collection, with one key per MonitorObject (used by the streaming RootFileSink).
+/// The readers accept both of them.
+namespace o2::quality_control::core::root_file_helpers
+{
+
+/// \brief Returns the names of the collections stored in the directory, in any of the layouts.
+std::vector<std::string> listMonitorObjectCollections(TDirectory& parent);
+
+/// \brief Tells if the collection is stored as a directory with one key per MonitorObject.
+bool isStoredPerObject(TDirectory& parent, const std::string& name);
+
+/// \brief Reads the collection, returns nullptr if there is none with such name.
+///
+/// The returned collection owns its objects (postDeserialization() has already been called).
+/// Throws if the key exists, but it does not contain a MonitorObjectCollection.
+std::unique_ptr<MonitorObjectCollection> readMonitorObjectCollection(TDirectory& parent, const std::string& name);
+
+/// \brief Stores the collection as one key, replacing a collection with the same name stored in any of the layouts.
+int writeMonitorObjectCollection(TDirectory& parent, MonitorObjectCollection& collection);
+
+/// \brief Stores the MonitorObjects in the directory of the collection, replacing their previous versions.
+///
+/// The other objects in the directory are not rewritten. A collection with the same name stored as one key is removed,
+/// thus it should be read beforehand and all its objects should be provided at the first call.
+int writeMonitorObjects(TDirectory& parent, const std::string& collectionName, const std::vector<TObject*>& objects);
+
+} // namespace o2::quality_control::core::root_file_helpers
+
+#endif // QUALITYCONTROL_ROOTFILEHELPERS_H
@@ -21,18 +21,40 @@
 #include <Framework/CompletionPolicy.h>
 #include <Framework/DataProcessorLabel.h>
 
+#include <chrono>
+#include <future>
+#include <map>
+#include <memory>
+#include <set>
+
+class TFile;
+
 namespace o2::quality_control::core
 {
 
+class MonitorObjectCollection;
+class ThreadPool;
+
 /// \brief A Data Processor which stores MonitorObjectCollections in a specified file
+///
+/// By default, the file is opened for each message, the stored collection is read, merged with the received one and
+/// written back as a whole. In the streaming mode, the file is kept open from the first message until the end of stream,
+/// thus it is reopened for each run, and the merged collections stay in memory. Only the objects modified since the last flush are written, each under its own key in
+/// the directory of its collection. The flushes are performed in a separate thread, periodically and at the end of stream.
 class RootFileSink : public framework::Task
 {
  public:
-  explicit RootFileSink(std::string filePath);
+  struct Config {
+    bool streaming = false;
+    double flushPeriodSeconds = 0; // 0 means flushing only at the end of stream
+  };
+
+  explicit RootFileSink(std::string filePath, Config config = {});
   ~RootFileSink() override;
 
   void init(framework::InitContext& ictx) override;
   void run(framework::ProcessingContext& pctx) override;
+  void endOfStream(framework::EndOfStreamContext& eosContext) override;
 
   static framework::DataProcessorLabel getLabel()
   {
@@ -43,9 +65,27 @@ class RootFileSink : public framework::Task
 
  private:
   void reset();
+  void runStreaming(framework::ProcessingContext& pctx);
+  /// Opens the file and reads the collections it already contains.
+  void openFile();
+  void markAllAsModified(const std::string& collectionName, const MonitorObjectCollection& collection);
+  /// Writes the modified objects in the background, unless the previous flush is still ongoing.
+  void flush();
+  /// Waits for the ongoing flush. If it failed, the error is logged and all the objects are written at the next flush.
+  void waitForFlush();
+  void closeFile();
 
  private:
   std::string mFilePath;
+  Config mConfig;
+
+  // used only in the streaming mode
+  TFile* mFile = nullptr;
+  std::map<std::string, std::unique_ptr<MonitorObjectCollection>> mCollections;
+  std::map<std::string, std::set<std::string>> mModifiedObjects; // collection name -> object names
+  std::unique_ptr<ThreadPool> mWriter;
+  std::future<void> mPendingFlush;
+  std::chrono::steady_clock::time_point mLastFlush;
 };
 
 } // namespace o2::quality_control::core
@@ -25,11 +25,14 @@
 // O2
 #include <Framework/InitContext.h>
 #include <Framework/ProcessingContext.h>
+#include <Framework/DataRef.h>
 #include <CCDB/CcdbApi.h>
 #include <Monitoring/Monitoring.h>
 // QC
 #include "QualityControl/Activity.h"
+#include "QualityControl/ConditionsService.h"
 #include "QualityControl/ObjectsManager.h"
+#include "QualityControl/ObjectShards.h"
 #include "QualityControl/QcInfoLogger.h"
 
 namespace o2::ccdb
@@ -85,6 +88,14 @@ class TaskInterface
   virtual void endOfActivity(Activity& activity) = 0;
   virtual void reset() = 0;
 
+  /// \brief Processes one part of the inputs, concurrently with the other parts.
+  /// It is called instead of monitorData() for each part of the inputs when the task is configured with
+  /// "monitorDataThreads" larger than 1 and supportsMonitorDataPart() returns true.
+  /// The published histograms must be filled through getShard(), other members must be protected by the task.
+  virtual void monitorDataPart(const o2::framework::DataRef& part);
+  /// \brief Tells if the task implements monitorDataPart().
+  virtual bool supportsMonitorDataPart() const { return false; }
+
   // Setters and getters
   void setObjectsManager(std::shared_ptr<ObjectsManager> objectsManager);
   void setName(const std::string& name);
@@ -102,10 +113,26 @@ class TaskInterface
 
  protected:
   std::shared_ptr<ObjectsManager> getObjectsManager();
+  /// \brief Returns the copy of a published histogram to be filled by the calling thread in monitorDataPart().
+  /// Outside of monitorDataPart(), the histogram itself is returned.
+  template <typename T>
+  static T* getShard(T* histogram)
+  {
+    return static_cast<T*>(ObjectShards::get(histogram));
+  }
   TObject* retrieveCondition(std::string path, std::map<std::string, std::string> metadata = {}, long timestamp = -1);
   template <typename T>
   T* retrieveConditionAny(std::string const& path, std::map<std::string, std::string> const& metadata = {},
                           long timestamp = -1) const;
+  /// \brief Starts retrieving the latest version of a condition in the background. To be called in initialize().
+  template <typename T>
+  void prefetchCondition(std::string const& path, std::map<std::string, std::string> const& metadata = {});
+  /// \brief Returns the latest version of a condition, nullptr if it could not be retrieved.
+  /// The object is shared by all the tasks of the process and refreshed in the background when its validity ends.
+  /// If the condition was never retrieved yet, this call blocks until its first retrieval ends, at most for the timeout.
+  template <typename T>
+  std::shared_ptr<const T> getCondition(std::string const& path, std::map<std::string, std::string> const& metadata = {},
+                                        std::chrono::milliseconds timeout = ConditionsService::defaultTimeout);
 
   std::unordered_map<std::string, std::string> mCustomParameters;
   std::shared_ptr<o2::monitoring::Monitoring> mMonitoring;
@@ -113,7 +140,10 @@ class TaskInterface
  private:
   std::string mName;
   std::shared_ptr<ObjectsManager> mObjectsManager;
+  ConditionsService& getConditionsService();
+
   std::shared_ptr<o2::ccdb::CcdbApi> mCcdbApi;
+  std::shared_ptr<ConditionsService> mConditionsService;
   std::string mCcdbUrl; // we need to keep the url in addition to the ccdbapi because we don't initialize the latter before the first call
 };
 
@@ -129,6 +159,19 @@ T* TaskInterface::retrieveConditionAny(std::string const& path, std::map<std::st
   }
 }
 
+template <typename T>
+void TaskInterface::prefetchCondition(std::string const& path, std::map<std::string, std::string> const& metadata)
+{
+  getConditionsService().prefetch<T>(path, metadata);
+}
+
+template <typename T>
+std::shared_ptr<const T> TaskInterface::getCondition(std::string const& path, std::map<std::string, std::string> const& metadata,
+                                                     std::chrono::milliseconds timeout)
+{
+  return getConditionsService().get<T>(path, metadata, timeout);
+}
+
 } // namespace o2::quality_control::core
 
 #endif // QC_CORE_TASKINTERFACE_H
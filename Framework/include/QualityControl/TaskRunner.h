@@ -30,6 +30,8 @@
 // QC
 #include "QualityControl/TaskRunnerConfig.h"
 #include "QualityControl/TaskInterface.h"
+#include "QualityControl/ObjectShards.h"
+#include "QualityControl/ThreadPool.h"
 
 namespace o2::configuration
 {
@@ -117,6 +119,7 @@ class TaskRunner : public framework::Task
   void printTaskConfig();
   void startOfActivity();
   void endOfActivity();
+  void monitorDataInParallel(framework::ProcessingContext& pCtx);
   void startCycle();
   void finishCycle(framework::DataAllocator& outputs);
   int publish(framework::DataAllocator& outputs);
@@ -129,6 +132,8 @@ class TaskRunner : public framework::Task
   std::shared_ptr<TaskInterface> mTask;
   std::shared_ptr<ObjectsManager> mObjectsManager;
   int mRunNumber;
+  std::unique_ptr<ThreadPool> mMonitorDataPool;
+  std::unique_ptr<ObjectShards> mShards; // copies of the histograms filled by each thread of mMonitorDataPool
 
   void updateMonitoringStats(framework::ProcessingContext& pCtx);
 
@@ -141,6 +146,9 @@ class TaskRunner : public framework::Task
   int mNumberObjectsPublishedInCycle = 0;
   int mTotalNumberObjectsPublished = 0; // over a run
   double mLastPublicationDuration = 0;
+  double mLastEncodingDuration = 0;
+  uint64_t mLastPublishedBytes = 0;             // the serialized collection, without the header of the message
+  uint64_t mLastPublishedUncompressedBytes = 0; // the same without compression
   uint64_t mDataReceivedInCycle = 0;
   AliceO2::Common::Timer mTimerTotalDurationActivity;
   AliceO2::Common::Timer mTimerDurationCycle;
@@ -23,6 +23,8 @@
 
 #include <Framework/DataProcessorSpec.h>
 
+#include "QualityControl/HistogramTransport.h"
+
 namespace o2::quality_control::core
 {
 
@@ -52,6 +54,14 @@ struct TaskRunnerConfig {
   std::string activityPassName = "";
   std::string activityProvenance = "qc";
   int fallbackRunNumber = 0;
+  bool deltaPublication = false;          // publish only the objects which changed during the cycle
+  int deltaPublicationKeyframeCycles = 10; // with deltaPublication, publish all the objects every n cycles
+  int monitorDataThreads = 1;              // with more than 1, the parts of the inputs are given concurrently to monitorDataPart()
+  bool copyHistogramBins = false;          // copy the bins of the histograms in the messages instead of streaming them
+  // with copyHistogramBins, compression of the messages
+  histogram_transport::Compression publicationCompression{};
+  // the objects go to Mergers, which read them with ROOT, thus the bins are copied by the Streamer of MonitorObjectCollection
+  bool publishToMergers = false;
 };
 
 } // namespace o2::quality_control::core
@@ -59,6 +59,12 @@ struct TaskSpec {
   int maxNumberCycles = -1;
   size_t resetAfterCycles = 0;
   std::string saveObjectsToFile;
+  bool deltaPublication = false;
+  int deltaPublicationKeyframeCycles = 10;
+  int monitorDataThreads = 1;
+  bool copyHistogramBins = false;
+  std::string publicationCompression = "none";
+  int publicationCompressionLevel = 1;
   std::unordered_map<std::string, std::string> customParameters = {};
   // multinode setups
   TaskLocationSpec location = TaskLocationSpec::Remote;
@@ -0,0 +1,69 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   ThreadPool.h
+///
+
+#ifndef QC_CORE_THREADPOOL_H
+#define QC_CORE_THREADPOOL_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace o2::quality_control::core
+{
+
+/// \brief A fixed set of threads executing the submitted tasks in the order of submission.
+///
+/// The idle threads take the next task from a shared queue, so that long tasks do not hold back the others.
+/// Exceptions thrown by a task are rethrown when calling get() on the future returned by submit().
+class ThreadPool
+{
+ public:
+  explicit ThreadPool(size_t threads);
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  template <typename F>
+  std::future<std::invoke_result_t<F>> submit(F&& task)
+  {
+    auto packagedTask = std::make_shared<std::packaged_task<std::invoke_result_t<F>()>>(std::forward<F>(task));
+    auto future = packagedTask->get_future();
+    enqueue([packagedTask]() { (*packagedTask)(); });
+    return future;
+  }
+
+  size_t size() const { return mThreads.size(); }
+
+ private:
+  void enqueue(std::function<void()> task);
+  void run();
+
+  std::vector<std::thread> mThreads;
+  std::deque<std::function<void()>> mTasks;
+  std::mutex mMutex;
+  std::condition_variable mTaskAvailable;
+  bool mStopping = false;
+};
+
+} // namespace o2::quality_control::core
+
+#endif // QC_CORE_THREADPOOL_H
@@ -19,12 +19,18 @@
 
 #include "QualityControl/PostProcessingInterface.h"
 #include "QualityControl/TrendingTaskConfig.h"
+#include "QualityControl/ConcurrentRetriever.h"
 #include "QualityControl/Reductor.h"
 
 #include <memory>
 #include <unordered_map>
+#include <unordered_set>
 #include <TTree.h>
 
+class TTreeFormula;
+class TGraph;
+class TH1;
+
 namespace o2::quality_control::repository
 {
 class DatabaseInterface;
@@ -57,8 +63,28 @@ class TrendingTask : public PostProcessingInterface
     Int_t runNumber = 0;
   };
 
+  /// A plot which is updated with the new entries of the trend, instead of drawing the whole TTree again.
+  struct IncrementalPlot {
+    IncrementalPlot();
+    ~IncrementalPlot();
+    IncrementalPlot(IncrementalPlot&&) noexcept;
+
+    std::vector<std::unique_ptr<TTreeFormula>> variables; // in the order of varexp and then graphErrors
+    std::unique_ptr<TTreeFormula> selection;
+    std::unique_ptr<TH1> histogram; // for 1-dimensional plots
+    std::unique_ptr<TGraph> graph;  // for 2-dimensional plots
+    double xMin, xMax, yMin, yMax;
+  };
+
   void trendValues(const Trigger& t, repository::DatabaseInterface&);
   void generatePlots();
+  void generatePlot(const TrendingTaskConfig::Plot& plot);
+  /// Adds the last entry of the trend to the plots, creating them if needed.
+  void appendToPlots();
+  bool createIncrementalPlot(const TrendingTaskConfig::Plot& plot);
+  void appendToPlot(IncrementalPlot& incrementalPlot, Long64_t entry);
+  void deletePlot(const std::string& name);
+  void deleteIncrementalPlots();
 
   TrendingTaskConfig mConfig;
   MetaData mMetaData;
@@ -66,6 +92,9 @@ class TrendingTask : public PostProcessingInterface
   std::unique_ptr<TTree> mTrend;
   std::map<std::string, TObject*> mPlots;
   std::unordered_map<std::string, std::unique_ptr<Reductor>> mReductors;
+  std::unique_ptr<ConcurrentRetriever> mRetriever;
+  std::map<std::string, IncrementalPlot> mIncrementalPlots;
+  std::unordered_set<std::string> mNonIncrementalPlots; // plots which cannot be appended to, they are always redrawn
 };
 
 } // namespace o2::quality_control::postprocessing
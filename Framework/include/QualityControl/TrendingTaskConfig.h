@@ -49,6 +49,7 @@ struct TrendingTaskConfig : PostProcessingConfig {
   };
 
   bool producePlotsOnUpdate;
+  bool incrementalPlots = false;
   std::vector<Plot> plots;
   std::vector<DataSource> dataSources;
 };
@@ -18,9 +18,8 @@
 #define QC_CHECKER_POLICYMANAGER_H
 
 #include <string>
-#include <map>
+#include <unordered_map>
 #include <vector>
-#include <functional>
 #include <iosfwd>
 
 #include "QualityControl/UpdatePolicyType.h"
@@ -28,7 +27,6 @@
 namespace o2::quality_control::checker
 {
 
-using UpdatePolicyFunctionType = std::function<bool()>;
 typedef uint32_t RevisionType;
 
 /**
@@ -36,13 +34,17 @@ typedef uint32_t RevisionType;
  */
 struct UpdatePolicy {
   std::string actorName;
-  UpdatePolicyFunctionType isReady;
+  UpdatePolicyType policyType;
   std::vector<std::string> inputObjects;
   bool allInputObjects;
-  // TODO this line makes me think that lambdas are not enough because we actually need to store a state...
   bool policyHelperFlag; // the purpose might change depending on policy,
   RevisionType revision = 0;
 
+  // State kept up to date by the UpdatePolicyManager, so that the readiness can be evaluated in constant time.
+  std::vector<size_t> inputObjectIds;  // interned and deduplicated inputObjects
+  size_t receivedInputs = 0;           // number of inputs which have been received at least once
+  size_t updatedInputs = 0;            // number of inputs with a revision newer than the actor's revision
+
   friend std::ostream& operator<<(std::ostream& out, const UpdatePolicy& updatePolicy); // output
 };
 
@@ -85,6 +87,9 @@ struct UpdatePolicy {
  *  // end run() loop
  * \endcode
  *
+ * Object names are interned when first seen and each object keeps the list of actors which depend on it. The
+ * per-actor counters of received and updated inputs are maintained when revisions change, so isReady() does not
+ * depend on the number of inputs and getReadyActors() only looks at actors whose inputs have changed.
  */
 class UpdatePolicyManager
 {
@@ -113,6 +118,16 @@ class UpdatePolicyManager
    */
   void updateObjectRevision(std::string objectName, RevisionType revision);
   void updateObjectRevision(std::string objectName);
+  /**
+   * \brief Update the revision number of an object identified by the id returned by getObjectId().
+   *
+   * This avoids looking up the object by its name each time it is received.
+   */
+  void updateObjectRevision(size_t objectId);
+  /**
+   * Returns the id of the object, registering it if it is not known yet. The ids remain valid until reset().
+   */
+  size_t getObjectId(const std::string& objectName);
   /**
    * Add a policy for the given actor.
    * @param actorName
@@ -135,10 +150,36 @@ class UpdatePolicyManager
    */
   bool isReady(const std::string& actorName);
 
+  /**
+   * Returns the names of the actors which are ready, in the order in which their policies were added.
+   *
+   * Only the actors which had any of their inputs updated (or which are always ready) are evaluated, the caller
+   * does not need to call isReady() for all of them.
+   */
+  std::vector<std::string> getReadyActors();
+
  private:
-  std::map<std::string /* Actor name */, UpdatePolicy> mPoliciesByActor;
+  struct ObjectState {
+    RevisionType revision = 0;
+    bool received = false;
+    std::vector<size_t> dependentActors;
+  };
+
+  size_t internObject(const std::string& objectName);
+  void setObjectRevision(size_t objectId, RevisionType revision);
+  void setActorRevision(size_t actorId, RevisionType revision);
+  bool isReady(const UpdatePolicy& policy) const;
+  void markCandidate(size_t actorId);
+
+  std::vector<UpdatePolicy> mPolicies; // indexed by actor id, in the order of addition
+  std::unordered_map<std::string /* Actor name */, size_t> mActorIds;
+  std::vector<ObjectState> mObjects; // indexed by object id
+  std::unordered_map<std::string /* Object name */, size_t> mObjectIds;
   RevisionType mGlobalRevision = 1;
-  std::map<std::string /* Object name */, RevisionType> mObjectsRevision;
+  RevisionType mMaxObjectRevision = 0;
+  // actors which might have become ready since the last call to getReadyActors()
+  std::vector<size_t> mCandidates;
+  std::vector<bool> mIsCandidate;
 };
 
 } // namespace o2::quality_control::checker
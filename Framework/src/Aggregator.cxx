@@ -62,6 +62,13 @@ void Aggregator::init()
   }
 }
 
+void Aggregator::setLatencyHistograms(core::LatencyHistograms& histograms)
+{
+#ifdef QC_WITH_LATENCY_HISTOGRAMS
+  mAggregateLatency = &histograms.get("aggregate_" + mAggregatorConfig.name);
+#endif
+}
+
 QualityObjectsMapType Aggregator::filter(QualityObjectsMapType& qoMap)
 {
   // This is a basic implementation, if it needs to be more efficient it will have to be rethought.
@@ -99,7 +106,11 @@ QualityObjectsMapType Aggregator::filter(QualityObjectsMapType& qoMap)
 QualityObjectsType Aggregator::aggregate(QualityObjectsMapType& qoMap)
 {
   auto filtered = filter(qoMap);
-  auto results = mAggregatorInterface->aggregate(filtered);
+  std::map<std::string, Quality> results;
+  {
+    QC_LATENCY_SCOPE(mAggregateLatency);
+    results = mAggregatorInterface->aggregate(filtered);
+  }
   QualityObjectsType qualityObjects;
   for (auto const& [qualityName, quality] : results) {
     qualityObjects.emplace_back(std::make_shared<QualityObject>(
@@ -31,6 +31,7 @@
 
 // QC
 #include "QualityControl/DatabaseFactory.h"
+#include "QualityControl/AsyncDatabase.h"
 #include "QualityControl/QcInfoLogger.h"
 #include "QualityControl/ServiceDiscovery.h"
 #include "QualityControl/Aggregator.h"
@@ -179,7 +180,11 @@ void AggregatorRunner::run(framework::ProcessingContext& ctx)
   framework::InputRecord& inputs = ctx.inputs();
   for (auto const& ref : InputRecordWalker(inputs)) { // InputRecordWalker because the output of CheckRunner can be multi-part
     ILOG(Debug, Trace) << "AggregatorRunner received data" << ENDM;
-    shared_ptr<const QualityObject> qo = inputs.get<QualityObject*>(ref);
+    shared_ptr<const QualityObject> qo;
+    {
+      QC_LATENCY_SCOPE(mDeserializationLatency);
+      qo = inputs.get<QualityObject*>(ref);
+    }
     if (qo != nullptr) {
       ILOG(Debug, Trace) << "   It is a qo: " << qo->getName() << ENDM;
       mQualityObjects[qo->getName()] = qo;
@@ -242,8 +247,10 @@ void AggregatorRunner::store(QualityObjectsType& qualityObjects)
 
 void AggregatorRunner::initDatabase()
 {
-  mDatabase = DatabaseFactory::create(mRunnerConfig.database.at("implementation"));
-  mDatabase->connect(mRunnerConfig.database);
+  mDatabase = DatabaseFactory::createAndConnect(mRunnerConfig.database);
+#ifdef QC_WITH_LATENCY_HISTOGRAMS
+  mDatabase->setLatencyHistograms(*mLatencyHistograms);
+#endif
   ILOG(Info, Devel) << "Database that is going to be used : ";
   ILOG(Info, Support) << ">> Implementation : " << mRunnerConfig.database.at("implementation") << ENDM;
   ILOG(Info, Support) << ">> Host : " << mRunnerConfig.database.at("host") << ENDM;
@@ -280,6 +287,9 @@ void AggregatorRunner::initAggregators()
     try {
       auto aggregator = make_shared<Aggregator>(aggregatorConfig);
       aggregator->init();
+#ifdef QC_WITH_LATENCY_HISTOGRAMS
+      aggregator->setLatencyHistograms(*mLatencyHistograms);
+#endif
       updatePolicyManager.addPolicy(aggregator->getName(),
                                     aggregator->getUpdatePolicyType(),
                                     aggregator->getObjectsNames(),
@@ -393,6 +403,19 @@ void AggregatorRunner::sendPeriodicMonitoring()
     mCollector->send({ mTotalNumberAggregatorExecuted, "qc_aggregator_executed" });
     mCollector->send({ mTotalNumberObjectsProduced, "qc_aggregator_objects_produced" });
     mCollector->send({ mTimerTotalDurationActivity.getTime(), "qc_aggregator_duration" });
+#ifdef QC_WITH_LATENCY_HISTOGRAMS
+    mLatencyHistograms->send(*mCollector);
+#endif
+    if (auto asyncDatabase = dynamic_cast<AsyncDatabase*>(mDatabase.get())) {
+      auto statistics = asyncDatabase->getAndResetStatistics();
+      mCollector->send(Metric{ "qc_aggregator_storage_queue" }
+                         .addValue(static_cast<uint64_t>(statistics.queueDepth), "depth")
+                         .addValue(static_cast<uint64_t>(statistics.coalesced), "coalesced")
+                         .addValue(static_cast<uint64_t>(statistics.dropped), "dropped")
+                         .addValue(static_cast<uint64_t>(statistics.failed), "failed")
+                         .addValue(statistics.meanQueueLatencyMs, "latency_mean_ms")
+                         .addValue(statistics.maxQueueLatencyMs, "latency_max_ms"));
+    }
   }
 }
 
@@ -414,6 +437,9 @@ void AggregatorRunner::start(const ServiceRegistry& services)
 void AggregatorRunner::stop()
 {
   ILOG(Info, Ops) << "Stopping run " << mActivity.mId << ENDM;
+  if (auto asyncDatabase = dynamic_cast<AsyncDatabase*>(mDatabase.get())) {
+    asyncDatabase->flush();
+  }
 }
 
 void AggregatorRunner::reset()
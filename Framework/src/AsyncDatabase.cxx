@@ -0,0 +1,398 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   AsyncDatabase.cxx
+///
+
+#include "QualityControl/AsyncDatabase.h"
+#include "QualityControl/QcInfoLogger.h"
+
+#include <DataFormatsQualityControl/TimeRangeFlagCollection.h>
+#include <Common/Exceptions.h>
+#include <TROOT.h>
+#include <boost/exception/diagnostic_information.hpp>
+
+using namespace std::chrono;
+using namespace AliceO2::Common;
+using namespace o2::quality_control::core;
+
+namespace o2::quality_control::repository
+{
+
+AsyncDatabase::AsyncDatabase(BackendFactory backendFactory, Config config)
+  : mBackendFactory(std::move(backendFactory)),
+    mConfig(config),
+    mBackend(mBackendFactory())
+{
+  if (mConfig.uploaderThreads == 0) {
+    BOOST_THROW_EXCEPTION(FatalException() << errinfo_details("AsyncDatabase needs at least one uploader thread"));
+  }
+  if (mConfig.queueDepth == 0) {
+    BOOST_THROW_EXCEPTION(FatalException() << errinfo_details("AsyncDatabase needs a queue depth larger than 0"));
+  }
+}
+
+AsyncDatabase::~AsyncDatabase()
+{
+  stopUploaders();
+}
+
+bool AsyncDatabase::isEnabled(const std::unordered_map<std::string, std::string>& databaseConfig)
+{
+  auto it = databaseConfig.find("asyncStorage");
+  return it != databaseConfig.end() && (it->second == "true" || it->second == "1");
+}
+
+AsyncDatabase::Config AsyncDatabase::extractConfig(const std::unordered_map<std::string, std::string>& databaseConfig)
+{
+  Config config;
+  if (databaseConfig.count("asyncStorageThreads")) {
+    config.uploaderThreads = std::stoul(databaseConfig.at("asyncStorageThreads"));
+  }
+  if (databaseConfig.count("asyncStorageQueueDepth")) {
+    config.queueDepth = std::stoul(databaseConfig.at("asyncStorageQueueDepth"));
+  }
+  if (databaseConfig.count("asyncStorageDropPolicy")) {
+    const auto& policy = databaseConfig.at("asyncStorageDropPolicy");
+    if (policy == "block") {
+      config.dropPolicy = DropPolicy::Block;
+    } else if (policy == "dropOldest") {
+      config.dropPolicy = DropPolicy::DropOldest;
+    } else if (policy == "dropNewest") {
+      config.dropPolicy = DropPolicy::DropNewest;
+    } else {
+      BOOST_THROW_EXCEPTION(FatalException() << errinfo_details("Unknown asyncStorageDropPolicy '" + policy + "', expected block, dropOldest or dropNewest"));
+    }
+  }
+  if (databaseConfig.count("asyncStorageCoalescing")) {
+    const auto& coalescing = databaseConfig.at("asyncStorageCoalescing");
+    config.coalescing = coalescing == "true" || coalescing == "1";
+  }
+  return config;
+}
+
+void AsyncDatabase::connect(std::string host, std::string database, std::string username, std::string password)
+{
+  mBackend->connect(host, database, username, password);
+  startUploaders([=](DatabaseInterface& backend) { backend.connect(host, database, username, password); });
+}
+
+void AsyncDatabase::connect(const std::unordered_map<std::string, std::string>& config)
+{
+  mBackend->connect(config);
+  startUploaders([&config](DatabaseInterface& backend) { backend.connect(config); });
+}
+
+void AsyncDatabase::startUploaders(const std::function<void(DatabaseInterface&)>& connector)
+{
+  stopUploaders();
+
+  // the uploaders stream ROOT objects concurrently
+  ROOT::EnableThreadSafety();
+
+  std::vector<std::unique_ptr<DatabaseInterface>> backends;
+  for (size_t i = 0; i < mConfig.uploaderThreads; i++) {
+    connector(*backends.emplace_back(mBackendFactory()));
+  }
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mStopping = false;
+    mUploaderBackends = std::move(backends);
+    for (auto& backend : mUploaderBackends) {
+      mUploaders.emplace_back([this, &backend = *backend]() { runUploader(backend); });
+    }
+  }
+  ILOG(Info, Support) << "Asynchronous storage enabled with " << mConfig.uploaderThreads << " uploader thread(s) and a queue depth of "
+                      << mConfig.queueDepth << ENDM;
+}
+
+void AsyncDatabase::stopUploaders()
+{
+  std::vector<std::thread> uploaders;
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mStopping = true;
+    uploaders.swap(mUploaders);
+  }
+  mQueueNotEmpty.notify_all();
+  mQueueNotFull.notify_all();
+  for (auto& uploader : uploaders) {
+    if (uploader.joinable()) {
+      uploader.join();
+    }
+  }
+  mUploaderBackends.clear();
+}
+
+void AsyncDatabase::storeMO(std::shared_ptr<const MonitorObject> mo, long from, long to)
+{
+  // the caller may keep modifying the object (e.g. when beautifying it), so we queue a copy
+  std::shared_ptr<MonitorObject> copy(dynamic_cast<MonitorObject*>(mo->Clone()));
+  copy->setIsOwner(true);
+  enqueue({ mo->getPath(), copy, nullptr, from, to, steady_clock::now() });
+}
+
+void AsyncDatabase::storeQO(std::shared_ptr<const QualityObject> qo, long from, long to)
+{
+  enqueue({ qo->getPath(), nullptr, std::make_shared<QualityObject>(*qo), from, to, steady_clock::now() });
+}
+
+void AsyncDatabase::enqueue(Entry&& entry)
+{
+  // The start of validity has to correspond to the moment of the storage request, not of the actual upload.
+  if (entry.from == -1) {
+    entry.from = duration_cast<milliseconds>(system_clock::now().time_since_epoch()).count();
+  }
+
+  std::unique_lock<std::mutex> lock(mMutex);
+  if (mUploaders.empty() && !mStopping) {
+    BOOST_THROW_EXCEPTION(DatabaseException() << errinfo_details("AsyncDatabase is not connected, cannot store " + entry.path));
+  }
+  mStatistics.queued++;
+
+  // the conditions are checked again after waiting for some space in the queue, since other producers or stop() may
+  // have changed the queue in the meantime
+  while (true) {
+    if (mStopping) {
+      // the uploaders may have already left, thus nobody would store the entry
+      lock.unlock();
+      storeNow(entry);
+      return;
+    }
+
+    if (mConfig.coalescing) {
+      if (auto queued = mQueueIndex.find(entry.path); queued != mQueueIndex.end()) {
+        // we keep the position and the waiting time of the older version, only the content is replaced
+        auto queuedAt = queued->second->queuedAt;
+        *queued->second = std::move(entry);
+        queued->second->queuedAt = queuedAt;
+        mStatistics.coalesced++;
+        return;
+      }
+    }
+
+    if (mQueue.size() < mConfig.queueDepth) {
+      break;
+    }
+    switch (mConfig.dropPolicy) {
+      case DropPolicy::Block:
+        mQueueNotFull.wait(lock, [this]() { return mQueue.size() < mConfig.queueDepth || mStopping; });
+        continue;
+      case DropPolicy::DropOldest: {
+        auto& oldest = mQueue.front();
+        ILOG(Warning, Support) << "Storage queue is full, dropping the oldest object " << oldest.path << ENDM;
+        mQueueIndex.erase(oldest.path);
+        mQueue.pop_front();
+        mStatistics.dropped++;
+        continue;
+      }
+      case DropPolicy::DropNewest:
+        ILOG(Warning, Support) << "Storage queue is full, dropping the new object " << entry.path << ENDM;
+        mStatistics.dropped++;
+        return;
+    }
+  }
+
+  auto inserted = mQueue.insert(mQueue.end(), std::move(entry));
+  if (mConfig.coalescing) {
+    mQueueIndex[inserted->path] = inserted;
+  }
+  lock.unlock();
+  mQueueNotEmpty.notify_one();
+}
+
+void AsyncDatabase::storeNow(const Entry& entry)
+{
+  bool success = true;
+  try {
+    std::lock_guard<std::mutex> backendLock(mBackendMutex);
+    if (entry.mo) {
+      mBackend->storeMO(entry.mo, entry.from, entry.to);
+    } else {
+      mBackend->storeQO(entry.qo, entry.from, entry.to);
+    }
+  } catch (...) {
+    success = false;
+    ILOG(Error, Support) << "Unable to store the object " << entry.path << ":\n"
+                         << boost::current_exception_diagnostic_information(true) << ENDM;
+  }
+  std::lock_guard<std::mutex> lock(mMutex);
+  if (success) {
+    mStatistics.stored++;
+  } else {
+    mStatistics.failed++;
+  }
+}
+
+void AsyncDatabase::runUploader(DatabaseInterface& backend)
+{
+  while (true) {
+    std::unique_lock<std::mutex> lock(mMutex);
+    mQueueNotEmpty.wait(lock, [this]() { return !mQueue.empty() || mStopping; });
+    if (mQueue.empty()) {
+      // stopping and nothing left to store
+      return;
+    }
+    Entry entry = std::move(mQueue.front());
+    mQueueIndex.erase(entry.path);
+    mQueue.pop_front();
+    mInFlight++;
+    double latencyMs = duration_cast<duration<double, std::milli>>(steady_clock::now() - entry.queuedAt).count();
+    mTotalQueueLatencyMs += latencyMs;
+    mStatistics.maxQueueLatencyMs = std::max(mStatistics.maxQueueLatencyMs, latencyMs);
+    lock.unlock();
+    mQueueNotFull.notify_one();
+
+    bool success = true;
+    try {
+      if (entry.mo) {
+        backend.storeMO(entry.mo, entry.from, entry.to);
+      } else {
+        backend.storeQO(entry.qo, entry.from, entry.to);
+      }
+    } catch (...) {
+      success = false;
+      ILOG(Error, Support) << "Unable to store the object " << entry.path << ":\n"
+                           << boost::current_exception_diagnostic_information(true) << ENDM;
+    }
+    entry = {}; // we release the object outside of the lock
+
+    lock.lock();
+    mInFlight--;
+    if (success) {
+      mStatistics.stored++;
+    } else {
+      mStatistics.failed++;
+    }
+    if (mQueue.empty() && mInFlight == 0) {
+      mQueueDrained.notify_all();
+    }
+  }
+}
+
+void AsyncDatabase::flush()
+{
+  std::unique_lock<std::mutex> lock(mMutex);
+  if (mUploaders.empty()) {
+    return;
+  }
+  mQueueDrained.wait(lock, [this]() { return mQueue.empty() && mInFlight == 0; });
+}
+
+void AsyncDatabase::setCoalescing(bool coalescing)
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  mConfig.coalescing = coalescing;
+  if (!coalescing) {
+    mQueueIndex.clear();
+  }
+}
+
+AsyncDatabase::Statistics AsyncDatabase::getAndResetStatistics()
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  Statistics statistics = mStatistics;
+  statistics.queueDepth = mQueue.size();
+  size_t dequeued = mStatistics.stored + mStatistics.failed + mInFlight;
+  statistics.meanQueueLatencyMs = dequeued > 0 ? mTotalQueueLatencyMs / dequeued : 0;
+  mStatistics = {};
+  mTotalQueueLatencyMs = 0;
+  return statistics;
+}
+
+void AsyncDatabase::disconnect()
+{
+  stopUploaders();
+  mBackend->disconnect();
+}
+
+void AsyncDatabase::storeTRFC(std::shared_ptr<const o2::quality_control::TimeRangeFlagCollection> trfc)
+{
+  mBackend->storeTRFC(trfc);
+}
+
+void AsyncDatabase::storeAny(const void* obj, std::type_info const& typeInfo, std::string const& path, std::map<std::string, std::string> const& metadata,
+                             std::string const& detectorName, std::string const& taskName, long from, long to)
+{
+  mBackend->storeAny(obj, typeInfo, path, metadata, detectorName, taskName, from, to);
+}
+
+void* AsyncDatabase::retrieveAny(std::type_info const& tinfo, std::string const& path, std::map<std::string, std::string> const& metadata, long timestamp,
+                                 std::map<std::string, std::string>* headers, const std::string& createdNotAfter, const std::string& createdNotBefore)
+{
+  return mBackend->retrieveAny(tinfo, path, metadata, timestamp, headers, createdNotAfter, createdNotBefore);
+}
+
+std::shared_ptr<MonitorObject> AsyncDatabase::retrieveMO(std::string objectPath, std::string objectName, long timestamp, const core::Activity& activity)
+{
+  return mBackend->retrieveMO(objectPath, objectName, timestamp, activity);
+}
+
+std::shared_ptr<QualityObject> AsyncDatabase::retrieveQO(std::string qoPath, long timestamp, const core::Activity& activity)
+{
+  return mBackend->retrieveQO(qoPath, timestamp, activity);
+}
+
+std::shared_ptr<o2::quality_control::TimeRangeFlagCollection> AsyncDatabase::retrieveTRFC(const std::string& name, const std::string& detector, int runNumber,
+                                                                                          const std::string& passName, const std::string& periodName,
+                                                                                          const std::string& provenance, long timestamp)
+{
+  return mBackend->retrieveTRFC(name, detector, runNumber, passName, periodName, provenance, timestamp);
+}
+
+std::string AsyncDatabase::retrieveJson(std::string path, long timestamp, const std::map<std::string, std::string>& metadata)
+{
+  return mBackend->retrieveJson(path, timestamp, metadata);
+}
+
+std::map<std::string, std::string> AsyncDatabase::retrieveHeaders(const std::string& path, const std::map<std::string, std::string>& metadata, long timestamp)
+{
+  return mBackend->retrieveHeaders(path, metadata, timestamp);
+}
+
+TObject* AsyncDatabase::retrieveTObject(std::string path, const std::map<std::string, std::string>& metadata, long timestamp, std::map<std::string, std::string>* headers)
+{
+  return mBackend->retrieveTObject(path, metadata, timestamp, headers);
+}
+
+void AsyncDatabase::prepareTaskDataContainer(std::string taskName)
+{
+  mBackend->prepareTaskDataContainer(taskName);
+}
+
+std::vector<std::string> AsyncDatabase::getPublishedObjectNames(std::string taskName)
+{
+  return mBackend->getPublishedObjectNames(taskName);
+}
+
+void AsyncDatabase::truncate(std::string taskName, std::string objectName)
+{
+  mBackend->truncate(taskName, objectName);
+}
+
+void AsyncDatabase::setMaxObjectSize(size_t maxObjectSize)
+{
+  mBackend->setMaxObjectSize(maxObjectSize);
+  for (auto& backend : mUploaderBackends) {
+    backend->setMaxObjectSize(maxObjectSize);
+  }
+}
+
+void AsyncDatabase::setLatencyHistograms(core::LatencyHistograms& histograms)
+{
+  mBackend->setLatencyHistograms(histograms);
+  for (auto& backend : mUploaderBackends) {
+    backend->setLatencyHistograms(histograms);
+  }
+}
+
+} // namespace o2::quality_control::repository
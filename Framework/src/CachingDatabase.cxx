@@ -0,0 +1,421 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   CachingDatabase.cxx
+///
+
+#include "QualityControl/CachingDatabase.h"
+#include "QualityControl/DatabaseHelpers.h"
+#include "QualityControl/MonitorObject.h"
+#include "QualityControl/QualityObject.h"
+#include "QualityControl/QcInfoLogger.h"
+
+#include <DataFormatsQualityControl/TimeRangeFlagCollection.h>
+#include <TFile.h>
+#include <TNamed.h>
+#include <chrono>
+#include <filesystem>
+#include <limits>
+#include <optional>
+#include <sstream>
+#include <thread>
+
+using namespace o2::quality_control::core;
+
+namespace o2::quality_control::repository
+{
+
+namespace
+{
+// Header names as returned by CCDB
+constexpr auto etagKey = "ETag";
+constexpr auto md5Key = "Content-MD5";
+constexpr auto validFromKey = "Valid-From";
+constexpr auto validUntilKey = "Valid-Until";
+
+std::string getETag(const std::map<std::string, std::string>& headers)
+{
+  if (auto it = headers.find(etagKey); it != headers.end()) {
+    return it->second;
+  }
+  if (auto it = headers.find(md5Key); it != headers.end()) {
+    return it->second;
+  }
+  return {};
+}
+
+long getTimestamp(const std::map<std::string, std::string>& headers, const char* key, long defaultValue)
+{
+  auto it = headers.find(key);
+  if (it == headers.end()) {
+    return defaultValue;
+  }
+  try {
+    return std::stol(it->second);
+  } catch (...) {
+    return defaultValue;
+  }
+}
+
+std::string makeKey(const char* type, const std::string& fullPath, const std::map<std::string, std::string>& metadata)
+{
+  std::string key = std::string(type) + ":" + fullPath;
+  for (const auto& [name, value] : metadata) {
+    key += "/" + name + "=" + value;
+  }
+  return key;
+}
+
+bool isEnabledValue(const std::string& value)
+{
+  return value == "true" || value == "1";
+}
+} // namespace
+
+CachingDatabase::CachingDatabase(std::unique_ptr<DatabaseInterface> backend, Config config)
+  : mBackend(std::move(backend)),
+    mConfig(std::move(config))
+{
+  if (!mConfig.directory.empty()) {
+    std::error_code error;
+    std::filesystem::create_directories(mConfig.directory, error);
+    if (error) {
+      ILOG(Error, Support) << "Could not create the object cache directory '" << mConfig.directory << "', the on-disk cache is disabled: "
+                           << error.message() << ENDM;
+      mConfig.directory.clear();
+    }
+  }
+}
+
+bool CachingDatabase::isEnabled(const std::unordered_map<std::string, std::string>& databaseConfig)
+{
+  auto it = databaseConfig.find("cache");
+  return it != databaseConfig.end() && isEnabledValue(it->second);
+}
+
+CachingDatabase::Config CachingDatabase::extractConfig(const std::unordered_map<std::string, std::string>& databaseConfig)
+{
+  Config config;
+  if (databaseConfig.count("cacheSize")) {
+    config.maxObjects = std::stoul(databaseConfig.at("cacheSize"));
+  }
+  if (databaseConfig.count("cacheDirectory")) {
+    config.directory = databaseConfig.at("cacheDirectory");
+  }
+  if (databaseConfig.count("cacheRevalidation")) {
+    config.revalidation = isEnabledValue(databaseConfig.at("cacheRevalidation"));
+  }
+  return config;
+}
+
+void CachingDatabase::connect(std::string host, std::string database, std::string username, std::string password)
+{
+  mBackend->connect(host, database, username, password);
+}
+
+void CachingDatabase::connect(const std::unordered_map<std::string, std::string>& config)
+{
+  mBackend->connect(config);
+}
+
+std::shared_ptr<MonitorObject> CachingDatabase::retrieveMO(std::string objectPath, std::string objectName, long timestamp, const core::Activity& activity)
+{
+  // the same path and metadata as used by CcdbDatabase::retrieveMO
+  const auto fullPath = activity.mProvenance + "/" + objectPath + "/" + objectName;
+  const auto metadata = database_helpers::asDatabaseMetadata(activity, false);
+  auto entry = retrieve(makeKey("MO", fullPath, metadata), fullPath, metadata, timestamp, [&]() {
+    Entry fetched;
+    fetched.mo = mBackend->retrieveMO(objectPath, objectName, timestamp, activity);
+    if (fetched.mo) {
+      const auto& headers = fetched.mo->getMetadataMap();
+      fetched.validFrom = getTimestamp(headers, validFromKey, -1);
+      fetched.validUntil = getTimestamp(headers, validUntilKey, -1);
+      fetched.etag = getETag(headers);
+    }
+    return fetched;
+  });
+  return entry.mo;
+}
+
+std::shared_ptr<QualityObject> CachingDatabase::retrieveQO(std::string qoPath, long timestamp, const core::Activity& activity)
+{
+  // the same path and metadata as used by CcdbDatabase::retrieveQO
+  const auto fullPath = activity.mProvenance + "/" + qoPath;
+  const auto metadata = database_helpers::asDatabaseMetadata(activity, false);
+  auto entry = retrieve(makeKey("QO", fullPath, metadata), fullPath, metadata, timestamp, [&]() {
+    Entry fetched;
+    fetched.qo = mBackend->retrieveQO(qoPath, timestamp, activity);
+    if (fetched.qo) {
+      const auto& headers = fetched.qo->getMetadataMap();
+      fetched.validFrom = getTimestamp(headers, validFromKey, -1);
+      fetched.validUntil = getTimestamp(headers, validUntilKey, -1);
+      fetched.etag = getETag(headers);
+    }
+    return fetched;
+  });
+  return entry.qo;
+}
+
+CachingDatabase::Entry CachingDatabase::retrieve(const std::string& key, const std::string& fullPath, const std::map<std::string, std::string>& metadata,
+                                                 long timestamp, const Fetcher& fetch)
+{
+  const long time = timestamp < 0 ? std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count()
+                                  : timestamp;
+
+  std::optional<Entry> cached;
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    auto range = mIndex.equal_range(key);
+    for (auto it = range.first; it != range.second; ++it) {
+      if (it->second->validFrom <= time && time < it->second->validUntil) {
+        mEntries.splice(mEntries.begin(), mEntries, it->second);
+        cached = *it->second;
+        break;
+      }
+    }
+    if (cached && !mConfig.revalidation) {
+      mStatistics.hits++;
+      return *cached;
+    }
+  }
+
+  // Asking only for the headers is much cheaper than downloading and deserializing the object again.
+  if (cached || !mConfig.directory.empty()) {
+    auto headers = mBackend->retrieveHeaders(fullPath, metadata, timestamp);
+    auto etag = getETag(headers);
+    {
+      std::lock_guard<std::mutex> lock(mMutex);
+      mStatistics.revalidations++;
+      if (cached && !etag.empty() && etag == cached->etag) {
+        mStatistics.hits++;
+        return *cached;
+      }
+      if (cached) {
+        mStatistics.stale++;
+        auto range = mIndex.equal_range(key);
+        for (auto it = range.first; it != range.second; ++it) {
+          if (it->second->etag == cached->etag) {
+            evict(it->second);
+            break;
+          }
+        }
+      }
+    }
+
+    Entry fromDisk{ key, getTimestamp(headers, validFromKey, -1), getTimestamp(headers, validUntilKey, std::numeric_limits<long>::max()), etag, nullptr, nullptr };
+    if (!etag.empty() && !mConfig.directory.empty() && loadFromDisk(fromDisk)) {
+      std::lock_guard<std::mutex> lock(mMutex);
+      mStatistics.diskHits++;
+      insert(fromDisk);
+      return fromDisk;
+    }
+  }
+
+  auto entry = fetch();
+  entry.key = key;
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mStatistics.misses++;
+    // without the validity and ETag we would not know when the object can be reused
+    if ((entry.mo || entry.qo) && !entry.etag.empty() && entry.validFrom >= 0 && entry.validUntil > entry.validFrom) {
+      insert(entry);
+    } else {
+      return entry;
+    }
+  }
+  storeOnDisk(entry);
+  return entry;
+}
+
+std::string CachingDatabase::getDiskPath(const std::string& key, const std::string& etag) const
+{
+  std::stringstream path;
+  path << mConfig.directory << "/" << std::hex << std::hash<std::string>{}(key) << "_" << std::hash<std::string>{}(etag) << ".root";
+  return path.str();
+}
+
+bool CachingDatabase::loadFromDisk(Entry& entry) const
+{
+  const auto path = getDiskPath(entry.key, entry.etag);
+  if (!std::filesystem::exists(path)) {
+    return false;
+  }
+  std::unique_ptr<TFile> file(TFile::Open(path.c_str(), "READ"));
+  if (!file || file->IsZombie()) {
+    return false;
+  }
+  // the file name is a hash, we check that it indeed contains the requested object
+  std::unique_ptr<TNamed> description(file->Get<TNamed>("description"));
+  if (!description || entry.key != description->GetName() || entry.etag != description->GetTitle()) {
+    return false;
+  }
+  std::unique_ptr<TObject> object(file->Get<TObject>("object"));
+  if (auto* mo = dynamic_cast<MonitorObject*>(object.get())) {
+    object.release();
+    entry.mo.reset(mo);
+    entry.mo->setIsOwner(true);
+  } else if (auto* qo = dynamic_cast<QualityObject*>(object.get())) {
+    object.release();
+    entry.qo.reset(qo);
+  }
+  return entry.mo || entry.qo;
+}
+
+void CachingDatabase::storeOnDisk(const Entry& entry) const
+{
+  if (mConfig.directory.empty()) {
+    return;
+  }
+  const auto path = getDiskPath(entry.key, entry.etag);
+  // We write to a temporary file first, so other processes never read an incomplete one.
+  std::stringstream temporaryPath;
+  temporaryPath << path << "." << std::this_thread::get_id() << ".tmp";
+  {
+    std::unique_ptr<TFile> file(TFile::Open(temporaryPath.str().c_str(), "RECREATE"));
+    if (!file || file->IsZombie()) {
+      ILOG(Warning, Support) << "Could not write the object cache file '" << temporaryPath.str() << "'" << ENDM;
+      return;
+    }
+    TNamed description(entry.key.c_str(), entry.etag.c_str());
+    file->WriteTObject(&description, "description");
+    file->WriteTObject(entry.mo ? static_cast<const TObject*>(entry.mo.get()) : entry.qo.get(), "object");
+    file->Close();
+  }
+  std::error_code error;
+  std::filesystem::rename(temporaryPath.str(), path, error);
+  if (error) {
+    ILOG(Warning, Support) << "Could not move the object cache file to '" << path << "': " << error.message() << ENDM;
+    std::filesystem::remove(temporaryPath.str(), error);
+  }
+}
+
+void CachingDatabase::insert(Entry entry)
+{
+  auto range = mIndex.equal_range(entry.key);
+  for (auto it = range.first; it != range.second; ++it) {
+    if (it->second->etag == entry.etag) {
+      // already fetched by another thread
+      mEntries.splice(mEntries.begin(), mEntries, it->second);
+      return;
+    }
+  }
+  mEntries.push_front(std::move(entry));
+  mIndex.emplace(mEntries.front().key, mEntries.begin());
+  while (mEntries.size() > mConfig.maxObjects) {
+    evict(std::prev(mEntries.end()));
+    mStatistics.evictions++;
+  }
+}
+
+void CachingDatabase::evict(std::list<Entry>::iterator entry)
+{
+  auto range = mIndex.equal_range(entry->key);
+  for (auto it = range.first; it != range.second; ++it) {
+    if (it->second == entry) {
+      mIndex.erase(it);
+      break;
+    }
+  }
+  mEntries.erase(entry);
+}
+
+void CachingDatabase::clear()
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  mIndex.clear();
+  mEntries.clear();
+}
+
+CachingDatabase::Statistics CachingDatabase::getAndResetStatistics()
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  auto statistics = mStatistics;
+  statistics.size = mEntries.size();
+  mStatistics = {};
+  return statistics;
+}
+
+void CachingDatabase::storeMO(std::shared_ptr<const MonitorObject> mo, long from, long to)
+{
+  mBackend->storeMO(mo, from, to);
+}
+
+void CachingDatabase::storeQO(std::shared_ptr<const QualityObject> qo, long from, long to)
+{
+  mBackend->storeQO(qo, from, to);
+}
+
+void CachingDatabase::storeTRFC(std::shared_ptr<const o2::quality_control::TimeRangeFlagCollection> trfc)
+{
+  mBackend->storeTRFC(trfc);
+}
+
+void CachingDatabase::storeAny(const void* obj, std::type_info const& typeInfo, std::string const& path, std::map<std::string, std::string> const& metadata,
+                               std::string const& detectorName, std::string const& taskName, long from, long to)
+{
+  mBackend->storeAny(obj, typeInfo, path, metadata, detectorName, taskName, from, to);
+}
+
+void* CachingDatabase::retrieveAny(std::type_info const& tinfo, std::string const& path, std::map<std::string, std::string> const& metadata, long timestamp,
+                                   std::map<std::string, std::string>* headers, const std::string& createdNotAfter, const std::string& createdNotBefore)
+{
+  return mBackend->retrieveAny(tinfo, path, metadata, timestamp, headers, createdNotAfter, createdNotBefore);
+}
+
+std::shared_ptr<o2::quality_control::TimeRangeFlagCollection> CachingDatabase::retrieveTRFC(const std::string& name, const std::string& detector, int runNumber,
+                                                                                            const std::string& passName, const std::string& periodName,
+                                                                                            const std::string& provenance, long timestamp)
+{
+  return mBackend->retrieveTRFC(name, detector, runNumber, passName, periodName, provenance, timestamp);
+}
+
+std::string CachingDatabase::retrieveJson(std::string path, long timestamp, const std::map<std::string, std::string>& metadata)
+{
+  return mBackend->retrieveJson(path, timestamp, metadata);
+}
+
+TObject* CachingDatabase::retrieveTObject(std::string path, const std::map<std::string, std::string>& metadata, long timestamp, std::map<std::string, std::string>* headers)
+{
+  return mBackend->retrieveTObject(path, metadata, timestamp, headers);
+}
+
+std::map<std::string, std::string> CachingDatabase::retrieveHeaders(const std::string& path, const std::map<std::string, std::string>& metadata, long timestamp)
+{
+  return mBackend->retrieveHeaders(path, metadata, timestamp);
+}
+
+void CachingDatabase::disconnect()
+{
+  mBackend->disconnect();
+}
+
+void CachingDatabase::prepareTaskDataContainer(std::string taskName)
+{
+  mBackend->prepareTaskDataContainer(taskName);
+}
+
+std::vector<std::string> CachingDatabase::getPublishedObjectNames(std::string taskName)
+{
+  return mBackend->getPublishedObjectNames(taskName);
+}
+
+void CachingDatabase::truncate(std::string taskName, std::string objectName)
+{
+  mBackend->truncate(taskName, objectName);
+}
+
+void CachingDatabase::setMaxObjectSize(size_t maxObjectSize)
+{
+  mBackend->setMaxObjectSize(maxObjectSize);
+}
+
+} // namespace o2::quality_control::repository
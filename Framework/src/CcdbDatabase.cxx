@@ -113,9 +113,33 @@ void CcdbDatabase::connect(const std::unordered_map<std::string, std::string>& c
 void CcdbDatabase::init()
 {
   ccdbApi.init(mUrl);
+  {
+    std::lock_guard<std::mutex> lock(mApiPoolMutex);
+    mApiPool.clear(); // they might point to another server
+  }
   loadDeprecatedStreamerInfos();
 }
 
+std::shared_ptr<o2::ccdb::CcdbApi> CcdbDatabase::borrowApi()
+{
+  std::unique_ptr<o2::ccdb::CcdbApi> api;
+  {
+    std::lock_guard<std::mutex> lock(mApiPoolMutex);
+    if (!mApiPool.empty()) {
+      api = std::move(mApiPool.back());
+      mApiPool.pop_back();
+    }
+  }
+  if (api == nullptr) {
+    api = std::make_unique<o2::ccdb::CcdbApi>();
+    api->init(mUrl);
+  }
+  return std::shared_ptr<o2::ccdb::CcdbApi>(api.release(), [this](o2::ccdb::CcdbApi* released) {
+    std::lock_guard<std::mutex> lock(mApiPoolMutex);
+    mApiPool.emplace_back(released);
+  });
+}
+
 void CcdbDatabase::handleStorageError(const string& path, int result)
 {
   if (result == -1 /* object bigger than maxObjectSize */) {
@@ -232,6 +256,7 @@ void CcdbDatabase::storeMO(std::shared_ptr<const o2::quality_control::core::Moni
   }
 
   ILOG(Debug, Support) << "Storing MonitorObject " << path << ENDM;
+  QC_LATENCY_SCOPE(mStoreMOLatency);
   int result = ccdbApi.storeAsTFileAny<TObject>(obj, path, metadata, from, to, mMaxObjectSize);
 
   handleStorageError(path, result);
@@ -267,6 +292,7 @@ void CcdbDatabase::storeQO(std::shared_ptr<const o2::quality_control::core::Qual
   }
 
   ILOG(Debug, Support) << "Storing quality object " << path << " (" << qo->getName() << ")" << ENDM;
+  QC_LATENCY_SCOPE(mStoreQOLatency);
   int result = ccdbApi.storeAsTFileAny<QualityObject>(qo.get(), path, metadata, from, to);
 
   handleStorageError(path, result);
@@ -304,7 +330,7 @@ void CcdbDatabase::storeTRFC(std::shared_ptr<const o2::quality_control::TimeRang
 TObject* CcdbDatabase::retrieveTObject(std::string path, std::map<std::string, std::string> const& metadata, long timestamp, std::map<std::string, std::string>* headers)
 {
   // we try first to load a TFile
-  auto* object = ccdbApi.retrieveFromTFileAny<TObject>(path, metadata, timestamp, headers);
+  auto* object = borrowApi()->retrieveFromTFileAny<TObject>(path, metadata, timestamp, headers);
   if (object == nullptr) {
     ILOG(Error, Support) << "We could NOT retrieve the object " << path << " with timestamp " << timestamp << "." << ENDM;
     return nullptr;
@@ -313,9 +339,14 @@ TObject* CcdbDatabase::retrieveTObject(std::string path, std::map<std::string, s
   return object;
 }
 
+std::map<std::string, std::string> CcdbDatabase::retrieveHeaders(const std::string& path, const std::map<std::string, std::string>& metadata, long timestamp)
+{
+  return borrowApi()->retrieveHeaders(path, metadata, timestamp);
+}
+
 void* CcdbDatabase::retrieveAny(const type_info& tinfo, const string& path, const map<std::string, std::string>& metadata, long timestamp, std::map<std::string, std::string>* headers, const string& createdNotAfter, const string& createdNotBefore)
 {
-  auto* object = ccdbApi.retrieveFromTFile(tinfo, path, metadata, timestamp, headers, "", createdNotAfter, createdNotBefore);
+  auto* object = borrowApi()->retrieveFromTFile(tinfo, path, metadata, timestamp, headers, "", createdNotAfter, createdNotBefore);
   if (object == nullptr) {
     ILOG(Error, Support) << "We could NOT retrieve the object " << path << " with timestamp " << timestamp << "." << ENDM;
     return nullptr;
@@ -404,7 +435,8 @@ std::shared_ptr<o2::quality_control::TimeRangeFlagCollection> CcdbDatabase::retr
     return nullptr;
   }
 
-  auto resultMetadata = ccdbApi.retrieveHeaders(trfcPath, metadata, timestamp);
+  auto api = borrowApi();
+  auto resultMetadata = api->retrieveHeaders(trfcPath, metadata, timestamp);
   if (resultMetadata.empty()) {
     ILOG(Error, Support) << "Could not extract headers of TRFC at '" << trfcPath << "' with the metadata: " << ENDM; // TODO
     ILOG(Error, Support) << " - RunNumber  : " << metadata["RunNumber"] << ENDM;
@@ -413,7 +445,7 @@ std::shared_ptr<o2::quality_control::TimeRangeFlagCollection> CcdbDatabase::retr
     return nullptr;
   }
 
-  auto success = ccdbApi.retrieveBlob(trfcPath, localFileDir, metadata, timestamp, false, localFileName);
+  auto success = api->retrieveBlob(trfcPath, localFileDir, metadata, timestamp, false, localFileName);
   if (!success) {
     ILOG(Error, Support) << "Could not retrieve the TRFC at '" << trfcPath << "' with the metadata: " << ENDM; // TODO
     ILOG(Error, Support) << " - RunNumber  : " << metadata["RunNumber"] << ENDM;
@@ -504,7 +536,7 @@ void CcdbDatabase::prepareTaskDataContainer(std::string /*taskName*/)
 
 std::string CcdbDatabase::getListingAsString(std::string subpath, std::string accept)
 {
-  std::string tempString = ccdbApi.list(subpath, false, accept);
+  std::string tempString = borrowApi()->list(subpath, false, accept);
 
   return tempString;
 }
@@ -554,6 +586,11 @@ boost::property_tree::ptree CcdbDatabase::getListingAsPtree(std::string path)
   return listingAsTree;
 }
 
+std::vector<database_helpers::ListedVersion> CcdbDatabase::getListedVersions(std::string path, const std::function<bool(const core::Activity&)>& accept)
+{
+  return database_helpers::parseListing(getListingAsString(path, "application/json"), accept);
+}
+
 std::vector<uint64_t> CcdbDatabase::getTimestampsForObject(std::string path)
 {
   const auto& objects = getListingAsPtree(path).get_child("objects");
@@ -574,7 +611,7 @@ std::vector<uint64_t> CcdbDatabase::getTimestampsForObject(std::string path)
 std::vector<std::string> CcdbDatabase::getPublishedObjectNames(std::string taskName)
 {
   std::vector<string> result;
-  string listing = ccdbApi.list(taskName + "/.*", true, "Application/JSON");
+  string listing = borrowApi()->list(taskName + "/.*", true, "Application/JSON");
 
   boost::property_tree::ptree pt;
   stringstream ss;
@@ -636,4 +673,12 @@ void CcdbDatabase::setMaxObjectSize(size_t maxObjectSize)
   CcdbDatabase::mMaxObjectSize = maxObjectSize;
 }
 
+void CcdbDatabase::setLatencyHistograms(core::LatencyHistograms& histograms)
+{
+#ifdef QC_WITH_LATENCY_HISTOGRAMS
+  mStoreMOLatency = &histograms.get("storeMO");
+  mStoreQOLatency = &histograms.get("storeQO");
+#endif
+}
+
 } // namespace o2::quality_control::repository
@@ -0,0 +1,612 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   CcdbStandIn.cxx
+///
+
+#include "QualityControl/CcdbStandIn.h"
+#include "QualityControl/QcInfoLogger.h"
+
+#include <boost/asio/buffers_iterator.hpp>
+#include <boost/asio/connect.hpp>
+#include <boost/asio/read.hpp>
+#include <boost/asio/read_until.hpp>
+#include <boost/asio/streambuf.hpp>
+#include <boost/asio/write.hpp>
+#include <sys/socket.h>
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <exception>
+#include <regex>
+#include <set>
+#include <sstream>
+
+using boost::asio::ip::tcp;
+
+namespace o2::quality_control::repository
+{
+
+namespace
+{
+
+constexpr auto headerEnd = "\r\n\r\n";
+
+uint64_t getCurrentTimestamp()
+{
+  return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+std::string toLower(std::string text)
+{
+  std::transform(text.begin(), text.end(), text.begin(), [](unsigned char c) { return std::tolower(c); });
+  return text;
+}
+
+std::string trim(const std::string& text)
+{
+  auto begin = text.find_first_not_of(" \t");
+  auto end = text.find_last_not_of(" \t\r");
+  return begin == std::string::npos ? "" : text.substr(begin, end - begin + 1);
+}
+
+bool isNumber(const std::string& text)
+{
+  return !text.empty() && text.size() < 20 && std::all_of(text.begin(), text.end(), [](unsigned char c) { return std::isdigit(c); });
+}
+
+/// Decodes the %XX sequences of a URL segment.
+std::string decode(const std::string& segment)
+{
+  std::string decoded;
+  decoded.reserve(segment.size());
+  for (size_t i = 0; i < segment.size(); i++) {
+    if (segment[i] == '%' && i + 2 < segment.size() && std::isxdigit(segment[i + 1]) && std::isxdigit(segment[i + 2])) {
+      decoded += static_cast<char>(std::stoi(segment.substr(i + 1, 2), nullptr, 16));
+      i += 2;
+    } else {
+      decoded += segment[i];
+    }
+  }
+  return decoded;
+}
+
+/// 64-bit FNV-1a, stands for the MD5 of the real server: identical contents have the same checksum.
+std::string computeChecksum(const std::string& content)
+{
+  uint64_t hash = 0xcbf29ce484222325ull;
+  for (unsigned char c : content) {
+    hash = (hash ^ c) * 0x100000001b3ull;
+  }
+  char text[17];
+  std::snprintf(text, sizeof(text), "%016llx", static_cast<unsigned long long>(hash));
+  return text;
+}
+
+std::string escapeJson(const std::string& text)
+{
+  std::string escaped;
+  for (unsigned char c : text) {
+    if (c == '"' || c == '\\') {
+      escaped += '\\';
+      escaped += c;
+    } else if (c < 0x20) {
+      char code[7];
+      std::snprintf(code, sizeof(code), "\\u%04x", c);
+      escaped += code;
+    } else {
+      escaped += c;
+    }
+  }
+  return escaped;
+}
+
+/// A lone "*" is a wildcard, as in the paths given to truncate(), other patterns are regular expressions.
+std::regex toRegex(const std::string& pattern)
+{
+  std::string expression;
+  for (size_t i = 0; i < pattern.size(); i++) {
+    expression += (pattern[i] == '*' && (i == 0 || pattern[i - 1] != '.')) ? ".*" : std::string(1, pattern[i]);
+  }
+  return std::regex(expression);
+}
+
+std::string take(boost::asio::streambuf& buffer, size_t size)
+{
+  auto begin = boost::asio::buffers_begin(buffer.data());
+  std::string taken(begin, begin + size);
+  buffer.consume(size);
+  return taken;
+}
+
+/// The parts of a CCDB URL: /path/to/object[/timestamps...][/id][/key=value...]
+struct Address {
+  std::string path;
+  std::vector<uint64_t> timestamps;
+  std::string id;
+  std::map<std::string, std::string> metadata;
+};
+
+Address parseAddress(const std::vector<std::string>& segments, size_t first)
+{
+  Address address;
+  size_t i = first;
+  // as in the real server, the path ends with the first number or metadata
+  for (; i < segments.size() && !isNumber(segments[i]) && segments[i].find('=') == std::string::npos; i++) {
+    address.path += (address.path.empty() ? "" : "/") + segments[i];
+  }
+  for (; i < segments.size(); i++) {
+    const auto& segment = segments[i];
+    if (auto equal = segment.find('='); equal != std::string::npos) {
+      address.metadata[segment.substr(0, equal)] = segment.substr(equal + 1);
+    } else if (isNumber(segment)) {
+      address.timestamps.push_back(std::stoull(segment));
+    } else {
+      address.id = segment;
+    }
+  }
+  return address;
+}
+
+/// Extracts the first part of a multipart/form-data body, which is the stored file for the CCDB clients.
+bool parseMultipart(const std::string& body, const std::string& contentType, std::string& fileName, std::string& partType, std::string& content)
+{
+  auto boundaryStart = contentType.find("boundary=");
+  if (boundaryStart == std::string::npos) {
+    return false;
+  }
+  auto boundary = contentType.substr(boundaryStart + 9);
+  boundary = boundary.substr(0, boundary.find(';'));
+  boundary.erase(std::remove(boundary.begin(), boundary.end(), '"'), boundary.end());
+  auto delimiter = "--" + trim(boundary);
+
+  auto partStart = body.find(delimiter);
+  auto headersEnd = partStart == std::string::npos ? std::string::npos : body.find(headerEnd, partStart);
+  auto contentEnd = headersEnd == std::string::npos ? std::string::npos : body.find("\r\n" + delimiter, headersEnd + 4);
+  if (contentEnd == std::string::npos) {
+    return false;
+  }
+  content = body.substr(headersEnd + 4, contentEnd - headersEnd - 4);
+
+  std::istringstream headers(body.substr(partStart + delimiter.size(), headersEnd - partStart - delimiter.size()));
+  std::string line;
+  while (std::getline(headers, line)) {
+    auto colon = line.find(':');
+    if (colon == std::string::npos) {
+      continue;
+    }
+    auto name = toLower(trim(line.substr(0, colon)));
+    auto value = trim(line.substr(colon + 1));
+    if (name == "content-type") {
+      partType = value;
+    } else if (auto fileNameStart = value.find("filename=\""); name == "content-disposition" && fileNameStart != std::string::npos) {
+      fileNameStart += 10;
+      fileName = value.substr(fileNameStart, value.find('"', fileNameStart) - fileNameStart);
+    }
+  }
+  return true;
+}
+
+} // namespace
+
+struct CcdbStandIn::Request {
+  std::string method;
+  std::vector<std::string> segments;          // of the path, decoded, without the query
+  std::map<std::string, std::string> headers; // with lower case names
+  std::string body;
+
+  std::string getHeader(const std::string& name) const
+  {
+    auto header = headers.find(name);
+    return header == headers.end() ? "" : header->second;
+  }
+};
+
+struct CcdbStandIn::Response {
+  int status = 200;
+  std::string reason = "OK";
+  std::vector<std::pair<std::string, std::string>> headers;
+  std::string body;
+  std::shared_ptr<const Version> version; // its content is the body if set
+
+  static Response error(int status, const std::string& reason)
+  {
+    return { status, reason, {}, reason + "\n", nullptr };
+  }
+};
+
+CcdbStandIn::CcdbStandIn(Config config)
+  : mConfig(config), mAcceptor(mContext, tcp::endpoint(boost::asio::ip::address_v4::loopback(), config.port)), mGenerator(config.seed)
+{
+  mAcceptThread = std::thread(&CcdbStandIn::acceptConnections, this);
+  ILOG(Info, Support) << "CCDB stand-in listening at " << getUrl() << ENDM;
+}
+
+CcdbStandIn::~CcdbStandIn()
+{
+  mStopping = true;
+  // the blocking accept() is woken up by a last connection
+  try {
+    tcp::socket wakeUp(mContext);
+    wakeUp.connect(mAcceptor.local_endpoint());
+  } catch (const std::exception& exception) {
+    ILOG(Warning, Support) << "Could not wake up the CCDB stand-in: " << exception.what() << ENDM;
+  }
+  mAcceptThread.join();
+
+  std::lock_guard<std::mutex> lock(mConnectionsMutex);
+  for (auto& connection : mConnections) {
+    // the sockets are closed only once their thread is joined, so the descriptors are still valid
+    ::shutdown(connection.socket.native_handle(), SHUT_RDWR);
+  }
+  for (auto& connection : mConnections) {
+    connection.thread.join();
+  }
+}
+
+unsigned short CcdbStandIn::getPort() const
+{
+  return mAcceptor.local_endpoint().port();
+}
+
+std::string CcdbStandIn::getUrl() const
+{
+  return "localhost:" + std::to_string(getPort());
+}
+
+CcdbStandIn::Statistics CcdbStandIn::getStatistics() const
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  return mStatistics;
+}
+
+void CcdbStandIn::acceptConnections()
+{
+  while (!mStopping) {
+    tcp::socket socket(mContext);
+    boost::system::error_code error;
+    mAcceptor.accept(socket, error);
+    if (error || mStopping) {
+      continue;
+    }
+    std::lock_guard<std::mutex> lock(mConnectionsMutex);
+    for (auto it = mConnections.begin(); it != mConnections.end();) {
+      if (it->finished) {
+        it->thread.join();
+        it = mConnections.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    auto& connection = mConnections.emplace_back(std::move(socket));
+    connection.thread = std::thread(&CcdbStandIn::serve, this, std::ref(connection));
+  }
+}
+
+void CcdbStandIn::serve(Connection& connection)
+{
+  auto& socket = connection.socket;
+  boost::asio::streambuf buffer;
+  boost::system::error_code error;
+  bool keepAlive = true;
+  while (keepAlive && !mStopping) {
+    auto headSize = boost::asio::read_until(socket, buffer, headerEnd, error);
+    if (error) {
+      break;
+    }
+    std::istringstream head(take(buffer, headSize));
+
+    Request request;
+    std::string line, target;
+    std::getline(head, line);
+    std::istringstream(line) >> request.method >> target;
+    target = target.substr(0, target.find('?'));
+    std::istringstream path(target);
+    std::string segment;
+    while (std::getline(path, segment, '/')) {
+      if (!segment.empty()) {
+        request.segments.push_back(decode(segment));
+      }
+    }
+    while (std::getline(head, line) && line != "\r") {
+      if (auto colon = line.find(':'); colon != std::string::npos) {
+        request.headers[toLower(trim(line.substr(0, colon)))] = trim(line.substr(colon + 1));
+      }
+    }
+    keepAlive = toLower(request.getHeader("connection")) != "close";
+
+    if (toLower(request.getHeader("expect")) == "100-continue") {
+      boost::asio::write(socket, boost::asio::buffer(std::string("HTTP/1.1 100 Continue\r\n\r\n")), error);
+    }
+    if (auto length = request.getHeader("content-length"); !length.empty()) {
+      size_t size = std::stoull(length);
+      if (buffer.size() < size) {
+        boost::asio::read(socket, buffer, boost::asio::transfer_exactly(size - buffer.size()), error);
+      }
+      request.body = take(buffer, std::min(size, buffer.size()));
+    } else if (toLower(request.getHeader("transfer-encoding")) == "chunked") {
+      while (!error) {
+        auto lineSize = boost::asio::read_until(socket, buffer, "\r\n", error);
+        size_t chunkSize = error ? 0 : std::stoull(take(buffer, lineSize), nullptr, 16);
+        if (!error && buffer.size() < chunkSize + 2) {
+          boost::asio::read(socket, buffer, boost::asio::transfer_exactly(chunkSize + 2 - buffer.size()), error);
+        }
+        if (error || chunkSize == 0) {
+          buffer.consume(std::min<size_t>(2, buffer.size()));
+          break;
+        }
+        request.body += take(buffer, chunkSize);
+        buffer.consume(2);
+      }
+    }
+    if (error) {
+      break;
+    }
+
+    Response response;
+    if (injectError()) {
+      response = Response::error(503, "Service Unavailable");
+    } else {
+      try {
+        response = handle(request);
+      } catch (const std::exception& exception) {
+        response = Response::error(400, "Bad Request");
+        response.body = exception.what() + std::string("\n");
+      }
+    }
+    if (mConfig.latency.count() > 0) {
+      std::this_thread::sleep_for(mConfig.latency);
+    }
+
+    const auto& body = response.version ? response.version->content : response.body;
+    std::string responseHead = "HTTP/1.1 " + std::to_string(response.status) + " " + response.reason + "\r\n";
+    for (const auto& [name, value] : response.headers) {
+      responseHead += name + ": " + value + "\r\n";
+    }
+    responseHead += "Content-Length: " + std::to_string(response.status == 304 ? 0 : body.size()) + "\r\n";
+    responseHead += keepAlive ? "\r\n" : "Connection: close\r\n\r\n";
+    std::vector<boost::asio::const_buffer> buffers{ boost::asio::buffer(responseHead) };
+    if (request.method != "HEAD" && response.status != 304) {
+      buffers.push_back(boost::asio::buffer(body));
+    }
+    boost::asio::write(socket, buffers, error);
+    if (error) {
+      break;
+    }
+  }
+  socket.shutdown(tcp::socket::shutdown_both, error);
+  connection.finished = true;
+}
+
+bool CcdbStandIn::injectError()
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  mStatistics.requests++;
+  if (mConfig.errorRate <= 0 || std::uniform_real_distribution<double>(0, 1)(mGenerator) >= mConfig.errorRate) {
+    return false;
+  }
+  mStatistics.injectedErrors++;
+  return true;
+}
+
+CcdbStandIn::Response CcdbStandIn::handle(const Request& request)
+{
+  const std::string first = request.segments.empty() ? "" : request.segments[0];
+  if (request.method == "POST") {
+    return store(request);
+  } else if ((request.method == "GET" || request.method == "HEAD") && first.empty()) {
+    // the clients check if the host is reachable this way
+    return { 200, "OK", {}, "CCDB stand-in\n", nullptr };
+  } else if (request.method == "GET" && (first == "browse" || first == "latest")) {
+    return browse(request, first == "latest");
+  } else if (request.method == "GET" || request.method == "HEAD") {
+    return retrieve(request, request.method == "GET");
+  } else if (request.method == "DELETE" && first == "truncate") {
+    return truncate(request);
+  } else if (request.method == "DELETE") {
+    return remove(request);
+  }
+  return Response::error(405, "Method Not Allowed");
+}
+
+CcdbStandIn::Response CcdbStandIn::store(const Request& request)
+{
+  auto address = parseAddress(request.segments, 0);
+  if (address.path.empty() || address.timestamps.size() < 2 || address.timestamps[0] >= address.timestamps[1]) {
+    return Response::error(400, "Bad Request");
+  }
+  auto version = std::make_shared<Version>();
+  if (!parseMultipart(request.body, request.getHeader("content-type"), version->fileName, version->contentType, version->content)) {
+    return Response::error(400, "Bad Request");
+  }
+  version->path = address.path;
+  version->validFrom = address.timestamps[0];
+  version->validUntil = address.timestamps[1];
+  version->metadata = std::move(address.metadata);
+  version->checksum = computeChecksum(version->content);
+
+  std::lock_guard<std::mutex> lock(mMutex);
+  char id[37];
+  std::snprintf(id, sizeof(id), "00000000-0000-11ee-8000-%012llx", static_cast<unsigned long long>(mNextId++));
+  version->id = id;
+  version->created = getCurrentTimestamp();
+  mObjects[version->path].push_back(version);
+  mStatistics.storedVersions++;
+  return { 201, "Created", { { "Location", "/" + version->path + "/" + std::to_string(version->validFrom) + "/" + version->id } }, "", nullptr };
+}
+
+CcdbStandIn::Response CcdbStandIn::retrieve(const Request& request, bool withContent)
+{
+  auto address = parseAddress(request.segments, 0);
+  auto timestamp = address.timestamps.empty() ? getCurrentTimestamp() : address.timestamps[0];
+  auto notAfter = request.getHeader("if-not-after");
+  auto notBefore = request.getHeader("if-not-before");
+
+  std::shared_ptr<const Version> found;
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    auto versions = mObjects.find(address.path);
+    if (versions != mObjects.end()) {
+      for (auto it = versions->second.rbegin(); it != versions->second.rend() && found == nullptr; ++it) {
+        const auto& version = **it;
+        bool matches = version.validFrom <= timestamp && timestamp < version.validUntil && (address.id.empty() || address.id == version.id) &&
+                       (notAfter.empty() || version.created <= std::stoull(notAfter)) && (notBefore.empty() || version.created >= std::stoull(notBefore));
+        for (const auto& [key, value] : address.metadata) {
+          auto metadata = version.metadata.find(key);
+          matches = matches && metadata != version.metadata.end() && metadata->second == value;
+        }
+        if (matches) {
+          found = *it;
+        }
+      }
+    }
+  }
+  if (found == nullptr) {
+    return Response::error(404, "Not Found");
+  }
+
+  Response response{ 200, "OK", {}, "", withContent ? found : nullptr };
+  auto etag = "\"" + found->id + "\"";
+  if (request.getHeader("if-none-match") == etag) {
+    response.status = 304;
+    response.reason = "Not Modified";
+    response.version = nullptr;
+  }
+  response.headers = {
+    { "Valid-From", std::to_string(found->validFrom) },
+    { "Valid-Until", std::to_string(found->validUntil) },
+    { "Created", std::to_string(found->created) },
+    { "Last-Modified", std::to_string(found->created) },
+    { "ETag", etag },
+    { "Content-MD5", found->checksum },
+    { "Content-Type", found->contentType.empty() ? "application/octet-stream" : found->contentType },
+    { "Content-Disposition", "inline;filename=\"" + found->fileName + "\"" }
+  };
+  for (const auto& [key, value] : found->metadata) {
+    if (key.find_first_of(":\r\n") == std::string::npos && value.find_first_of("\r\n") == std::string::npos) {
+      response.headers.emplace_back(key, value);
+    }
+  }
+  if (!withContent) {
+    // the answer to HEAD gives the size of the content it does not send
+    response.version = found;
+  }
+  return response;
+}
+
+CcdbStandIn::Response CcdbStandIn::browse(const Request& request, bool latestOnly)
+{
+  std::string pattern;
+  for (size_t i = 1; i < request.segments.size(); i++) {
+    pattern += (pattern.empty() ? "" : "/") + request.segments[i];
+  }
+  bool isPattern = pattern.find('*') != std::string::npos;
+  auto expression = isPattern ? toRegex(pattern) : std::regex();
+  bool json = toLower(request.getHeader("accept")).find("application/json") != std::string::npos;
+
+  std::vector<std::shared_ptr<const Version>> versions;
+  std::set<std::string> subfolders;
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    for (const auto& [path, pathVersions] : mObjects) {
+      if (pathVersions.empty()) {
+        continue;
+      }
+      if (isPattern ? std::regex_match(path, expression) : path == pattern) {
+        // the newest version first
+        auto end = latestOnly ? pathVersions.rbegin() + 1 : pathVersions.rend();
+        versions.insert(versions.end(), pathVersions.rbegin(), end);
+      } else if (!isPattern && (pattern.empty() || path.compare(0, pattern.size() + 1, pattern + "/") == 0)) {
+        auto folderEnd = path.find('/', pattern.empty() ? 0 : pattern.size() + 1);
+        subfolders.insert(path.substr(0, folderEnd));
+      }
+    }
+  }
+
+  std::ostringstream body;
+  if (json) {
+    body << "{\"objects\":[";
+    for (size_t i = 0; i < versions.size(); i++) {
+      const auto& version = *versions[i];
+      body << (i == 0 ? "" : ",") << "{\"path\":\"" << escapeJson(version.path) << "\",\"id\":\"" << version.id
+           << "\",\"Created\":" << version.created << ",\"Last-Modified\":" << version.created
+           << ",\"Valid-From\":" << version.validFrom << ",\"Valid-Until\":" << version.validUntil
+           << ",\"MD5\":\"" << version.checksum << "\",\"fileName\":\"" << escapeJson(version.fileName)
+           << "\",\"contentType\":\"" << escapeJson(version.contentType) << "\",\"size\":" << version.content.size();
+      for (const auto& [key, value] : version.metadata) {
+        body << ",\"" << escapeJson(key) << "\":\"" << escapeJson(value) << "\"";
+      }
+      body << "}";
+    }
+    body << "],\"subfolders\":[";
+    for (auto it = subfolders.begin(); it != subfolders.end(); ++it) {
+      body << (it == subfolders.begin() ? "" : ",") << "\"" << escapeJson(*it) << "\"";
+    }
+    body << "]}";
+  } else {
+    std::set<std::string> paths;
+    for (const auto& version : versions) {
+      if (paths.insert(version->path).second) {
+        body << version->path << "\n";
+      }
+    }
+    body << "Subfolders:\n";
+    for (const auto& subfolder : subfolders) {
+      body << subfolder << "\n";
+    }
+  }
+  return { 200, "OK", { { "Content-Type", json ? "application/json" : "text/plain" } }, body.str(), nullptr };
+}
+
+CcdbStandIn::Response CcdbStandIn::remove(const Request& request)
+{
+  auto address = parseAddress(request.segments, 0);
+  if (address.timestamps.empty()) {
+    return Response::error(400, "Bad Request");
+  }
+  auto timestamp = address.timestamps[0];
+  std::lock_guard<std::mutex> lock(mMutex);
+  auto versions = mObjects.find(address.path);
+  if (versions != mObjects.end()) {
+    auto& list = versions->second;
+    for (auto it = list.rbegin(); it != list.rend(); ++it) {
+      const auto& version = **it;
+      if (version.validFrom <= timestamp && timestamp < version.validUntil && (address.id.empty() || address.id == version.id)) {
+        list.erase(std::next(it).base());
+        mStatistics.storedVersions--;
+        return { 200, "OK", {}, "", nullptr };
+      }
+    }
+  }
+  return Response::error(404, "Not Found");
+}
+
+CcdbStandIn::Response CcdbStandIn::truncate(const Request& request)
+{
+  std::string pattern;
+  for (size_t i = 1; i < request.segments.size(); i++) {
+    pattern += (pattern.empty() ? "" : "/") + request.segments[i];
+  }
+  auto expression = toRegex(pattern);
+  std::lock_guard<std::mutex> lock(mMutex);
+  for (auto it = mObjects.begin(); it != mObjects.end();) {
+    if (std::regex_match(it->first, expression)) {
+      mStatistics.storedVersions -= it->second.size();
+      it = mObjects.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  return { 200, "OK", {}, "", nullptr };
+}
+
+} // namespace o2::quality_control::repository
@@ -76,7 +76,15 @@ void Check::init()
   }
 }
 
-QualityObjectsType Check::check(std::map<std::string, std::shared_ptr<MonitorObject>>& moMap)
+void Check::setLatencyHistograms(core::LatencyHistograms& histograms)
+{
+#ifdef QC_WITH_LATENCY_HISTOGRAMS
+  mCheckLatency = &histograms.get("check_" + mCheckConfig.name);
+  mBeautifyLatency = &histograms.get("beautify_" + mCheckConfig.name);
+#endif
+}
+
+QualityObjectsType Check::check(std::map<std::string, std::shared_ptr<MonitorObject>>& moMap, bool beautifyObjects)
 {
   if (mCheckInterface == nullptr) {
     BOOST_THROW_EXCEPTION(FatalException() << errinfo_details("Attempting to check, but no CheckInterface is loaded"));
@@ -100,8 +108,8 @@ QualityObjectsType Check::check(std::map<std::string, std::shared_ptr<MonitorObj
      */
     for (auto& key : mCheckConfig.objectNames) {
       // don't create empty shared_ptr
-      if (moMap.count(key)) {
-        shadowMap.insert({ key, moMap[key] });
+      if (auto mo = moMap.find(key); mo != moMap.end()) {
+        shadowMap.insert(*mo);
       }
     }
   }
@@ -122,7 +130,11 @@ QualityObjectsType Check::check(std::map<std::string, std::shared_ptr<MonitorObj
     std::vector<std::string> monitorObjectsNames;
     boost::copy(moMapToCheck | boost::adaptors::map_keys, std::back_inserter(monitorObjectsNames));
 
-    auto quality = mCheckInterface->check(&moMapToCheck);
+    Quality quality;
+    {
+      QC_LATENCY_SCOPE(mCheckLatency);
+      quality = mCheckInterface->check(&moMapToCheck);
+    }
     ILOG(Info, Support) << "Check '" << mCheckConfig.name << "', quality '" << quality << "'" << ENDM;
     // todo: take metadata from somewhere
     qualityObjects.emplace_back(std::make_shared<QualityObject>(
@@ -132,18 +144,38 @@ QualityObjectsType Check::check(std::map<std::string, std::shared_ptr<MonitorObj
       UpdatePolicyTypeUtils::ToString(mCheckConfig.policyType),
       stringifyInput(mCheckConfig.inputSpecs),
       monitorObjectsNames));
-    beautify(moMapToCheck, quality);
+    if (beautifyObjects) {
+      beautify(moMapToCheck, quality);
+    }
   }
 
   return qualityObjects;
 }
 
+void Check::beautify(const QualityObjectsType& qualityObjects, std::map<std::string, std::shared_ptr<MonitorObject>>& moMap)
+{
+  if (!mCheckConfig.allowBeautify) {
+    return;
+  }
+
+  for (const auto& qualityObject : qualityObjects) {
+    std::map<std::string, std::shared_ptr<MonitorObject>> checkedMap;
+    for (const auto& moName : qualityObject->getMonitorObjectsNames()) {
+      if (auto mo = moMap.find(moName); mo != moMap.end()) {
+        checkedMap.insert(*mo);
+      }
+    }
+    beautify(checkedMap, qualityObject->getQuality());
+  }
+}
+
 void Check::beautify(std::map<std::string, std::shared_ptr<MonitorObject>>& moMap, Quality quality)
 {
   if (!mCheckConfig.allowBeautify) {
     return;
   }
 
+  QC_LATENCY_SCOPE(mBeautifyLatency);
   for (auto const& item : moMap) {
     mCheckInterface->beautify(item.second /*mo*/, quality);
   }
@@ -213,7 +245,8 @@ CheckConfig Check::extractConfig(const CommonSpec&, const CheckSpec& checkSpec)
     checkAllObjects,
     allowBeautify,
     std::move(inputs),
-    createOutputSpec(checkSpec.checkName)
+    createOutputSpec(checkSpec.checkName),
+    checkSpec.threadSafe
   };
 }
 
@@ -21,6 +21,8 @@
 // O2
 #include <Common/Exceptions.h>
 #include <Framework/DataSpecUtils.h>
+#include <Framework/DataRefUtils.h>
+#include <Framework/TMessageSerializer.h>
 #include <Monitoring/MonitoringFactory.h>
 #include <Monitoring/Monitoring.h>
 #include <CommonUtils/ConfigurableParam.h>
@@ -28,14 +30,18 @@
 #include <utility>
 // QC
 #include "QualityControl/DatabaseFactory.h"
+#include "QualityControl/AsyncDatabase.h"
 #include "QualityControl/ServiceDiscovery.h"
 #include "QualityControl/runnerUtils.h"
 #include "QualityControl/InfrastructureSpecReader.h"
 #include "QualityControl/CheckRunnerFactory.h"
 #include "QualityControl/RootClassFactory.h"
 #include "QualityControl/ConfigParamGlo.h"
+#include "QualityControl/HistogramTransport.h"
 
 #include <TSystem.h>
+#include <TROOT.h>
+#include <TH1.h>
 
 using namespace std::chrono;
 using namespace AliceO2::Common;
@@ -52,6 +58,41 @@ const auto current_diagnostic = boost::current_exception_diagnostic_information;
 namespace o2::quality_control::checker
 {
 
+namespace
+{
+/// Deserializes the payload into the spare object if it is of the same class, so that its buffers are reused instead
+/// of allocating a new object, like TTree does when reading entries. Returns nullptr if it was not possible.
+std::unique_ptr<TObject> deserializeIntoSpare(const DataRef& dataRef, std::unique_ptr<TObject>& spare)
+{
+  if (spare == nullptr) {
+    return nullptr;
+  }
+  auto dataHeader = DataRefUtils::getHeader<header::DataHeader*>(dataRef);
+  if (dataHeader == nullptr || dataHeader->payloadSerializationMethod != header::gSerializationMethodROOT) {
+    return nullptr;
+  }
+  FairTMessage tm(const_cast<char*>(dataRef.payload), static_cast<int>(DataRefUtils::getPayloadSize(dataRef)));
+  if (tm.GetClass() != spare->IsA()) {
+    return nullptr;
+  }
+  UInt_t tag;
+  tm.ReadClass(spare->IsA(), &tag); // skips the class tag, we have just checked it
+  spare->Streamer(tm);
+  return std::move(spare);
+}
+
+/// Reads the objects of a task which copied the bins of its histograms, returns nullptr if the payload is streamed.
+std::unique_ptr<TObject> decodeHistograms(const DataRef& dataRef)
+{
+  auto dataHeader = DataRefUtils::getHeader<header::DataHeader*>(dataRef);
+  auto payloadSize = DataRefUtils::getPayloadSize(dataRef);
+  if (dataHeader == nullptr || dataHeader->payloadSerializationMethod != header::gSerializationMethodNone || !histogram_transport::isEncoded(dataRef.payload, payloadSize)) {
+    return nullptr;
+  }
+  return histogram_transport::decode(dataRef.payload, payloadSize);
+}
+} // namespace
+
 std::size_t CheckRunner::hash(const std::string& inputString)
 {
   // BSD checksum
@@ -225,10 +266,20 @@ void CheckRunner::init(framework::InitContext& iCtx)
     iCtx.services().get<CallbackService>().set(CallbackService::Id::Stop, [this]() { stop(); });
 
     updatePolicyManager.reset();
+    mCacheIndex.clear(); // the object ids are not valid anymore
     for (auto& [checkName, check] : mChecks) {
       check.init();
+#ifdef QC_WITH_LATENCY_HISTOGRAMS
+      check.setLatencyHistograms(*mLatencyHistograms);
+#endif
       updatePolicyManager.addPolicy(check.getName(), check.getUpdatePolicyType(), check.getObjectsNames(), check.getAllObjectsOption(), false);
     }
+
+    if (mConfig.checkThreads > 1 && mCheckPool == nullptr) {
+      ROOT::EnableThreadSafety();
+      mCheckPool = std::make_unique<ThreadPool>(mConfig.checkThreads);
+      ILOG(Info, Support) << "Thread-safe checks will be executed in parallel by " << mConfig.checkThreads << " threads" << ENDM;
+    }
   } catch (...) {
     // catch the exceptions and print it (the ultimate caller might not know how to display it)
     ILOG(Fatal, Ops) << "Unexpected exception during initialization:\n"
@@ -257,17 +308,30 @@ void CheckRunner::run(framework::ProcessingContext& ctx)
 void CheckRunner::prepareCacheData(framework::InputRecord& inputRecord)
 {
   mMonitorObjectStoreVector.clear();
+  mSpareObjects.resize(mInputs.size());
 
-  for (const auto& input : mInputs) {
+  for (size_t inputIndex = 0; inputIndex < mInputs.size(); ++inputIndex) {
+    const auto& input = mInputs[inputIndex];
     auto dataRef = inputRecord.get(input.binding.c_str());
     if (dataRef.header != nullptr && dataRef.payload != nullptr) {
 
       // We don't know what we receive, so we test for an array and then try a tobject.
       // If we received a tobject, it gets encapsulated in the tobjarray.
       shared_ptr<TObjArray> array = nullptr;
-      auto tobj = DataRefUtils::as<TObject>(dataRef);
-      // if the object has not been found, it will raise an exception that we just let go.
-      if (tobj->InheritsFrom("TObjArray")) {
+      std::unique_ptr<TObject> tobj;
+      {
+        QC_LATENCY_SCOPE(mDeserializationLatency);
+        tobj = decodeHistograms(dataRef);
+        if (tobj == nullptr) {
+          tobj = deserializeIntoSpare(dataRef, mSpareObjects[inputIndex]);
+        }
+        if (tobj == nullptr) {
+          // if the object has not been found, it will raise an exception that we just let go.
+          tobj = DataRefUtils::as<TObject>(dataRef);
+        }
+      }
+      bool isArray = tobj->InheritsFrom("TObjArray");
+      if (isArray) {
         array.reset(dynamic_cast<TObjArray*>(tobj.release()));
         array->SetOwner(false);
         ILOG(Info, Support) << "CheckRunner " << mDeviceName
@@ -275,13 +339,11 @@ void CheckRunner::prepareCacheData(framework::InputRecord& inputRecord)
                             << " entries from " << input.binding << ENDM;
       } else {
         // it is just a TObject not embedded in a TObjArray. We build a TObjArray for it.
-        auto* newArray = new TObjArray();    // we cannot use `array` to add an object as it is const
-        TObject* newTObject = tobj->Clone(); // we need a copy to avoid that it gets deleted behind our back.
-        newArray->Add(newTObject);
-        array.reset(newArray); // now that the array is ready we can adopt it.
         ILOG(Info, Support) << "CheckRunner " << mDeviceName
                             << " received a tobject named " << tobj->GetName()
                             << " from " << input.binding << ENDM;
+        array = std::make_shared<TObjArray>();
+        array->Add(tobj.release()); // the array does not own it, it will be adopted by a MonitorObject below
       }
 
       // for each item of the array, check whether it is a MonitorObject. If not, create one and encapsulate.
@@ -289,6 +351,7 @@ void CheckRunner::prepareCacheData(framework::InputRecord& inputRecord)
       bool store = mInputStoreSet.count(DataSpecUtils::label(input)) > 0; // Check if this CheckRunner stores this input
       for (const auto tObject : *array) {
         std::shared_ptr<MonitorObject> mo{ dynamic_cast<MonitorObject*>(tObject) };
+        bool adHoc = mo == nullptr;
 
         if (mo == nullptr) {
           ILOG(Info, Support) << "The MO is null, probably a TObject could not be casted into an MO." << ENDM;
@@ -299,8 +362,17 @@ void CheckRunner::prepareCacheData(framework::InputRecord& inputRecord)
 
         if (mo) {
           mo->setIsOwner(true);
-          mMonitorObjects[mo->getFullName()] = mo;
-          updatePolicyManager.updateObjectRevision(mo->getFullName());
+          auto& slot = getCacheSlot(*mo);
+          auto& cached = *slot.monitorObject;
+          // If nobody else uses the previous version of a histogram received alone (e.g. it is not waiting in the
+          // storage queue), we keep it to deserialize the next payload of this input into it.
+          if (!isArray && adHoc && cached != nullptr && cached.use_count() == 1 && cached->getObject() != nullptr && cached->getObject()->InheritsFrom(TH1::Class())) {
+            cached->setIsOwner(false);
+            mSpareObjects[inputIndex].reset(cached->getObject());
+            cached->setObject(nullptr);
+          }
+          cached = mo;
+          updatePolicyManager.updateObjectRevision(slot.objectId);
           mTotalNumberObjectsReceived++;
 
           if (store) { // Monitor Object will be stored later, after possible beautification
@@ -312,6 +384,21 @@ void CheckRunner::prepareCacheData(framework::InputRecord& inputRecord)
   }
 }
 
+CheckRunner::CacheSlot& CheckRunner::getCacheSlot(const MonitorObject& mo)
+{
+  auto taskIndex = mCacheIndex.find(mo.getTaskName());
+  if (taskIndex == mCacheIndex.end()) {
+    taskIndex = mCacheIndex.emplace(mo.getTaskName(), std::map<std::string, CacheSlot, std::less<>>{}).first;
+  }
+  auto slot = taskIndex->second.find(std::string_view(mo.GetName()));
+  if (slot == taskIndex->second.end()) {
+    auto fullName = mo.getFullName();
+    CacheSlot newSlot{ &mMonitorObjects[fullName], updatePolicyManager.getObjectId(fullName) };
+    slot = taskIndex->second.emplace(mo.GetName(), newSlot).first;
+  }
+  return slot->second;
+}
+
 void CheckRunner::sendPeriodicMonitoring()
 {
   if (mTimer.isTimeout()) {
@@ -323,6 +410,19 @@ void CheckRunner::sendPeriodicMonitoring()
                        .addValue(mTotalNumberQOStored, "qos"));
     mCollector->send({ mTotalQOSent, "qc_checkrunner_qo_sent" });
     mCollector->send({ mTimerTotalDurationActivity.getTime(), "qc_checkrunner_duration" });
+#ifdef QC_WITH_LATENCY_HISTOGRAMS
+    mLatencyHistograms->send(*mCollector);
+#endif
+    if (auto asyncDatabase = dynamic_cast<AsyncDatabase*>(mDatabase.get())) {
+      auto statistics = asyncDatabase->getAndResetStatistics();
+      mCollector->send(Metric{ "qc_checkrunner_storage_queue" }
+                         .addValue(static_cast<uint64_t>(statistics.queueDepth), "depth")
+                         .addValue(static_cast<uint64_t>(statistics.coalesced), "coalesced")
+                         .addValue(static_cast<uint64_t>(statistics.dropped), "dropped")
+                         .addValue(static_cast<uint64_t>(statistics.failed), "failed")
+                         .addValue(statistics.meanQueueLatencyMs, "latency_mean_ms")
+                         .addValue(statistics.maxQueueLatencyMs, "latency_max_ms"));
+    }
   }
 }
 
@@ -331,20 +431,62 @@ QualityObjectsType CheckRunner::check()
   ILOG(Info, Support) << "Trying " << mChecks.size() << " checks for " << mMonitorObjects.size() << " monitor objects"
                       << ENDM;
 
-  QualityObjectsType allQOs;
-  for (auto& [checkName, check] : mChecks) {
-    if (updatePolicyManager.isReady(check.getName())) {
-      auto newQOs = check.check(mMonitorObjects);
-      mTotalNumberCheckExecuted += newQOs.size();
+  // only the checks affected by the received objects are returned, in the same order as mChecks
+  auto readyChecks = updatePolicyManager.getReadyActors();
+  ILOG(Debug, Devel) << readyChecks.size() << " checks out of " << mChecks.size() << " are ready" << ENDM;
+
+  std::vector<QualityObjectsType> qualityObjectsPerCheck(readyChecks.size());
+  auto runCheck = [&](size_t index, bool beautifyObjects) {
+    qualityObjectsPerCheck[index] = mChecks.at(readyChecks[index]).check(mMonitorObjects, beautifyObjects);
+  };
+
+  if (mCheckPool != nullptr && readyChecks.size() > 1) {
+    // The thread-safe checks are given to the pool, the other ones are executed meanwhile in this thread.
+    // The MonitorObjects can be shared between checks, so they are beautified only once all the checks are done.
+    std::vector<std::future<void>> pendingChecks;
+    for (size_t i = 0; i < readyChecks.size(); ++i) {
+      if (mChecks.at(readyChecks[i]).isThreadSafe()) {
+        pendingChecks.push_back(mCheckPool->submit([&runCheck, i]() { runCheck(i, false); }));
+      }
+    }
+    std::exception_ptr error;
+    for (size_t i = 0; i < readyChecks.size(); ++i) {
+      if (!mChecks.at(readyChecks[i]).isThreadSafe()) {
+        try {
+          runCheck(i, false);
+        } catch (...) {
+          error = error ? error : std::current_exception();
+        }
+      }
+    }
+    // all the checks must have finished before we leave, even if one of them failed
+    for (auto& pendingCheck : pendingChecks) {
+      try {
+        pendingCheck.get();
+      } catch (...) {
+        error = error ? error : std::current_exception();
+      }
+    }
+    if (error) {
+      std::rethrow_exception(error);
+    }
+    for (size_t i = 0; i < readyChecks.size(); ++i) {
+      mChecks.at(readyChecks[i]).beautify(qualityObjectsPerCheck[i], mMonitorObjects);
+    }
+  } else {
+    for (size_t i = 0; i < readyChecks.size(); ++i) {
+      runCheck(i, true);
+    }
+  }
 
-      allQOs.insert(allQOs.end(), std::make_move_iterator(newQOs.begin()), std::make_move_iterator(newQOs.end()));
-      newQOs.clear();
+  QualityObjectsType allQOs;
+  for (size_t i = 0; i < readyChecks.size(); ++i) {
+    auto& newQOs = qualityObjectsPerCheck[i];
+    mTotalNumberCheckExecuted += newQOs.size();
+    allQOs.insert(allQOs.end(), std::make_move_iterator(newQOs.begin()), std::make_move_iterator(newQOs.end()));
 
-      // Was checked, update latest revision
-      updatePolicyManager.updateActorRevision(checkName);
-    } else {
-      ILOG(Info, Support) << "Monitor Objects for the check '" << checkName << "' are not ready, ignoring" << ENDM;
-    }
+    // Was checked, update latest revision
+    updatePolicyManager.updateActorRevision(readyChecks[i]);
   }
   return allQOs;
 }
@@ -426,8 +568,10 @@ void CheckRunner::updateServiceDiscovery(const QualityObjectsType& qualityObject
 
 void CheckRunner::initDatabase()
 {
-  mDatabase = DatabaseFactory::create(mConfig.database.at("implementation"));
-  mDatabase->connect(mConfig.database);
+  mDatabase = DatabaseFactory::createAndConnect(mConfig.database);
+#ifdef QC_WITH_LATENCY_HISTOGRAMS
+  mDatabase->setLatencyHistograms(*mLatencyHistograms);
+#endif
   ILOG(Info, Support) << "Database that is going to be used : " << ENDM;
   ILOG(Info, Support) << ">> Implementation : " << mConfig.database.at("implementation") << ENDM;
   ILOG(Info, Support) << ">> Host : " << mConfig.database.at("host") << ENDM;
@@ -500,6 +644,9 @@ void CheckRunner::start(const ServiceRegistry& services)
 void CheckRunner::stop()
 {
   ILOG(Info, Ops) << "Stopping run " << mActivity.mId << ENDM;
+  if (auto asyncDatabase = dynamic_cast<AsyncDatabase*>(mDatabase.get())) {
+    asyncDatabase->flush();
+  }
 }
 
 void CheckRunner::reset()
@@ -92,7 +92,8 @@ CheckRunnerConfig CheckRunnerFactory::extractConfig(const CommonSpec& commonSpec
     commonSpec.activityPeriodName,
     commonSpec.activityPassName,
     commonSpec.activityProvenance,
-    options
+    options,
+    commonSpec.checkRunnerThreads
   };
 }
 
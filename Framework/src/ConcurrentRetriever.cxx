@@ -0,0 +1,131 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   ConcurrentRetriever.cxx
+///
+
+#include "QualityControl/ConcurrentRetriever.h"
+#include "QualityControl/DatabaseInterface.h"
+#include "QualityControl/MonitorObject.h"
+#include "QualityControl/QualityObject.h"
+#include "QualityControl/ThreadPool.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <future>
+#include <mutex>
+#include <TROOT.h>
+
+using namespace o2::quality_control::core;
+
+namespace o2::quality_control::postprocessing
+{
+
+namespace
+{
+ConcurrentRetriever::Result fetch(repository::DatabaseInterface& repository, const ConcurrentRetriever::Request& request)
+{
+  ConcurrentRetriever::Result result;
+  if (request.type == ConcurrentRetriever::Request::Type::MonitorObject) {
+    result.mo = repository.retrieveMO(request.path, request.name, request.timestamp, request.activity);
+  } else {
+    result.qo = repository.retrieveQO(request.path, request.timestamp, request.activity);
+  }
+  return result;
+}
+} // namespace
+
+ConcurrentRetriever::ConcurrentRetriever(size_t maxConcurrency) : mMaxConcurrency(std::max<size_t>(maxConcurrency, 1))
+{
+  if (mMaxConcurrency > 1) {
+    // the objects are deserialized by ROOT in the worker threads
+    ROOT::EnableThreadSafety();
+    mPool = std::make_unique<ThreadPool>(mMaxConcurrency);
+  }
+}
+
+ConcurrentRetriever::~ConcurrentRetriever() = default;
+
+void ConcurrentRetriever::retrieve(repository::DatabaseInterface& repository, const std::vector<Request>& requests, const Callback& callback)
+{
+  if (!mPool) {
+    for (size_t i = 0; i < requests.size(); i++) {
+      auto result = fetch(repository, requests[i]);
+      callback(i, result);
+    }
+    return;
+  }
+
+  std::mutex mutex;
+  std::condition_variable arrived;
+  std::deque<size_t> arrivals;
+  std::vector<Result> results(requests.size());
+  std::exception_ptr retrievalError;
+
+  // The pool size limits the number of requests in flight, the other ones wait in its queue.
+  std::vector<std::future<void>> retrievals;
+  retrievals.reserve(requests.size());
+  for (size_t i = 0; i < requests.size(); i++) {
+    retrievals.push_back(mPool->submit([&, i]() {
+      Result result;
+      std::exception_ptr error;
+      try {
+        result = fetch(repository, requests[i]);
+      } catch (...) {
+        error = std::current_exception();
+      }
+      std::lock_guard<std::mutex> lock(mutex);
+      results[i] = std::move(result);
+      if (error && !retrievalError) {
+        retrievalError = error;
+      }
+      arrivals.push_back(i);
+      arrived.notify_one();
+    }));
+  }
+
+  std::exception_ptr callbackError;
+  for (size_t handled = 0; handled < requests.size(); handled++) {
+    size_t index;
+    bool failed;
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      arrived.wait(lock, [&]() { return !arrivals.empty(); });
+      index = arrivals.front();
+      arrivals.pop_front();
+      failed = retrievalError != nullptr;
+    }
+    if (!failed && !callbackError) {
+      try {
+        callback(index, results[index]);
+      } catch (...) {
+        callbackError = std::current_exception();
+      }
+    }
+    results[index] = {};
+  }
+  // the tasks still refer to the local variables until they return
+  for (auto& retrieval : retrievals) {
+    retrieval.wait();
+  }
+
+  if (retrievalError) {
+    std::rethrow_exception(retrievalError);
+  }
+  if (callbackError) {
+    std::rethrow_exception(callbackError);
+  }
+}
+
+} // namespace o2::quality_control::postprocessing
@@ -0,0 +1,194 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   ConditionsService.cxx
+///
+
+#include "QualityControl/ConditionsService.h"
+#include "QualityControl/QcInfoLogger.h"
+
+#include <CCDB/CcdbApi.h>
+#include <TROOT.h>
+#include <algorithm>
+#include <exception>
+
+namespace o2::quality_control::core
+{
+
+namespace
+{
+
+constexpr auto validUntilKey = "Valid-Until";
+// Objects valid for a long time are still retrieved once in a while, it also keeps the deadlines far from overflows.
+constexpr std::chrono::hours longestValidity{ 24 };
+
+std::string makeKey(const std::type_info& type, const std::string& path, const std::map<std::string, std::string>& metadata)
+{
+  std::string key = std::string(type.name()) + ":" + path;
+  for (const auto& [name, value] : metadata) {
+    key += "/" + name + "=" + value;
+  }
+  return key;
+}
+
+} // namespace
+
+ConditionsService::ConditionsService(Retriever retriever, std::chrono::milliseconds retryInterval)
+  : mRetriever(std::move(retriever)), mRetryInterval(retryInterval)
+{
+  // the objects are deserialized in the background thread, while the tasks use ROOT in theirs
+  ROOT::EnableThreadSafety();
+  mThread = std::thread(&ConditionsService::run, this);
+}
+
+ConditionsService::~ConditionsService()
+{
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mStopping = true;
+  }
+  mChanged.notify_all();
+  mThread.join();
+}
+
+std::shared_ptr<ConditionsService> ConditionsService::getInstance(const std::string& databaseUrl)
+{
+  static std::mutex instancesMutex;
+  static std::map<std::string, std::weak_ptr<ConditionsService>> instances;
+
+  std::lock_guard<std::mutex> lock(instancesMutex);
+  if (auto instance = instances[databaseUrl].lock()) {
+    return instance;
+  }
+
+  auto api = std::make_shared<o2::ccdb::CcdbApi>();
+  api->init(databaseUrl);
+  if (!api->isHostReachable()) {
+    ILOG(Warning, Support) << "CCDB at URL '" << databaseUrl << "' is not reachable." << ENDM;
+  }
+  auto instance = std::make_shared<ConditionsService>(
+    [api](const std::type_info& type, const std::string& path, const std::map<std::string, std::string>& metadata,
+          std::map<std::string, std::string>& headers) {
+      return api->retrieveFromTFile(type, path, metadata, -1, &headers, "", "", "");
+    });
+  instances[databaseUrl] = instance;
+  return instance;
+}
+
+void ConditionsService::prefetch(const std::type_info& type, const std::string& path, const std::map<std::string, std::string>& metadata, Deleter deleter)
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  request(type, path, metadata, deleter);
+}
+
+std::shared_ptr<const void> ConditionsService::get(const std::type_info& type, const std::string& path, const std::map<std::string, std::string>& metadata, Deleter deleter,
+                                                   std::chrono::milliseconds timeout)
+{
+  std::unique_lock<std::mutex> lock(mMutex);
+  auto& condition = request(type, path, metadata, deleter);
+  if (!mChanged.wait_for(lock, timeout, [&]() { return condition.retrieved || mStopping; })) {
+    ILOG(Warning, Support) << "The condition '" << path << "' could not be retrieved within " << timeout.count()
+                           << " ms, it is still being retrieved in the background" << ENDM;
+  }
+  return condition.object;
+}
+
+size_t ConditionsService::getNumberRetrievals() const
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  return mNumberRetrievals;
+}
+
+ConditionsService::Condition& ConditionsService::request(const std::type_info& type, const std::string& path, const std::map<std::string, std::string>& metadata, Deleter deleter)
+{
+  auto key = makeKey(type, path, metadata);
+  if (auto existing = mConditions.find(key); existing != mConditions.end()) {
+    return existing->second;
+  }
+  auto& condition = mConditions[key];
+  condition.type = &type;
+  condition.path = path;
+  condition.metadata = metadata;
+  condition.deleter = deleter;
+  condition.nextUpdate = std::chrono::steady_clock::now();
+  mChanged.notify_all();
+  return condition;
+}
+
+void ConditionsService::run()
+{
+  std::unique_lock<std::mutex> lock(mMutex);
+  while (!mStopping) {
+    Condition* next = nullptr;
+    for (auto& [key, condition] : mConditions) {
+      if (next == nullptr || condition.nextUpdate < next->nextUpdate) {
+        next = &condition;
+      }
+    }
+    if (next == nullptr) {
+      mChanged.wait(lock);
+    } else if (next->nextUpdate > std::chrono::steady_clock::now()) {
+      mChanged.wait_until(lock, next->nextUpdate);
+    } else {
+      retrieve(*next, lock);
+    }
+  }
+}
+
+void ConditionsService::retrieve(Condition& condition, std::unique_lock<std::mutex>& lock)
+{
+  // the condition stays in the map and only this thread modifies it, so it can be read without the lock
+  mNumberRetrievals++;
+  lock.unlock();
+  std::shared_ptr<const void> object;
+  std::map<std::string, std::string> headers;
+  std::string error = "not found";
+  try {
+    if (auto* retrieved = mRetriever(*condition.type, condition.path, condition.metadata, headers)) {
+      object = std::shared_ptr<const void>(retrieved, condition.deleter);
+    }
+  } catch (const std::exception& exception) {
+    error = exception.what();
+  }
+
+  auto now = std::chrono::steady_clock::now();
+  auto nextUpdate = now + mRetryInterval;
+  if (object == nullptr) {
+    ILOG(Warning, Support) << "Could not retrieve the condition '" << condition.path << "' (" << error
+                           << "), it will be tried again in " << mRetryInterval.count() << " ms" << ENDM;
+  } else if (auto validUntil = headers.find(validUntilKey); validUntil != headers.end()) {
+    try {
+      auto currentTime = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch());
+      auto remaining = std::chrono::milliseconds(std::stoll(validUntil->second)) - currentTime;
+      if (remaining > std::chrono::milliseconds::zero()) {
+        nextUpdate = now + std::min<std::chrono::milliseconds>(remaining, longestValidity);
+      }
+    } catch (const std::exception&) {
+      ILOG(Warning, Support) << "The condition '" << condition.path << "' has an invalid '" << validUntilKey << "' header" << ENDM;
+    }
+  } else {
+    nextUpdate = now + longestValidity;
+  }
+
+  lock.lock();
+  if (object != nullptr) {
+    // after a failed refresh, the tasks keep using the previous version
+    condition.object = std::move(object);
+  }
+  condition.retrieved = true;
+  condition.nextUpdate = nextUpdate;
+  lock.unlock();
+  mChanged.notify_all();
+  lock.lock();
+}
+
+} // namespace o2::quality_control::core
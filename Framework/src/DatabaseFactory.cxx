@@ -20,6 +20,8 @@
 #include <Common/Exceptions.h>
 // QC
 #include "QualityControl/DummyDatabase.h"
+#include "QualityControl/AsyncDatabase.h"
+#include "QualityControl/CachingDatabase.h"
 #include "QualityControl/DatabaseFactory.h"
 #include "QualityControl/QcInfoLogger.h"
 #ifdef _WITH_MYSQL
@@ -56,4 +58,28 @@ std::unique_ptr<DatabaseInterface> DatabaseFactory::create(std::string name)
   return nullptr;
 }
 
+std::unique_ptr<DatabaseInterface> DatabaseFactory::createAndConnect(const std::unordered_map<std::string, std::string>& config)
+{
+  const auto& implementation = config.at("implementation");
+  // The cache is applied directly on the backend, so that the asynchronous storage can still be found at the top.
+  auto createBackend = [implementation, caching = CachingDatabase::isEnabled(config), cacheConfig = CachingDatabase::extractConfig(config)]() -> std::unique_ptr<DatabaseInterface> {
+    if (caching) {
+      return std::make_unique<CachingDatabase>(DatabaseFactory::create(implementation), cacheConfig);
+    }
+    return DatabaseFactory::create(implementation);
+  };
+  if (CachingDatabase::isEnabled(config)) {
+    ILOG(Info, Support) << "Object cache selected" << ENDM;
+  }
+  std::unique_ptr<DatabaseInterface> database;
+  if (AsyncDatabase::isEnabled(config)) {
+    ILOG(Info, Support) << "Asynchronous storage selected" << ENDM;
+    database = std::make_unique<AsyncDatabase>(createBackend, AsyncDatabase::extractConfig(config));
+  } else {
+    database = createBackend();
+  }
+  database->connect(config);
+  return database;
+}
+
 } // namespace o2::quality_control::repository
@@ -16,6 +16,9 @@
 
 #include "QualityControl/DatabaseHelpers.h"
 #include <boost/property_tree/ptree.hpp>
+#include <rapidjson/error/en.h>
+#include <rapidjson/reader.h>
+#include <stdexcept>
 
 namespace o2::quality_control::repository::database_helpers
 {
@@ -90,4 +93,131 @@ core::Activity asActivity(const boost::property_tree::ptree& tree, const std::st
   return activity;
 }
 
+namespace
+{
+
+/// Handles the events of the JSON parser, filling a ListedVersion for each element of the "objects" array.
+class ListingHandler : public rapidjson::BaseReaderHandler<rapidjson::UTF8<>, ListingHandler>
+{
+ public:
+  ListingHandler(const std::function<bool(const core::Activity&)>& accept, const std::string& provenance, std::vector<ListedVersion>& versions)
+    : mAccept(accept), mProvenance(provenance), mVersions(versions)
+  {
+  }
+
+  bool StartObject()
+  {
+    mDepth++;
+    if (isVersion()) {
+      mVersion = ListedVersion{};
+      mVersion.activity.mProvenance = mProvenance;
+    }
+    return true;
+  }
+
+  bool EndObject(rapidjson::SizeType)
+  {
+    if (isVersion() && mAccept(mVersion.activity)) {
+      mVersions.push_back(std::move(mVersion));
+    }
+    mDepth--;
+    return true;
+  }
+
+  bool StartArray()
+  {
+    mDepth++;
+    if (mDepth == 2) {
+      mInObjects = mKey == "objects";
+    }
+    return true;
+  }
+
+  bool EndArray(rapidjson::SizeType)
+  {
+    if (mDepth == 2) {
+      mInObjects = false;
+    }
+    mDepth--;
+    return true;
+  }
+
+  bool Key(const char* key, rapidjson::SizeType length, bool)
+  {
+    mKey.assign(key, length);
+    return true;
+  }
+
+  bool String(const char* value, rapidjson::SizeType length, bool)
+  {
+    if (isVersion()) {
+      setField(std::string(value, length));
+    }
+    return true;
+  }
+
+  bool Int(int value) { return handleNumber(std::to_string(value)); }
+  bool Uint(unsigned value) { return handleNumber(std::to_string(value)); }
+  bool Int64(int64_t value) { return handleNumber(std::to_string(value)); }
+  bool Uint64(uint64_t value) { return handleNumber(std::to_string(value)); }
+
+  // the other values (e.g. booleans, null) are not used
+  bool Default() { return true; }
+
+ private:
+  // in an element of the "objects" array of the top-level object, not in a nested object or array
+  bool isVersion() const { return mInObjects && mDepth == 3; }
+
+  // the numbers are handled as the strings, the metadata can be given as either of them
+  bool handleNumber(const std::string& value)
+  {
+    if (isVersion()) {
+      setField(value);
+    }
+    return true;
+  }
+
+  void setField(const std::string& value)
+  {
+    auto& activity = mVersion.activity;
+    if (mKey == "RunType") {
+      activity.mType = std::strtol(value.c_str(), nullptr, 10);
+    } else if (mKey == "RunNumber") {
+      activity.mId = std::strtol(value.c_str(), nullptr, 10);
+    } else if (mKey == "PassName") {
+      activity.mPassName = value;
+    } else if (mKey == "PeriodName") {
+      activity.mPeriodName = value;
+    } else if (mKey == "Valid-From") {
+      activity.mValidity.setMin(std::strtoull(value.c_str(), nullptr, 10));
+    } else if (mKey == "Valid-Until") {
+      activity.mValidity.setMax(std::strtoull(value.c_str(), nullptr, 10));
+    } else if (mKey == "Created") {
+      mVersion.created = std::strtoull(value.c_str(), nullptr, 10);
+    }
+  }
+
+  const std::function<bool(const core::Activity&)>& mAccept;
+  const std::string& mProvenance;
+  std::vector<ListedVersion>& mVersions;
+  int mDepth = 0;
+  bool mInObjects = false;
+  std::string mKey;
+  ListedVersion mVersion;
+};
+
+} // namespace
+
+std::vector<ListedVersion> parseListing(const std::string& listing, const std::function<bool(const core::Activity&)>& accept, const std::string& provenance)
+{
+  std::vector<ListedVersion> versions;
+  ListingHandler handler(accept, provenance, versions);
+  rapidjson::Reader reader;
+  rapidjson::StringStream stream(listing.c_str());
+  if (auto result = reader.Parse(stream, handler); result.IsError()) {
+    throw std::runtime_error(std::string("Could not parse the listing: ") + rapidjson::GetParseError_En(result.Code()) + " at offset " + std::to_string(result.Offset()));
+  }
+  return versions;
+}
+
 } // namespace o2::quality_control::repository::database_helpers
\ No newline at end of file
@@ -0,0 +1,140 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   DerivedObjects.cxx
+///
+
+#include "QualityControl/DerivedObjects.h"
+#include "QualityControl/MonitorObject.h"
+#include "QualityControl/MonitorObjectCollection.h"
+#include "QualityControl/QcInfoLogger.h"
+
+#include <TH1.h>
+#include <boost/algorithm/string.hpp>
+#include <mutex>
+#include <unordered_map>
+
+namespace o2::quality_control::core::derived_objects
+{
+
+const std::string gFunctionKey = "qc_derived_function";
+const std::string gSourcesKey = "qc_derived_sources";
+
+namespace
+{
+
+Function makeDivision(Option_t* option)
+{
+  return [option](TObject& derived, const std::vector<const TObject*>& sources) {
+    auto histogram = dynamic_cast<TH1*>(&derived);
+    auto numerator = sources.size() == 2 ? dynamic_cast<const TH1*>(sources[0]) : nullptr;
+    auto denominator = sources.size() == 2 ? dynamic_cast<const TH1*>(sources[1]) : nullptr;
+    if (histogram == nullptr || numerator == nullptr || denominator == nullptr) {
+      throw std::runtime_error("A division expects a derived histogram and two source histograms");
+    }
+    histogram->Reset();
+    histogram->Divide(numerator, denominator, 1, 1, option);
+  };
+}
+
+struct Registry {
+  std::mutex mutex;
+  std::unordered_map<std::string, Function> functions{
+    { "ratio", makeDivision("") },
+    { "efficiency", makeDivision("B") }
+  };
+};
+
+Registry& registry()
+{
+  static Registry registry;
+  return registry;
+}
+
+Function getFunction(const std::string& name)
+{
+  auto& reg = registry();
+  std::lock_guard<std::mutex> lock(reg.mutex);
+  auto it = reg.functions.find(name);
+  return it != reg.functions.end() ? it->second : Function{};
+}
+
+} // namespace
+
+void registerFunction(const std::string& name, Function function)
+{
+  auto& reg = registry();
+  std::lock_guard<std::mutex> lock(reg.mutex);
+  reg.functions[name] = std::move(function);
+}
+
+bool isRegistered(const std::string& name)
+{
+  auto& reg = registry();
+  std::lock_guard<std::mutex> lock(reg.mutex);
+  return reg.functions.count(name) > 0;
+}
+
+bool isComputable(const MonitorObject& mo)
+{
+  const auto& metadata = mo.getMetadataMap();
+  auto function = metadata.find(gFunctionKey);
+  return function != metadata.end() && isRegistered(function->second);
+}
+
+void declare(MonitorObject& mo, const std::string& functionName, const std::vector<std::string>& sourceNames)
+{
+  mo.addOrUpdateMetadata(gFunctionKey, functionName);
+  mo.addOrUpdateMetadata(gSourcesKey, boost::algorithm::join(sourceNames, ","));
+}
+
+bool compute(MonitorObject& mo, const MonitorObjectCollection& collection)
+{
+  const auto& metadata = mo.getMetadataMap();
+  auto functionName = metadata.find(gFunctionKey);
+  auto sourcesNames = metadata.find(gSourcesKey);
+  if (functionName == metadata.end() || sourcesNames == metadata.end() || mo.getObject() == nullptr) {
+    return false;
+  }
+  auto function = getFunction(functionName->second);
+  if (!function) {
+    return false;
+  }
+
+  std::vector<std::string> names;
+  boost::algorithm::split(names, sourcesNames->second, boost::is_any_of(","));
+  std::vector<const TObject*> sources;
+  for (const auto& name : names) {
+    auto source = dynamic_cast<const MonitorObject*>(collection.FindObject(name.c_str()));
+    if (source == nullptr || source->getObject() == nullptr) {
+      ILOG(Warning, Devel) << "The source '" << name << "' of the derived object '" << mo.getName() << "' is missing" << ENDM;
+      return false;
+    }
+    sources.push_back(source->getObject());
+  }
+  function(*mo.getObject(), sources);
+  return true;
+}
+
+size_t computeAll(MonitorObjectCollection& collection)
+{
+  size_t computed = 0;
+  for (auto obj : collection) {
+    auto mo = dynamic_cast<MonitorObject*>(obj);
+    if (mo != nullptr && compute(*mo, collection)) {
+      computed++;
+    }
+  }
+  return computed;
+}
+
+} // namespace o2::quality_control::core::derived_objects
@@ -78,6 +78,11 @@ TObject* DummyDatabase::retrieveTObject(std::string, const std::map<std::string,
   return nullptr;
 }
 
+std::map<std::string, std::string> DummyDatabase::retrieveHeaders(const std::string&, const std::map<std::string, std::string>&, long)
+{
+  return {};
+}
+
 std::string DummyDatabase::retrieveJson(std::string, long, const std::map<std::string, std::string>&)
 {
   return std::string();
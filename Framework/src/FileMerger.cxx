@@ -0,0 +1,217 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   FileMerger.cxx
+///
+
+#include "QualityControl/FileMerger.h"
+#include "QualityControl/QcInfoLogger.h"
+#include "QualityControl/MonitorObjectCollection.h"
+#include "QualityControl/RootFileHelpers.h"
+#include "QualityControl/ThreadPool.h"
+
+#include <atomic>
+#include <future>
+#include <optional>
+#include <set>
+#include <boost/exception/diagnostic_information.hpp>
+#include <TFile.h>
+#include <TROOT.h>
+
+namespace o2::quality_control::core::file_merger
+{
+
+namespace
+{
+
+/// Reads all the MonitorObjectCollections in the file. Returns nullopt if the file could not be opened.
+std::optional<std::vector<std::unique_ptr<MonitorObjectCollection>>> readInputFile(const std::string& inputFilePath, const ErrorHandler& handleError)
+{
+  auto* file = TFile::Open(inputFilePath.c_str(), "READ");
+  if (file == nullptr) {
+    handleError("File handler for '" + inputFilePath + "' is nullptr.");
+    return std::nullopt;
+  }
+  if (file->IsZombie()) {
+    delete file;
+    handleError("File '" + inputFilePath + "' is zombie.");
+    return std::nullopt;
+  }
+  if (!file->IsOpen()) {
+    delete file;
+    handleError("Failed to open the file: " + inputFilePath);
+    return std::nullopt;
+  }
+  ILOG(Debug) << "Input file '" << inputFilePath << "' successfully open." << ENDM;
+
+  std::vector<std::unique_ptr<MonitorObjectCollection>> inputMOCs;
+  for (const auto& name : root_file_helpers::listMonitorObjectCollections(*file)) {
+    try {
+      if (auto inputMOC = root_file_helpers::readMonitorObjectCollection(*file, name)) {
+        inputMOCs.push_back(std::move(inputMOC));
+      }
+    } catch (const std::runtime_error& ex) {
+      handleError(std::string("Could not read the input MonitorObjectCollection: ") + ex.what());
+    }
+  }
+  file->Close();
+  delete file;
+  return inputMOCs;
+}
+
+void mergeInto(MonitorObjectCollectionMap& mergedMocMap, std::unique_ptr<MonitorObjectCollection> inputMOC, bool exitOnError)
+{
+  auto& mergedMOC = mergedMocMap[inputMOC->GetName()];
+  if (mergedMOC == nullptr) {
+    mergedMOC = std::move(inputMOC);
+    return;
+  }
+  try {
+    mergedMOC->merge(inputMOC.get());
+  } catch (...) {
+    if (exitOnError) {
+      throw;
+    } else {
+      ILOG(Error, Ops) << "Exception caught: " << boost::current_exception_diagnostic_information(true) << ENDM;
+      ILOG(Error, Ops) << "Failed to merge the Monitor Object Collection, but will try to continue." << ENDM;
+    }
+  }
+}
+
+/// Merges the files one after another, the next file is read in the background while the current one is merged.
+MonitorObjectCollectionMap mergeSequence(const std::vector<std::string>& inputFilePaths, const ErrorHandler& handleError, bool exitOnError, std::atomic<size_t>& filesRead)
+{
+  MonitorObjectCollectionMap mergedMocMap;
+  if (inputFilePaths.empty()) {
+    return mergedMocMap;
+  }
+  auto nextFile = std::async(std::launch::async, readInputFile, inputFilePaths[0], handleError);
+  for (size_t i = 0; i < inputFilePaths.size(); i++) {
+    auto inputMOCs = nextFile.get();
+    if (i + 1 < inputFilePaths.size()) {
+      nextFile = std::async(std::launch::async, readInputFile, inputFilePaths[i + 1], handleError);
+    }
+    if (!inputMOCs.has_value()) {
+      continue;
+    }
+    for (auto& inputMOC : inputMOCs.value()) {
+      mergeInto(mergedMocMap, std::move(inputMOC), exitOnError);
+    }
+    filesRead++;
+  }
+  return mergedMocMap;
+}
+
+/// Each thread merges a contiguous range of the input files, then the partial results are merged pairwise.
+/// The order of merging is kept, so the result is the same as the one of merging the files one after another,
+/// apart from the rounding of floating point sums.
+MonitorObjectCollectionMap mergeInParallel(const std::vector<std::string>& inputFilePaths, TFile& outputFile, size_t threads,
+                                           const ErrorHandler& handleError, bool exitOnError, size_t& filesRead)
+{
+  ROOT::EnableThreadSafety();
+  std::atomic<size_t> filesReadCounter = 0;
+  // the first one is reserved for the objects already present in the output file
+  std::vector<MonitorObjectCollectionMap> partials(threads + 1);
+  std::vector<std::future<void>> tasks;
+  // declared last, so the threads are joined before the data they use is destroyed
+  ThreadPool pool(threads);
+  for (size_t t = 0; t < threads; t++) {
+    auto begin = inputFilePaths.begin() + t * inputFilePaths.size() / threads;
+    auto end = inputFilePaths.begin() + (t + 1) * inputFilePaths.size() / threads;
+    tasks.push_back(pool.submit([&, t, range = std::vector<std::string>(begin, end)]() {
+      partials[t + 1] = mergeSequence(range, handleError, exitOnError, filesReadCounter);
+    }));
+  }
+  for (auto& task : tasks) {
+    task.get();
+  }
+  filesRead = filesReadCounter;
+
+  std::set<std::string> names;
+  for (const auto& partial : partials) {
+    for (const auto& [name, moc] : partial) {
+      names.insert(name);
+    }
+  }
+  for (const auto& name : names) {
+    try {
+      if (auto mergedMOC = root_file_helpers::readMonitorObjectCollection(outputFile, name)) {
+        ILOG(Info) << "Read merged object '" << mergedMOC->GetName() << "'" << ENDM;
+        partials[0][name] = std::move(mergedMOC);
+      }
+    } catch (const std::runtime_error& ex) {
+      handleError(std::string("Could not read the merged MonitorObjectCollection, skipping: ") + ex.what());
+      for (auto& partial : partials) {
+        partial.erase(name);
+      }
+    }
+  }
+
+  while (partials.size() > 1) {
+    tasks.clear();
+    for (size_t i = 0; i + 1 < partials.size(); i += 2) {
+      tasks.push_back(pool.submit([&, i]() {
+        for (auto& [name, moc] : partials[i + 1]) {
+          mergeInto(partials[i], std::move(moc), exitOnError);
+        }
+      }));
+    }
+    for (auto& task : tasks) {
+      task.get();
+    }
+    std::vector<MonitorObjectCollectionMap> remaining;
+    for (size_t i = 0; i < partials.size(); i += 2) {
+      remaining.push_back(std::move(partials[i]));
+    }
+    partials = std::move(remaining);
+  }
+  return std::move(partials[0]);
+}
+
+} // namespace
+
+MonitorObjectCollectionMap mergeFiles(const std::vector<std::string>& inputFilePaths, TFile& outputFile, size_t threads,
+                                      const ErrorHandler& handleError, bool exitOnError, size_t& filesRead)
+{
+  filesRead = 0;
+  if (threads > 1) {
+    return mergeInParallel(inputFilePaths, outputFile, threads, handleError, exitOnError, filesRead);
+  }
+
+  MonitorObjectCollectionMap mergedMocMap;
+  for (const auto& inputFilePath : inputFilePaths) {
+    auto inputMOCs = readInputFile(inputFilePath, handleError);
+    if (!inputMOCs.has_value()) {
+      continue;
+    }
+    for (auto& inputMOC : inputMOCs.value()) {
+      if (mergedMocMap.count(inputMOC->GetName()) == 0) {
+        std::unique_ptr<MonitorObjectCollection> mergedMOC;
+        try {
+          mergedMOC = root_file_helpers::readMonitorObjectCollection(outputFile, inputMOC->GetName());
+        } catch (const std::runtime_error& ex) {
+          handleError(std::string("Could not read the merged MonitorObjectCollection, skipping: ") + ex.what());
+          continue;
+        }
+        if (mergedMOC != nullptr) {
+          ILOG(Info) << "Read merged object '" << mergedMOC->GetName() << "'" << ENDM;
+          mergedMocMap[mergedMOC->GetName()] = std::move(mergedMOC);
+        }
+      }
+      mergeInto(mergedMocMap, std::move(inputMOC), exitOnError);
+    }
+    filesRead++;
+  }
+  return mergedMocMap;
+}
+
+} // namespace o2::quality_control::core::file_merger
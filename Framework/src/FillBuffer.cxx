@@ -0,0 +1,200 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   FillBuffer.cxx
+///
+
+#include "QualityControl/FillBuffer.h"
+
+#include <TArrayD.h>
+#include <TArrayF.h>
+#include <TH1.h>
+#include <TH2.h>
+#include <TProfile.h>
+#include <TProfile2D.h>
+#include <stdexcept>
+#include <string>
+
+namespace o2::quality_control::core
+{
+
+namespace
+{
+
+/// Same result as TAxis::FindFixBin, in a loop without branches which the compiler can vectorize.
+/// NaN goes to the overflow, like in ROOT.
+void computeBins(const double* values, size_t n, int nBins, double min, double max, int* bins)
+{
+  const double width = max - min;
+  const double last = nBins - 1;
+  for (size_t i = 0; i < n; i++) {
+    const double value = values[i];
+    double position = nBins * (value - min) / width;
+    position = position > 0 ? position : 0; // also drops NaN, so that the conversion is defined
+    position = position < last ? position : last;
+    const int bin = 1 + static_cast<int>(position);
+    bins[i] = value < min ? 0 : (value < max ? bin : nBins + 1);
+  }
+}
+
+bool hasFixedBins(const TAxis* axis)
+{
+  return axis->GetXbins()->GetSize() == 0 && !axis->TestBit(TAxis::kAxisRange);
+}
+
+} // namespace
+
+template <int Dimension>
+FillBuffer<Dimension>::FillBuffer(TH1* histogram, size_t capacity)
+  : mHistogram(histogram), mCapacity(capacity > 0 ? capacity : 1)
+{
+  if (histogram == nullptr) {
+    throw std::invalid_argument("FillBuffer: the histogram is null");
+  }
+  if (histogram->GetDimension() != Dimension) {
+    throw std::invalid_argument(std::string("FillBuffer: the histogram ") + histogram->GetName() + " has " +
+                                std::to_string(histogram->GetDimension()) + " dimension(s), expected " + std::to_string(Dimension));
+  }
+  if (histogram->InheritsFrom(TProfile::Class()) || histogram->InheritsFrom(TProfile2D::Class())) {
+    throw std::invalid_argument(std::string("FillBuffer: profiles are not supported (") + histogram->GetName() + ")");
+  }
+  mX.reserve(mCapacity);
+  mWeights.reserve(mCapacity);
+  if constexpr (Dimension == 2) {
+    mY.reserve(mCapacity);
+  }
+}
+
+template <int Dimension>
+void FillBuffer<Dimension>::flush()
+{
+  if (mX.empty()) {
+    return;
+  }
+  if (canFillInBulk()) {
+    fillInBulk();
+  } else {
+    fillOneByOne();
+  }
+  clear();
+}
+
+template <int Dimension>
+void FillBuffer<Dimension>::clear()
+{
+  mX.clear();
+  mY.clear();
+  mWeights.clear();
+  mWeighted = false;
+}
+
+template <int Dimension>
+bool FillBuffer<Dimension>::canFillInBulk() const
+{
+  // the histograms which buffer their entries or extend their axes have to be filled one by one
+  if (mHistogram->GetBuffer() != nullptr || mHistogram->CanExtendAllAxes()) {
+    return false;
+  }
+  const auto* histogramClass = mHistogram->IsA();
+  if constexpr (Dimension == 1) {
+    return (histogramClass == TH1F::Class() || histogramClass == TH1D::Class()) && hasFixedBins(mHistogram->GetXaxis());
+  } else {
+    return (histogramClass == TH2F::Class() || histogramClass == TH2D::Class()) && hasFixedBins(mHistogram->GetXaxis()) && hasFixedBins(mHistogram->GetYaxis());
+  }
+}
+
+template <int Dimension>
+void FillBuffer<Dimension>::fillInBulk()
+{
+  const size_t n = mX.size();
+  const auto* xAxis = mHistogram->GetXaxis();
+  const int nx = xAxis->GetNbins();
+  mBins.resize(n);
+  computeBins(mX.data(), n, nx, xAxis->GetXmin(), xAxis->GetXmax(), mBins.data());
+  int ny = 0;
+  if constexpr (Dimension == 2) {
+    const auto* yAxis = mHistogram->GetYaxis();
+    ny = yAxis->GetNbins();
+    mBinsY.resize(n);
+    computeBins(mY.data(), n, ny, yAxis->GetXmin(), yAxis->GetXmax(), mBinsY.data());
+  }
+
+  // the statistics are read before the contents change, otherwise they could be recomputed from them
+  const double entries = mHistogram->GetEntries();
+  Double_t stats[TH1::kNstat] = { 0 };
+  mHistogram->GetStats(stats);
+
+  // same as in TH1::Fill
+  if (mWeighted && mHistogram->GetSumw2N() == 0 && !mHistogram->TestBit(TH1::kIsNotW)) {
+    mHistogram->Sumw2();
+  }
+  double* sumw2 = mHistogram->GetSumw2N() > 0 ? mHistogram->GetSumw2()->GetArray() : nullptr;
+  auto* contentD = dynamic_cast<TArrayD*>(mHistogram);
+  auto* contentF = contentD == nullptr ? dynamic_cast<TArrayF*>(mHistogram) : nullptr;
+  const bool statOverflows = mHistogram->GetStatOverflowsBehaviour();
+
+  for (size_t i = 0; i < n; i++) {
+    const double w = mWeights[i];
+    const int bx = mBins[i];
+    int bin = bx;
+    bool inRange = bx > 0 && bx <= nx;
+    if constexpr (Dimension == 2) {
+      const int by = mBinsY[i];
+      bin += (nx + 2) * by;
+      inRange = inRange && by > 0 && by <= ny;
+    }
+    if (contentD) {
+      contentD->fArray[bin] += w;
+    } else if (contentF) {
+      contentF->fArray[bin] += w;
+    } else {
+      mHistogram->AddBinContent(bin, w);
+    }
+    if (sumw2) {
+      sumw2[bin] += w * w;
+    }
+    if (!inRange && !statOverflows) {
+      continue;
+    }
+    const double x = mX[i];
+    stats[0] += w;
+    stats[1] += w * w;
+    stats[2] += w * x;
+    stats[3] += w * x * x;
+    if constexpr (Dimension == 2) {
+      const double y = mY[i];
+      stats[4] += w * y;
+      stats[5] += w * y * y;
+      stats[6] += w * x * y;
+    }
+  }
+
+  mHistogram->PutStats(stats);
+  mHistogram->SetEntries(entries + n);
+}
+
+template <int Dimension>
+void FillBuffer<Dimension>::fillOneByOne()
+{
+  for (size_t i = 0; i < mX.size(); i++) {
+    if constexpr (Dimension == 1) {
+      mHistogram->Fill(mX[i], mWeights[i]);
+    } else {
+      static_cast<TH2*>(mHistogram)->Fill(mX[i], mY[i], mWeights[i]);
+    }
+  }
+}
+
+template class FillBuffer<1>;
+template class FillBuffer<2>;
+
+} // namespace o2::quality_control::core
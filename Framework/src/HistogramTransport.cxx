@@ -0,0 +1,758 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   HistogramTransport.cxx
+///
+
+#include "QualityControl/HistogramTransport.h"
+
+#include "QualityControl/MonitorObject.h"
+#include "QualityControl/MonitorObjectCollection.h"
+#include <TArrayD.h>
+#include <TArrayF.h>
+#include <TBufferFile.h>
+#include <TH1.h>
+#include <TH2.h>
+#include <Compression.h>
+#include <RZip.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace o2::quality_control::core::histogram_transport
+{
+
+namespace
+{
+
+constexpr char gMagic[4] = { 'Q', 'C', 'H', 'T' };
+constexpr uint32_t gVersion = 2;
+constexpr uint32_t gByteOrder = 0x01020304;
+constexpr size_t gMaxCompressedBlockSize = 0xffffff; // the largest block ROOT compresses at once
+
+struct MessageHeader {
+  char magic[4];
+  uint32_t version;
+  uint32_t byteOrder;
+  uint32_t nObjects;
+  uint64_t nameSize; // the name of the collection is at the beginning of the body
+  Compression::Algorithm compression;
+  uint32_t reserved;
+  uint64_t bodySize; // everything after the header, before compression
+};
+
+enum class Bins : uint32_t {
+  Streamed = 0, // the object is entirely streamed by ROOT
+  Float = 1,
+  Double = 2
+};
+
+enum class Layout : uint32_t {
+  Dense = 0, // all the bins
+  Sparse = 1 // only the runs of non-empty bins
+};
+
+struct ObjectHeader {
+  uint64_t streamedSize; // the object streamed by ROOT, without the bins if they are copied
+  uint64_t nCells;
+  Bins bins;
+  uint32_t hasSumw2;
+  Layout layout;
+  uint32_t nRuns;
+  uint64_t nStoredCells; // the number of bins which are written, nCells with the dense layout
+};
+
+struct Run {
+  uint32_t first;
+  uint32_t length;
+};
+
+struct BlockHeader {
+  uint32_t storedSize; // equal to originalSize if the block could not be compressed
+  uint32_t originalSize;
+};
+
+size_t padded(size_t size)
+{
+  return (size + 7) & ~static_cast<size_t>(7);
+}
+
+size_t binSize(Bins bins)
+{
+  return bins == Bins::Float ? sizeof(float) : bins == Bins::Double ? sizeof(double) : 0;
+}
+
+/// Empties the arrays of the bins for the time the histogram is streamed, without freeing them.
+class HiddenBins
+{
+ public:
+  HiddenBins(TArray* contents, TArray* sumw2) : mContents(contents), mSumw2(sumw2), mContentsSize(contents->fN), mSumw2Size(sumw2 ? sumw2->fN : 0)
+  {
+    mContents->fN = 0;
+    if (mSumw2) {
+      mSumw2->fN = 0;
+    }
+  }
+  ~HiddenBins()
+  {
+    mContents->fN = mContentsSize;
+    if (mSumw2) {
+      mSumw2->fN = mSumw2Size;
+    }
+  }
+
+ private:
+  TArray* mContents;
+  TArray* mSumw2;
+  Int_t mContentsSize;
+  Int_t mSumw2Size;
+};
+
+struct PreparedObject {
+  std::unique_ptr<TBufferFile> buffer;
+  ObjectHeader header;
+  const char* contents = nullptr;
+  const char* sumw2 = nullptr;
+  std::vector<Run> runs;
+};
+
+size_t computeBinsSize(const ObjectHeader& header)
+{
+  size_t size = padded(header.nStoredCells * binSize(header.bins)) + header.nRuns * sizeof(Run);
+  if (header.hasSumw2) {
+    size += header.nStoredCells * sizeof(double);
+  }
+  return size;
+}
+
+/// Finds the runs of non-empty bins. Gaps shorter than a Run are included in the runs, they take less space.
+template <typename T>
+std::vector<Run> findRuns(const T* contents, const double* sumw2, size_t nCells, size_t cellSize)
+{
+  const size_t maxGap = sizeof(Run) / cellSize;
+  std::vector<Run> runs;
+  for (size_t cell = 0; cell < nCells; cell++) {
+    if (contents[cell] == 0 && (sumw2 == nullptr || sumw2[cell] == 0)) {
+      continue;
+    }
+    if (!runs.empty() && cell - runs.back().first - runs.back().length <= maxGap) {
+      runs.back().length = cell - runs.back().first + 1;
+    } else {
+      runs.push_back({ static_cast<uint32_t>(cell), 1 });
+    }
+  }
+  return runs;
+}
+
+/// Chooses the sparse layout if it is smaller than the dense one.
+void chooseLayout(PreparedObject& prepared)
+{
+  auto& header = prepared.header;
+  const size_t cellSize = binSize(header.bins) + (header.hasSumw2 ? sizeof(double) : 0);
+  const auto* sumw2 = header.hasSumw2 ? reinterpret_cast<const double*>(prepared.sumw2) : nullptr;
+  std::vector<Run> runs = header.bins == Bins::Float
+                            ? findRuns(reinterpret_cast<const float*>(prepared.contents), sumw2, header.nCells, cellSize)
+                            : findRuns(reinterpret_cast<const double*>(prepared.contents), sumw2, header.nCells, cellSize);
+  size_t nStoredCells = 0;
+  for (const auto& run : runs) {
+    nStoredCells += run.length;
+  }
+  ObjectHeader sparse = header;
+  sparse.layout = Layout::Sparse;
+  sparse.nRuns = runs.size();
+  sparse.nStoredCells = nStoredCells;
+  if (computeBinsSize(sparse) < computeBinsSize(header)) {
+    header = sparse;
+    prepared.runs = std::move(runs);
+  }
+}
+
+PreparedObject prepare(TObject* object)
+{
+  PreparedObject prepared;
+  prepared.buffer = std::make_unique<TBufferFile>(TBuffer::kWrite);
+  prepared.header = { 0, 0, Bins::Streamed, 0, Layout::Dense, 0, 0 };
+
+  auto* mo = dynamic_cast<MonitorObject*>(object);
+  auto* histogram = mo != nullptr ? dynamic_cast<TH1*>(mo->getObject()) : nullptr;
+  if (histogram == nullptr || !canCopyBins(histogram)) {
+    prepared.buffer->WriteObject(object);
+    prepared.header.streamedSize = prepared.buffer->Length();
+    return prepared;
+  }
+
+  auto* contents = dynamic_cast<TArray*>(histogram);
+  auto* sumw2 = histogram->GetSumw2();
+  prepared.header.nCells = contents->fN;
+  prepared.header.nStoredCells = contents->fN;
+  prepared.header.hasSumw2 = sumw2->fN == contents->fN && sumw2->fN > 0;
+  if (auto* floats = dynamic_cast<TArrayF*>(histogram)) {
+    prepared.header.bins = Bins::Float;
+    prepared.contents = reinterpret_cast<const char*>(floats->GetArray());
+  } else {
+    prepared.header.bins = Bins::Double;
+    prepared.contents = reinterpret_cast<const char*>(dynamic_cast<TArrayD*>(histogram)->GetArray());
+  }
+  prepared.sumw2 = prepared.header.hasSumw2 ? reinterpret_cast<const char*>(sumw2->GetArray()) : nullptr;
+  chooseLayout(prepared);
+  {
+    HiddenBins hidden(contents, prepared.header.hasSumw2 ? sumw2 : nullptr);
+    prepared.buffer->WriteObject(object);
+  }
+  prepared.header.streamedSize = prepared.buffer->Length();
+  return prepared;
+}
+
+size_t computeSize(const ObjectHeader& header)
+{
+  return sizeof(ObjectHeader) + padded(header.streamedSize) + computeBinsSize(header);
+}
+
+class Writer
+{
+ public:
+  explicit Writer(char* destination) : mBegin(destination), mPosition(destination) {}
+
+  /// Writes the data and the padding which aligns what follows to 8 bytes.
+  void write(const void* data, size_t size)
+  {
+    append(data, size);
+    pad();
+  }
+
+  /// Writes the data without padding, a series of append() has to be followed by pad().
+  void append(const void* data, size_t size)
+  {
+    if (size > 0) {
+      std::memcpy(mPosition, data, size);
+      mPosition += size;
+    }
+  }
+
+  void pad()
+  {
+    size_t written = mPosition - mBegin;
+    size_t padding = padded(written) - written;
+    std::memset(mPosition, 0, padding);
+    mPosition += padding;
+  }
+
+ private:
+  char* mBegin;
+  char* mPosition;
+};
+
+void writeBody(char* destination, const std::string& name, const std::vector<PreparedObject>& objects)
+{
+  Writer writer(destination);
+  writer.write(name.data(), name.size());
+  for (const auto& object : objects) {
+    const auto& header = object.header;
+    const size_t cellSize = binSize(header.bins);
+    writer.write(&header, sizeof(ObjectHeader));
+    writer.write(object.buffer->Buffer(), header.streamedSize);
+    if (header.layout == Layout::Dense) {
+      writer.write(object.contents, header.nCells * cellSize);
+      if (header.hasSumw2) {
+        writer.write(object.sumw2, header.nCells * sizeof(double));
+      }
+      continue;
+    }
+    writer.write(object.runs.data(), object.runs.size() * sizeof(Run));
+    for (const auto& run : object.runs) {
+      writer.append(object.contents + run.first * cellSize, run.length * cellSize);
+    }
+    writer.pad();
+    if (header.hasSumw2) {
+      for (const auto& run : object.runs) {
+        writer.append(object.sumw2 + run.first * sizeof(double), run.length * sizeof(double));
+      }
+    }
+  }
+}
+
+ROOT::RCompressionSetting::EAlgorithm::EValues toRootAlgorithm(Compression::Algorithm algorithm)
+{
+  switch (algorithm) {
+    case Compression::Algorithm::Zlib:
+      return ROOT::RCompressionSetting::EAlgorithm::kZLIB;
+    case Compression::Algorithm::LZMA:
+      return ROOT::RCompressionSetting::EAlgorithm::kLZMA;
+    case Compression::Algorithm::LZ4:
+      return ROOT::RCompressionSetting::EAlgorithm::kLZ4;
+    case Compression::Algorithm::ZSTD:
+      return ROOT::RCompressionSetting::EAlgorithm::kZSTD;
+    default:
+      throw std::invalid_argument("No ROOT compression algorithm for " + std::to_string(static_cast<uint32_t>(algorithm)));
+  }
+}
+
+/// Compresses the body in blocks, each one preceded by a BlockHeader.
+std::vector<char> compress(std::vector<char>& body, const Compression& compression)
+{
+  const auto algorithm = toRootAlgorithm(compression.algorithm);
+  std::vector<char> compressed;
+  compressed.reserve(body.size() / 2);
+  for (size_t offset = 0; offset < body.size(); offset += gMaxCompressedBlockSize) {
+    int originalSize = static_cast<int>(std::min(gMaxCompressedBlockSize, body.size() - offset));
+    size_t headerPosition = compressed.size();
+    compressed.resize(headerPosition + sizeof(BlockHeader) + originalSize);
+    char* target = compressed.data() + headerPosition + sizeof(BlockHeader);
+
+    // the target is smaller than the block, so that ROOT gives up when the block does not get smaller
+    int sourceSize = originalSize;
+    int targetSize = originalSize - 1;
+    int storedSize = 0;
+    R__zipMultipleAlgorithm(compression.level, &sourceSize, body.data() + offset, &targetSize, target, &storedSize, algorithm);
+    if (storedSize <= 0 || storedSize >= originalSize) {
+      std::memcpy(target, body.data() + offset, originalSize);
+      storedSize = originalSize;
+    }
+    BlockHeader blockHeader{ static_cast<uint32_t>(storedSize), static_cast<uint32_t>(originalSize) };
+    std::memcpy(compressed.data() + headerPosition, &blockHeader, sizeof(BlockHeader));
+    compressed.resize(headerPosition + sizeof(BlockHeader) + storedSize);
+  }
+  return compressed;
+}
+
+std::vector<char> decompress(const char* data, size_t size, size_t bodySize)
+{
+  std::vector<char> body(bodySize);
+  size_t position = 0;
+  size_t output = 0;
+  while (output < bodySize) {
+    BlockHeader blockHeader;
+    if (sizeof(BlockHeader) > size - position) {
+      throw std::runtime_error("The compressed payload of the histograms is truncated");
+    }
+    std::memcpy(&blockHeader, data + position, sizeof(BlockHeader));
+    position += sizeof(BlockHeader);
+    if (blockHeader.storedSize > size - position || blockHeader.originalSize > bodySize - output || blockHeader.storedSize > blockHeader.originalSize) {
+      throw std::runtime_error("Invalid block in the compressed payload of the histograms");
+    }
+    if (blockHeader.storedSize == blockHeader.originalSize) {
+      std::memcpy(body.data() + output, data + position, blockHeader.storedSize);
+    } else {
+      int sourceSize = static_cast<int>(blockHeader.storedSize);
+      int targetSize = static_cast<int>(blockHeader.originalSize);
+      int decompressedSize = 0;
+      R__unzip(&sourceSize, reinterpret_cast<unsigned char*>(const_cast<char*>(data + position)), &targetSize,
+               reinterpret_cast<unsigned char*>(body.data() + output), &decompressedSize);
+      if (decompressedSize != targetSize) {
+        throw std::runtime_error("Could not decompress the payload of the histograms");
+      }
+    }
+    position += blockHeader.storedSize;
+    output += blockHeader.originalSize;
+  }
+  if (position != size) {
+    throw std::runtime_error("Unexpected data after the compressed payload of the histograms");
+  }
+  return body;
+}
+
+class Reader
+{
+ public:
+  Reader(const char* payload, size_t size) : mPayload(payload), mSize(size) {}
+
+  const char* read(size_t size)
+  {
+    if (size > mSize - mPosition) {
+      throw std::runtime_error("The payload of the histograms is truncated (" + std::to_string(mSize) + " bytes)");
+    }
+    auto data = mPayload + mPosition;
+    mPosition += std::min(padded(size), mSize - mPosition);
+    return data;
+  }
+
+  template <typename T>
+  T readStruct()
+  {
+    T value;
+    std::memcpy(&value, read(sizeof(T)), sizeof(T));
+    return value;
+  }
+
+ private:
+  const char* mPayload;
+  size_t mSize;
+  size_t mPosition = 0;
+};
+
+/// Allocates the arrays of the bins of a histogram which has been streamed without them.
+/// @return The contents and the sumw2 (or nullptr), filled with zeros.
+std::pair<char*, char*> allocateBins(TH1* histogram, const ObjectHeader& header)
+{
+  char* contents = nullptr;
+  if (header.bins == Bins::Float) {
+    auto* floats = dynamic_cast<TArrayF*>(histogram);
+    floats->Set(header.nCells);
+    contents = reinterpret_cast<char*>(floats->GetArray());
+  } else {
+    auto* doubles = dynamic_cast<TArrayD*>(histogram);
+    doubles->Set(header.nCells);
+    contents = reinterpret_cast<char*>(doubles->GetArray());
+  }
+  char* sumw2 = nullptr;
+  if (header.hasSumw2) {
+    histogram->GetSumw2()->Set(header.nCells);
+    sumw2 = reinterpret_cast<char*>(histogram->GetSumw2()->GetArray());
+  }
+  return { contents, sumw2 };
+}
+
+void readBins(Reader& reader, TH1* histogram, const ObjectHeader& header)
+{
+  if (histogram == nullptr || !canCopyBins(histogram) || (header.bins == Bins::Float) != (dynamic_cast<TArrayF*>(histogram) != nullptr) || header.nCells != static_cast<uint64_t>(histogram->GetNcells())) {
+    throw std::runtime_error("The bins of an encoded object do not match its type");
+  }
+  const size_t cellSize = binSize(header.bins);
+  if (header.layout == Layout::Dense) {
+    auto contents = reader.read(header.nCells * cellSize);
+    auto sumw2 = header.hasSumw2 ? reader.read(header.nCells * sizeof(double)) : nullptr;
+    auto [contentsArray, sumw2Array] = allocateBins(histogram, header);
+    std::memcpy(contentsArray, contents, header.nCells * cellSize);
+    if (header.hasSumw2) {
+      std::memcpy(sumw2Array, sumw2, header.nCells * sizeof(double));
+    }
+    return;
+  }
+
+  std::vector<Run> runs(header.nRuns);
+  std::memcpy(runs.data(), reader.read(header.nRuns * sizeof(Run)), header.nRuns * sizeof(Run));
+  uint64_t nStoredCells = 0;
+  for (const auto& run : runs) {
+    if (static_cast<uint64_t>(run.first) + run.length > header.nCells) {
+      throw std::runtime_error("A run of encoded bins is outside of the histogram");
+    }
+    nStoredCells += run.length;
+  }
+  if (nStoredCells != header.nStoredCells) {
+    throw std::runtime_error("The runs of encoded bins do not match the number of bins");
+  }
+  auto contents = reader.read(header.nStoredCells * cellSize);
+  auto sumw2 = header.hasSumw2 ? reader.read(header.nStoredCells * sizeof(double)) : nullptr;
+  auto [contentsArray, sumw2Array] = allocateBins(histogram, header);
+  for (const auto& run : runs) {
+    std::memcpy(contentsArray + run.first * cellSize, contents, run.length * cellSize);
+    contents += run.length * cellSize;
+    if (header.hasSumw2) {
+      std::memcpy(sumw2Array + run.first * sizeof(double), sumw2, run.length * sizeof(double));
+      sumw2 += run.length * sizeof(double);
+    }
+  }
+}
+
+/// Header of the bins written after a collection streamed by writeCollection().
+struct CopiedBinsHeader {
+  uint32_t byteOrder;
+  uint32_t nHistograms;
+  Compression::Algorithm compression;
+  uint32_t reserved;
+  uint64_t bodySize;   // the bins of all the histograms, before compression
+  uint64_t storedSize; // what follows the histogram headers
+};
+
+struct CopiedHistogramHeader {
+  uint32_t index; // of the MonitorObject in the collection
+  Bins bins;
+  uint32_t hasSumw2;
+  uint32_t reserved;
+  uint64_t nCells;
+};
+
+struct CopiedHistogram {
+  CopiedHistogramHeader header;
+  TArray* contents;
+  TArray* sumw2;
+  const char* contentsData;
+  const char* sumw2Data;
+};
+
+size_t computeBinsSize(const CopiedHistogramHeader& header)
+{
+  return header.nCells * (binSize(header.bins) + (header.hasSumw2 ? sizeof(double) : 0));
+}
+
+void readBuffer(TBuffer& buffer, void* destination, size_t size)
+{
+  if (size > 0 && buffer.ReadBuf(destination, static_cast<Int_t>(size)) != static_cast<Int_t>(size)) {
+    throw std::runtime_error("The copied bins of the histograms are truncated");
+  }
+}
+
+} // namespace
+
+Compression Compression::fromString(const std::string& algorithm, int level)
+{
+  static const std::vector<std::pair<std::string, Algorithm>> algorithms{
+    { "none", Algorithm::None },
+    { "zlib", Algorithm::Zlib },
+    { "lzma", Algorithm::LZMA },
+    { "lz4", Algorithm::LZ4 },
+    { "zstd", Algorithm::ZSTD }
+  };
+  auto found = std::find_if(algorithms.begin(), algorithms.end(), [&algorithm](const auto& pair) { return pair.first == algorithm; });
+  if (found == algorithms.end()) {
+    throw std::invalid_argument("Unknown compression algorithm '" + algorithm + "', it should be none, zlib, lzma, lz4 or zstd");
+  }
+  if (level < 1 || level > 9) {
+    throw std::invalid_argument("The compression level should be between 1 and 9, not " + std::to_string(level));
+  }
+  return { found->second, level };
+}
+
+bool canCopyBins(const TObject* object)
+{
+  if (object == nullptr) {
+    return false;
+  }
+  // the derived classes (e.g. profiles) have other arrays, they are streamed
+  auto* objectClass = object->IsA();
+  return objectClass == TH1F::Class() || objectClass == TH1D::Class() || objectClass == TH2F::Class() || objectClass == TH2D::Class();
+}
+
+EncodedSize encode(const MonitorObjectCollection& collection, const std::function<char*(size_t)>& allocate, const Compression& compression)
+{
+  std::vector<PreparedObject> objects;
+  objects.reserve(collection.GetEntriesFast());
+  for (auto* object : collection) {
+    if (object != nullptr) {
+      objects.push_back(prepare(object));
+    }
+  }
+
+  std::string name = collection.GetName();
+  MessageHeader messageHeader;
+  std::memcpy(messageHeader.magic, gMagic, sizeof(gMagic));
+  messageHeader.version = gVersion;
+  messageHeader.byteOrder = gByteOrder;
+  messageHeader.nObjects = objects.size();
+  messageHeader.nameSize = name.size();
+  messageHeader.compression = compression.algorithm;
+  messageHeader.reserved = 0;
+  messageHeader.bodySize = padded(name.size());
+  for (const auto& object : objects) {
+    messageHeader.bodySize += computeSize(object.header);
+  }
+
+  EncodedSize size;
+  size.uncompressed = sizeof(MessageHeader) + messageHeader.bodySize;
+  if (compression.algorithm == Compression::Algorithm::None) {
+    // written directly in the message
+    char* payload = allocate(size.uncompressed);
+    std::memcpy(payload, &messageHeader, sizeof(MessageHeader));
+    writeBody(payload + sizeof(MessageHeader), name, objects);
+    size.payload = size.uncompressed;
+    return size;
+  }
+
+  std::vector<char> body(messageHeader.bodySize);
+  writeBody(body.data(), name, objects);
+  auto compressed = compress(body, compression);
+  size.payload = sizeof(MessageHeader) + compressed.size();
+  char* payload = allocate(size.payload);
+  std::memcpy(payload, &messageHeader, sizeof(MessageHeader));
+  std::memcpy(payload + sizeof(MessageHeader), compressed.data(), compressed.size());
+  return size;
+}
+
+bool isEncoded(const char* payload, size_t size)
+{
+  return payload != nullptr && size >= sizeof(MessageHeader) && std::memcmp(payload, gMagic, sizeof(gMagic)) == 0;
+}
+
+std::unique_ptr<MonitorObjectCollection> decode(const char* payload, size_t size)
+{
+  if (!isEncoded(payload, size)) {
+    throw std::runtime_error("The payload does not contain encoded histograms");
+  }
+  MessageHeader messageHeader;
+  std::memcpy(&messageHeader, payload, sizeof(MessageHeader));
+  if (messageHeader.version != gVersion) {
+    throw std::runtime_error("Unsupported version of the encoded histograms: " + std::to_string(messageHeader.version));
+  }
+  if (messageHeader.byteOrder != gByteOrder) {
+    throw std::runtime_error("The histograms have been encoded on a machine with another byte order");
+  }
+
+  const char* body = payload + sizeof(MessageHeader);
+  size_t bodySize = size - sizeof(MessageHeader);
+  std::vector<char> decompressed;
+  if (messageHeader.compression != Compression::Algorithm::None) {
+    decompressed = decompress(body, bodySize, messageHeader.bodySize);
+    body = decompressed.data();
+    bodySize = decompressed.size();
+  }
+  Reader reader(body, bodySize);
+
+  auto collection = std::make_unique<MonitorObjectCollection>();
+  collection->SetOwner(true);
+  collection->SetName(std::string(reader.read(messageHeader.nameSize), messageHeader.nameSize).c_str());
+  for (uint32_t i = 0; i < messageHeader.nObjects; i++) {
+    auto header = reader.readStruct<ObjectHeader>();
+    auto streamed = reader.read(header.streamedSize);
+    TBufferFile buffer(TBuffer::kRead, static_cast<Int_t>(header.streamedSize), const_cast<char*>(streamed), kFALSE);
+    std::unique_ptr<TObject> object(buffer.ReadObject(TObject::Class()));
+    if (object == nullptr) {
+      throw std::runtime_error("Could not read an encoded object");
+    }
+    auto* mo = dynamic_cast<MonitorObject*>(object.get());
+    if (mo != nullptr) {
+      mo->setIsOwner(true);
+    }
+    if (header.bins != Bins::Streamed) {
+      readBins(reader, mo != nullptr ? dynamic_cast<TH1*>(mo->getObject()) : nullptr, header);
+    }
+    collection->Add(object.release());
+  }
+  return collection;
+}
+
+EncodedSize writeCollection(TBuffer& buffer, MonitorObjectCollection& collection, bool copyBins, const Compression& compression)
+{
+  const Int_t start = buffer.Length();
+  std::vector<CopiedHistogram> histograms;
+  for (Int_t i = 0; copyBins && i <= collection.GetAbsLast(); i++) {
+    auto* mo = dynamic_cast<MonitorObject*>(collection.UncheckedAt(i));
+    auto* histogram = mo != nullptr ? dynamic_cast<TH1*>(mo->getObject()) : nullptr;
+    if (!canCopyBins(histogram)) {
+      continue;
+    }
+    auto* contents = dynamic_cast<TArray*>(histogram);
+    auto* sumw2 = histogram->GetSumw2();
+    CopiedHistogram copied{ { static_cast<uint32_t>(i), Bins::Double, sumw2->fN == contents->fN && sumw2->fN > 0, 0, static_cast<uint64_t>(contents->fN) }, contents, nullptr, nullptr, nullptr };
+    if (auto* floats = dynamic_cast<TArrayF*>(histogram)) {
+      copied.header.bins = Bins::Float;
+      copied.contentsData = reinterpret_cast<const char*>(floats->GetArray());
+    } else {
+      copied.contentsData = reinterpret_cast<const char*>(dynamic_cast<TArrayD*>(histogram)->GetArray());
+    }
+    if (copied.header.hasSumw2) {
+      copied.sumw2 = sumw2;
+      copied.sumw2Data = reinterpret_cast<const char*>(sumw2->GetArray());
+    }
+    histograms.push_back(copied);
+  }
+
+  {
+    std::vector<std::unique_ptr<HiddenBins>> hidden;
+    hidden.reserve(histograms.size());
+    for (const auto& histogram : histograms) {
+      hidden.push_back(std::make_unique<HiddenBins>(histogram.contents, histogram.sumw2));
+    }
+    collection.TObjArray::Streamer(buffer);
+  }
+
+  CopiedBinsHeader header{ gByteOrder, static_cast<uint32_t>(histograms.size()), compression.algorithm, 0, 0, 0 };
+  for (const auto& histogram : histograms) {
+    header.bodySize += computeBinsSize(histogram.header);
+  }
+  std::vector<char> compressed;
+  if (compression.algorithm != Compression::Algorithm::None && header.bodySize > 0) {
+    std::vector<char> body;
+    body.reserve(header.bodySize);
+    for (const auto& histogram : histograms) {
+      body.insert(body.end(), histogram.contentsData, histogram.contentsData + histogram.header.nCells * binSize(histogram.header.bins));
+      if (histogram.header.hasSumw2) {
+        body.insert(body.end(), histogram.sumw2Data, histogram.sumw2Data + histogram.header.nCells * sizeof(double));
+      }
+    }
+    compressed = compress(body, compression);
+    header.storedSize = compressed.size();
+  } else {
+    header.compression = Compression::Algorithm::None;
+    header.storedSize = header.bodySize;
+  }
+
+  buffer.WriteBuf(&header, sizeof(CopiedBinsHeader));
+  for (const auto& histogram : histograms) {
+    buffer.WriteBuf(&histogram.header, sizeof(CopiedHistogramHeader));
+  }
+  if (header.compression != Compression::Algorithm::None) {
+    buffer.WriteBuf(compressed.data(), static_cast<Int_t>(compressed.size()));
+  } else {
+    // copied directly from the histograms
+    for (const auto& histogram : histograms) {
+      buffer.WriteBuf(histogram.contentsData, static_cast<Int_t>(histogram.header.nCells * binSize(histogram.header.bins)));
+      if (histogram.header.hasSumw2) {
+        buffer.WriteBuf(histogram.sumw2Data, static_cast<Int_t>(histogram.header.nCells * sizeof(double)));
+      }
+    }
+  }
+
+  EncodedSize size;
+  size.payload = buffer.Length() - start;
+  size.uncompressed = size.payload - header.storedSize + header.bodySize;
+  return size;
+}
+
+void readCollection(TBuffer& buffer, MonitorObjectCollection& collection)
+{
+  collection.TObjArray::Streamer(buffer);
+
+  CopiedBinsHeader header;
+  readBuffer(buffer, &header, sizeof(CopiedBinsHeader));
+  if (header.nHistograms == 0) {
+    return;
+  }
+  if (header.byteOrder != gByteOrder) {
+    throw std::runtime_error("The histograms have been streamed on a machine with another byte order");
+  }
+  std::vector<CopiedHistogramHeader> histograms(header.nHistograms);
+  readBuffer(buffer, histograms.data(), histograms.size() * sizeof(CopiedHistogramHeader));
+  uint64_t bodySize = 0;
+  for (const auto& histogram : histograms) {
+    bodySize += computeBinsSize(histogram);
+  }
+  if (bodySize != header.bodySize) {
+    throw std::runtime_error("The size of the copied bins does not match the histograms");
+  }
+  std::vector<char> body;
+  if (header.compression != Compression::Algorithm::None) {
+    std::vector<char> compressed(header.storedSize);
+    readBuffer(buffer, compressed.data(), compressed.size());
+    body = decompress(compressed.data(), compressed.size(), header.bodySize);
+  } else if (header.storedSize != header.bodySize) {
+    throw std::runtime_error("The size of the copied bins does not match the histograms");
+  }
+
+  size_t position = 0;
+  for (const auto& histogram : histograms) {
+    auto* mo = histogram.index <= static_cast<uint32_t>(collection.GetAbsLast()) ? dynamic_cast<MonitorObject*>(collection.UncheckedAt(histogram.index)) : nullptr;
+    auto* th1 = mo != nullptr ? dynamic_cast<TH1*>(mo->getObject()) : nullptr;
+    if (th1 == nullptr || !canCopyBins(th1) || (histogram.bins == Bins::Float) != (dynamic_cast<TArrayF*>(th1) != nullptr) || histogram.nCells != static_cast<uint64_t>(th1->GetNcells())) {
+      throw std::runtime_error("The copied bins of an object do not match its type");
+    }
+    ObjectHeader objectHeader{ 0, histogram.nCells, histogram.bins, histogram.hasSumw2, Layout::Dense, 0, histogram.nCells };
+    auto [contents, sumw2] = allocateBins(th1, objectHeader);
+    const size_t contentsSize = histogram.nCells * binSize(histogram.bins);
+    const size_t sumw2Size = histogram.hasSumw2 ? histogram.nCells * sizeof(double) : 0;
+    if (body.empty()) {
+      readBuffer(buffer, contents, contentsSize);
+      readBuffer(buffer, sumw2, sumw2Size);
+    } else {
+      std::memcpy(contents, body.data() + position, contentsSize);
+      if (sumw2Size > 0) {
+        std::memcpy(sumw2, body.data() + position + contentsSize, sumw2Size);
+      }
+      position += contentsSize + sumw2Size;
+    }
+  }
+}
+
+} // namespace o2::quality_control::core::histogram_transport
@@ -284,10 +284,11 @@ framework::WorkflowSpec InfrastructureGenerator::generateLocalBatchInfrastructur
 
   if (fileSinkInputs.size() > 0) {
     // todo: could be moved to a factory.
+    RootFileSink::Config fileSinkConfig{ infrastructureSpec.common.fileSinkStreaming, infrastructureSpec.common.fileSinkFlushPeriodSeconds };
     workflow.push_back({ "qc-root-file-sink",
                          std::move(fileSinkInputs),
                          Outputs{},
-                         adaptFromTask<RootFileSink>(sinkFilePath),
+                         adaptFromTask<RootFileSink>(sinkFilePath, fileSinkConfig),
                          Options{},
                          CommonServices::defaultServices(),
                          { RootFileSink::getLabel() } });
@@ -71,6 +71,9 @@ CommonSpec InfrastructureSpecReader::readSpecEntry<CommonSpec>(std::string, cons
   spec.infologgerFilterDiscardDebug = commonTree.get<bool>("infologger.filterDiscardDebug", spec.infologgerFilterDiscardDebug);
   spec.infologgerDiscardLevel = commonTree.get<int>("infologger.filterDiscardLevel", spec.infologgerDiscardLevel);
   spec.postprocessingPeriod = commonTree.get<double>("postprocessing.period", spec.postprocessingPeriod);
+  spec.checkRunnerThreads = commonTree.get<int>("checkRunner.threads", spec.checkRunnerThreads);
+  spec.fileSinkStreaming = commonTree.get<bool>("fileSink.streaming", spec.fileSinkStreaming);
+  spec.fileSinkFlushPeriodSeconds = commonTree.get<double>("fileSink.flushPeriodSeconds", spec.fileSinkFlushPeriodSeconds);
 
   return spec;
 }
@@ -95,6 +98,12 @@ TaskSpec InfrastructureSpecReader::readSpecEntry<TaskSpec>(std::string taskID, c
   ts.maxNumberCycles = taskTree.get<int>("maxNumberCycles", ts.maxNumberCycles);
   ts.resetAfterCycles = taskTree.get<size_t>("resetAfterCycles", ts.resetAfterCycles);
   ts.saveObjectsToFile = taskTree.get<std::string>("saveObjectsToFile", ts.saveObjectsToFile);
+  ts.deltaPublication = taskTree.get<bool>("deltaPublication", ts.deltaPublication);
+  ts.deltaPublicationKeyframeCycles = taskTree.get<int>("deltaPublicationKeyframeCycles", ts.deltaPublicationKeyframeCycles);
+  ts.monitorDataThreads = taskTree.get<int>("monitorDataThreads", ts.monitorDataThreads);
+  ts.copyHistogramBins = taskTree.get<bool>("copyHistogramBins", ts.copyHistogramBins);
+  ts.publicationCompression = taskTree.get<std::string>("publicationCompression", ts.publicationCompression);
+  ts.publicationCompressionLevel = taskTree.get<int>("publicationCompressionLevel", ts.publicationCompressionLevel);
   if (taskTree.count("taskParameters") > 0) {
     for (const auto& [key, value] : taskTree.get_child("taskParameters")) {
       ts.customParameters.emplace(key, value.get_value<std::string>());
@@ -247,6 +256,7 @@ CheckSpec InfrastructureSpecReader::readSpecEntry<CheckSpec>(std::string checkID
   }
 
   cs.active = checkTree.get<bool>("active", cs.active);
+  cs.threadSafe = checkTree.get<bool>("threadSafe", cs.threadSafe);
   if (checkTree.count("checkParameters") > 0) {
     for (const auto& [key, value] : checkTree.get_child("checkParameters")) {
       cs.customParameters.emplace(key, value.get_value<std::string>());
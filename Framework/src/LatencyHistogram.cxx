@@ -0,0 +1,117 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   LatencyHistogram.cxx
+///
+
+#include "QualityControl/LatencyHistogram.h"
+
+#include <Monitoring/Monitoring.h>
+#include <algorithm>
+
+using namespace o2::monitoring;
+
+namespace o2::quality_control::core
+{
+
+size_t LatencyHistogram::bucketIndex(uint64_t value)
+{
+  if (value < kSubBuckets) {
+    return value;
+  }
+  size_t msb = 63 - __builtin_clzll(value);
+  size_t shift = msb - kSubBucketBits;
+  return (shift + 1) * kSubBuckets + ((value >> shift) - kSubBuckets);
+}
+
+uint64_t LatencyHistogram::bucketUpperBound(size_t index)
+{
+  if (index < kSubBuckets) {
+    return index;
+  }
+  size_t shift = index / kSubBuckets - 1;
+  uint64_t lowerBound = (kSubBuckets + index % kSubBuckets) << shift;
+  return lowerBound + ((uint64_t(1) << shift) - 1);
+}
+
+void LatencyHistogram::record(uint64_t microseconds)
+{
+  mBuckets[bucketIndex(microseconds)].fetch_add(1, std::memory_order_relaxed);
+  auto max = mMax.load(std::memory_order_relaxed);
+  while (microseconds > max && !mMax.compare_exchange_weak(max, microseconds, std::memory_order_relaxed)) {
+  }
+}
+
+LatencyHistogram::Summary LatencyHistogram::getAndReset()
+{
+  std::array<uint64_t, kBuckets> counts;
+  Summary summary;
+  for (size_t i = 0; i < kBuckets; ++i) {
+    counts[i] = mBuckets[i].exchange(0, std::memory_order_relaxed);
+    summary.count += counts[i];
+  }
+  summary.max = mMax.exchange(0, std::memory_order_relaxed);
+  if (summary.count == 0) {
+    return summary;
+  }
+
+  auto percentile = [&](double fraction) {
+    auto rank = std::max<uint64_t>(1, static_cast<uint64_t>(fraction * summary.count + 0.5));
+    uint64_t cumulated = 0;
+    for (size_t i = 0; i < kBuckets; ++i) {
+      cumulated += counts[i];
+      if (cumulated >= rank) {
+        return std::min(bucketUpperBound(i), summary.max);
+      }
+    }
+    return summary.max;
+  };
+  summary.p50 = percentile(0.5);
+  summary.p99 = percentile(0.99);
+  return summary;
+}
+
+LatencyHistogram& LatencyHistograms::get(const std::string& name)
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  auto& histogram = mHistograms[name];
+  if (histogram == nullptr) {
+    histogram = std::make_unique<LatencyHistogram>();
+  }
+  return *histogram;
+}
+
+std::vector<std::pair<std::string, LatencyHistogram::Summary>> LatencyHistograms::getAndResetSummaries()
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  std::vector<std::pair<std::string, LatencyHistogram::Summary>> summaries;
+  for (auto& [name, histogram] : mHistograms) {
+    auto summary = histogram->getAndReset();
+    if (summary.count > 0) {
+      summaries.emplace_back(name, summary);
+    }
+  }
+  return summaries;
+}
+
+void LatencyHistograms::send(Monitoring& collector)
+{
+  for (const auto& [name, summary] : getAndResetSummaries()) {
+    collector.send(Metric{ "qc_latency_" + name }
+                     .addValue(summary.count, "count")
+                     .addValue(summary.p50, "p50_us")
+                     .addValue(summary.p99, "p99_us")
+                     .addValue(summary.max, "max_us"));
+  }
+}
+
+} // namespace o2::quality_control::core
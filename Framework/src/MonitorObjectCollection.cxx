@@ -15,10 +15,13 @@
 ///
 
 #include "QualityControl/MonitorObjectCollection.h"
+#include "QualityControl/DerivedObjects.h"
 #include "QualityControl/MonitorObject.h"
 #include "QualityControl/QcInfoLogger.h"
 
 #include <Mergers/MergerAlgorithm.h>
+#include <TBuffer.h>
+#include <cstring>
 
 using namespace o2::mergers;
 
@@ -32,6 +35,7 @@ void MonitorObjectCollection::merge(mergers::MergeInterface* const other)
     throw std::runtime_error("The other object is not a MonitorObjectCollection");
   }
 
+  bool derivedObjectsPresent = false;
   auto otherIterator = otherCollection->MakeIterator();
   while (auto otherObject = otherIterator->Next()) {
     auto otherObjectName = otherObject->GetName();
@@ -41,7 +45,10 @@ void MonitorObjectCollection::merge(mergers::MergeInterface* const other)
       // A corresponding object in the target collection was found, we try to merge.
       auto otherMO = dynamic_cast<MonitorObject*>(otherObject);
       auto targetMO = dynamic_cast<MonitorObject*>(targetObject);
-      if (otherMO && targetMO) {
+      if (otherMO && targetMO && derived_objects::isComputable(*targetMO)) {
+        // Derived objects are computed once the sources are merged.
+        derivedObjectsPresent = true;
+      } else if (otherMO && targetMO) {
         // That might be another collection or a concrete object to be merged, we walk on the collection recursively.
         algorithm::merge(targetMO->getObject(), otherMO->getObject());
       } else {
@@ -54,6 +61,10 @@ void MonitorObjectCollection::merge(mergers::MergeInterface* const other)
     }
   }
   delete otherIterator;
+
+  if (derivedObjectsPresent) {
+    derived_objects::computeAll(*this);
+  }
 }
 
 void MonitorObjectCollection::postDeserialization()
@@ -81,4 +92,135 @@ void MonitorObjectCollection::postDeserialization()
   delete it;
 }
 
+template <typename Add>
+void MonitorObjectCollection::addIndexed(TObject* obj, Int_t idx, Add add)
+{
+  auto slot = idx - LowerBound();
+  bool appended = slot > GetAbsLast();
+  bool slotFree = appended || (slot >= 0 && UncheckedAt(slot) == nullptr);
+  // an object put before another one with the same name would be the one found first
+  bool keepIndex = mIndexValid && obj != nullptr && slotFree && (appended || mIndex.count(obj->GetName()) == 0);
+
+  add(); // invalidates the index through Changed()
+
+  if (keepIndex && slot < GetSize() && UncheckedAt(slot) == obj) {
+    mIndex.emplace(obj->GetName(), obj);
+    mIndexValid = true;
+  }
+}
+
+TObject* MonitorObjectCollection::FindObject(const char* name) const
+{
+  if (name == nullptr) {
+    return nullptr;
+  }
+  if (!mIndexValid) {
+    buildIndex();
+  }
+  auto it = mIndex.find(name);
+  if (it != mIndex.end() && std::strcmp(it->second->GetName(), name) != 0) {
+    // the object was renamed after it was added
+    buildIndex();
+    it = mIndex.find(name);
+  }
+  return it != mIndex.end() ? it->second : nullptr;
+}
+
+void MonitorObjectCollection::AddFirst(TObject* obj)
+{
+  addIndexed(obj, LowerBound(), [&]() { TObjArray::AddFirst(obj); });
+}
+
+void MonitorObjectCollection::AddLast(TObject* obj)
+{
+  addIndexed(obj, GetAbsLast() + 1 + LowerBound(), [&]() { TObjArray::AddLast(obj); });
+}
+
+void MonitorObjectCollection::AddAt(TObject* obj, Int_t idx)
+{
+  addIndexed(obj, idx, [&]() { TObjArray::AddAt(obj, idx); });
+}
+
+void MonitorObjectCollection::AddAtAndExpand(TObject* obj, Int_t idx)
+{
+  addIndexed(obj, idx, [&]() { TObjArray::AddAtAndExpand(obj, idx); });
+}
+
+TObject* MonitorObjectCollection::Remove(TObject* obj)
+{
+  auto removed = TObjArray::Remove(obj);
+  mIndexValid = false;
+  return removed;
+}
+
+TObject* MonitorObjectCollection::RemoveAt(Int_t idx)
+{
+  auto removed = TObjArray::RemoveAt(idx);
+  mIndexValid = false;
+  return removed;
+}
+
+void MonitorObjectCollection::Clear(Option_t* option)
+{
+  TObjArray::Clear(option);
+  mIndex.clear();
+  mIndexValid = false;
+}
+
+void MonitorObjectCollection::Delete(Option_t* option)
+{
+  TObjArray::Delete(option);
+  mIndex.clear();
+  mIndexValid = false;
+}
+
+void MonitorObjectCollection::Changed()
+{
+  // called by TObjArray whenever the content is modified, also when reading from a buffer
+  TObjArray::Changed();
+  mIndexValid = false;
+}
+
+void MonitorObjectCollection::setCopyHistogramBins(bool copy, histogram_transport::Compression compression)
+{
+  mCopyHistogramBins = copy;
+  mBinsCompression = compression;
+}
+
+histogram_transport::EncodedSize MonitorObjectCollection::getLastStreamedSize() const
+{
+  return mLastStreamedSize;
+}
+
+void MonitorObjectCollection::Streamer(TBuffer& buffer)
+{
+  if (buffer.IsReading()) {
+    UInt_t start = 0;
+    UInt_t count = 0;
+    Version_t version = buffer.ReadVersion(&start, &count);
+    if (version < 1) {
+      // written before the bins could be copied, only TObjArray was streamed
+      buffer.ReadClassBuffer(MonitorObjectCollection::Class(), this, version, start, count);
+      return;
+    }
+    histogram_transport::readCollection(buffer, *this);
+    buffer.CheckByteCount(start, count, MonitorObjectCollection::IsA());
+  } else {
+    UInt_t count = buffer.WriteVersion(MonitorObjectCollection::IsA(), kTRUE);
+    mLastStreamedSize = histogram_transport::writeCollection(buffer, *this, mCopyHistogramBins, mBinsCompression);
+    buffer.SetByteCount(count, kTRUE);
+  }
+}
+
+void MonitorObjectCollection::buildIndex() const
+{
+  mIndex.clear();
+  for (Int_t i = 0; i <= GetAbsLast(); i++) {
+    if (auto obj = UncheckedAt(i)) {
+      mIndex.emplace(obj->GetName(), obj);
+    }
+  }
+  mIndexValid = true;
+}
+
 } // namespace o2::quality_control::core
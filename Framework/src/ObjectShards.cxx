@@ -0,0 +1,172 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   ObjectShards.cxx
+///
+
+#include "QualityControl/ObjectShards.h"
+
+#include "QualityControl/ObjectsManager.h"
+#include "QualityControl/MonitorObject.h"
+#include <Mergers/MergerAlgorithm.h>
+#include <TH1.h>
+#include <THnBase.h>
+#include <iterator>
+#include <stdexcept>
+#include <unordered_set>
+
+using namespace o2::mergers;
+
+namespace o2::quality_control::core
+{
+
+namespace
+{
+
+// the shard used by the calling thread, set by ObjectShards::runWith()
+thread_local const ObjectShards* tCurrentOwner = nullptr;
+thread_local size_t tCurrentShard = 0;
+
+bool canBeSharded(const TObject* object)
+{
+  return dynamic_cast<const TH1*>(object) != nullptr || dynamic_cast<const THnBase*>(object) != nullptr;
+}
+
+void resetObject(TObject* object)
+{
+  if (auto histogram = dynamic_cast<TH1*>(object)) {
+    histogram->Reset();
+  } else if (auto histogram = dynamic_cast<THnBase*>(object)) {
+    histogram->Reset();
+  }
+}
+
+/// The number of entries is not enough, AddBinContent() does not change it.
+bool isEmpty(const TObject* object)
+{
+  if (auto histogram = dynamic_cast<const TH1*>(object)) {
+    if (histogram->GetEntries() != 0) {
+      return false;
+    }
+    for (Int_t bin = 0; bin < histogram->GetNcells(); bin++) {
+      if (histogram->GetBinContent(bin) != 0) {
+        return false;
+      }
+    }
+    return true;
+  } else if (auto histogram = dynamic_cast<const THnBase*>(object)) {
+    if (histogram->GetEntries() != 0) {
+      return false;
+    }
+    for (Long64_t bin = 0; bin < histogram->GetNbins(); bin++) {
+      if (histogram->GetBinContent(bin) != 0) {
+        return false;
+      }
+    }
+    return true;
+  }
+  return false;
+}
+
+std::unique_ptr<TObject> makeEmptyCopy(const TObject* object)
+{
+  std::unique_ptr<TObject> copy(object->Clone());
+  if (auto histogram = dynamic_cast<TH1*>(copy.get())) {
+    histogram->SetDirectory(nullptr);
+  }
+  resetObject(copy.get());
+  return copy;
+}
+
+} // namespace
+
+ObjectShards::ShardGuard::ShardGuard(const ObjectShards* owner, size_t shard)
+{
+  if (shard >= owner->mShards) {
+    throw std::out_of_range("ObjectShards: shard " + std::to_string(shard) + " does not exist");
+  }
+  tCurrentOwner = owner;
+  tCurrentShard = shard;
+}
+
+ObjectShards::ShardGuard::~ShardGuard()
+{
+  tCurrentOwner = nullptr;
+  tCurrentShard = 0;
+}
+
+ObjectShards::ObjectShards(size_t shards) : mShards(shards > 0 ? shards : 1)
+{
+}
+
+ObjectShards::~ObjectShards() = default;
+
+void ObjectShards::update(ObjectsManager& objectsManager)
+{
+  std::unordered_set<TObject*> published;
+  for (size_t i = 0; i < objectsManager.getNumberPublishedObjects(); i++) {
+    auto* object = objectsManager.getMonitorObject(i)->getObject();
+    if (object == nullptr || !canBeSharded(object)) {
+      continue;
+    }
+    published.insert(object);
+    auto& copies = mObjects[object];
+    // a new object might have been created at the address of a deleted one
+    if (copies.shards.empty() || copies.name != object->GetName()) {
+      copies.name = object->GetName();
+      copies.shards.clear();
+      for (size_t shard = 0; shard < mShards; shard++) {
+        copies.shards.push_back(makeEmptyCopy(object));
+      }
+    }
+  }
+  // the unpublished objects might have been deleted already, they are not touched
+  for (auto it = mObjects.begin(); it != mObjects.end();) {
+    it = published.count(it->first) > 0 ? std::next(it) : mObjects.erase(it);
+  }
+}
+
+void ObjectShards::merge()
+{
+  for (auto& [object, copies] : mObjects) {
+    for (auto& copy : copies.shards) {
+      if (!isEmpty(copy.get())) {
+        algorithm::merge(object, copy.get());
+        resetObject(copy.get());
+      }
+    }
+  }
+}
+
+void ObjectShards::reset()
+{
+  for (auto& [object, copies] : mObjects) {
+    for (auto& copy : copies.shards) {
+      resetObject(copy.get());
+    }
+  }
+}
+
+TObject* ObjectShards::get(TObject* object)
+{
+  if (tCurrentOwner == nullptr) {
+    return object;
+  }
+  auto found = tCurrentOwner->mObjects.find(object);
+  if (found == tCurrentOwner->mObjects.end()) {
+    throw std::runtime_error(std::string("The object ") + (object ? object->GetName() : "(null)") +
+                             " cannot be filled concurrently, only the published histograms can");
+  }
+  return found->second.shards[tCurrentShard].get();
+}
+
+} // namespace o2::quality_control::core
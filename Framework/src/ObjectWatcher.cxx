@@ -0,0 +1,220 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   ObjectWatcher.cxx
+///
+
+#include "QualityControl/ObjectWatcher.h"
+#include "QualityControl/QcInfoLogger.h"
+
+#include <CCDB/CcdbApi.h>
+#include <algorithm>
+#include <exception>
+#include <vector>
+
+namespace o2::quality_control::postprocessing
+{
+
+namespace
+{
+
+// Key names in the header map.
+constexpr auto md5Key = "Content-MD5";
+constexpr auto validFromKey = "Valid-From";
+constexpr std::chrono::milliseconds minimumInterval{ 1 };
+
+std::string makeKey(const std::string& path, const std::map<std::string, std::string>& metadata)
+{
+  std::string key = path;
+  for (const auto& [name, value] : metadata) {
+    key += "/" + name + "=" + value;
+  }
+  return key;
+}
+
+} // namespace
+
+ObjectWatcher::Watch::Watch(std::string path, std::map<std::string, std::string> metadata)
+  : mPath(std::move(path)), mMetadata(std::move(metadata))
+{
+}
+
+ObjectWatcher::Watch::State ObjectWatcher::Watch::getState() const
+{
+  std::lock_guard<std::mutex> lock(mStateMutex);
+  return mState;
+}
+
+ObjectWatcher::ObjectWatcher(HeadersFetcher fetcher, std::chrono::milliseconds interval)
+  : mFetcher(std::move(fetcher)), mInterval(std::max(interval, minimumInterval))
+{
+  mThread = std::thread(&ObjectWatcher::run, this);
+}
+
+ObjectWatcher::~ObjectWatcher()
+{
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mStopping = true;
+  }
+  mWakeUp.notify_all();
+  mThread.join();
+}
+
+std::shared_ptr<ObjectWatcher> ObjectWatcher::getInstance(const std::string& databaseUrl, std::chrono::milliseconds interval)
+{
+  static std::mutex instancesMutex;
+  static std::map<std::string, std::weak_ptr<ObjectWatcher>> instances;
+
+  std::lock_guard<std::mutex> lock(instancesMutex);
+  if (auto instance = instances[databaseUrl].lock()) {
+    instance->requestInterval(interval);
+    return instance;
+  }
+
+  auto api = std::make_shared<o2::ccdb::CcdbApi>();
+  api->init(databaseUrl);
+  if (!api->isHostReachable()) {
+    ILOG(Error, Support) << "CCDB at URL '" << databaseUrl << "' is not reachable." << ENDM;
+  }
+  auto instance = std::make_shared<ObjectWatcher>(
+    [api](const std::string& path, const std::map<std::string, std::string>& metadata) {
+      return api->retrieveHeaders(path, metadata);
+    },
+    interval);
+  instances[databaseUrl] = instance;
+  return instance;
+}
+
+std::shared_ptr<ObjectWatcher::Watch> ObjectWatcher::watch(const std::string& path, const std::map<std::string, std::string>& metadata)
+{
+  auto key = makeKey(path, metadata);
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (auto existing = mWatches[key].lock()) {
+      return existing;
+    }
+  }
+  // the first check is done before the Watch is shared, so no trigger can see it as a change
+  std::lock_guard<std::mutex> checkLock(mCheckMutex);
+  auto watch = std::make_shared<Watch>(path, metadata);
+  check(*watch);
+  std::lock_guard<std::mutex> lock(mMutex);
+  if (auto existing = mWatches[key].lock()) {
+    return existing;
+  }
+  mWatches[key] = watch;
+  return watch;
+}
+
+void ObjectWatcher::refresh()
+{
+  std::lock_guard<std::mutex> checkLock(mCheckMutex);
+  std::vector<std::shared_ptr<Watch>> watches;
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    for (auto it = mWatches.begin(); it != mWatches.end();) {
+      if (auto watch = it->second.lock()) {
+        watches.push_back(std::move(watch));
+        ++it;
+      } else {
+        it = mWatches.erase(it);
+      }
+    }
+  }
+  for (const auto& watch : watches) {
+    check(*watch);
+  }
+}
+
+void ObjectWatcher::check(Watch& watch)
+{
+  std::map<std::string, std::string> headers;
+  try {
+    headers = mFetcher(watch.mPath, watch.mMetadata);
+  } catch (const std::exception& exception) {
+    ILOG(Warning, Support) << "Could not check the latest version of the object '" << watch.mPath << "': " << exception.what() << ENDM;
+    return;
+  }
+
+  // We rely on changing MD5 - if the object has changed, it should have a different check sum.
+  // If someone reuploaded an old object, it should not have an influence.
+  auto md5 = headers.find(md5Key);
+  if (md5 == headers.end()) {
+    // We might be just waiting for the first version of such object.
+    ILOG(Debug, Support) << "Could not find the object '" << watch.mPath << "' for the given Activity settings." << ENDM;
+    return;
+  }
+  if (md5->second == watch.mLastMD5) {
+    return;
+  }
+  watch.mLastMD5 = md5->second;
+
+  uint64_t validFrom = 0;
+  try {
+    validFrom = std::stoull(headers[validFromKey]);
+  } catch (const std::exception&) {
+    ILOG(Warning, Support) << "The object '" << watch.mPath << "' has an invalid '" << validFromKey << "' header" << ENDM;
+  }
+  std::lock_guard<std::mutex> lock(watch.mStateMutex);
+  watch.mState.version++;
+  watch.mState.validFrom = validFrom;
+}
+
+void ObjectWatcher::requestInterval(std::chrono::milliseconds interval)
+{
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (interval >= mInterval) {
+      return;
+    }
+    mInterval = std::max(interval, minimumInterval);
+  }
+  mWakeUp.notify_all();
+}
+
+std::chrono::milliseconds ObjectWatcher::getInterval() const
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  return mInterval;
+}
+
+size_t ObjectWatcher::getNumberWatches()
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  size_t count = 0;
+  for (const auto& [key, watch] : mWatches) {
+    count += !watch.expired();
+  }
+  return count;
+}
+
+void ObjectWatcher::run()
+{
+  std::unique_lock<std::mutex> lock(mMutex);
+  while (!mStopping) {
+    auto interval = mInterval;
+    mWakeUp.wait_for(lock, interval, [&]() { return mStopping || mInterval != interval; });
+    if (mStopping) {
+      break;
+    }
+    if (mInterval != interval) {
+      // the interval has been shortened, we wait again with the new one
+      continue;
+    }
+    lock.unlock();
+    refresh();
+    lock.lock();
+  }
+}
+
+} // namespace o2::quality_control::postprocessing
@@ -19,8 +19,14 @@
 #include "QualityControl/QcInfoLogger.h"
 #include "QualityControl/ServiceDiscovery.h"
 #include "QualityControl/MonitorObjectCollection.h"
+#include "QualityControl/DerivedObjects.h"
 #include <Common/Exceptions.h>
 #include <TObjArray.h>
+#include <TH1.h>
+#include <TH2.h>
+#include <THnBase.h>
+#include <algorithm>
+#include <optional>
 
 using namespace o2::quality_control::core;
 using namespace AliceO2::Common;
@@ -29,6 +35,55 @@ using namespace std;
 namespace o2::quality_control::core
 {
 
+namespace
+{
+
+template <typename T>
+void hashCombine(size_t& seed, const T& value)
+{
+  seed ^= std::hash<T>{}(value) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+}
+
+/// Computes a cheap fingerprint of the object content, or nothing if the type is not supported.
+std::optional<size_t> computeFingerprint(const TObject* object)
+{
+  size_t fingerprint = 0;
+  if (auto histogram = dynamic_cast<const TH1*>(object)) {
+    // SetBinContent increments the number of entries, Fill changes also the statistics
+    Double_t stats[TH1::kNstat] = { 0 };
+    histogram->GetStats(stats);
+    hashCombine(fingerprint, histogram->GetEntries());
+    for (auto stat : stats) {
+      hashCombine(fingerprint, stat);
+    }
+    return fingerprint;
+  } else if (auto histogram = dynamic_cast<const THnBase*>(object)) {
+    hashCombine(fingerprint, histogram->GetEntries());
+    hashCombine(fingerprint, histogram->GetSumw());
+    hashCombine(fingerprint, histogram->GetSumw2());
+    hashCombine(fingerprint, histogram->GetNbins());
+    return fingerprint;
+  }
+  return std::nullopt;
+}
+
+template <typename Buffer>
+Buffer& findFillBuffer(std::unordered_map<std::string, std::unique_ptr<FillBufferBase>>& buffers, TH1* histogram)
+{
+  auto found = buffers.find(histogram->GetName());
+  if (found == buffers.end()) {
+    // the constructor throws if the histogram is not supported, nothing is added then
+    found = buffers.emplace(histogram->GetName(), std::make_unique<Buffer>(histogram)).first;
+  }
+  auto* typed = dynamic_cast<Buffer*>(found->second.get());
+  if (typed == nullptr || typed->getHistogram() != histogram) {
+    throw std::invalid_argument(std::string("The fill buffer of ") + histogram->GetName() + " belongs to another histogram");
+  }
+  return *typed;
+}
+
+} // namespace
+
 const std::string ObjectsManager::gDrawOptionsKey = "drawOptions";
 const std::string ObjectsManager::gDisplayHintsKey = "displayHints";
 
@@ -101,7 +156,14 @@ void ObjectsManager::stopPublishing(TObject* object)
 void ObjectsManager::stopPublishing(const string& objectName)
 {
   auto* mo = dynamic_cast<MonitorObject*>(getMonitorObject(objectName));
+  if (auto buffer = mFillBuffers.find(objectName); buffer != mFillBuffers.end()) {
+    buffer->second->flush();
+    mFillBuffers.erase(buffer);
+  }
   mMonitorObjects->Remove(mo);
+  mLastFingerprints.erase(objectName);
+  mForcedChanges.erase(objectName);
+  mDerivedObjects.erase(std::remove(mDerivedObjects.begin(), mDerivedObjects.end(), objectName), mDerivedObjects.end());
 }
 
 bool ObjectsManager::isBeingPublished(const string& name)
@@ -135,10 +197,102 @@ MonitorObjectCollection* ObjectsManager::getNonOwningArray() const
   return new MonitorObjectCollection(*mMonitorObjects);
 }
 
+MonitorObjectCollection* ObjectsManager::getNonOwningArrayOfChanged()
+{
+  auto* changed = new MonitorObjectCollection();
+  changed->SetOwner(false);
+  changed->SetName(mMonitorObjects->GetName());
+  for (auto tobj : *mMonitorObjects) {
+    auto* mo = dynamic_cast<MonitorObject*>(tobj);
+    if (mo == nullptr) {
+      continue;
+    }
+    auto fingerprint = computeFingerprint(mo->getObject());
+    auto forced = mForcedChanges.count(mo->getName()) > 0;
+    auto last = mLastFingerprints.find(mo->getName());
+    if (!fingerprint.has_value() || forced || last == mLastFingerprints.end() || last->second != fingerprint.value()) {
+      changed->Add(mo);
+      if (fingerprint.has_value()) {
+        mLastFingerprints[mo->getName()] = fingerprint.value();
+      }
+    }
+  }
+  mForcedChanges.clear();
+  return changed;
+}
+
+void ObjectsManager::setChanged(const std::string& objectName)
+{
+  getMonitorObject(objectName); // throws if it does not exist
+  mForcedChanges.insert(objectName);
+}
+
+void ObjectsManager::resetChangeTracking()
+{
+  mLastFingerprints.clear();
+  mForcedChanges.clear();
+}
+
+void ObjectsManager::setChangeTrackingReference()
+{
+  for (auto tobj : *mMonitorObjects) {
+    auto* mo = dynamic_cast<MonitorObject*>(tobj);
+    if (mo == nullptr) {
+      continue;
+    }
+    if (auto fingerprint = computeFingerprint(mo->getObject()); fingerprint.has_value()) {
+      mLastFingerprints[mo->getName()] = fingerprint.value();
+    } else {
+      mLastFingerprints.erase(mo->getName());
+    }
+  }
+}
+
+void ObjectsManager::setDerived(const std::string& objectName, const std::string& functionName, const std::vector<std::string>& sourceNames)
+{
+  if (!derived_objects::isRegistered(functionName)) {
+    throw std::runtime_error("Unknown function of derived objects: " + functionName);
+  }
+  for (const auto& sourceName : sourceNames) {
+    getMonitorObject(sourceName); // throws if it does not exist
+  }
+  derived_objects::declare(*getMonitorObject(objectName), functionName, sourceNames);
+  if (std::find(mDerivedObjects.begin(), mDerivedObjects.end(), objectName) == mDerivedObjects.end()) {
+    mDerivedObjects.push_back(objectName);
+  }
+}
+
+void ObjectsManager::computeDerivedObjects()
+{
+  for (const auto& objectName : mDerivedObjects) {
+    derived_objects::compute(*getMonitorObject(objectName), *mMonitorObjects);
+  }
+}
+
+FillBuffer1D& ObjectsManager::getFillBuffer(TH1* histogram)
+{
+  getMonitorObject(histogram->GetName()); // throws if it does not exist
+  return findFillBuffer<FillBuffer1D>(mFillBuffers, histogram);
+}
+
+FillBuffer2D& ObjectsManager::getFillBuffer(TH2* histogram)
+{
+  getMonitorObject(histogram->GetName()); // throws if it does not exist
+  return findFillBuffer<FillBuffer2D>(mFillBuffers, histogram);
+}
+
+void ObjectsManager::flushFillBuffers()
+{
+  for (auto& [name, buffer] : mFillBuffers) {
+    buffer->flush();
+  }
+}
+
 void ObjectsManager::addMetadata(const std::string& objectName, const std::string& key, const std::string& value)
 {
   MonitorObject* mo = getMonitorObject(objectName);
   mo->addMetadata(key, value);
+  mForcedChanges.insert(objectName);
   ILOG(Debug, Devel) << "Added metadata on " << objectName << " : " << key << " -> " << value << ENDM;
 }
 
@@ -146,6 +300,7 @@ void ObjectsManager::addOrUpdateMetadata(const std::string& objectName, const st
 {
   MonitorObject* mo = getMonitorObject(objectName);
   mo->addOrUpdateMetadata(key, value);
+  mForcedChanges.insert(objectName);
   ILOG(Debug, Devel) << "Added/Modified metadata on " << objectName << " : " << key << " -> " << value << ENDM;
 }
 
@@ -158,24 +313,28 @@ void ObjectsManager::setDefaultDrawOptions(const std::string& objectName, const
 {
   MonitorObject* mo = getMonitorObject(objectName);
   mo->addOrUpdateMetadata(gDrawOptionsKey, options);
+  mForcedChanges.insert(objectName);
 }
 
 void ObjectsManager::setDefaultDrawOptions(TObject* obj, const std::string& options)
 {
   MonitorObject* mo = getMonitorObject(obj->GetName());
   mo->addOrUpdateMetadata(gDrawOptionsKey, options);
+  mForcedChanges.insert(obj->GetName());
 }
 
 void ObjectsManager::setDisplayHint(const std::string& objectName, const std::string& hints)
 {
   MonitorObject* mo = getMonitorObject(objectName);
   mo->addOrUpdateMetadata(gDisplayHintsKey, hints);
+  mForcedChanges.insert(objectName);
 }
 
 void ObjectsManager::setDisplayHint(TObject* obj, const std::string& hints)
 {
   MonitorObject* mo = getMonitorObject(obj->GetName());
   mo->addOrUpdateMetadata(gDisplayHintsKey, hints);
+  mForcedChanges.insert(obj->GetName());
 }
 
 const Activity& ObjectsManager::getActivity() const
@@ -191,6 +350,8 @@ void ObjectsManager::setActivity(const Activity& activity)
     MonitorObject* mo = dynamic_cast<MonitorObject*>(tobj);
     mo->setActivity(activity);
   }
+  // the objects have to be published again with the new activity
+  resetChangeTracking();
 }
 
 } // namespace o2::quality_control::core
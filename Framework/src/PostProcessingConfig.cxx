@@ -35,7 +35,10 @@ PostProcessingConfig::PostProcessingConfig(const std::string& name, const boost:
              config.get<std::string>("qc.config.Activity.provenance", "qc"),
              { config.get<uint64_t>("qc.config.Activity.start", 0),
                config.get<uint64_t>("qc.config.Activity.end", -1) }),
-    matchAnyRunNumber(config.get<bool>("qc.config.postprocessing.matchAnyRunNumber", false))
+    matchAnyRunNumber(config.get<bool>("qc.config.postprocessing.matchAnyRunNumber", false)),
+    retrievalConcurrency(config.get<size_t>("qc.postprocessing." + name + ".retrievalConcurrency", 1)),
+    newObjectPollingSeconds(config.get<double>("qc.config.postprocessing.newObjectPollingSeconds",
+                                               config.get<double>("qc.config.postprocessing.periodSeconds", 10.0)))
 {
   for (const auto& initTrigger : config.get_child("qc.postprocessing." + name + ".initTrigger")) {
     initTriggers.push_back(initTrigger.second.get_value<std::string>());
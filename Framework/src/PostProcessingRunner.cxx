@@ -15,6 +15,8 @@
 #include "QualityControl/PostProcessingConfig.h"
 #include "QualityControl/TriggerHelpers.h"
 #include "QualityControl/DatabaseFactory.h"
+#include "QualityControl/AsyncDatabase.h"
+#include "QualityControl/CachingDatabase.h"
 #include "QualityControl/QcInfoLogger.h"
 #include "QualityControl/CommonSpec.h"
 #include "QualityControl/InfrastructureSpecReader.h"
@@ -27,9 +29,12 @@
 #include <utility>
 #include <Framework/DataAllocator.h>
 #include <CommonUtils/ConfigurableParam.h>
+#include <Monitoring/MonitoringFactory.h>
+#include <Monitoring/Monitoring.h>
 
 using namespace o2::quality_control::core;
 using namespace o2::quality_control::repository;
+using namespace o2::monitoring;
 
 namespace o2::quality_control::postprocessing
 {
@@ -75,12 +80,16 @@ void PostProcessingRunner::init(const PostProcessingRunnerConfig& runnerConfig,
   }
 
   // configuration of the database
-  mDatabase = DatabaseFactory::create(mRunnerConfig.database.at("implementation"));
-  mDatabase->connect(mRunnerConfig.database);
+  mDatabase = DatabaseFactory::createAndConnect(mRunnerConfig.database);
   ILOG(Info, Support) << "Database that is going to be used : " << ENDM;
   ILOG(Info, Support) << ">> Implementation : " << mRunnerConfig.database.at("implementation") << ENDM;
   ILOG(Info, Support) << ">> Host : " << mRunnerConfig.database.at("host") << ENDM;
 
+  mCollector = MonitoringFactory::Get(mRunnerConfig.monitoringUrl);
+  mCollector->addGlobalTag(tags::Key::Subsystem, tags::Value::QC);
+  mCollector->addGlobalTag("PostProcessingTaskName", mName);
+  mTimer.reset(10000000); // 10 s.
+
   mObjectManager = std::make_shared<ObjectsManager>(mTaskConfig.taskName, mTaskConfig.className, mTaskConfig.detectorName, mRunnerConfig.consulUrl);
   mServices.registerService<DatabaseInterface>(mDatabase.get());
   if (mPublicationCallback == nullptr) {
@@ -130,6 +139,7 @@ bool PostProcessingRunner::run()
     // That in principle shouldn't happen if we reach run()
     throw std::runtime_error("The user task has INVALID state");
   }
+  sendPeriodicMonitoring();
 
   return true;
 }
@@ -143,6 +153,10 @@ void PostProcessingRunner::runOverTimestamps(const std::vector<uint64_t>& timest
   }
 
   ILOG(Info, Support) << "Running the task '" << mTask->getName() << "' over " << timestamps.size() << " timestamps." << ENDM;
+  // Each timestamp produces a different version of the objects, none of them should be replaced by the next one.
+  if (auto asyncDatabase = dynamic_cast<AsyncDatabase*>(mDatabase.get())) {
+    asyncDatabase->setCoalescing(false);
+  }
 
   doInitialize({ TriggerType::UserOrControl, false, mTaskConfig.activity, timestamps.front() });
   for (size_t i = 1; i < timestamps.size() - 1; i++) {
@@ -228,8 +242,39 @@ void PostProcessingRunner::doFinalize(Trigger trigger)
   ILOG(Info, Support) << "Finalizing the user task due to trigger '" << trigger << "'" << ENDM;
   mTask->finalize(trigger, mServices);
   mPublicationCallback(mObjectManager->getNonOwningArray(), trigger.timestamp, trigger.timestamp + objectValidity);
+  if (auto asyncDatabase = dynamic_cast<AsyncDatabase*>(mDatabase.get())) {
+    asyncDatabase->flush();
+  }
+  sendCacheStatistics();
   mTaskState = TaskState::Finished;
 }
+
+void PostProcessingRunner::sendPeriodicMonitoring()
+{
+  if (mTimer.isTimeout()) {
+    mTimer.reset(10000000); // 10 s.
+    sendCacheStatistics();
+  }
+}
+
+void PostProcessingRunner::sendCacheStatistics()
+{
+  DatabaseInterface* backend = mDatabase.get();
+  if (auto asyncDatabase = dynamic_cast<AsyncDatabase*>(mDatabase.get())) {
+    backend = &asyncDatabase->getBackend();
+  }
+  if (auto cachingDatabase = dynamic_cast<CachingDatabase*>(backend)) {
+    auto statistics = cachingDatabase->getAndResetStatistics();
+    mCollector->send(Metric{ "qc_postprocessing_cache" }
+                       .addValue(static_cast<uint64_t>(statistics.hits), "hits")
+                       .addValue(static_cast<uint64_t>(statistics.diskHits), "disk_hits")
+                       .addValue(static_cast<uint64_t>(statistics.misses), "misses")
+                       .addValue(static_cast<uint64_t>(statistics.revalidations), "revalidations")
+                       .addValue(static_cast<uint64_t>(statistics.stale), "stale")
+                       .addValue(static_cast<uint64_t>(statistics.evictions), "evictions")
+                       .addValue(static_cast<uint64_t>(statistics.size), "size"));
+  }
+}
 const std::string& PostProcessingRunner::getName()
 {
   return mName;
@@ -241,6 +286,7 @@ PostProcessingRunnerConfig PostProcessingRunner::extractConfig(const CommonSpec&
     ppTaskSpec.taskName,
     commonSpec.database,
     commonSpec.consulUrl,
+    commonSpec.monitoringUrl,
     commonSpec.infologgerFilterDiscardDebug,
     commonSpec.infologgerDiscardLevel,
     commonSpec.postprocessingPeriod,
@@ -20,12 +20,14 @@
 #include <thread> // this_thread::sleep_for
 
 #include <TH2F.h>
+#include <TROOT.h>
 
 #include <fairmq/ProgOptions.h> // device->fConfig
 
 #include <Common/Exceptions.h>
 
 #include "QualityControl/DatabaseFactory.h"
+#include "QualityControl/LatencyHistogram.h"
 #include "QualityControl/QcInfoLogger.h"
 
 using namespace std;
@@ -75,13 +77,22 @@ TH1* RepositoryBenchmark::createHisto(uint64_t sizeObjects, string name)
 void RepositoryBenchmark::InitTask()
 {
   // parse arguments database
-  string dbUrl = fConfig->GetValue<string>("database-url");
-  string dbBackend = fConfig->GetValue<string>("database-backend");
+  mDbBackend = fConfig->GetValue<string>("database-backend");
+  mDbUrl = fConfig->GetValue<string>("database-url");
+  mDbName = fConfig->GetValue<string>("database-name");
+  mDbUsername = fConfig->GetValue<string>("database-username");
+  mDbPassword = fConfig->GetValue<string>("database-password");
   mTaskName = fConfig->GetValue<string>("task-name");
+  if (fConfig->GetValue<int>("stand-in")) {
+    CcdbStandIn::Config standInConfig;
+    standInConfig.latency = milliseconds(fConfig->GetValue<uint64_t>("stand-in-latency-ms"));
+    standInConfig.errorRate = fConfig->GetValue<double>("stand-in-error-rate");
+    mStandIn = make_unique<CcdbStandIn>(standInConfig);
+    mDbBackend = "CCDB";
+    mDbUrl = mStandIn->getUrl();
+  }
   try {
-    mDatabase = o2::quality_control::repository::DatabaseFactory::create(dbBackend);
-    mDatabase->connect(fConfig->GetValue<string>("database-url"), fConfig->GetValue<string>("database-name"),
-                       fConfig->GetValue<string>("database-username"), fConfig->GetValue<string>("database-password"));
+    mDatabase = connectDatabase();
     mDatabase->prepareTaskDataContainer(mTaskName);
   } catch (boost::exception& exc) {
     string diagnostic = boost::current_exception_diagnostic_information();
@@ -98,6 +109,14 @@ void RepositoryBenchmark::InitTask()
   mSizeObjects = fConfig->GetValue<uint64_t>("size-objects");
   mDeletionMode = static_cast<bool>(fConfig->GetValue<int>("delete"));
   mObjectName = fConfig->GetValue<string>("object-name");
+  mNumberThreads = fConfig->GetValue<uint64_t>("threads");
+  if (mNumberThreads > 0 && mMaxIterations == 0 && !mDeletionMode) {
+    BOOST_THROW_EXCEPTION(FatalException() << errinfo_details("max-iterations must be set when using threads"));
+  }
+  if (mNumberThreads > 0 && mStandIn && fConfig->GetValue<double>("stand-in-error-rate") > 0) {
+    // a failed storage makes the client skip the following ones, which would be timed and counted as stored
+    BOOST_THROW_EXCEPTION(FatalException() << errinfo_details("stand-in-error-rate cannot be used with threads, the throughput would be wrong"));
+  }
   auto numberTasks = fConfig->GetValue<uint64_t>("number-tasks");
 
   // monitoring
@@ -120,8 +139,11 @@ void RepositoryBenchmark::InitTask()
     emptyDatabase();
   }
 
-  // prepare objects
-  for (uint64_t i = 0; i < mNumberObjects; i++) {
+  // prepare objects, number-objects for each thread
+  if (mNumberThreads > 0) {
+    ROOT::EnableThreadSafety();
+  }
+  for (uint64_t i = 0; i < mNumberObjects * max<uint64_t>(mNumberThreads, 1); i++) {
     TH1* histo = createHisto(mSizeObjects, mObjectName + to_string(i));
     shared_ptr<MonitorObject> mo = make_shared<MonitorObject>(histo, mTaskName, "Benchmark", "BMK");
     mo->setIsOwner(true);
@@ -145,11 +167,22 @@ void RepositoryBenchmark::checkTimedOut()
   mTimer->async_wait(boost::bind(&RepositoryBenchmark::checkTimedOut, this));
 }
 
+unique_ptr<DatabaseInterface> RepositoryBenchmark::connectDatabase()
+{
+  auto database = DatabaseFactory::create(mDbBackend);
+  database->connect(mDbUrl, mDbName, mDbUsername, mDbPassword);
+  return database;
+}
+
 bool RepositoryBenchmark::ConditionalRun()
 {
   if (mDeletionMode) { // the only way to not run is to return false from here.
     return false;
   }
+  if (mNumberThreads > 0) {
+    runLoad();
+    return false;
+  }
 
   high_resolution_clock::time_point t1 = high_resolution_clock::now();
 
@@ -185,10 +218,57 @@ bool RepositoryBenchmark::ConditionalRun()
   return true;
 }
 
+void RepositoryBenchmark::runLoad()
+{
+  ILOG(Info, Support) << "Storing " << mNumberObjects << " objects " << mMaxIterations << " times from each of "
+                      << mNumberThreads << " threads, as fast as possible" << ENDM;
+  LatencyHistogram latencies;
+  vector<thread> threads;
+  auto storedBefore = mStandIn ? mStandIn->getStatistics().storedVersions : 0;
+  auto start = steady_clock::now();
+  for (uint64_t t = 0; t < mNumberThreads; t++) {
+    threads.emplace_back([this, t, &latencies]() {
+      // the clients are not shared, as each task has its own in a real setup
+      auto database = connectDatabase();
+      for (uint64_t iteration = 0; iteration < mMaxIterations; iteration++) {
+        for (uint64_t i = t * mNumberObjects; i < (t + 1) * mNumberObjects; i++) {
+          LatencyTimer timer(&latencies);
+          database->storeMO(mMyObjects[i]);
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  auto seconds = duration_cast<duration<double>>(steady_clock::now() - start).count();
+
+  uint64_t attempted = mNumberThreads * mMaxIterations * mNumberObjects;
+  mTotalNumberObjects += attempted;
+  auto summary = latencies.getAndReset();
+  double objectsPerSecond = attempted / seconds;
+  double megabytesPerSecond = objectsPerSecond * mSizeObjects / 1000.;
+  ILOG(Info, Support) << attempted << " objects stored in " << seconds << " s: " << objectsPerSecond << " objects/s, "
+                      << megabytesPerSecond << " MB/s. Latency of one storage: p50 " << summary.p50 << " us, p99 "
+                      << summary.p99 << " us, max " << summary.max << " us" << ENDM;
+  if (mStandIn) {
+    auto statistics = mStandIn->getStatistics();
+    ILOG(Info, Support) << "Stand-in: " << statistics.requests << " requests, " << (statistics.storedVersions - storedBefore)
+                        << " objects stored" << ENDM;
+  }
+  mMonitoring->send(Metric{ "ccdb_benchmark_load" }
+                      .addValue(mNumberThreads, "threads")
+                      .addValue(objectsPerSecond, "objects_per_second")
+                      .addValue(megabytesPerSecond, "megabytes_per_second")
+                      .addValue(summary.p50, "latency_p50_us")
+                      .addValue(summary.p99, "latency_p99_us")
+                      .addValue(summary.max, "latency_max_us"));
+}
+
 void RepositoryBenchmark::emptyDatabase()
 {
   mDatabase->truncate(mTaskName, mObjectName);
-  for (uint64_t i = 0; i < mNumberObjects; i++) {
+  for (uint64_t i = 0; i < mNumberObjects * max<uint64_t>(mNumberThreads, 1); i++) {
     mDatabase->truncate(mTaskName, mObjectName + to_string(i));
   }
 }
@@ -18,6 +18,7 @@
 #define QC_REPOSITORYBENCHMARK_H
 
 #include "QualityControl/DatabaseInterface.h"
+#include "QualityControl/CcdbStandIn.h"
 #include <fairmq/Device.h>
 #include <TH1.h>
 #include <Monitoring/MonitoringFactory.h>
@@ -39,6 +40,8 @@ class RepositoryBenchmark : public fair::mq::Device
   virtual bool ConditionalRun();
   void emptyDatabase();
   void checkTimedOut();
+  void runLoad();
+  std::unique_ptr<o2::quality_control::repository::DatabaseInterface> connectDatabase();
   TH1* createHisto(uint64_t sizeObjects, std::string name);
 
  private:
@@ -50,6 +53,12 @@ class RepositoryBenchmark : public fair::mq::Device
   std::string mTaskName;
   std::string mObjectName;
   bool mDeletionMode = false; // todo: is false ok as default?
+  uint64_t mNumberThreads = 0; // 0: store from the device's thread, once per second
+  std::string mDbBackend;
+  std::string mDbUrl;
+  std::string mDbName;
+  std::string mDbUsername;
+  std::string mDbPassword;
 
   // monitoring
   std::unique_ptr<o2::monitoring::Monitoring> mMonitoring;
@@ -60,6 +69,7 @@ class RepositoryBenchmark : public fair::mq::Device
   // internal state
   std::unique_ptr<o2::quality_control::repository::DatabaseInterface> mDatabase;
   std::vector<std::shared_ptr<MonitorObject>> mMyObjects;
+  std::unique_ptr<o2::quality_control::repository::CcdbStandIn> mStandIn;
   //  TH1* mMyHisto;
 
   // variables for the timer
@@ -0,0 +1,134 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   RootFileHelpers.cxx
+///
+
+#include "QualityControl/RootFileHelpers.h"
+#include "QualityControl/MonitorObject.h"
+#include "QualityControl/MonitorObjectCollection.h"
+
+#include <TClass.h>
+#include <TDirectory.h>
+#include <TKey.h>
+#include <algorithm>
+#include <stdexcept>
+
+namespace o2::quality_control::core::root_file_helpers
+{
+
+namespace
+{
+
+bool isDirectory(const TKey& key)
+{
+  auto cl = TClass::GetClass(key.GetClassName());
+  return cl != nullptr && cl->InheritsFrom(TDirectory::Class());
+}
+
+/// Removes the collection stored with the other layout than the one which is going to be written.
+void removeOtherLayout(TDirectory& parent, const std::string& name, bool keepDirectory)
+{
+  auto key = parent.GetKey(name.c_str());
+  if (key == nullptr || isDirectory(*key) == keepDirectory) {
+    return;
+  }
+  if (keepDirectory) {
+    parent.Delete((name + ";*").c_str());
+  } else {
+    parent.rmdir(name.c_str());
+  }
+}
+
+} // namespace
+
+std::vector<std::string> listMonitorObjectCollections(TDirectory& parent)
+{
+  std::vector<std::string> names;
+  TIter next(parent.GetListOfKeys());
+  while (auto key = (TKey*)next()) {
+    // keys might be present in many cycles
+    if (std::find(names.begin(), names.end(), key->GetName()) == names.end()) {
+      names.emplace_back(key->GetName());
+    }
+  }
+  return names;
+}
+
+bool isStoredPerObject(TDirectory& parent, const std::string& name)
+{
+  auto key = parent.GetKey(name.c_str());
+  return key != nullptr && isDirectory(*key);
+}
+
+std::unique_ptr<MonitorObjectCollection> readMonitorObjectCollection(TDirectory& parent, const std::string& name)
+{
+  auto key = parent.GetKey(name.c_str());
+  if (key == nullptr) {
+    return nullptr;
+  }
+
+  if (!isDirectory(*key)) {
+    std::unique_ptr<TObject> storedTObj(key->ReadObj());
+    auto storedMOC = dynamic_cast<MonitorObjectCollection*>(storedTObj.get());
+    if (storedMOC == nullptr) {
+      throw std::runtime_error("The object '" + name + "' is not a MonitorObjectCollection");
+    }
+    storedTObj.release();
+    storedMOC->postDeserialization();
+    return std::unique_ptr<MonitorObjectCollection>(storedMOC);
+  }
+
+  auto directory = parent.GetDirectory(name.c_str());
+  if (directory == nullptr) {
+    throw std::runtime_error("Could not open the directory '" + name + "'");
+  }
+  auto collection = std::make_unique<MonitorObjectCollection>();
+  collection->SetName(name.c_str());
+  for (const auto& moName : listMonitorObjectCollections(*directory)) {
+    std::unique_ptr<TObject> storedTObj(directory->GetKey(moName.c_str())->ReadObj());
+    if (dynamic_cast<MonitorObject*>(storedTObj.get()) == nullptr) {
+      throw std::runtime_error("The object '" + moName + "' in the directory '" + name + "' is not a MonitorObject");
+    }
+    collection->Add(storedTObj.release());
+  }
+  collection->postDeserialization();
+  return collection;
+}
+
+int writeMonitorObjectCollection(TDirectory& parent, MonitorObjectCollection& collection)
+{
+  removeOtherLayout(parent, collection.GetName(), false);
+  return parent.WriteObject(&collection, collection.GetName(), "Overwrite");
+}
+
+int writeMonitorObjects(TDirectory& parent, const std::string& collectionName, const std::vector<TObject*>& objects)
+{
+  removeOtherLayout(parent, collectionName, true);
+  auto directory = parent.GetDirectory(collectionName.c_str());
+  if (directory == nullptr) {
+    directory = parent.mkdir(collectionName.c_str());
+  }
+  if (directory == nullptr) {
+    throw std::runtime_error("Could not create the directory '" + collectionName + "'");
+  }
+
+  int nbytes = 0;
+  for (auto object : objects) {
+    // WriteDelete removes the previous cycle only once the new one is written.
+    nbytes += directory->WriteTObject(object, object->GetName(), "WriteDelete");
+  }
+  directory->SaveSelf(kTRUE);
+  return nbytes;
+}
+
+} // namespace o2::quality_control::core::root_file_helpers
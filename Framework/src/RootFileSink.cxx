@@ -17,19 +17,25 @@
 #include "QualityControl/RootFileSink.h"
 #include "QualityControl/QcInfoLogger.h"
 #include "QualityControl/MonitorObjectCollection.h"
+#include "QualityControl/RootFileHelpers.h"
+#include "QualityControl/ThreadPool.h"
+#include "QualityControl/HistogramTransport.h"
 #include <Framework/DeviceSpec.h>
 #include <Framework/CompletionPolicyHelpers.h>
 #include <Framework/CompletionPolicy.h>
+#include <Framework/EndOfStreamContext.h>
 #include <Framework/InputRecordWalker.h>
+#include <Framework/DataRefUtils.h>
 #include <TFile.h>
+#include <TROOT.h>
 
 using namespace o2::framework;
 
 namespace o2::quality_control::core
 {
 
-RootFileSink::RootFileSink(std::string filePath)
-  : mFilePath(std::move(filePath))
+RootFileSink::RootFileSink(std::string filePath, Config config)
+  : mFilePath(std::move(filePath)), mConfig(config)
 {
 }
 
@@ -49,6 +55,16 @@ TFile* openSinkFile(const std::string& name)
   return file;
 }
 
+// the tasks send either collections streamed by ROOT or encoded with histogram_transport::encode()
+std::unique_ptr<MonitorObjectCollection> readCollection(const DataRef& input)
+{
+  auto payloadSize = DataRefUtils::getPayloadSize(input);
+  if (histogram_transport::isEncoded(input.payload, payloadSize)) {
+    return histogram_transport::decode(input.payload, payloadSize);
+  }
+  return DataRefUtils::as<MonitorObjectCollection>(input);
+}
+
 void closeSinkFile(TFile* file)
 {
   if (file != nullptr) {
@@ -62,6 +78,8 @@ void closeSinkFile(TFile* file)
 
 RootFileSink::~RootFileSink()
 {
+  waitForFlush();
+  closeFile();
 }
 
 void RootFileSink::customizeInfrastructure(std::vector<framework::CompletionPolicy>& policies)
@@ -76,15 +94,55 @@ void RootFileSink::customizeInfrastructure(std::vector<framework::CompletionPoli
 
 void RootFileSink::init(framework::InitContext& ictx)
 {
+  if (!mConfig.streaming) {
+    return;
+  }
+  ILOG(Info, Support) << "The file sink works in the streaming mode, flush period: " << mConfig.flushPeriodSeconds << "s" << ENDM;
+  // the file is written by the flushing thread
+  ROOT::EnableThreadSafety();
+  mWriter = std::make_unique<ThreadPool>(1);
+}
+
+void RootFileSink::openFile()
+{
+  {
+    // opening a file changes the current directory, objects created later could be attached to it otherwise
+    TDirectory::TContext context;
+    mFile = openSinkFile(mFilePath);
+  }
+  for (const auto& name : root_file_helpers::listMonitorObjectCollections(*mFile)) {
+    auto collection = root_file_helpers::readMonitorObjectCollection(*mFile, name);
+    if (!root_file_helpers::isStoredPerObject(*mFile, name)) {
+      // the collection stored as a whole will be replaced at the first flush, so all of its objects have to be written
+      markAllAsModified(name, *collection);
+    }
+    ILOG(Info, Support) << "Read " << collection->GetEntries() << " objects of the collection '" << name << "' stored in the file." << ENDM;
+    mCollections[name] = std::move(collection);
+  }
+  mLastFlush = std::chrono::steady_clock::now();
+}
+
+void RootFileSink::markAllAsModified(const std::string& collectionName, const MonitorObjectCollection& collection)
+{
+  auto it = collection.MakeIterator();
+  while (auto obj = it->Next()) {
+    mModifiedObjects[collectionName].insert(obj->GetName());
+  }
+  delete it;
 }
 
 void RootFileSink::run(framework::ProcessingContext& pctx)
 {
+  if (mConfig.streaming) {
+    runStreaming(pctx);
+    return;
+  }
+
   TFile* sinkFile = nullptr;
   try {
     sinkFile = openSinkFile(mFilePath);
     for (const auto& input : InputRecordWalker(pctx.inputs())) {
-      auto moc = DataRefUtils::as<MonitorObjectCollection>(input).release();
+      auto moc = readCollection(input).release();
       if (moc == nullptr) {
         ILOG(Error) << "Could not cast the input object to MonitorObjectCollection, skipping." << ENDM;
         continue;
@@ -99,21 +157,20 @@ void RootFileSink::run(framework::ProcessingContext& pctx)
       }
 
       ILOG(Info, Support) << "Checking for existing objects in the file." << ENDM;
-      auto storedTObj = sinkFile->Get(mocName);
-      if (storedTObj != nullptr) {
-        auto storedMOC = dynamic_cast<MonitorObjectCollection*>(storedTObj);
-        if (storedMOC == nullptr) {
-          ILOG(Error, Ops) << "Could not cast the stored object to MonitorObjectCollection, skipping." << ENDM;
-          delete storedTObj;
-          continue;
-        }
-        storedMOC->postDeserialization();
+      std::unique_ptr<MonitorObjectCollection> storedMOC;
+      try {
+        storedMOC = root_file_helpers::readMonitorObjectCollection(*sinkFile, mocName);
+      } catch (const std::runtime_error& ex) {
+        ILOG(Error, Ops) << "Could not read the stored MonitorObjectCollection, skipping. Details: " << ex.what() << ENDM;
+        delete moc;
+        continue;
+      }
+      if (storedMOC != nullptr) {
         ILOG(Info, Support) << "Merging object '" << moc->GetName() << "' with the existing one in the file." << ENDM;
-        moc->merge(storedMOC);
+        moc->merge(storedMOC.get());
       }
-      delete storedTObj;
 
-      auto nbytes = sinkFile->WriteObject(moc, moc->GetName(), "Overwrite");
+      auto nbytes = root_file_helpers::writeMonitorObjectCollection(*sinkFile, *moc);
       ILOG(Info, Support) << "Object '" << moc->GetName() << "' has been stored in the file (" << nbytes << " bytes)." << ENDM;
       delete moc;
     }
@@ -128,4 +185,126 @@ void RootFileSink::run(framework::ProcessingContext& pctx)
   }
 }
 
+void RootFileSink::runStreaming(framework::ProcessingContext& pctx)
+{
+  if (mFile == nullptr) {
+    // the file is closed at each end of stream, this is the first data of a new run or of the processing
+    openFile();
+  }
+  try {
+    for (const auto& input : InputRecordWalker(pctx.inputs())) {
+      std::unique_ptr<MonitorObjectCollection> moc(readCollection(input).release());
+      if (moc == nullptr) {
+        ILOG(Error) << "Could not cast the input object to MonitorObjectCollection, skipping." << ENDM;
+        continue;
+      }
+      moc->postDeserialization();
+
+      std::string mocName = moc->GetName();
+      if (mocName.empty()) {
+        ILOG(Error, Support) << "MonitorObjectCollection does not have a name, skipping." << ENDM;
+        continue;
+      }
+      ILOG(Debug, Support) << "Received MonitorObjectCollection '" << mocName << "'" << ENDM;
+
+      auto& modifiedObjects = mModifiedObjects[mocName];
+      auto it = moc->MakeIterator();
+      while (auto obj = it->Next()) {
+        modifiedObjects.insert(obj->GetName());
+      }
+      delete it;
+
+      auto& collection = mCollections[mocName];
+      if (collection == nullptr) {
+        collection = std::move(moc);
+      } else {
+        collection->merge(moc.get());
+      }
+    }
+  } catch (const std::bad_alloc& ex) {
+    ILOG(Error, Ops) << "Caught a bad_alloc exception, there is probably a huge object present, but I will try to survive" << ENDM;
+    ILOG(Error, Support) << "Details: " << ex.what() << ENDM;
+  }
+
+  if (mConfig.flushPeriodSeconds > 0 && std::chrono::steady_clock::now() - mLastFlush >= std::chrono::duration<double>(mConfig.flushPeriodSeconds)) {
+    flush();
+  }
+}
+
+void RootFileSink::endOfStream(framework::EndOfStreamContext&)
+{
+  if (!mConfig.streaming) {
+    return;
+  }
+  ILOG(Info, Support) << "End of stream received, storing the remaining objects in the file." << ENDM;
+  waitForFlush();
+  flush();
+  waitForFlush();
+  closeFile();
+}
+
+void RootFileSink::flush()
+{
+  if (mPendingFlush.valid()) {
+    if (mPendingFlush.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+      // the modified objects will be stored at the next occasion
+      return;
+    }
+    waitForFlush();
+  }
+  mLastFlush = std::chrono::steady_clock::now();
+
+  // the copies are written, so that the merging can continue in the meantime
+  std::map<std::string, std::vector<std::unique_ptr<TObject>>> copies;
+  for (const auto& [collectionName, objectNames] : mModifiedObjects) {
+    auto& collection = mCollections.at(collectionName);
+    for (const auto& objectName : objectNames) {
+      if (auto obj = collection->FindObject(objectName.c_str())) {
+        copies[collectionName].emplace_back(obj->Clone());
+      }
+    }
+  }
+  mModifiedObjects.clear();
+  if (copies.empty() || mFile == nullptr) {
+    return;
+  }
+
+  mPendingFlush = mWriter->submit([file = mFile, copies = std::move(copies)]() {
+    for (const auto& [collectionName, objects] : copies) {
+      std::vector<TObject*> objectPtrs;
+      for (const auto& obj : objects) {
+        objectPtrs.push_back(obj.get());
+      }
+      auto nbytes = root_file_helpers::writeMonitorObjects(*file, collectionName, objectPtrs);
+      ILOG(Info, Support) << objects.size() << " objects of the collection '" << collectionName << "' have been stored in the file (" << nbytes << " bytes)." << ENDM;
+    }
+    file->SaveSelf(kTRUE);
+    file->Flush();
+  });
+}
+
+void RootFileSink::waitForFlush()
+{
+  if (!mPendingFlush.valid()) {
+    return;
+  }
+  try {
+    mPendingFlush.get();
+  } catch (const std::exception& ex) {
+    // an I/O error should not stop the processing, the objects are written again at the next flush
+    ILOG(Error, Support) << "Failed to store the objects in the file: " << ex.what() << ENDM;
+    for (const auto& [collectionName, collection] : mCollections) {
+      markAllAsModified(collectionName, *collection);
+    }
+  }
+}
+
+void RootFileSink::closeFile()
+{
+  closeSinkFile(mFile);
+  mFile = nullptr;
+  mCollections.clear();
+  mModifiedObjects.clear();
+}
+
 } // namespace o2::quality_control::core
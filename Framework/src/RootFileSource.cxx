@@ -17,10 +17,10 @@
 #include "QualityControl/RootFileSource.h"
 #include "QualityControl/QcInfoLogger.h"
 #include "QualityControl/MonitorObjectCollection.h"
+#include "QualityControl/RootFileHelpers.h"
 
 #include <Framework/ControlService.h>
 #include <TFile.h>
-#include <TKey.h>
 
 using namespace o2::framework;
 
@@ -46,25 +46,20 @@ void RootFileSource::run(framework::ProcessingContext& ctx)
   }
   ILOG(Info) << "Input file '" << mFilePath << "' successfully open." << ENDM;
 
-  TIter next(file->GetListOfKeys());
-  TKey* key;
-  while ((key = (TKey*)next())) {
-    auto storedTObj = file->Get(key->GetName());
-    if (storedTObj != nullptr) {
-      auto storedMOC = dynamic_cast<MonitorObjectCollection*>(storedTObj);
-      if (storedMOC == nullptr) {
-        ILOG(Error) << "Could not cast the stored object to MonitorObjectCollection, skipping." << ENDM;
-        delete storedTObj;
-        continue;
-      }
-
-      // snapshot does a shallow copy, so we cannot let it delete elements in MOC when it deletes the MOC
-      storedMOC->SetOwner(false);
-      ctx.outputs().snapshot(OutputRef{ storedMOC->GetName(), 0 }, *storedMOC);
-      storedMOC->postDeserialization();
-      ILOG(Info) << "Read and published object '" << storedMOC->GetName() << "'" << ENDM;
+  for (const auto& name : root_file_helpers::listMonitorObjectCollections(*file)) {
+    std::unique_ptr<MonitorObjectCollection> storedMOC;
+    try {
+      storedMOC = root_file_helpers::readMonitorObjectCollection(*file, name);
+    } catch (const std::runtime_error& ex) {
+      ILOG(Error) << "Could not read the stored MonitorObjectCollection, skipping. Details: " << ex.what() << ENDM;
+      continue;
     }
-    delete storedTObj;
+
+    // snapshot does a shallow copy, so we cannot let it delete elements in MOC when it deletes the MOC
+    storedMOC->SetOwner(false);
+    ctx.outputs().snapshot(OutputRef{ storedMOC->GetName(), 0 }, *storedMOC);
+    storedMOC->SetOwner(true);
+    ILOG(Info) << "Read and published object '" << storedMOC->GetName() << "'" << ENDM;
   }
   file->Close();
   delete file;
@@ -18,6 +18,7 @@
 #include "QualityControl/TaskInterface.h"
 #include "QualityControl/stringUtils.h"
 #include <CCDB/CcdbApi.h>
+#include <stdexcept>
 
 using namespace o2::ccdb;
 
@@ -49,6 +50,11 @@ void TaskInterface::loadCcdb()
   }
 }
 
+void TaskInterface::monitorDataPart(const o2::framework::DataRef&)
+{
+  throw std::runtime_error("The task " + mName + " does not implement monitorDataPart()");
+}
+
 void TaskInterface::setCustomParameters(const std::unordered_map<std::string, std::string>& parameters)
 {
   mCustomParameters = parameters;
@@ -63,6 +69,14 @@ TObject* TaskInterface::retrieveCondition(std::string path, std::map<std::string
   return mCcdbApi->retrieveFromTFileAny<TObject>(path, metadata, timestamp);
 }
 
+ConditionsService& TaskInterface::getConditionsService()
+{
+  if (!mConditionsService) {
+    mConditionsService = ConditionsService::getInstance(mCcdbUrl);
+  }
+  return *mConditionsService;
+}
+
 std::shared_ptr<ObjectsManager> TaskInterface::getObjectsManager() { return mObjectsManager; }
 
 void TaskInterface::setMonitoring(const std::shared_ptr<o2::monitoring::Monitoring>& mMonitoring)
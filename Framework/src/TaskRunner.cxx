@@ -39,11 +39,14 @@
 #include "QualityControl/InfrastructureSpecReader.h"
 #include "QualityControl/TaskRunnerFactory.h"
 #include "QualityControl/ConfigParamGlo.h"
+#include "QualityControl/HistogramTransport.h"
 
+#include <algorithm>
 #include <string>
 #include <TFile.h>
 #include <boost/property_tree/ptree.hpp>
 #include <TSystem.h>
+#include <TROOT.h>
 
 using namespace std;
 
@@ -162,6 +165,17 @@ void TaskRunner::init(InitContext& iCtx)
   mTask->setCcdbUrl(mTaskConfig.conditionUrl);
   mTask->initialize(iCtx);
 
+  if (mTaskConfig.monitorDataThreads > 1) {
+    if (mTask->supportsMonitorDataPart()) {
+      ROOT::EnableThreadSafety();
+      mMonitorDataPool = std::make_unique<ThreadPool>(mTaskConfig.monitorDataThreads);
+      mShards = std::make_unique<ObjectShards>(mTaskConfig.monitorDataThreads);
+      ILOG(Info, Support) << "The inputs will be processed in parallel by " << mTaskConfig.monitorDataThreads << " threads" << ENDM;
+    } else {
+      ILOG(Warning, Support) << "The task does not implement monitorDataPart(), monitorDataThreads is ignored" << ENDM;
+    }
+  }
+
   mNoMoreCycles = false;
   mCycleNumber = 0;
 }
@@ -181,7 +195,11 @@ void TaskRunner::run(ProcessingContext& pCtx)
   auto [dataReady, timerReady] = validateInputs(pCtx.inputs());
 
   if (dataReady) {
-    mTask->monitorData(pCtx);
+    if (mShards) {
+      monitorDataInParallel(pCtx);
+    } else {
+      mTask->monitorData(pCtx);
+    }
     updateMonitoringStats(pCtx);
   }
 
@@ -189,6 +207,7 @@ void TaskRunner::run(ProcessingContext& pCtx)
     finishCycle(pCtx.outputs());
     if (mTaskConfig.resetAfterCycles > 0 && (mCycleNumber % mTaskConfig.resetAfterCycles == 0)) {
       mTask->reset();
+      mObjectsManager->setChangeTrackingReference();
     }
     if (mTaskConfig.maxNumberCycles < 0 || mCycleNumber < mTaskConfig.maxNumberCycles) {
       startCycle();
@@ -323,13 +342,19 @@ void TaskRunner::start(const ServiceRegistry& services)
 void TaskRunner::stop()
 {
   try {
+    // the task sees all the entries of the run in endOfCycle and endOfActivity
+    mObjectsManager->flushFillBuffers();
     if (mCycleOn) {
+      if (mShards) {
+        mShards->merge();
+      }
       mTask->endOfCycle();
       mCycleNumber++;
       mCycleOn = false;
     }
     endOfActivity();
     mTask->reset();
+    mObjectsManager->setChangeTrackingReference();
     mRunNumber = 0;
   } catch (...) {
     // we catch here because we don't know where it will go in DPL's CallbackService
@@ -342,6 +367,8 @@ void TaskRunner::stop()
 void TaskRunner::reset()
 {
   try {
+    mShards.reset();
+    mMonitorDataPool.reset();
     mTask.reset();
     mCollector.reset();
     mObjectsManager.reset();
@@ -414,6 +441,40 @@ void TaskRunner::endOfActivity()
   mCollector->send(Metric{ "qc_objects_published" }.addValue(rate, "per_second_whole_run"));
 }
 
+void TaskRunner::monitorDataInParallel(ProcessingContext& pCtx)
+{
+  // the histograms published since the last message get their copies
+  mShards->update(*mObjectsManager);
+
+  std::vector<DataRef> parts;
+  for (const auto& part : InputRecordWalker(pCtx.inputs())) {
+    if (part.spec != nullptr && part.spec->binding == "timer-cycle") {
+      continue;
+    }
+    parts.push_back(part);
+  }
+
+  // each thread takes every n-th part and fills its own copies
+  const size_t nShards = std::min(mShards->size(), parts.size());
+  std::vector<std::future<void>> results;
+  for (size_t shard = 0; shard < nShards; shard++) {
+    results.push_back(mMonitorDataPool->submit([this, &parts, shard, nShards]() {
+      mShards->runWith(shard, [&]() {
+        for (size_t i = shard; i < parts.size(); i += nShards) {
+          mTask->monitorDataPart(parts[i]);
+        }
+      });
+    }));
+  }
+  // all the threads have to be done with the parts before an exception is rethrown
+  for (auto& result : results) {
+    result.wait();
+  }
+  for (auto& result : results) {
+    result.get();
+  }
+}
+
 void TaskRunner::startCycle()
 {
   ILOG(Debug, Ops) << "Start cycle " << mCycleNumber << ENDM;
@@ -428,6 +489,11 @@ void TaskRunner::startCycle()
 void TaskRunner::finishCycle(DataAllocator& outputs)
 {
   ILOG(Debug, Ops) << "Finish cycle " << mCycleNumber << ENDM;
+  if (mShards) {
+    mShards->merge();
+  }
+  // as the shards, the buffered entries have to be in the objects when the task finalizes them in endOfCycle
+  mObjectsManager->flushFillBuffers();
   mTask->endOfCycle();
 
   mNumberObjectsPublishedInCycle += publish(outputs);
@@ -485,25 +551,67 @@ void TaskRunner::publishCycleStats()
                      .addValue(rate, "per_second")
                      .addValue(mTotalNumberObjectsPublished, "whole_run")
                      .addValue(wholeRunRate, "per_second_whole_run"));
+
+  Metric publicationMetric{ "qc_publication" };
+  publicationMetric.addValue(mLastEncodingDuration, "encoding_duration");
+  publicationMetric.addValue(mLastPublishedBytes, "bytes");
+  publicationMetric.addValue(mLastPublishedUncompressedBytes, "uncompressed_bytes");
+  mCollector->send(std::move(publicationMetric));
 }
 
 int TaskRunner::publish(DataAllocator& outputs)
 {
-  ILOG(Info, Support) << "Publishing " << mObjectsManager->getNumberPublishedObjects() << " MonitorObjects" << ENDM;
   AliceO2::Common::Timer publicationDurationTimer;
+  mLastEncodingDuration = 0;
+  mLastPublishedBytes = 0;
+  mLastPublishedUncompressedBytes = 0;
 
   auto concreteOutput = framework::DataSpecUtils::asConcreteDataMatcher(mTaskConfig.moSpec);
+  mObjectsManager->computeDerivedObjects();
   // getNonOwningArray creates a TObjArray containing the monitoring objects, but not
   // owning them. The array is created by new and must be cleaned up by the caller
-  std::unique_ptr<MonitorObjectCollection> array(mObjectsManager->getNonOwningArray());
+  std::unique_ptr<MonitorObjectCollection> array;
+  if (mTaskConfig.deltaPublication) {
+    // Once in a while we publish everything (keyframe), so the consumers which joined late or lost some messages
+    // can rebuild the full state. In between, only the objects which changed are sent.
+    if (mCycleNumber % mTaskConfig.deltaPublicationKeyframeCycles == 0) {
+      mObjectsManager->resetChangeTracking();
+    }
+    array.reset(mObjectsManager->getNonOwningArrayOfChanged());
+  } else {
+    array.reset(mObjectsManager->getNonOwningArray());
+  }
   int objectsPublished = array->GetEntries();
+  ILOG(Info, Support) << "Publishing " << objectsPublished << " out of " << mObjectsManager->getNumberPublishedObjects() << " MonitorObjects" << ENDM;
+
+  if (objectsPublished == 0 && mTaskConfig.deltaPublication) {
+    mLastPublicationDuration = publicationDurationTimer.getTime();
+    return 0;
+  }
 
-  outputs.snapshot(
-    Output{ concreteOutput.origin,
-            concreteOutput.description,
-            concreteOutput.subSpec,
-            mTaskConfig.moSpec.lifetime },
-    *array);
+  Output output{ concreteOutput.origin,
+                 concreteOutput.description,
+                 concreteOutput.subSpec,
+                 mTaskConfig.moSpec.lifetime };
+  AliceO2::Common::Timer encodingTimer;
+  if (mTaskConfig.copyHistogramBins && !mTaskConfig.publishToMergers) {
+    // the bins are copied directly into the message
+    auto encodedSize = histogram_transport::encode(
+      *array, [&outputs, &output](size_t size) {
+        return outputs.make<char>(output, size).data();
+      },
+      mTaskConfig.publicationCompression);
+    mLastPublishedBytes = encodedSize.payload;
+    mLastPublishedUncompressedBytes = encodedSize.uncompressed;
+  } else {
+    // Mergers read the objects with ROOT, the bins are copied by the Streamer of the collection
+    array->setCopyHistogramBins(mTaskConfig.copyHistogramBins, mTaskConfig.publicationCompression);
+    outputs.snapshot(output, *array);
+    // the collection is serialized by snapshot(), its Streamer knows the size
+    mLastPublishedBytes = array->getLastStreamedSize().payload;
+    mLastPublishedUncompressedBytes = array->getLastStreamedSize().uncompressed;
+  }
+  mLastEncodingDuration = encodingTimer.getTime();
 
   mLastPublicationDuration = publicationDurationTimer.getTime();
   return objectsPublished;
@@ -79,6 +79,27 @@ TaskRunnerConfig TaskRunnerFactory::extractConfig(const CommonSpec& globalConfig
                                  static_cast<header::DataHeader::SubSpecificationType>(parallelTaskID),
                                  Lifetime::Sporadic };
 
+  bool deltaPublication = taskSpec.deltaPublication;
+  if (deltaPublication && taskSpec.location == TaskLocationSpec::Local && taskSpec.mergingMode == "entire") {
+    // Mergers expecting entire objects replace everything a task sent previously with its latest message
+    ILOG(Warning, Support) << "Delta publication cannot be used with the 'entire' merging mode, it is disabled for the task '" << taskSpec.taskName << "'" << ENDM;
+    deltaPublication = false;
+  }
+  if (taskSpec.deltaPublicationKeyframeCycles < 1) {
+    throw std::runtime_error("deltaPublicationKeyframeCycles of the task '" + taskSpec.taskName + "' should be at least 1.");
+  }
+  histogram_transport::Compression publicationCompression;
+  try {
+    publicationCompression = histogram_transport::Compression::fromString(taskSpec.publicationCompression, taskSpec.publicationCompressionLevel);
+  } catch (const std::invalid_argument& error) {
+    throw std::runtime_error("Invalid publication compression of the task '" + taskSpec.taskName + "': " + error.what());
+  }
+  // compressing the messages requires the encoding of histogram_transport
+  bool copyHistogramBins = taskSpec.copyHistogramBins || publicationCompression.algorithm != histogram_transport::Compression::Algorithm::None;
+  if (taskSpec.monitorDataThreads < 1) {
+    throw std::runtime_error("monitorDataThreads of the task '" + taskSpec.taskName + "' should be at least 1.");
+  }
+
   Options options{
     { "period-timer-cycle", framework::VariantType::Int, static_cast<int>(taskSpec.cycleDurationSeconds * 1000000), { "timer period" } },
     { "runNumber", framework::VariantType::String, { "Run number" } },
@@ -109,7 +130,13 @@ TaskRunnerConfig TaskRunnerFactory::extractConfig(const CommonSpec& globalConfig
     globalConfig.activityPeriodName,
     globalConfig.activityPassName,
     globalConfig.activityProvenance,
-    globalConfig.activityNumber
+    globalConfig.activityNumber,
+    deltaPublication,
+    taskSpec.deltaPublicationKeyframeCycles,
+    taskSpec.monitorDataThreads,
+    copyHistogramBins,
+    publicationCompression,
+    taskSpec.location == TaskLocationSpec::Local
   };
 }
 
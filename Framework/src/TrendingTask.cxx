@@ -21,17 +21,57 @@
 #include "QualityControl/Reductor.h"
 #include "QualityControl/RootClassFactory.h"
 #include <boost/property_tree/ptree.hpp>
-#include <TH1.h>
+#include <TH1F.h>
 #include <TCanvas.h>
 #include <TPaveText.h>
 #include <TDatime.h>
 #include <TGraphErrors.h>
 #include <TPoint.h>
+#include <TTreeFormula.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
 
 using namespace o2::quality_control;
 using namespace o2::quality_control::core;
 using namespace o2::quality_control::postprocessing;
 
+namespace
+{
+// Splits the varexp of TTree::Draw into separate variables, taking care of the scope operators.
+std::vector<std::string> splitVariables(const std::string& varexp)
+{
+  std::vector<std::string> variables(1);
+  for (size_t i = 0; i < varexp.size(); i++) {
+    if (varexp[i] == ':' && i + 1 < varexp.size() && varexp[i + 1] == ':') {
+      variables.back() += "::";
+      i++;
+    } else if (varexp[i] == ':') {
+      variables.emplace_back();
+    } else {
+      variables.back() += varexp[i];
+    }
+  }
+  return variables;
+}
+
+// Draw options which do not make sense for a graph, so the TTree::Draw output cannot be reproduced incrementally.
+bool isHistogramOption(std::string option)
+{
+  std::transform(option.begin(), option.end(), option.begin(), ::tolower);
+  for (const auto& histogramOption : { "col", "box", "lego", "surf", "cont", "hist", "text", "arr" }) {
+    if (option.find(histogramOption) != std::string::npos) {
+      return true;
+    }
+  }
+  return false;
+}
+} // namespace
+
+TrendingTask::IncrementalPlot::IncrementalPlot() = default;
+TrendingTask::IncrementalPlot::~IncrementalPlot() = default;
+TrendingTask::IncrementalPlot::IncrementalPlot(IncrementalPlot&&) noexcept = default;
+
 void TrendingTask::configure(std::string name, const boost::property_tree::ptree& config)
 {
   mConfig = TrendingTaskConfig(name, config);
@@ -39,6 +79,13 @@ void TrendingTask::configure(std::string name, const boost::property_tree::ptree
 
 void TrendingTask::initialize(Trigger, framework::ServiceRegistry&)
 {
+  // The incremental plots refer to the previous TTree, they have to go first.
+  deleteIncrementalPlots();
+  // The previous TTree is still published if the task is initialized again, e.g. at the next START.
+  if (mTrend && getObjectsManager()->isBeingPublished(mTrend->GetName())) {
+    getObjectsManager()->stopPublishing(mTrend.get());
+  }
+
   // Preparing data structure of TTree
   mTrend = std::make_unique<TTree>(); // todo: retrieve last TTree, so we continue trending. maybe do it optionally?
   mTrend->SetName(PostProcessingInterface::getName().c_str());
@@ -50,6 +97,7 @@ void TrendingTask::initialize(Trigger, framework::ServiceRegistry&)
     mTrend->Branch(source.name.c_str(), reductor->getBranchAddress(), reductor->getBranchLeafList());
     mReductors[source.name] = std::move(reductor);
   }
+  mRetriever = std::make_unique<ConcurrentRetriever>(mConfig.retrievalConcurrency);
   if (mConfig.producePlotsOnUpdate) {
     getObjectsManager()->startPublishing(mTrend.get());
   }
@@ -62,7 +110,11 @@ void TrendingTask::update(Trigger t, framework::ServiceRegistry& services)
 
   trendValues(t, qcdb);
   if (mConfig.producePlotsOnUpdate) {
-    generatePlots();
+    if (mConfig.incrementalPlots) {
+      appendToPlots();
+    } else {
+      generatePlots();
+    }
   }
 }
 
@@ -71,6 +123,7 @@ void TrendingTask::finalize(Trigger, framework::ServiceRegistry&)
   if (!mConfig.producePlotsOnUpdate) {
     getObjectsManager()->startPublishing(mTrend.get());
   }
+  // The final plots are always drawn from the complete TTree.
   generatePlots();
 }
 
@@ -81,25 +134,31 @@ void TrendingTask::trendValues(const Trigger& t, repository::DatabaseInterface&
   //  enough if we trend across runs).
   mMetaData.runNumber = -1;
 
+  std::vector<ConcurrentRetriever::Request> requests;
+  std::vector<Reductor*> requestReductors;
   for (auto& dataSource : mConfig.dataSources) {
 
     // todo: make it agnostic to MOs, QOs or other objects. Let the reductor cast to whatever it needs.
     if (dataSource.type == "repository") {
-      auto mo = qcdb.retrieveMO(dataSource.path, dataSource.name, t.timestamp, t.activity);
-      TObject* obj = mo ? mo->getObject() : nullptr;
-      if (obj) {
-        mReductors[dataSource.name]->update(obj);
-      }
+      requests.push_back({ ConcurrentRetriever::Request::Type::MonitorObject, dataSource.path, dataSource.name, static_cast<long>(t.timestamp), t.activity });
     } else if (dataSource.type == "repository-quality") {
-      auto qo = qcdb.retrieveQO(dataSource.path + "/" + dataSource.name, t.timestamp, t.activity);
-      if (qo) {
-        mReductors[dataSource.name]->update(qo.get());
-      }
+      requests.push_back({ ConcurrentRetriever::Request::Type::QualityObject, dataSource.path + "/" + dataSource.name, "", static_cast<long>(t.timestamp), t.activity });
     } else {
       ILOG(Error, Support) << "Unknown type of data source '" << dataSource.type << "'." << ENDM;
+      continue;
     }
+    requestReductors.push_back(mReductors[dataSource.name].get());
   }
 
+  // The sources are retrieved concurrently if configured so, each reductor runs as soon as its object arrives.
+  mRetriever->retrieve(qcdb, requests, [&](size_t index, ConcurrentRetriever::Result& result) {
+    if (TObject* obj = result.mo ? result.mo->getObject() : nullptr) {
+      requestReductors[index]->update(obj);
+    } else if (result.qo) {
+      requestReductors[index]->update(result.qo.get());
+    }
+  });
+
   mTrend->Fill();
 }
 
@@ -113,81 +172,245 @@ void TrendingTask::generatePlots()
   ILOG(Info, Support) << "Generating " << mConfig.plots.size() << " plots." << ENDM;
 
   for (const auto& plot : mConfig.plots) {
+    generatePlot(plot);
+  }
+}
 
-    // Before we generate any new plots, we have to delete existing under the same names.
-    // It seems that ROOT cannot handle an existence of two canvases with a common name in the same process.
-    if (mPlots.count(plot.name)) {
-      getObjectsManager()->stopPublishing(plot.name);
-      delete mPlots[plot.name];
-    }
+void TrendingTask::generatePlot(const TrendingTaskConfig::Plot& plot)
+{
+  // Before we generate any new plots, we have to delete existing under the same names.
+  // It seems that ROOT cannot handle an existence of two canvases with a common name in the same process.
+  deletePlot(plot.name);
+
+  // we determine the order of the plot, i.e. if it is a histogram (1), graph (2), or any higher dimension.
+  const size_t plotOrder = std::count(plot.varexp.begin(), plot.varexp.end(), ':') + 1;
+  // we have to delete the graph errors after the plot is saved, unfortunately the canvas does not take its ownership
+  TGraphErrors* graphErrors = nullptr;
+
+  TCanvas* c = new TCanvas();
+
+  mTrend->Draw(plot.varexp.c_str(), plot.selection.c_str(), plot.option.c_str());
 
-    // we determine the order of the plot, i.e. if it is a histogram (1), graph (2), or any higher dimension.
-    const size_t plotOrder = std::count(plot.varexp.begin(), plot.varexp.end(), ':') + 1;
-    // we have to delete the graph errors after the plot is saved, unfortunately the canvas does not take its ownership
-    TGraphErrors* graphErrors = nullptr;
-
-    TCanvas* c = new TCanvas();
-
-    mTrend->Draw(plot.varexp.c_str(), plot.selection.c_str(), plot.option.c_str());
-
-    c->SetName(plot.name.c_str());
-    c->SetTitle(plot.title.c_str());
-
-    // For graphs we allow to draw errors if they are specified.
-    if (!plot.graphErrors.empty()) {
-      if (plotOrder != 2) {
-        ILOG(Error, Support) << "Non empty graphErrors seen for the plot '" << plot.name << "', which is not a graph, ignoring." << ENDM;
-      } else {
-        // We generate some 4-D points, where 2 dimensions represent graph points and 2 others are the error bars
-        std::string varexpWithErrors(plot.varexp + ":" + plot.graphErrors);
-        mTrend->Draw(varexpWithErrors.c_str(), plot.selection.c_str(), "goff");
-        graphErrors = new TGraphErrors(mTrend->GetSelectedRows(), mTrend->GetVal(1), mTrend->GetVal(0), mTrend->GetVal(2), mTrend->GetVal(3));
-        // We draw on the same plot as the main graph, but only error bars
-        graphErrors->Draw("SAME E");
-        // We try to convince ROOT to delete graphErrors together with the rest of the canvas.
-        if (auto* pad = c->GetPad(0)) {
-          if (auto* primitives = pad->GetListOfPrimitives()) {
-            primitives->Add(graphErrors);
-          }
+  c->SetName(plot.name.c_str());
+  c->SetTitle(plot.title.c_str());
+
+  // For graphs we allow to draw errors if they are specified.
+  if (!plot.graphErrors.empty()) {
+    if (plotOrder != 2) {
+      ILOG(Error, Support) << "Non empty graphErrors seen for the plot '" << plot.name << "', which is not a graph, ignoring." << ENDM;
+    } else {
+      // We generate some 4-D points, where 2 dimensions represent graph points and 2 others are the error bars
+      std::string varexpWithErrors(plot.varexp + ":" + plot.graphErrors);
+      mTrend->Draw(varexpWithErrors.c_str(), plot.selection.c_str(), "goff");
+      graphErrors = new TGraphErrors(mTrend->GetSelectedRows(), mTrend->GetVal(1), mTrend->GetVal(0), mTrend->GetVal(2), mTrend->GetVal(3));
+      // We draw on the same plot as the main graph, but only error bars
+      graphErrors->Draw("SAME E");
+      // We try to convince ROOT to delete graphErrors together with the rest of the canvas.
+      if (auto* pad = c->GetPad(0)) {
+        if (auto* primitives = pad->GetListOfPrimitives()) {
+          primitives->Add(graphErrors);
         }
       }
     }
+  }
 
-    // Postprocessing the plot - adding specified titles, configuring time-based plots, flushing buffers.
-    // Notice that axes and title are drawn using a histogram, even in the case of graphs.
-    if (auto histo = dynamic_cast<TH1*>(c->GetPrimitive("htemp"))) {
-      // The title of histogram is printed, not the title of canvas => we set it as well.
-      histo->SetTitle(plot.title.c_str());
-      // We have to update the canvas to make the title appear.
-      c->Update();
-
-      // After the update, the title has a different size and it is not in the center anymore. We have to fix that.
-      if (auto title = dynamic_cast<TPaveText*>(c->GetPrimitive("title"))) {
-        title->SetBBoxCenterX(c->GetBBoxCenter().fX);
-        // It will have an effect only after invoking Draw again.
-        title->Draw();
-      } else {
-        ILOG(Error, Devel) << "Could not get the title TPaveText of the plot '" << plot.name << "'." << ENDM;
-      }
+  // Postprocessing the plot - adding specified titles, configuring time-based plots, flushing buffers.
+  // Notice that axes and title are drawn using a histogram, even in the case of graphs.
+  if (auto histo = dynamic_cast<TH1*>(c->GetPrimitive("htemp"))) {
+    // The title of histogram is printed, not the title of canvas => we set it as well.
+    histo->SetTitle(plot.title.c_str());
+    // We have to update the canvas to make the title appear.
+    c->Update();
+
+    // After the update, the title has a different size and it is not in the center anymore. We have to fix that.
+    if (auto title = dynamic_cast<TPaveText*>(c->GetPrimitive("title"))) {
+      title->SetBBoxCenterX(c->GetBBoxCenter().fX);
+      // It will have an effect only after invoking Draw again.
+      title->Draw();
+    } else {
+      ILOG(Error, Devel) << "Could not get the title TPaveText of the plot '" << plot.name << "'." << ENDM;
+    }
+
+    // We have to explicitly configure showing time on x axis.
+    // I hope that looking for ":time" is enough here and someone doesn't come with an exotic use-case.
+    if (plot.varexp.find(":time") != std::string::npos) {
+      histo->GetXaxis()->SetTimeDisplay(1);
+      // It deals with highly congested dates labels
+      histo->GetXaxis()->SetNdivisions(505);
+      // Without this it would show dates in order of 2044-12-18 on the day of 2019-12-19.
+      histo->GetXaxis()->SetTimeOffset(0.0);
+      histo->GetXaxis()->SetTimeFormat("%Y-%m-%d %H:%M");
+    }
+    // QCG doesn't empty the buffers before visualizing the plot, nor does ROOT when saving the file,
+    // so we have to do it here.
+    histo->BufferEmpty();
+  } else {
+    ILOG(Error, Devel) << "Could not get the htemp histogram of the plot '" << plot.name << "'." << ENDM;
+  }
+
+  mPlots[plot.name] = c;
+  getObjectsManager()->startPublishing(c);
+}
+
+void TrendingTask::appendToPlots()
+{
+  if (mTrend->GetEntries() < 1) {
+    ILOG(Info, Support) << "No entries in the trend so far, won't generate any plots." << ENDM;
+    return;
+  }
 
-      // We have to explicitly configure showing time on x axis.
-      // I hope that looking for ":time" is enough here and someone doesn't come with an exotic use-case.
-      if (plot.varexp.find(":time") != std::string::npos) {
-        histo->GetXaxis()->SetTimeDisplay(1);
-        // It deals with highly congested dates labels
-        histo->GetXaxis()->SetNdivisions(505);
-        // Without this it would show dates in order of 2044-12-18 on the day of 2019-12-19.
-        histo->GetXaxis()->SetTimeOffset(0.0);
-        histo->GetXaxis()->SetTimeFormat("%Y-%m-%d %H:%M");
+  const Long64_t lastEntry = mTrend->GetEntries() - 1;
+  for (const auto& plot : mConfig.plots) {
+    if (mNonIncrementalPlots.count(plot.name)) {
+      generatePlot(plot);
+    } else if (auto it = mIncrementalPlots.find(plot.name); it != mIncrementalPlots.end()) {
+      appendToPlot(it->second, lastEntry);
+      if (auto canvas = dynamic_cast<TCanvas*>(mPlots[plot.name])) {
+        canvas->Modified();
       }
-      // QCG doesn't empty the buffers before visualizing the plot, nor does ROOT when saving the file,
-      // so we have to do it here.
-      histo->BufferEmpty();
+    } else if (!createIncrementalPlot(plot)) {
+      ILOG(Info, Support) << "The plot '" << plot.name << "' cannot be updated incrementally, it will be redrawn at each update." << ENDM;
+      mNonIncrementalPlots.insert(plot.name);
+      generatePlot(plot);
+    }
+  }
+}
+
+bool TrendingTask::createIncrementalPlot(const TrendingTaskConfig::Plot& plot)
+{
+  auto variables = splitVariables(plot.varexp);
+  if (variables.size() > 2 || (variables.size() == 2 && isHistogramOption(plot.option))) {
+    return false;
+  }
+  if (!plot.graphErrors.empty() && variables.size() == 2) {
+    auto errors = splitVariables(plot.graphErrors);
+    if (errors.size() != 2) {
+      return false;
+    }
+    variables.insert(variables.end(), errors.begin(), errors.end());
+  }
+
+  IncrementalPlot incrementalPlot;
+  for (const auto& variable : variables) {
+    auto formula = std::make_unique<TTreeFormula>(variable.c_str(), variable.c_str(), mTrend.get());
+    // strings are shown by TTree::Draw as alphanumeric bin labels, we do not reproduce that
+    if (formula->GetNdim() == 0 || formula->IsString()) {
+      return false;
+    }
+    incrementalPlot.variables.push_back(std::move(formula));
+  }
+  if (!plot.selection.empty()) {
+    incrementalPlot.selection = std::make_unique<TTreeFormula>("selection", plot.selection.c_str(), mTrend.get());
+    if (incrementalPlot.selection->GetNdim() == 0) {
+      return false;
+    }
+  }
+  incrementalPlot.xMin = incrementalPlot.yMin = std::numeric_limits<double>::max();
+  incrementalPlot.xMax = incrementalPlot.yMax = std::numeric_limits<double>::lowest();
+
+  deletePlot(plot.name);
+  auto* c = new TCanvas();
+  c->SetName(plot.name.c_str());
+  c->SetTitle(plot.title.c_str());
+
+  if (variables.size() == 1) {
+    // Same as htemp of TTree::Draw, the range is decided by the buffer, then the axis is extended when needed.
+    incrementalPlot.histogram = std::make_unique<TH1F>(plot.name.c_str(), plot.title.c_str(), 100, 0, 0);
+    incrementalPlot.histogram->SetDirectory(nullptr);
+    incrementalPlot.histogram->SetCanExtend(TH1::kAllAxes);
+  } else {
+    if (plot.graphErrors.empty()) {
+      incrementalPlot.graph = std::make_unique<TGraph>();
     } else {
-      ILOG(Error, Devel) << "Could not get the htemp histogram of the plot '" << plot.name << "'." << ENDM;
+      incrementalPlot.graph = std::make_unique<TGraphErrors>();
+    }
+    incrementalPlot.graph->SetName(plot.name.c_str());
+    incrementalPlot.graph->SetTitle(plot.title.c_str());
+  }
+
+  for (Long64_t entry = 0; entry < mTrend->GetEntries(); entry++) {
+    appendToPlot(incrementalPlot, entry);
+  }
+
+  if (incrementalPlot.histogram) {
+    incrementalPlot.histogram->Draw(plot.option.c_str());
+  } else {
+    incrementalPlot.graph->Draw(("A" + (plot.option.empty() ? std::string("P") : plot.option)).c_str());
+    if (plot.varexp.find(":time") != std::string::npos) {
+      auto* xAxis = incrementalPlot.graph->GetXaxis();
+      xAxis->SetTimeDisplay(1);
+      xAxis->SetNdivisions(505);
+      xAxis->SetTimeOffset(0.0);
+      xAxis->SetTimeFormat("%Y-%m-%d %H:%M");
     }
+  }
+
+  mIncrementalPlots.emplace(plot.name, std::move(incrementalPlot));
+  mPlots[plot.name] = c;
+  getObjectsManager()->startPublishing(c);
+  return true;
+}
+
+void TrendingTask::appendToPlot(IncrementalPlot& incrementalPlot, Long64_t entry)
+{
+  mTrend->LoadTree(entry);
+  if (incrementalPlot.selection && (incrementalPlot.selection->GetNdata() < 1 || incrementalPlot.selection->EvalInstance(0) == 0)) {
+    return;
+  }
+  std::vector<double> values;
+  for (auto& variable : incrementalPlot.variables) {
+    if (variable->GetNdata() < 1) {
+      return;
+    }
+    values.push_back(variable->EvalInstance(0));
+  }
+
+  if (incrementalPlot.histogram) {
+    incrementalPlot.histogram->Fill(values[0]);
+    // QCG doesn't empty the buffers before visualizing the plot, nor does ROOT when saving the file.
+    incrementalPlot.histogram->BufferEmpty();
+    return;
+  }
+
+  // TTree::Draw puts the first variable on the y axis
+  const double x = values[1];
+  const double y = values[0];
+  auto* graph = incrementalPlot.graph.get();
+  const int point = graph->GetN();
+  graph->SetPoint(point, x, y);
+  if (values.size() == 4) {
+    static_cast<TGraphErrors*>(graph)->SetPointError(point, values[2], values[3]);
+  }
+
+  const double ex = values.size() == 4 ? std::abs(values[2]) : 0;
+  const double ey = values.size() == 4 ? std::abs(values[3]) : 0;
+  incrementalPlot.xMin = std::min(incrementalPlot.xMin, x - ex);
+  incrementalPlot.xMax = std::max(incrementalPlot.xMax, x + ex);
+  incrementalPlot.yMin = std::min(incrementalPlot.yMin, y - ey);
+  incrementalPlot.yMax = std::max(incrementalPlot.yMax, y + ey);
+  // The axis ranges are kept up to date here, so the graph never has to recompute them from all the points.
+  const double xMargin = std::max(0.05 * (incrementalPlot.xMax - incrementalPlot.xMin), 1.0);
+  const double yMargin = std::max(0.1 * (incrementalPlot.yMax - incrementalPlot.yMin), 1e-6);
+  graph->GetXaxis()->SetLimits(incrementalPlot.xMin - xMargin, incrementalPlot.xMax + xMargin);
+  graph->SetMinimum(incrementalPlot.yMin - yMargin);
+  graph->SetMaximum(incrementalPlot.yMax + yMargin);
+}
 
-    mPlots[plot.name] = c;
-    getObjectsManager()->startPublishing(c);
+void TrendingTask::deletePlot(const std::string& name)
+{
+  if (mPlots.count(name)) {
+    getObjectsManager()->stopPublishing(name);
+    delete mPlots[name];
+    mPlots.erase(name);
+  }
+  // the canvas does not own the objects of incremental plots, they are deleted after it
+  mIncrementalPlots.erase(name);
+}
+
+void TrendingTask::deleteIncrementalPlots()
+{
+  while (!mIncrementalPlots.empty()) {
+    deletePlot(mIncrementalPlots.begin()->first);
   }
+  mNonIncrementalPlots.clear();
 }
@@ -103,7 +103,7 @@ TriggerFcn triggerFactory(std::string trigger, const PostProcessingConfig& confi
   } else if (triggerLowerCase.find("newobject") != std::string::npos) {
     const auto [db, objectPath] = parseDbTriggers(trigger, "newobject");
     const std::string& dbUrl = db == "qcdb" ? config.qcdbUrl : config.ccdbUrl;
-    return triggers::NewObject(dbUrl, db, objectPath, activity);
+    return triggers::NewObject(dbUrl, db, objectPath, activity, config.newObjectPollingSeconds);
   } else if (triggerLowerCase.find("foreachobject") != std::string::npos) {
     const auto [db, objectPath] = parseDbTriggers(trigger, "foreachobject");
     const std::string& dbUrl = db == "qcdb" ? config.qcdbUrl : config.ccdbUrl;
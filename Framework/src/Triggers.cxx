@@ -18,14 +18,17 @@
 #include "QualityControl/QcInfoLogger.h"
 #include "QualityControl/DatabaseHelpers.h"
 #include "QualityControl/CcdbDatabase.h"
+#include "QualityControl/ObjectWatcher.h"
 
-#include <CCDB/CcdbApi.h>
 #include <Common/Timer.h>
+#include <algorithm>
 #include <chrono>
 #include <ostream>
+#include <unordered_map>
 
 using namespace std::chrono;
 using namespace o2::quality_control::core;
+using o2::quality_control::repository::database_helpers::ListedVersion;
 namespace o2::quality_control::postprocessing
 {
 
@@ -40,6 +43,28 @@ uint64_t Trigger::msSinceEpoch()
   return duration_cast<milliseconds>(system_clock::now().time_since_epoch()).count();
 }
 
+namespace
+{
+
+// hash and equality of activities which are the same, regardless of their validity
+struct SameActivityHash {
+  size_t operator()(const Activity& activity) const
+  {
+    size_t hash = std::hash<int>{}(activity.mId);
+    for (size_t value : { std::hash<int>{}(activity.mType), std::hash<std::string>{}(activity.mPeriodName),
+                          std::hash<std::string>{}(activity.mPassName), std::hash<std::string>{}(activity.mProvenance) }) {
+      hash ^= value + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    }
+    return hash;
+  }
+};
+
+struct SameActivity {
+  bool operator()(const Activity& a, const Activity& b) const { return a.same(b); }
+};
+
+} // namespace
+
 namespace triggers
 {
 
@@ -137,92 +162,60 @@ TriggerFcn Periodic(double seconds, const Activity& activity)
   };
 }
 
-TriggerFcn NewObject(std::string databaseUrl, std::string databaseType, std::string objectPath, const Activity& activity)
+TriggerFcn NewObject(std::string databaseUrl, std::string databaseType, std::string objectPath, const Activity& activity, double pollingSeconds)
 {
-  // Key names in the header map.
-  constexpr auto md5key = "Content-MD5";
-  constexpr auto timestampKey = "Valid-From";
   auto fullObjectPath = (databaseType == "qcdb" ? activity.mProvenance + "/" : "") + objectPath;
 
   ILOG(Debug, Support) << "Initializing newObject trigger for the object '" << fullObjectPath << "' and Activity '" << activity << "'" << ENDM;
   // We support only CCDB here.
-  auto db = std::make_shared<o2::ccdb::CcdbApi>();
-  db->init(databaseUrl);
-  if (!db->isHostReachable()) {
-    ILOG(Error, Support) << "CCDB at URL '" << databaseUrl << "' is not reachable." << ENDM;
-  }
-
-  // We rely on changing MD5 - if the object has changed, it should have a different check sum.
-  // If someone reuploaded an old object, it should not have an influence.
-  std::string lastMD5;
+  // The objects are checked in the background by a watcher shared with the other triggers of the process.
+  auto watcher = ObjectWatcher::getInstance(databaseUrl, duration_cast<milliseconds>(duration<double>(pollingSeconds)));
   auto metadata = repository::database_helpers::asDatabaseMetadata(activity, false);
-  if (auto headers = db->retrieveHeaders(fullObjectPath, metadata); headers.count(md5key)) {
-    lastMD5 = headers[md5key];
-  } else {
+  auto watch = watcher->watch(fullObjectPath, metadata);
+  auto lastVersion = watch->getState().version;
+  if (lastVersion == 0) {
     // We don't make a fuss over it, because we might be just waiting for the first version of such object.
     // It should not happen often though, so having a warning makes sense.
     ILOG(Warning, Support) << "Could not find the file '" << fullObjectPath << "' in the db '" << databaseUrl << "' for given Activity settings. It is fine at SOR." << ENDM;
   }
 
-  return [db, databaseUrl = std::move(databaseUrl), fullObjectPath = std::move(fullObjectPath), lastMD5, activity, metadata]() mutable -> Trigger {
-    if (auto headers = db->retrieveHeaders(fullObjectPath, metadata); headers.count(md5key)) {
-      auto newMD5 = headers[md5key];
-      if (lastMD5 != newMD5) {
-        lastMD5 = newMD5;
-        return { TriggerType::NewObject, false, activity, std::stoull(headers[timestampKey]) };
-      }
-    } else {
-      // We don't make a fuss over it, because we might be just waiting for the first version of such object.
-      // It should not happen often though, so having a warning makes sense.
-      ILOG(Warning, Support) << "Could not find the file '" << fullObjectPath << "' in the db '" << databaseUrl << "' for given Activity settings." << ENDM;
+  return [watcher, watch, lastVersion, activity]() mutable -> Trigger {
+    auto state = watch->getState();
+    if (state.version != lastVersion) {
+      lastVersion = state.version;
+      return { TriggerType::NewObject, false, activity, state.validFrom };
     }
-
     return { TriggerType::No, false };
   };
 }
 
 TriggerFcn ForEachObject(std::string databaseUrl, std::string databaseType, std::string objectPath, const Activity& activity)
 {
-  // Key names in the header map.
-  constexpr auto md5key = "Content-MD5";
-  constexpr auto timestampKey = "Valid-From";
   auto fullObjectPath = (databaseType == "qcdb" ? activity.mProvenance + "/" : "") + objectPath;
 
   // We support only CCDB here.
   auto db = std::make_shared<repository::CcdbDatabase>();
   db->connect(databaseUrl, "", "", "");
 
-  auto objects = db->getListingAsPtree(fullObjectPath).get_child("objects");
-  ILOG(Info, Support) << "Got " << objects.size() << " objects for the path '" << fullObjectPath << "'" << ENDM;
-  auto filteredObjects = std::make_shared<std::vector<boost::property_tree::ptree>>();
-  const auto& filter = activity;
-
   ILOG(Debug, Devel) << "Filter activity: " << activity << ENDM;
+  const auto& filter = activity;
+  auto filteredObjects = std::make_shared<std::vector<ListedVersion>>(
+    db->getListedVersions(fullObjectPath, [&filter](const Activity& objectActivity) { return filter.matches(objectActivity); }));
+  ILOG(Info, Support) << filteredObjects->size() << " objects matched the specified activity for the path '" << fullObjectPath << "'" << ENDM;
 
   // As for today, we receive objects in the order of the newest to the oldest.
-  // We prefer the other order here.
-  for (auto rit = objects.rbegin(); rit != objects.rend(); ++rit) {
-    auto objectActivity = repository::database_helpers::asActivity(rit->second);
-    if (filter.matches(objectActivity)) {
-      filteredObjects->emplace_back(rit->second);
-      ILOG(Debug, Devel) << "Matched an object with activity: " << activity << ENDM;
-    }
-  }
-  ILOG(Info, Support) << filteredObjects->size() << " objects matched the specified activity" << ENDM;
-
-  // we make sure it is sorted. If it is already, it shouldn't cost much.
-  std::sort(filteredObjects->begin(), filteredObjects->end(),
-            [](const boost::property_tree::ptree& a, const boost::property_tree::ptree& b) {
-              return a.get<int64_t>(timestampKey) < b.get<int64_t>(timestampKey);
-            });
-
-  return [filteredObjects, activity, currentObject = filteredObjects->begin()]() mutable -> Trigger {
-    if (currentObject != filteredObjects->end()) {
-      auto currentActivity = repository::database_helpers::asActivity(*currentObject);
-      bool last = currentObject + 1 == filteredObjects->end();
-      Trigger trigger(TriggerType::ForEachObject, last, currentActivity, currentObject->get<int64_t>(timestampKey));
+  // We prefer the other order here. Then we make sure it is sorted, if it is already, it shouldn't cost much.
+  std::reverse(filteredObjects->begin(), filteredObjects->end());
+  std::stable_sort(filteredObjects->begin(), filteredObjects->end(), [](const ListedVersion& a, const ListedVersion& b) {
+    return a.activity.mValidity.getMin() < b.activity.mValidity.getMin();
+  });
+
+  return [filteredObjects, activity, currentObject = size_t{ 0 }]() mutable -> Trigger {
+    if (currentObject < filteredObjects->size()) {
+      const auto& object = (*filteredObjects)[currentObject];
+      bool last = currentObject + 1 == filteredObjects->size();
       ++currentObject;
-      return trigger;
+      return { TriggerType::ForEachObject, last, object.activity, object.activity.mValidity.getMin() };
     } else {
       return { TriggerType::No, true, activity };
     }
@@ -231,55 +224,42 @@ TriggerFcn ForEachObject(std::string databaseUrl, std::string databaseType, std:
 
 TriggerFcn ForEachLatest(std::string databaseUrl, std::string databaseType, std::string objectPath, const Activity& activity)
 {
-  // Key names in the header map.
-  constexpr auto md5key = "Content-MD5";
-  constexpr auto timestampKey = "Created";
   auto fullObjectPath = (databaseType == "qcdb" ? activity.mProvenance + "/" : "") + objectPath;
 
   // We support only CCDB here.
   auto db = std::make_shared<repository::CcdbDatabase>();
   db->connect(databaseUrl, "", "", "");
 
-  auto objects = db->getListingAsPtree(fullObjectPath).get_child("objects");
-  ILOG(Info, Support) << "Got " << objects.size() << " objects for the path '" << fullObjectPath << "'" << ENDM;
-  auto filteredObjects = std::make_shared<std::vector<std::pair<Activity, boost::property_tree::ptree>>>();
-  const auto& filter = activity;
-
   ILOG(Debug, Devel) << "Filter activity: " << activity << ENDM;
-
-  // As for today, we receive objects in the order of the newest to the oldest.
-  // We prefer the other order here.
-  for (auto rit = objects.rbegin(); rit != objects.rend(); ++rit) {
-    auto objectActivity = repository::database_helpers::asActivity(rit->second);
-    if (filter.matches(objectActivity)) {
-      auto latestObject = std::find_if(filteredObjects->begin(), filteredObjects->end(), [&](const std::pair<Activity, boost::property_tree::ptree>& entry) {
-        return entry.first.same(objectActivity);
-      });
-      if (latestObject != filteredObjects->end() && latestObject->second.get<int64_t>(timestampKey) < rit->second.get<int64_t>(timestampKey)) {
-        *latestObject = { objectActivity, rit->second };
-        ILOG(Debug, Devel) << "Updated the object with activity: " << objectActivity << ENDM;
-      } else {
-        filteredObjects->emplace_back(objectActivity, rit->second);
-        ILOG(Debug, Devel) << "Matched an object with activity: " << objectActivity << ENDM;
-      }
+  const auto& filter = activity;
+  auto matchedObjects = db->getListedVersions(fullObjectPath, [&filter](const Activity& objectActivity) { return filter.matches(objectActivity); });
+  ILOG(Info, Support) << matchedObjects.size() << " objects matched the specified activity for the path '" << fullObjectPath << "'" << ENDM;
+
+  // We keep the latest version for each distinct activity.
+  // As for today, we receive objects in the order of the newest to the oldest. We prefer the other order here.
+  auto filteredObjects = std::make_shared<std::vector<ListedVersion>>();
+  std::unordered_map<Activity, size_t, SameActivityHash, SameActivity> latestObjects;
+  for (auto rit = matchedObjects.rbegin(); rit != matchedObjects.rend(); ++rit) {
+    auto [latestObject, inserted] = latestObjects.try_emplace(rit->activity, filteredObjects->size());
+    if (inserted) {
+      filteredObjects->push_back(std::move(*rit));
+    } else if ((*filteredObjects)[latestObject->second].created < rit->created) {
+      (*filteredObjects)[latestObject->second] = std::move(*rit);
     }
   }
-  ILOG(Info, Support) << filteredObjects->size() << " objects matched the specified activity" << ENDM;
+  ILOG(Info, Support) << filteredObjects->size() << " distinct activities matched the specified activity" << ENDM;
 
   // we make sure it is sorted. If it is already, it shouldn't cost much.
-  std::sort(filteredObjects->begin(), filteredObjects->end(),
-            [](const std::pair<Activity, boost::property_tree::ptree>& a, const std::pair<Activity, boost::property_tree::ptree>& b) {
-              return a.second.get<int64_t>(timestampKey) < b.second.get<int64_t>(timestampKey);
-            });
-
-  return [filteredObjects, activity, currentObject = filteredObjects->begin()]() mutable -> Trigger {
-    if (currentObject != filteredObjects->end()) {
-      const auto& currentActivity = currentObject->first;
-      const auto& currentPtree = currentObject->second;
-      bool last = currentObject + 1 == filteredObjects->end();
-      Trigger trigger(TriggerType::ForEachLatest, last, currentActivity, currentPtree.get<int64_t>(timestampKey));
+  std::stable_sort(filteredObjects->begin(), filteredObjects->end(), [](const ListedVersion& a, const ListedVersion& b) {
+    return a.created < b.created;
+  });
+
+  return [filteredObjects, activity, currentObject = size_t{ 0 }]() mutable -> Trigger {
+    if (currentObject < filteredObjects->size()) {
+      const auto& object = (*filteredObjects)[currentObject];
+      bool last = currentObject + 1 == filteredObjects->size();
       ++currentObject;
-      return trigger;
+      return { TriggerType::ForEachLatest, last, object.activity, object.created };
     } else {
       return { TriggerType::No, true, activity };
     }
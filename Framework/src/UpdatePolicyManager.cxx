@@ -19,6 +19,8 @@
 #include "QualityControl/QcInfoLogger.h"
 #include "Common/Exceptions.h"
 
+#include <algorithm>
+
 using namespace AliceO2::Common;
 
 namespace o2::quality_control::checker
@@ -31,19 +33,20 @@ void UpdatePolicyManager::updateGlobalRevision()
     // mGlobalRevision cannot be 0
     // 0 means overflow, increment and update all check revisions to 0
     ++mGlobalRevision;
-    for (auto& actor : mPoliciesByActor) {
-      updateActorRevision(actor.second.actorName, 0);
+    for (size_t actorId = 0; actorId < mPolicies.size(); ++actorId) {
+      setActorRevision(actorId, 0);
     }
   }
 }
 
 void UpdatePolicyManager::updateActorRevision(const std::string& actorName, RevisionType revision)
 {
-  if (mPoliciesByActor.count(actorName) == 0) {
+  auto actorIt = mActorIds.find(actorName);
+  if (actorIt == mActorIds.end()) {
     ILOG(Error, Support) << "Cannot update revision for " << actorName << " : object not found" << ENDM;
     BOOST_THROW_EXCEPTION(ObjectNotFoundError() << errinfo_object_name(actorName));
   }
-  mPoliciesByActor.at(actorName).revision = revision;
+  setActorRevision(actorIt->second, revision);
 }
 
 void UpdatePolicyManager::updateActorRevision(std::string actorName)
@@ -51,9 +54,26 @@ void UpdatePolicyManager::updateActorRevision(std::string actorName)
   updateActorRevision(actorName, mGlobalRevision);
 }
 
+void UpdatePolicyManager::setActorRevision(size_t actorId, RevisionType revision)
+{
+  auto& policy = mPolicies[actorId];
+  policy.revision = revision;
+  if (revision >= mMaxObjectRevision) {
+    // the usual case: no object can be newer than the actor
+    policy.updatedInputs = 0;
+    return;
+  }
+  policy.updatedInputs = std::count_if(policy.inputObjectIds.begin(), policy.inputObjectIds.end(), [&](size_t objectId) {
+    return mObjects[objectId].received && mObjects[objectId].revision > revision;
+  });
+  if (policy.updatedInputs > 0) {
+    markCandidate(actorId);
+  }
+}
+
 void UpdatePolicyManager::updateObjectRevision(std::string objectName, RevisionType revision)
 {
-  mObjectsRevision[objectName] = revision;
+  setObjectRevision(internObject(objectName), revision);
 }
 
 void UpdatePolicyManager::updateObjectRevision(std::string objectName)
@@ -61,113 +81,145 @@ void UpdatePolicyManager::updateObjectRevision(std::string objectName)
   updateObjectRevision(objectName, mGlobalRevision);
 }
 
-void UpdatePolicyManager::addPolicy(std::string actorName, UpdatePolicyType policyType, std::vector<std::string> objectNames, bool allObjects, bool policyHelper)
+void UpdatePolicyManager::updateObjectRevision(size_t objectId)
+{
+  setObjectRevision(objectId, mGlobalRevision);
+}
+
+size_t UpdatePolicyManager::getObjectId(const std::string& objectName)
 {
-  UpdatePolicyFunctionType policy;
-  switch (policyType) {
-    case UpdatePolicyType::OnAll: {
-      /**
-       * Run check if all MOs are updated
-       */
-      policy = [&, actorName]() {
-        for (const auto& objectName : mPoliciesByActor.at(actorName).inputObjects) {
-          if (mObjectsRevision.count(objectName) == 0 || mObjectsRevision.at(objectName) <= mPoliciesByActor.at(actorName).revision) {
-            return false;
-          }
-        }
-        return true;
-      };
-      break;
+  return internObject(objectName);
+}
+
+void UpdatePolicyManager::setObjectRevision(size_t objectId, RevisionType revision)
+{
+  auto& object = mObjects[objectId];
+  for (auto actorId : object.dependentActors) {
+    auto& policy = mPolicies[actorId];
+    bool wasUpdated = object.received && object.revision > policy.revision;
+    bool isUpdated = revision > policy.revision;
+    if (!object.received) {
+      policy.receivedInputs++;
     }
-    case UpdatePolicyType::OnAnyNonZero: {
-      /**
-       * Return true if any declared MOs were updated
-       * Guarantee that all declared MOs are available
-       */
-      policy = [&, actorName]() {
-        if (!mPoliciesByActor.at(actorName).policyHelperFlag) {
-          // Check if all monitor objects are available
-          for (const auto& objectName : mPoliciesByActor.at(actorName).inputObjects) {
-            if (!mObjectsRevision.count(objectName)) {
-              return false;
-            }
-          }
-          // From now on all MOs are available
-          mPoliciesByActor.at(actorName).policyHelperFlag = true;
-        }
-
-        for (const auto& objectName : mPoliciesByActor.at(actorName).inputObjects) {
-          if (mObjectsRevision[objectName] > mPoliciesByActor.at(actorName).revision) {
-            return true;
-          }
-        }
-        return false;
-      };
-      break;
+    if (isUpdated && !wasUpdated) {
+      policy.updatedInputs++;
+    } else if (wasUpdated && !isUpdated) {
+      policy.updatedInputs--;
     }
-    case UpdatePolicyType::OnEachSeparately: {
-      /**
-        * Return true if any declared object were updated.
-        * This is the same behaviour as OnAny.
-        */
-      policy = [&, actorName]() {
-        if (mPoliciesByActor.at(actorName).allInputObjects) {
-          return true;
-        }
-
-        for (const auto& objectName : mPoliciesByActor.at(actorName).inputObjects) {
-          if (mObjectsRevision.count(objectName) && mObjectsRevision[objectName] > mPoliciesByActor.at(actorName).revision) {
-            return true;
-          }
-        }
-        return false;
-      };
-      break;
+    if (isUpdated) {
+      markCandidate(actorId);
     }
-    case UpdatePolicyType::OnGlobalAny: {
-      /**
-       * Return true if any MOs were updated.
-       * Inner policy - used for `"MOs": "all"`
-       * Might return true even if MO is not used in Check
-       */
-
-      policy = []() {
-        // Expecting check of this policy only if any change
-        return true;
-      };
-      break;
+  }
+  object.revision = revision;
+  object.received = true;
+  mMaxObjectRevision = std::max(mMaxObjectRevision, revision);
+}
+
+size_t UpdatePolicyManager::internObject(const std::string& objectName)
+{
+  auto [objectIt, inserted] = mObjectIds.try_emplace(objectName, mObjects.size());
+  if (inserted) {
+    mObjects.emplace_back();
+  }
+  return objectIt->second;
+}
+
+void UpdatePolicyManager::addPolicy(std::string actorName, UpdatePolicyType policyType, std::vector<std::string> objectNames, bool allObjects, bool policyHelper)
+{
+  auto [actorIt, inserted] = mActorIds.try_emplace(actorName, mPolicies.size());
+  auto actorId = actorIt->second;
+  if (inserted) {
+    mPolicies.emplace_back();
+    mIsCandidate.push_back(false);
+  } else {
+    // the policy is replaced, the actor does not depend on its previous inputs anymore
+    for (auto objectId : mPolicies[actorId].inputObjectIds) {
+      auto& dependentActors = mObjects[objectId].dependentActors;
+      dependentActors.erase(std::remove(dependentActors.begin(), dependentActors.end(), actorId), dependentActors.end());
     }
-    case UpdatePolicyType::OnAny: {
-      /**
-       * Default behaviour
-       *
-       * Run check if any declared MOs are updated
-       * Does not guarantee to contain all declared MOs
-       */
-      policy = [&, actorName]() {
-        for (const auto& objectName : mPoliciesByActor.at(actorName).inputObjects) {
-          if (mObjectsRevision.count(objectName) && mObjectsRevision[objectName] > mPoliciesByActor.at(actorName).revision) {
-            return true;
-          }
-        }
-        return false;
-      };
-      break;
+  }
+
+  UpdatePolicy policy{ actorName, policyType, std::move(objectNames), allObjects, policyHelper };
+  for (const auto& objectName : policy.inputObjects) {
+    auto objectId = internObject(objectName);
+    if (std::find(policy.inputObjectIds.begin(), policy.inputObjectIds.end(), objectId) != policy.inputObjectIds.end()) {
+      continue;
+    }
+    policy.inputObjectIds.push_back(objectId);
+    auto& object = mObjects[objectId];
+    object.dependentActors.push_back(actorId);
+    if (object.received) {
+      policy.receivedInputs++;
+      if (object.revision > policy.revision) {
+        policy.updatedInputs++;
+      }
     }
   }
+  mPolicies[actorId] = std::move(policy);
+  markCandidate(actorId);
 
-  mPoliciesByActor[actorName] = { actorName, policy, objectNames, allObjects, policyHelper };
+  ILOG(Info, Devel) << "Added a policy : " << mPolicies[actorId] << ENDM;
+}
 
-  ILOG(Info, Devel) << "Added a policy : " << mPoliciesByActor[actorName] << ENDM;
+bool UpdatePolicyManager::isReady(const UpdatePolicy& policy) const
+{
+  switch (policy.policyType) {
+    case UpdatePolicyType::OnAll:
+      // Run check if all MOs are updated
+      return policy.updatedInputs == policy.inputObjectIds.size();
+    case UpdatePolicyType::OnAnyNonZero:
+      // Return true if any declared MOs were updated, guarantee that all declared MOs are available.
+      // Objects are never forgotten until reset(), so once all of them are received, they stay available.
+      return (policy.policyHelperFlag || policy.receivedInputs == policy.inputObjectIds.size()) && policy.updatedInputs > 0;
+    case UpdatePolicyType::OnEachSeparately:
+      // Return true if any declared object were updated. This is the same behaviour as OnAny.
+      return policy.allInputObjects || policy.updatedInputs > 0;
+    case UpdatePolicyType::OnGlobalAny:
+      // Inner policy - used for `"MOs": "all"`. Expecting check of this policy only if any change
+      return true;
+    case UpdatePolicyType::OnAny:
+    default:
+      // Default behaviour. Run check if any declared MOs are updated, does not guarantee to contain all declared MOs
+      return policy.updatedInputs > 0;
+  }
 }
 
 bool UpdatePolicyManager::isReady(const std::string& actorName)
 {
-  if (mPoliciesByActor.count(actorName) == 0) {
+  auto actorIt = mActorIds.find(actorName);
+  if (actorIt == mActorIds.end()) {
     ILOG(Error, Support) << "Cannot check if " << actorName << " is ready : object not found" << ENDM;
     BOOST_THROW_EXCEPTION(ObjectNotFoundError() << errinfo_object_name(actorName));
   }
-  return mPoliciesByActor.at(actorName).isReady();
+  return isReady(mPolicies[actorIt->second]);
+}
+
+void UpdatePolicyManager::markCandidate(size_t actorId)
+{
+  if (!mIsCandidate[actorId]) {
+    mIsCandidate[actorId] = true;
+    mCandidates.push_back(actorId);
+  }
+}
+
+std::vector<std::string> UpdatePolicyManager::getReadyActors()
+{
+  std::sort(mCandidates.begin(), mCandidates.end());
+
+  std::vector<std::string> readyActors;
+  std::vector<size_t> stillCandidates;
+  for (auto actorId : mCandidates) {
+    if (isReady(mPolicies[actorId])) {
+      // it stays a candidate until the caller triggers it
+      readyActors.push_back(mPolicies[actorId].actorName);
+      stillCandidates.push_back(actorId);
+    } else {
+      // it can become ready only once one of its inputs is updated, which marks it again
+      mIsCandidate[actorId] = false;
+    }
+  }
+  mCandidates = std::move(stillCandidates);
+  return readyActors;
 }
 
 std::ostream& operator<<(std::ostream& out, const UpdatePolicy& updatePolicy) // output
@@ -185,9 +237,14 @@ std::ostream& operator<<(std::ostream& out, const UpdatePolicy& updatePolicy) //
 
 void UpdatePolicyManager::reset()
 {
-  mPoliciesByActor.clear();
-  mObjectsRevision.clear();
+  mPolicies.clear();
+  mActorIds.clear();
+  mObjects.clear();
+  mObjectIds.clear();
+  mCandidates.clear();
+  mIsCandidate.clear();
   mGlobalRevision = 1;
+  mMaxObjectRevision = 0;
 }
 
-} // namespace o2::quality_control::checker
\ No newline at end of file
+} // namespace o2::quality_control::checker
@@ -18,14 +18,14 @@
 #include "QualityControl/QcInfoLogger.h"
 #include "QualityControl/MonitorObject.h"
 #include "QualityControl/MonitorObjectCollection.h"
+#include "QualityControl/RootFileHelpers.h"
+#include "QualityControl/FileMerger.h"
 
 #include <string>
-#include <unordered_map>
 #include <fstream>
 #include <boost/program_options.hpp>
 #include <boost/exception/diagnostic_information.hpp>
 #include <TFile.h>
-#include <TKey.h>
 #include <TGrid.h>
 
 namespace bpo = boost::program_options;
@@ -42,6 +42,7 @@ int main(int argc, const char* argv[])
       ("exit-on-error", bpo::bool_switch()->default_value(false), "Makes the executable exit if any of the input files could not be read.")                                    //
       ("output-file", bpo::value<std::string>()->default_value("merged.root"), "File path to store the merged results, if the file exists, it will be merged with new files.") //
       ("input-files-list", bpo::value<std::string>()->default_value(""), "Path to a file containing a list of input files (row by row)")                                       //
+      ("threads", bpo::value<size_t>()->default_value(1), "Number of threads merging the input files. Each of them keeps its own copy of the merged objects.")               //
       ("input-files", bpo::value<std::vector<std::string>>()->composing(),
        "Space-separated file paths which should be merged.");
 
@@ -107,78 +108,12 @@ int main(int argc, const char* argv[])
     }
     ILOG(Debug) << "Output file '" << outputFilePath << "' successfully open." << ENDM;
 
-    std::unordered_map<std::string, MonitorObjectCollection*> mergedMocMap;
-    for (const auto& inputFilePath : inputFilePaths) {
-      auto* file = TFile::Open(inputFilePath.c_str(), "READ");
-      if (file == nullptr) {
-        handleError("File handler for '" + inputFilePath + "' is nullptr.");
-        continue;
-      }
-      if (file->IsZombie()) {
-        handleError("File '" + inputFilePath + "' is zombie.");
-        continue;
-      }
-      if (!file->IsOpen()) {
-        handleError("Failed to open the file: " + inputFilePath);
-        continue;
-      }
-      ILOG(Debug) << "Input file '" << inputFilePath << "' successfully open." << ENDM;
-
-      TIter next(file->GetListOfKeys());
-      TKey* key;
-      while ((key = (TKey*)next())) {
-        auto inputTObj = file->Get(key->GetName());
-        if (inputTObj != nullptr) {
-          auto inputMOC = dynamic_cast<MonitorObjectCollection*>(inputTObj);
-          if (inputMOC == nullptr) {
-            handleError("Could not cast the input object to MonitorObjectCollection.");
-            delete inputTObj;
-            continue;
-          }
-
-          inputMOC->postDeserialization();
-
-          if (mergedMocMap.count(inputMOC->GetName()) == 0) {
-            auto mergedTObj = outputFile->Get(key->GetName());
-            if (mergedTObj != nullptr) {
-              auto mergedMOC = dynamic_cast<MonitorObjectCollection*>(mergedTObj);
-              if (mergedMOC == nullptr) {
-                handleError("Could not cast the merged object to MonitorObjectCollection, skipping.");
-                delete mergedMOC;
-                continue;
-              }
-              mergedMOC->postDeserialization();
-              mergedMocMap[mergedMOC->GetName()] = mergedMOC;
-              ILOG(Info) << "Read merged object '" << mergedMOC->GetName() << "'" << ENDM;
-            }
-          }
-
-          if (mergedMocMap.count(inputMOC->GetName())) {
-            try {
-              mergedMocMap[inputMOC->GetName()]->merge(inputMOC);
-            } catch (...) {
-              if (vm["exit-on-error"].as<bool>()) {
-                throw;
-              } else {
-                ILOG(Error, Ops) << "Exception caught: " << boost::current_exception_diagnostic_information(true) << ENDM;
-                ILOG(Error, Ops) << "Failed to merge the Monitor Object Collection, but will try to continue." << ENDM;
-              }
-            }
-            delete inputMOC;
-          } else {
-            mergedMocMap[inputMOC->GetName()] = inputMOC;
-          }
-        }
-      }
-      file->Close();
-      delete file;
-
-      filesRead++;
-    }
+    auto exitOnError = vm["exit-on-error"].as<bool>();
+    auto threads = vm["threads"].as<size_t>();
+    auto mergedMocMap = file_merger::mergeFiles(inputFilePaths, *outputFile, threads, handleError, exitOnError, filesRead);
 
     for (auto& [mocName, moc] : mergedMocMap) {
-      outputFile->WriteObject(moc, mocName.c_str(), "Overwrite");
-      delete moc;
+      root_file_helpers::writeMonitorObjectCollection(*outputFile, *moc);
     }
     outputFile->Close();
 
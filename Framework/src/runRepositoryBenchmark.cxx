@@ -46,7 +46,16 @@ void addCustomOptions(bpo::options_description& options)
     "monitoring-threaded-interval", bpo::value<int>()->default_value(1),
     "In case we have a thread for the monitoring, interval in sec. between sending monitoring data")(
     "monitoring-url", bpo::value<std::string>()->default_value("infologger://"),
-    "The URL to the monitoring system (default : \"infologger://\")");
+    "The URL to the monitoring system (default : \"infologger://\")")(
+    "threads", bpo::value<uint64_t>()->default_value(0),
+    "Number of threads storing number-objects objects max-iterations times as fast as possible, then reporting the "
+    "throughput and latencies (0 - one store per second from the device, default : 0)")(
+    "stand-in", bpo::value<int>()->default_value(0),
+    "Whether to store in a local CCDB stand-in started by the benchmark instead of database-url (1:true, 0:false)")(
+    "stand-in-latency-ms", bpo::value<uint64_t>()->default_value(0),
+    "Latency added by the stand-in to each answer, in ms (default : 0)")(
+    "stand-in-error-rate", bpo::value<double>()->default_value(0),
+    "Fraction of the requests answered with an error by the stand-in, not allowed with threads (default : 0)");
 }
 
 std::unique_ptr<fair::mq::Device> getDevice(fair::mq::ProgOptions& /*config*/)
@@ -0,0 +1,229 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   testAsyncDatabase.cxx
+///
+
+#include "QualityControl/AsyncDatabase.h"
+#include "QualityControl/DatabaseFactory.h"
+#include "QualityControl/DummyDatabase.h"
+#include "QualityControl/MonitorObject.h"
+#include "QualityControl/QualityObject.h"
+#include <TH1F.h>
+#include <algorithm>
+
+#define BOOST_TEST_MODULE AsyncDatabase test
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+
+using namespace o2::quality_control::core;
+using namespace o2::quality_control::repository;
+using namespace std;
+
+namespace
+{
+
+/// Records what would have been stored. The uploads can be held back to fill the queue.
+struct Recorder {
+  std::mutex mutex;
+  std::condition_variable released;
+  bool hold = false;
+  vector<pair<string, long>> stored; // path, from
+  vector<double> entries;            // of the stored histograms
+};
+
+class RecordingDatabase : public DummyDatabase
+{
+ public:
+  explicit RecordingDatabase(shared_ptr<Recorder> recorder) : mRecorder(std::move(recorder)) {}
+
+  void storeMO(std::shared_ptr<const MonitorObject> mo, long from, long) override
+  {
+    record(mo->getPath(), from);
+    std::lock_guard<std::mutex> lock(mRecorder->mutex);
+    mRecorder->entries.push_back(dynamic_cast<TH1*>(mo->getObject())->GetEntries());
+  }
+  void storeQO(std::shared_ptr<const QualityObject> qo, long from, long) override
+  {
+    record(qo->getPath(), from);
+  }
+
+ private:
+  void record(const string& path, long from)
+  {
+    std::unique_lock<std::mutex> lock(mRecorder->mutex);
+    mRecorder->released.wait(lock, [&]() { return !mRecorder->hold; });
+    mRecorder->stored.emplace_back(path, from);
+  }
+  shared_ptr<Recorder> mRecorder;
+};
+
+shared_ptr<MonitorObject> makeMO(const string& name)
+{
+  return make_shared<MonitorObject>(new TH1F(name.c_str(), name.c_str(), 10, 0, 10), "task", "class", "TST");
+}
+
+void release(Recorder& recorder)
+{
+  {
+    std::lock_guard<std::mutex> lock(recorder.mutex);
+    recorder.hold = false;
+  }
+  recorder.released.notify_all();
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(test_async_store)
+{
+  auto recorder = make_shared<Recorder>();
+  AsyncDatabase database([recorder]() { return make_unique<RecordingDatabase>(recorder); }, { 2, 10, AsyncDatabase::DropPolicy::Block, true });
+  database.connect({});
+
+  database.storeMO(makeMO("histo1"), 10);
+  database.storeMO(makeMO("histo2"), 20);
+  database.storeQO(make_shared<QualityObject>(Quality::Good, "check1"), 30);
+  database.flush();
+
+  BOOST_REQUIRE_EQUAL(recorder->stored.size(), 3);
+  auto stats = database.getAndResetStatistics();
+  BOOST_CHECK_EQUAL(stats.queued, 3);
+  BOOST_CHECK_EQUAL(stats.stored, 3);
+  BOOST_CHECK_EQUAL(stats.queueDepth, 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_async_coalescing)
+{
+  auto recorder = make_shared<Recorder>();
+  recorder->hold = true;
+  AsyncDatabase database([recorder]() { return make_unique<RecordingDatabase>(recorder); }, { 1, 10, AsyncDatabase::DropPolicy::Block, true });
+  database.connect({});
+
+  // the first object is taken by the uploader and held, the other ones wait in the queue
+  database.storeMO(makeMO("blocker"), 1);
+  while (database.getAndResetStatistics().queueDepth != 0) {
+    std::this_thread::yield();
+  }
+  database.storeMO(makeMO("histo"), 10);
+  database.storeMO(makeMO("histo"), 20);
+  database.storeMO(makeMO("histo"), 30);
+  auto stats = database.getAndResetStatistics();
+  BOOST_CHECK_EQUAL(stats.queueDepth, 1);
+  BOOST_CHECK_EQUAL(stats.coalesced, 2);
+
+  release(*recorder);
+  database.flush();
+
+  BOOST_REQUIRE_EQUAL(recorder->stored.size(), 2);
+  BOOST_CHECK_EQUAL(recorder->stored[1].first, makeMO("histo")->getPath());
+  BOOST_CHECK_EQUAL(recorder->stored[1].second, 30);
+}
+
+BOOST_AUTO_TEST_CASE(test_async_drop_policies)
+{
+  for (auto policy : { AsyncDatabase::DropPolicy::DropOldest, AsyncDatabase::DropPolicy::DropNewest }) {
+    auto recorder = make_shared<Recorder>();
+    recorder->hold = true;
+    AsyncDatabase database([recorder]() { return make_unique<RecordingDatabase>(recorder); }, { 1, 2, policy, true });
+    database.connect({});
+
+    database.storeMO(makeMO("blocker"), 1);
+    while (database.getAndResetStatistics().queueDepth != 0) {
+      std::this_thread::yield();
+    }
+    database.storeMO(makeMO("histo1"), 10);
+    database.storeMO(makeMO("histo2"), 20);
+    database.storeMO(makeMO("histo3"), 30);
+    auto stats = database.getAndResetStatistics();
+    BOOST_CHECK_EQUAL(stats.queueDepth, 2);
+    BOOST_CHECK_EQUAL(stats.dropped, 1);
+
+    release(*recorder);
+    database.flush();
+
+    BOOST_REQUIRE_EQUAL(recorder->stored.size(), 3);
+    if (policy == AsyncDatabase::DropPolicy::DropOldest) {
+      BOOST_CHECK_EQUAL(recorder->stored[1].second, 20);
+      BOOST_CHECK_EQUAL(recorder->stored[2].second, 30);
+    } else {
+      BOOST_CHECK_EQUAL(recorder->stored[1].second, 10);
+      BOOST_CHECK_EQUAL(recorder->stored[2].second, 20);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(test_async_copies)
+{
+  auto recorder = make_shared<Recorder>();
+  recorder->hold = true;
+  AsyncDatabase database([recorder]() { return make_unique<RecordingDatabase>(recorder); }, { 1, 10, AsyncDatabase::DropPolicy::Block, true });
+  database.connect({});
+
+  // the object is modified by the caller (e.g. beautified) while it waits to be stored
+  auto mo = makeMO("histo");
+  database.storeMO(mo, 10);
+  dynamic_cast<TH1*>(mo->getObject())->Fill(1);
+  release(*recorder);
+  database.flush();
+
+  BOOST_REQUIRE_EQUAL(recorder->entries.size(), 1);
+  BOOST_CHECK_EQUAL(recorder->entries[0], 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_async_store_during_stop)
+{
+  auto recorder = make_shared<Recorder>();
+  recorder->hold = true;
+  AsyncDatabase database([recorder]() { return make_unique<RecordingDatabase>(recorder); }, { 1, 1, AsyncDatabase::DropPolicy::Block, true });
+  database.connect({});
+
+  database.storeMO(makeMO("blocker"), 1);
+  while (database.getAndResetStatistics().queueDepth != 0) {
+    std::this_thread::yield();
+  }
+  database.storeMO(makeMO("filler"), 2);
+  // the queue is full, this producer waits until the database is stopped
+  std::thread producer([&database]() { database.storeMO(makeMO("late"), 3); });
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  std::thread stopper([&database]() { database.disconnect(); });
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  release(*recorder);
+  producer.join();
+  stopper.join();
+
+  // nothing is lost, the late object is stored either by the uploader or synchronously
+  BOOST_REQUIRE_EQUAL(recorder->stored.size(), 3);
+  BOOST_CHECK(std::find_if(recorder->stored.begin(), recorder->stored.end(), [](const auto& stored) { return stored.second == 3; }) != recorder->stored.end());
+  auto stats = database.getAndResetStatistics();
+  BOOST_CHECK_EQUAL(stats.stored, 3);
+  BOOST_CHECK_EQUAL(stats.dropped, 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_async_config)
+{
+  BOOST_CHECK(!AsyncDatabase::isEnabled({ { "implementation", "Dummy" } }));
+  BOOST_CHECK(AsyncDatabase::isEnabled({ { "implementation", "Dummy" }, { "asyncStorage", "true" } }));
+
+  auto config = AsyncDatabase::extractConfig({ { "asyncStorageThreads", "4" },
+                                               { "asyncStorageQueueDepth", "50" },
+                                               { "asyncStorageDropPolicy", "dropOldest" },
+                                               { "asyncStorageCoalescing", "false" } });
+  BOOST_CHECK_EQUAL(config.uploaderThreads, 4);
+  BOOST_CHECK_EQUAL(config.queueDepth, 50);
+  BOOST_CHECK(config.dropPolicy == AsyncDatabase::DropPolicy::DropOldest);
+  BOOST_CHECK(!config.coalescing);
+
+  auto database = DatabaseFactory::createAndConnect({ { "implementation", "Dummy" }, { "host", "" }, { "asyncStorage", "true" } });
+  BOOST_CHECK(dynamic_cast<AsyncDatabase*>(database.get()));
+}
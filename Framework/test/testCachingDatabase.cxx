@@ -0,0 +1,175 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   testCachingDatabase.cxx
+///
+
+#include "QualityControl/CachingDatabase.h"
+#include "QualityControl/DatabaseFactory.h"
+#include "QualityControl/DummyDatabase.h"
+#include "QualityControl/MonitorObject.h"
+#include "QualityControl/QualityObject.h"
+#include <TH1F.h>
+#include <filesystem>
+#include <unistd.h>
+
+#define BOOST_TEST_MODULE CachingDatabase test
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+
+using namespace o2::quality_control::core;
+using namespace o2::quality_control::repository;
+using namespace std;
+
+namespace
+{
+
+/// Serves one version of each object, valid between 1000 and 2000, and counts the requests.
+struct Repository {
+  string etag = "version1";
+  size_t objectRequests = 0;
+  size_t headerRequests = 0;
+};
+
+class FakeDatabase : public DummyDatabase
+{
+ public:
+  explicit FakeDatabase(shared_ptr<Repository> repository) : mRepository(std::move(repository)) {}
+
+  std::shared_ptr<MonitorObject> retrieveMO(std::string path, std::string name, long timestamp, const Activity&) override
+  {
+    mRepository->objectRequests++;
+    if (timestamp >= 2000) {
+      return nullptr;
+    }
+    auto mo = make_shared<MonitorObject>(new TH1F(name.c_str(), name.c_str(), 10, 0, 10), path, "class", "TST");
+    mo->setIsOwner(true);
+    mo->addMetadata(headers());
+    return mo;
+  }
+  std::shared_ptr<QualityObject> retrieveQO(std::string path, long, const Activity&) override
+  {
+    mRepository->objectRequests++;
+    auto qo = make_shared<QualityObject>(Quality::Good, path);
+    qo->addMetadata(headers());
+    return qo;
+  }
+  std::map<std::string, std::string> retrieveHeaders(const std::string&, const std::map<std::string, std::string>&, long timestamp) override
+  {
+    mRepository->headerRequests++;
+    return timestamp >= 2000 ? map<string, string>{} : headers();
+  }
+
+ private:
+  map<string, string> headers()
+  {
+    return { { "ETag", mRepository->etag }, { "Valid-From", "1000" }, { "Valid-Until", "2000" } };
+  }
+  shared_ptr<Repository> mRepository;
+};
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(test_cache_hits_and_revalidation)
+{
+  auto repository = make_shared<Repository>();
+  CachingDatabase database(make_unique<FakeDatabase>(repository));
+
+  auto first = database.retrieveMO("TST/MO/task", "histo", 1100);
+  BOOST_REQUIRE(first != nullptr);
+  BOOST_CHECK_EQUAL(repository->objectRequests, 1);
+
+  // any timestamp within the validity is served from the cache, only the headers are checked
+  auto second = database.retrieveMO("TST/MO/task", "histo", 1500);
+  BOOST_CHECK_EQUAL(second, first);
+  BOOST_CHECK_EQUAL(repository->objectRequests, 1);
+  BOOST_CHECK_EQUAL(repository->headerRequests, 1);
+
+  // a new version at the same path replaces the cached one
+  repository->etag = "version2";
+  auto third = database.retrieveMO("TST/MO/task", "histo", 1500);
+  BOOST_REQUIRE(third != nullptr);
+  BOOST_CHECK_NE(third, first);
+  BOOST_CHECK_EQUAL(repository->objectRequests, 2);
+
+  // outside of the validity
+  BOOST_CHECK(database.retrieveMO("TST/MO/task", "histo", 2500) == nullptr);
+  BOOST_CHECK_EQUAL(repository->objectRequests, 3);
+
+  // QualityObjects are cached separately
+  BOOST_CHECK(database.retrieveQO("TST/QO/check", 1100) != nullptr);
+  BOOST_CHECK(database.retrieveQO("TST/QO/check", 1200) != nullptr);
+  BOOST_CHECK_EQUAL(repository->objectRequests, 4);
+
+  auto statistics = database.getAndResetStatistics();
+  BOOST_CHECK_EQUAL(statistics.hits, 2);
+  BOOST_CHECK_EQUAL(statistics.misses, 4);
+  BOOST_CHECK_EQUAL(statistics.stale, 1);
+  BOOST_CHECK_EQUAL(statistics.size, 2);
+}
+
+BOOST_AUTO_TEST_CASE(test_cache_without_revalidation_and_eviction)
+{
+  auto repository = make_shared<Repository>();
+  CachingDatabase database(make_unique<FakeDatabase>(repository), { 2, "", false });
+
+  database.retrieveMO("TST/MO/task", "histo1", 1100);
+  database.retrieveMO("TST/MO/task", "histo1", 1200);
+  BOOST_CHECK_EQUAL(repository->objectRequests, 1);
+  BOOST_CHECK_EQUAL(repository->headerRequests, 0);
+
+  // histo1 is the least recently used one when histo3 arrives
+  database.retrieveMO("TST/MO/task", "histo2", 1100);
+  database.retrieveMO("TST/MO/task", "histo3", 1100);
+  database.retrieveMO("TST/MO/task", "histo1", 1100);
+  BOOST_CHECK_EQUAL(repository->objectRequests, 4);
+
+  auto statistics = database.getAndResetStatistics();
+  BOOST_CHECK_EQUAL(statistics.evictions, 2);
+  BOOST_CHECK_EQUAL(statistics.size, 2);
+}
+
+BOOST_AUTO_TEST_CASE(test_cache_on_disk)
+{
+  auto directory = filesystem::temp_directory_path() / ("qc-test-cache-" + to_string(getpid()));
+  auto repository = make_shared<Repository>();
+  {
+    CachingDatabase database(make_unique<FakeDatabase>(repository), { 10, directory.string(), true });
+    BOOST_CHECK(database.retrieveMO("TST/MO/task", "histo", 1100) != nullptr);
+  }
+  {
+    // a new process would find the object on the disk
+    CachingDatabase database(make_unique<FakeDatabase>(repository), { 10, directory.string(), true });
+    auto mo = database.retrieveMO("TST/MO/task", "histo", 1100);
+    BOOST_REQUIRE(mo != nullptr);
+    BOOST_CHECK_EQUAL(mo->getName(), "histo");
+    BOOST_CHECK_EQUAL(repository->objectRequests, 1);
+    BOOST_CHECK_EQUAL(database.getAndResetStatistics().diskHits, 1);
+  }
+  filesystem::remove_all(directory);
+}
+
+BOOST_AUTO_TEST_CASE(test_cache_config)
+{
+  BOOST_CHECK(!CachingDatabase::isEnabled({ { "implementation", "Dummy" } }));
+  BOOST_CHECK(CachingDatabase::isEnabled({ { "implementation", "Dummy" }, { "cache", "true" } }));
+
+  auto config = CachingDatabase::extractConfig({ { "cacheSize", "20" }, { "cacheDirectory", "/tmp/cache" }, { "cacheRevalidation", "false" } });
+  BOOST_CHECK_EQUAL(config.maxObjects, 20);
+  BOOST_CHECK_EQUAL(config.directory, "/tmp/cache");
+  BOOST_CHECK(!config.revalidation);
+
+  auto database = DatabaseFactory::createAndConnect({ { "implementation", "Dummy" }, { "host", "" }, { "cache", "true" } });
+  BOOST_CHECK(dynamic_cast<CachingDatabase*>(database.get()));
+}
@@ -0,0 +1,107 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   testCcdbStandIn.cxx
+///
+
+#include "QualityControl/CcdbStandIn.h"
+#include "QualityControl/CcdbDatabase.h"
+#include "QualityControl/MonitorObject.h"
+
+#define BOOST_TEST_MODULE CcdbStandIn test
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+#include <TH1F.h>
+
+using namespace o2::quality_control::core;
+using namespace o2::quality_control::repository;
+using namespace std::chrono_literals;
+
+namespace
+{
+
+std::shared_ptr<MonitorObject> createObject(const std::string& name)
+{
+  auto* histo = new TH1F(name.c_str(), "stand-in", 100, 0, 99);
+  histo->Fill(5);
+  auto mo = std::make_shared<MonitorObject>(histo, "StandIn", "TestClass", "TST");
+  mo->setIsOwner(true);
+  mo->updateActivity(1234, "LHC66", "passName1", "qc");
+  return mo;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(test_store_retrieve_list)
+{
+  CcdbStandIn standIn;
+  CcdbDatabase database;
+  database.connect(standIn.getUrl(), "", "", "");
+
+  auto mo = createObject("histo");
+  database.storeMO(mo, 1000, 2000);
+  database.storeMO(mo, 1500, 3000);
+  BOOST_CHECK_EQUAL(standIn.getStatistics().storedVersions, 2);
+
+  auto retrieved = database.retrieveMO("TST/MO/StandIn", "histo", 1200);
+  BOOST_REQUIRE(retrieved != nullptr);
+  BOOST_CHECK_EQUAL(retrieved->getName(), "histo");
+  BOOST_CHECK_EQUAL(retrieved->getActivity().mId, 1234);
+  BOOST_CHECK_EQUAL(dynamic_cast<TH1F*>(retrieved->getObject())->GetEntries(), 1);
+  BOOST_CHECK(database.retrieveMO("TST/MO/StandIn", "histo", 5000) == nullptr);
+
+  // the newest version valid at the timestamp is returned
+  auto headers = database.retrieveHeaders("qc/TST/MO/StandIn/histo", {}, 1700);
+  BOOST_CHECK_EQUAL(headers["Valid-From"], "1500");
+  BOOST_CHECK_EQUAL(headers["qc_task_name"], "StandIn");
+  BOOST_CHECK_EQUAL(database.retrieveHeaders("qc/TST/MO/StandIn/histo", { { "RunNumber", "1" } }, 1700).count("Valid-From"), 0);
+
+  auto timestamps = database.getTimestampsForObject("qc/TST/MO/StandIn/histo");
+  BOOST_CHECK((timestamps == std::vector<uint64_t>{ 1000, 1500 }));
+  auto listing = database.getListing("qc/TST/MO");
+  BOOST_CHECK((listing == std::vector<std::string>{ "qc/TST/MO/StandIn" }));
+
+  database.truncate("qc/TST/MO/StandIn", "*");
+  BOOST_CHECK_EQUAL(standIn.getStatistics().storedVersions, 0);
+  BOOST_CHECK(database.retrieveMO("TST/MO/StandIn", "histo", 1200) == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(test_latency)
+{
+  CcdbStandIn::Config config;
+  config.latency = 50ms;
+  CcdbStandIn standIn(config);
+  CcdbDatabase database;
+  database.connect(standIn.getUrl(), "", "", "");
+
+  auto start = std::chrono::steady_clock::now();
+  database.retrieveHeaders("qc/TST/MO/StandIn/histo", {});
+  BOOST_CHECK(std::chrono::steady_clock::now() - start >= 50ms);
+}
+
+BOOST_AUTO_TEST_CASE(test_injected_errors)
+{
+  CcdbStandIn::Config config;
+  config.errorRate = 1;
+  CcdbStandIn standIn(config);
+  CcdbDatabase database;
+  database.connect(standIn.getUrl(), "", "", "");
+
+  database.storeMO(createObject("histo"));
+  BOOST_CHECK_EQUAL(standIn.getStatistics().storedVersions, 0);
+  BOOST_CHECK(database.retrieveMO("TST/MO/StandIn", "histo") == nullptr);
+  auto statistics = standIn.getStatistics();
+  BOOST_CHECK_GT(statistics.injectedErrors, 0);
+  BOOST_CHECK_EQUAL(statistics.injectedErrors, statistics.requests);
+}
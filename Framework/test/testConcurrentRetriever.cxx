@@ -0,0 +1,133 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   testConcurrentRetriever.cxx
+///
+
+#include "QualityControl/ConcurrentRetriever.h"
+#include "QualityControl/DummyDatabase.h"
+#include "QualityControl/MonitorObject.h"
+#include "QualityControl/QualityObject.h"
+#include <TH1F.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#define BOOST_TEST_MODULE ConcurrentRetriever test
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+
+using namespace o2::quality_control::core;
+using namespace o2::quality_control::postprocessing;
+using namespace o2::quality_control::repository;
+using namespace std;
+
+namespace
+{
+
+/// Returns a histogram for each name except "missing", after a delay given by the timestamp in milliseconds.
+class SlowDatabase : public DummyDatabase
+{
+ public:
+  std::shared_ptr<MonitorObject> retrieveMO(std::string path, std::string name, long timestamp, const Activity&) override
+  {
+    auto guard = enter();
+    this_thread::sleep_for(chrono::milliseconds(timestamp));
+    if (name == "missing") {
+      return nullptr;
+    }
+    if (name == "throw") {
+      throw std::runtime_error("retrieval failed");
+    }
+    return make_shared<MonitorObject>(new TH1F(name.c_str(), name.c_str(), 10, 0, 10), path, "class", "TST");
+  }
+  std::shared_ptr<QualityObject> retrieveQO(std::string path, long timestamp, const Activity&) override
+  {
+    auto guard = enter();
+    this_thread::sleep_for(chrono::milliseconds(timestamp));
+    return make_shared<QualityObject>(Quality::Good, path);
+  }
+
+  std::atomic<size_t> inFlight = 0;
+  std::atomic<size_t> maxInFlight = 0;
+
+ private:
+  std::shared_ptr<void> enter()
+  {
+    auto current = ++inFlight;
+    auto max = maxInFlight.load();
+    while (current > max && !maxInFlight.compare_exchange_weak(max, current)) {
+    }
+    return { nullptr, [this](void*) { --inFlight; } };
+  }
+};
+
+ConcurrentRetriever::Request mo(const string& name, long delayMs)
+{
+  return { ConcurrentRetriever::Request::Type::MonitorObject, "TST/MO/Task", name, delayMs };
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(test_sequential)
+{
+  SlowDatabase database;
+  ConcurrentRetriever retriever(1);
+  vector<size_t> order;
+  retriever.retrieve(database, { mo("a", 5), mo("missing", 0), mo("c", 0) }, [&](size_t index, ConcurrentRetriever::Result& result) {
+    order.push_back(index);
+    BOOST_CHECK_EQUAL(result.mo == nullptr, index == 1);
+  });
+  BOOST_CHECK(order == vector<size_t>({ 0, 1, 2 }));
+  BOOST_CHECK_EQUAL(database.maxInFlight, 1);
+}
+
+BOOST_AUTO_TEST_CASE(test_concurrent)
+{
+  SlowDatabase database;
+  ConcurrentRetriever retriever(3);
+  vector<ConcurrentRetriever::Request> requests{ mo("slow", 300), mo("b", 10), mo("c", 10), mo("d", 10), mo("missing", 10) };
+  requests.push_back({ ConcurrentRetriever::Request::Type::QualityObject, "TST/QO/Check", "", 10 });
+
+  vector<size_t> order;
+  retriever.retrieve(database, requests, [&](size_t index, ConcurrentRetriever::Result& result) {
+    order.push_back(index);
+    if (index == 4) {
+      BOOST_CHECK(result.mo == nullptr);
+    } else if (index == 5) {
+      BOOST_REQUIRE(result.qo != nullptr);
+      BOOST_CHECK_EQUAL(result.qo->getCheckName(), "TST/QO/Check");
+    } else {
+      BOOST_REQUIRE(result.mo != nullptr);
+      BOOST_CHECK_EQUAL(result.mo->getName(), requests[index].name);
+    }
+  });
+
+  BOOST_REQUIRE_EQUAL(order.size(), requests.size());
+  // the other objects are processed while the slow one is still being retrieved
+  BOOST_CHECK_EQUAL(order.back(), 0);
+  BOOST_CHECK_LE(database.maxInFlight, 3);
+  BOOST_CHECK_GE(database.maxInFlight, 2);
+}
+
+BOOST_AUTO_TEST_CASE(test_errors)
+{
+  SlowDatabase database;
+  ConcurrentRetriever retriever(2);
+  BOOST_CHECK_THROW(retriever.retrieve(database, { mo("a", 0), mo("throw", 0), mo("c", 0) }, [](size_t, ConcurrentRetriever::Result&) {}),
+                    std::runtime_error);
+  BOOST_CHECK_THROW(retriever.retrieve(database, { mo("a", 0), mo("b", 0) }, [](size_t, ConcurrentRetriever::Result&) { throw std::logic_error("callback failed"); }),
+                    std::logic_error);
+  BOOST_CHECK_EQUAL(database.inFlight, 0);
+}
@@ -0,0 +1,133 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   testConditionsService.cxx
+///
+
+#include "QualityControl/ConditionsService.h"
+
+#define BOOST_TEST_MODULE ConditionsService test
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+#include <atomic>
+#include <stdexcept>
+
+using namespace o2::quality_control::core;
+using namespace std::chrono_literals;
+
+namespace
+{
+
+/// A database which returns a new version of each object at every retrieval, valid for a given time.
+struct FakeDatabase {
+  std::atomic<int> version = 0;
+  std::atomic<bool> available = true;
+  std::chrono::milliseconds validity = 1h;
+
+  ConditionsService::Retriever retriever()
+  {
+    return [this](const std::type_info& type, const std::string& path, const std::map<std::string, std::string>&,
+                  std::map<std::string, std::string>& headers) -> void* {
+      if (path == "broken") {
+        throw std::runtime_error("broken");
+      }
+      if (path == "slow") {
+        std::this_thread::sleep_for(200ms);
+      }
+      if (!available || type != typeid(int)) {
+        return nullptr;
+      }
+      auto now = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch());
+      headers["Valid-Until"] = std::to_string((now + validity).count());
+      return new int(++version);
+    };
+  }
+};
+
+template <typename Predicate>
+bool waitFor(Predicate predicate)
+{
+  for (int i = 0; i < 500 && !predicate(); i++) {
+    std::this_thread::sleep_for(10ms);
+  }
+  return predicate();
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(test_shared_conditions)
+{
+  FakeDatabase database;
+  ConditionsService service(database.retriever());
+
+  service.prefetch<int>("TST/Calib/First");
+  BOOST_CHECK(waitFor([&]() { return service.getNumberRetrievals() == 1; }));
+  auto first = service.get<int>("TST/Calib/First");
+  auto again = service.get<int>("TST/Calib/First");
+  BOOST_REQUIRE(first != nullptr);
+  BOOST_CHECK_EQUAL(first, again);
+  BOOST_CHECK_EQUAL(*first, 1);
+
+  // other metadata is another condition, not prefetched
+  auto otherRun = service.get<int>("TST/Calib/First", { { "RunNumber", "1" } });
+  BOOST_REQUIRE(otherRun != nullptr);
+  BOOST_CHECK_NE(first, otherRun);
+  BOOST_CHECK_EQUAL(service.getNumberRetrievals(), 2);
+
+  // missing objects and failing retrievals are given as nullptr
+  BOOST_CHECK(service.get<double>("TST/Calib/First") == nullptr);
+  BOOST_CHECK(service.get<int>("broken") == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(test_refresh_after_validity)
+{
+  FakeDatabase database;
+  database.validity = 50ms;
+  ConditionsService service(database.retriever());
+
+  auto first = service.get<int>("TST/Calib/Object");
+  BOOST_REQUIRE(first != nullptr);
+  BOOST_CHECK(waitFor([&]() { return *service.get<int>("TST/Calib/Object") != *first; }));
+  // the previous version is still usable by the tasks which hold it
+  BOOST_CHECK_EQUAL(*first, 1);
+}
+
+BOOST_AUTO_TEST_CASE(test_retry_after_failure)
+{
+  FakeDatabase database;
+  database.available = false;
+  database.validity = 0ms; // always expired, thus retrieved again after the retry interval
+  ConditionsService service(database.retriever(), 10ms);
+
+  BOOST_CHECK(service.get<int>("TST/Calib/Object") == nullptr);
+  database.available = true;
+  BOOST_CHECK(waitFor([&]() { return service.get<int>("TST/Calib/Object") != nullptr; }));
+
+  // a failed refresh keeps the previous version
+  database.available = false;
+  auto retrievals = service.getNumberRetrievals();
+  BOOST_CHECK(waitFor([&]() { return service.getNumberRetrievals() > retrievals + 1; }));
+  BOOST_CHECK(service.get<int>("TST/Calib/Object") != nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(test_timeout)
+{
+  FakeDatabase database;
+  ConditionsService service(database.retriever());
+
+  // the caller does not wait longer than the timeout, the retrieval goes on in the background
+  BOOST_CHECK(service.get<int>("slow", {}, 10ms) == nullptr);
+  BOOST_CHECK(waitFor([&]() { return service.get<int>("slow", {}, 10ms) != nullptr; }));
+  BOOST_CHECK_EQUAL(service.getNumberRetrievals(), 1);
+}
@@ -0,0 +1,102 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   testDatabaseHelpers.cxx
+///
+
+#include "QualityControl/DatabaseHelpers.h"
+
+#define BOOST_TEST_MODULE DatabaseHelpers test
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+#include <stdexcept>
+
+using namespace o2::quality_control::core;
+using namespace o2::quality_control::repository::database_helpers;
+
+const std::string listing = R"json(
+{
+  "objects": [
+    {
+      "path": "qc/TST/MO/Task/object",
+      "Created": 1700000003000,
+      "Valid-From": 1700000002000,
+      "Valid-Until": 1700000009000,
+      "RunNumber": "300",
+      "RunType": "1",
+      "PeriodName": "LHC23a",
+      "PassName": "apass1",
+      "replicas": [ "alien://first", { "RunNumber": "999" } ],
+      "qc_quality": null,
+      "partName": "send",
+      "size": 1024.5
+    },
+    {
+      "path": "qc/TST/MO/Task/object",
+      "Created": "1700000001000",
+      "Valid-From": "1700000000000",
+      "Valid-Until": "1700000009000",
+      "RunNumber": 200,
+      "PeriodName": "LHC23a",
+      "PassName": "apass1"
+    },
+    {
+      "path": "qc/TST/MO/Task/object",
+      "Created": 1600000000000,
+      "Valid-From": 1600000000000,
+      "Valid-Until": 1600000009000
+    }
+  ],
+  "subfolders": [ { "RunNumber": "1" } ]
+}
+)json";
+
+BOOST_AUTO_TEST_CASE(test_parse_listing)
+{
+  auto versions = parseListing(listing, [](const Activity&) { return true; }, "qc_async");
+  BOOST_REQUIRE_EQUAL(versions.size(), 3);
+
+  const auto& first = versions[0];
+  BOOST_CHECK_EQUAL(first.created, 1700000003000);
+  BOOST_CHECK_EQUAL(first.activity.mId, 300);
+  BOOST_CHECK_EQUAL(first.activity.mType, 1);
+  BOOST_CHECK_EQUAL(first.activity.mPeriodName, "LHC23a");
+  BOOST_CHECK_EQUAL(first.activity.mPassName, "apass1");
+  BOOST_CHECK_EQUAL(first.activity.mProvenance, "qc_async");
+  BOOST_CHECK_EQUAL(first.activity.mValidity.getMin(), 1700000002000);
+  BOOST_CHECK_EQUAL(first.activity.mValidity.getMax(), 1700000009000);
+
+  // the metadata can be either strings or numbers
+  const auto& second = versions[1];
+  BOOST_CHECK_EQUAL(second.created, 1700000001000);
+  BOOST_CHECK_EQUAL(second.activity.mId, 200);
+  BOOST_CHECK_EQUAL(second.activity.mType, 0);
+  BOOST_CHECK_EQUAL(second.activity.mValidity.getMin(), 1700000000000);
+
+  const auto& third = versions[2];
+  BOOST_CHECK_EQUAL(third.activity.mId, 0);
+  BOOST_CHECK(third.activity.mPeriodName.empty());
+}
+
+BOOST_AUTO_TEST_CASE(test_parse_listing_filter)
+{
+  Activity filter{ 0, 0, "LHC23a", "apass1", "qc" };
+  auto versions = parseListing(listing, [&filter](const Activity& activity) { return filter.matches(activity); });
+  BOOST_REQUIRE_EQUAL(versions.size(), 2);
+  BOOST_CHECK_EQUAL(versions[0].activity.mId, 300);
+  BOOST_CHECK_EQUAL(versions[1].activity.mId, 200);
+
+  BOOST_CHECK(parseListing(R"({"objects": [], "subfolders": []})", [](const Activity&) { return true; }).empty());
+  BOOST_CHECK_THROW(parseListing(R"({"objects": [ { "RunNumber": )", [](const Activity&) { return true; }), std::runtime_error);
+}
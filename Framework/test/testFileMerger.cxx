@@ -0,0 +1,138 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   testFileMerger.cxx
+///
+
+#include "QualityControl/FileMerger.h"
+#include "QualityControl/RootFileHelpers.h"
+#include "QualityControl/MonitorObject.h"
+#include "QualityControl/MonitorObjectCollection.h"
+#include <TFile.h>
+#include <TH1F.h>
+#include <TH2F.h>
+#include <TRandom3.h>
+#include <filesystem>
+#include <stdexcept>
+#include <unistd.h>
+
+#define BOOST_TEST_MODULE FileMerger test
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+
+using namespace o2::quality_control::core;
+using namespace std;
+
+namespace
+{
+
+MonitorObject* makeMO(TH1* histo)
+{
+  histo->SetDirectory(nullptr);
+  auto mo = new MonitorObject(histo, "task", "class", "TST");
+  mo->setIsOwner(true);
+  return mo;
+}
+
+// Writes a collection with a 1D and a 2D histogram, filled differently for each seed.
+void writeCollection(TFile& file, const string& name, unsigned int seed)
+{
+  TRandom3 random(seed);
+  auto histo1D = new TH1F("gauss", "gauss", 100, -5, 5);
+  auto histo2D = new TH2F("gauss2D", "gauss2D", 20, -5, 5, 20, -5, 5);
+  for (size_t i = 0; i < 1000 + seed * 10; i++) {
+    histo1D->Fill(random.Gaus(seed * 0.1, 1));
+    histo2D->Fill(random.Gaus(0, 1), random.Gaus(seed * 0.1, 2));
+  }
+  MonitorObjectCollection collection;
+  collection.SetOwner(true);
+  collection.SetName(name.c_str());
+  collection.Add(makeMO(histo1D));
+  collection.Add(makeMO(histo2D));
+  root_file_helpers::writeMonitorObjectCollection(file, collection);
+}
+
+file_merger::MonitorObjectCollectionMap merge(const vector<string>& inputFilePaths, const filesystem::path& outputFilePath, size_t threads)
+{
+  TFile outputFile(outputFilePath.c_str(), "UPDATE");
+  size_t filesRead = 0;
+  auto merged = file_merger::mergeFiles(
+    inputFilePaths, outputFile, threads, [](const string& message) { throw runtime_error(message); }, true, filesRead);
+  BOOST_CHECK_EQUAL(filesRead, inputFilePaths.size());
+  outputFile.Close();
+  return merged;
+}
+
+TH1* getHistogram(file_merger::MonitorObjectCollectionMap& collections, const string& collectionName, const string& name)
+{
+  BOOST_REQUIRE_EQUAL(collections.count(collectionName), 1);
+  auto mo = dynamic_cast<MonitorObject*>(collections.at(collectionName)->FindObject(name.c_str()));
+  BOOST_REQUIRE(mo != nullptr);
+  auto histo = dynamic_cast<TH1*>(mo->getObject());
+  BOOST_REQUIRE(histo != nullptr);
+  return histo;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(test_parallel_merging_as_serial)
+{
+  const auto directory = filesystem::temp_directory_path() / ("qc-test-file-merger-" + to_string(getpid()));
+  filesystem::create_directories(directory);
+
+  // the collection "task" is in all the files, "other" only in some of them and also in the output files already
+  vector<string> inputFilePaths;
+  for (unsigned int i = 0; i < 7; i++) {
+    auto path = directory / ("input" + to_string(i) + ".root");
+    TFile file(path.c_str(), "RECREATE");
+    writeCollection(file, "task", i);
+    if (i % 3 == 1) {
+      writeCollection(file, "other", 100 + i);
+    }
+    file.Close();
+    inputFilePaths.push_back(path.string());
+  }
+  const auto serialPath = directory / "serial.root";
+  const auto parallelPath = directory / "parallel.root";
+  for (const auto& path : { serialPath, parallelPath }) {
+    TFile file(path.c_str(), "RECREATE");
+    writeCollection(file, "other", 1000);
+    file.Close();
+  }
+
+  auto serial = merge(inputFilePaths, serialPath, 1);
+  auto parallel = merge(inputFilePaths, parallelPath, 3);
+  BOOST_CHECK_EQUAL(serial.size(), 2);
+  BOOST_CHECK_EQUAL(parallel.size(), serial.size());
+
+  for (const auto& collectionName : { "task", "other" }) {
+    for (const auto& name : { "gauss", "gauss2D" }) {
+      auto serialHisto = getHistogram(serial, collectionName, name);
+      auto parallelHisto = getHistogram(parallel, collectionName, name);
+      BOOST_CHECK_EQUAL(serialHisto->GetEntries(), parallelHisto->GetEntries());
+      BOOST_CHECK_CLOSE(serialHisto->GetMean(1), parallelHisto->GetMean(1), 1e-6);
+      BOOST_CHECK_CLOSE(serialHisto->GetStdDev(1), parallelHisto->GetStdDev(1), 1e-6);
+      BOOST_CHECK_CLOSE(serialHisto->GetMean(2), parallelHisto->GetMean(2), 1e-6);
+      BOOST_CHECK_CLOSE(serialHisto->GetStdDev(2), parallelHisto->GetStdDev(2), 1e-6);
+      for (int bin = 0; bin < serialHisto->GetNcells(); bin++) {
+        BOOST_CHECK_EQUAL(serialHisto->GetBinContent(bin), parallelHisto->GetBinContent(bin));
+      }
+    }
+  }
+  // all the fills of the input files and of the output file are there
+  BOOST_CHECK_EQUAL(getHistogram(serial, "task", "gauss")->GetEntries(), 7 * 1000 + 21 * 10);
+  BOOST_CHECK_EQUAL(getHistogram(serial, "other", "gauss")->GetEntries(), 3 * 1000 + (101 + 104 + 1000) * 10);
+
+  filesystem::remove_all(directory);
+}
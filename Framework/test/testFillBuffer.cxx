@@ -0,0 +1,159 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   testFillBuffer.cxx
+///
+
+#include "QualityControl/FillBuffer.h"
+#include <TH1F.h>
+#include <TH1D.h>
+#include <TH2F.h>
+#include <TH2D.h>
+#include <TProfile.h>
+#include <TRandom3.h>
+#include <cmath>
+#include <limits>
+
+#define BOOST_TEST_MODULE FillBuffer test
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+
+using namespace o2::quality_control::core;
+
+namespace
+{
+
+void checkSame(const TH1& expected, const TH1& actual)
+{
+  BOOST_REQUIRE_EQUAL(expected.GetNcells(), actual.GetNcells());
+  for (int bin = 0; bin < expected.GetNcells(); bin++) {
+    BOOST_CHECK_CLOSE(expected.GetBinContent(bin), actual.GetBinContent(bin), 1e-6);
+    BOOST_CHECK_CLOSE(expected.GetBinError(bin), actual.GetBinError(bin), 1e-6);
+  }
+  BOOST_CHECK_EQUAL(expected.GetEntries(), actual.GetEntries());
+  Double_t expectedStats[TH1::kNstat] = { 0 };
+  Double_t actualStats[TH1::kNstat] = { 0 };
+  expected.GetStats(expectedStats);
+  actual.GetStats(actualStats);
+  for (int i = 0; i < TH1::kNstat; i++) {
+    BOOST_CHECK_CLOSE(expectedStats[i], actualStats[i], 1e-6);
+  }
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(fill_1d)
+{
+  TH1F expected("expected", "expected", 50, -2, 3);
+  TH1F actual("actual", "actual", 50, -2, 3);
+  FillBuffer1D buffer(&actual, 100);
+  BOOST_CHECK_EQUAL(buffer.getHistogram(), &actual);
+  BOOST_CHECK_EQUAL(buffer.getCapacity(), 100);
+
+  TRandom3 random(42);
+  for (int i = 0; i < 1000; i++) {
+    double x = random.Gaus(0, 2); // some entries end up in the underflow and the overflow
+    double weight = i % 10 == 0 ? random.Uniform(0, 2) : 1.0;
+    expected.Fill(x, weight);
+    buffer.fill(x, weight);
+  }
+  // the bin edges and the values outside the axis
+  for (double x : { -2.0, 3.0, 0.1, std::numeric_limits<double>::infinity(), -std::numeric_limits<double>::infinity() }) {
+    expected.Fill(x);
+    buffer.fill(x);
+  }
+  BOOST_CHECK_EQUAL(buffer.size(), 5);
+  buffer.flush();
+  BOOST_CHECK_EQUAL(buffer.size(), 0);
+  checkSame(expected, actual);
+  BOOST_CHECK_CLOSE(expected.GetMean(), actual.GetMean(), 1e-6);
+  BOOST_CHECK_CLOSE(expected.GetRMS(), actual.GetRMS(), 1e-6);
+
+  // the histogram can still be filled directly
+  expected.Fill(1);
+  actual.Fill(1);
+  checkSame(expected, actual);
+}
+
+BOOST_AUTO_TEST_CASE(fill_2d)
+{
+  TH2D expected("expected", "expected", 20, 0, 10, 10, -5, 5);
+  TH2D actual("actual", "actual", 20, 0, 10, 10, -5, 5);
+  FillBuffer2D buffer(&actual);
+
+  TRandom3 random(42);
+  for (int i = 0; i < 1000; i++) {
+    double x = random.Uniform(-1, 11);
+    double y = random.Gaus(0, 3);
+    expected.Fill(x, y, 0.5);
+    buffer.fill(x, y, 0.5);
+  }
+  buffer.flush();
+  checkSame(expected, actual);
+  BOOST_CHECK_CLOSE(expected.GetCorrelationFactor(), actual.GetCorrelationFactor(), 1e-6);
+}
+
+BOOST_AUTO_TEST_CASE(fill_one_by_one)
+{
+  // variable bins and extendable axes are not filled in bulk, the result has to be the same
+  double edges[] = { 0, 1, 2, 4, 8 };
+  TH1D expectedVariable("expectedVariable", "expectedVariable", 4, edges);
+  TH1D actualVariable("actualVariable", "actualVariable", 4, edges);
+  TH1F expectedExtendable("expectedExtendable", "expectedExtendable", 10, 0, 1);
+  TH1F actualExtendable("actualExtendable", "actualExtendable", 10, 0, 1);
+  expectedExtendable.SetCanExtend(TH1::kAllAxes);
+  actualExtendable.SetCanExtend(TH1::kAllAxes);
+  FillBuffer1D variableBuffer(&actualVariable);
+  FillBuffer1D extendableBuffer(&actualExtendable);
+
+  for (double x : { -1.0, 0.5, 1.5, 3.0, 7.9, 9.0 }) {
+    expectedVariable.Fill(x);
+    variableBuffer.fill(x);
+    expectedExtendable.Fill(x);
+    extendableBuffer.fill(x);
+  }
+  variableBuffer.flush();
+  extendableBuffer.flush();
+  checkSame(expectedVariable, actualVariable);
+  checkSame(expectedExtendable, actualExtendable);
+}
+
+BOOST_AUTO_TEST_CASE(capacity_and_clear)
+{
+  TH1F histogram("histogram", "histogram", 10, 0, 10);
+  FillBuffer1D buffer(&histogram, 3);
+  buffer.fill(1);
+  buffer.fill(2);
+  BOOST_CHECK_EQUAL(histogram.GetEntries(), 0);
+  buffer.fill(3);
+  BOOST_CHECK_EQUAL(buffer.size(), 0);
+  BOOST_CHECK_EQUAL(histogram.GetEntries(), 3);
+
+  buffer.fill(4);
+  buffer.clear();
+  buffer.flush();
+  BOOST_CHECK_EQUAL(histogram.GetEntries(), 3);
+  BOOST_CHECK_EQUAL(histogram.GetBinContent(5), 0);
+}
+
+BOOST_AUTO_TEST_CASE(invalid_histograms)
+{
+  TH1F histogram1D("histogram1D", "histogram1D", 10, 0, 10);
+  TH2F histogram2D("histogram2D", "histogram2D", 10, 0, 10, 10, 0, 10);
+  TProfile profile("profile", "profile", 10, 0, 10);
+  BOOST_CHECK_THROW(FillBuffer1D(nullptr), std::invalid_argument);
+  BOOST_CHECK_THROW(FillBuffer1D(&histogram2D), std::invalid_argument);
+  BOOST_CHECK_THROW(FillBuffer2D(&histogram1D), std::invalid_argument);
+  BOOST_CHECK_THROW(FillBuffer1D(&profile), std::invalid_argument);
+}
@@ -0,0 +1,257 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   testHistogramTransport.cxx
+///
+
+#include "QualityControl/HistogramTransport.h"
+#include "QualityControl/MonitorObject.h"
+#include "QualityControl/MonitorObjectCollection.h"
+#include <TH1F.h>
+#include <TH2D.h>
+#include <TBufferFile.h>
+#include <TH2F.h>
+#include <TObjString.h>
+#include <TProfile.h>
+
+#define BOOST_TEST_MODULE HistogramTransport test
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+using namespace o2::quality_control::core;
+
+namespace
+{
+
+std::vector<char> encodeToVector(const MonitorObjectCollection& collection, const histogram_transport::Compression& compression = {})
+{
+  std::vector<char> payload;
+  auto encodedSize = histogram_transport::encode(
+    collection, [&payload](size_t size) {
+      payload.resize(size);
+      return payload.data();
+    },
+    compression);
+  BOOST_CHECK_EQUAL(encodedSize.payload, payload.size());
+  return payload;
+}
+
+template <typename T>
+T* getObject(const MonitorObjectCollection& collection, const char* name)
+{
+  auto mo = dynamic_cast<MonitorObject*>(collection.FindObject(name));
+  BOOST_REQUIRE(mo != nullptr);
+  auto object = dynamic_cast<T*>(mo->getObject());
+  BOOST_REQUIRE(object != nullptr);
+  return object;
+}
+
+void checkSame(const TH1& expected, const TH1& actual)
+{
+  BOOST_REQUIRE_EQUAL(expected.GetNcells(), actual.GetNcells());
+  for (int bin = 0; bin < expected.GetNcells(); bin++) {
+    BOOST_CHECK_EQUAL(expected.GetBinContent(bin), actual.GetBinContent(bin));
+    BOOST_CHECK_EQUAL(expected.GetBinError(bin), actual.GetBinError(bin));
+  }
+  BOOST_CHECK_EQUAL(expected.GetEntries(), actual.GetEntries());
+  BOOST_CHECK_EQUAL(expected.GetMean(), actual.GetMean());
+  BOOST_CHECK_EQUAL(expected.GetTitle(), actual.GetTitle());
+  BOOST_CHECK_EQUAL(expected.GetXaxis()->GetTitle(), actual.GetXaxis()->GetTitle());
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(test_encode_decode)
+{
+  TH1F histogram1D("histogram1D", "1D histogram", 100, 0, 10);
+  histogram1D.GetXaxis()->SetTitle("x");
+  histogram1D.SetLineColor(kRed);
+  for (int i = 0; i < 1000; i++) {
+    histogram1D.Fill(i % 120 / 10.0, 0.5); // weighted, with overflow
+  }
+  double edges[] = { 0, 1, 5, 10 };
+  TH2D histogram2D("histogram2D", "2D histogram", 3, edges, 20, -1, 1);
+  histogram2D.Fill(2, 0.5);
+  histogram2D.Fill(7, -0.5, 3);
+  TProfile profile("profile", "profile", 10, 0, 10);
+  profile.Fill(1, 2);
+  TObjString string("string");
+
+  MonitorObjectCollection collection;
+  collection.SetName("task");
+  collection.Add(new MonitorObject(&histogram1D, "task", "class", "TST"));
+  collection.Add(new MonitorObject(&histogram2D, "task", "class", "TST"));
+  collection.Add(new MonitorObject(&profile, "task", "class", "TST"));
+  collection.Add(new MonitorObject(&string, "task", "class", "TST"));
+  for (auto object : collection) {
+    dynamic_cast<MonitorObject*>(object)->setIsOwner(false);
+  }
+  dynamic_cast<MonitorObject*>(collection.FindObject("histogram1D"))->addMetadata("key", "value");
+  collection.SetOwner(true);
+
+  BOOST_CHECK(histogram_transport::canCopyBins(&histogram1D));
+  BOOST_CHECK(histogram_transport::canCopyBins(&histogram2D));
+  BOOST_CHECK(!histogram_transport::canCopyBins(&profile));
+  BOOST_CHECK(!histogram_transport::canCopyBins(&string));
+
+  std::unique_ptr<TH1F> before(dynamic_cast<TH1F*>(histogram1D.Clone("before")));
+  auto payload = encodeToVector(collection);
+  BOOST_CHECK(histogram_transport::isEncoded(payload.data(), payload.size()));
+  // the histograms are left as they were
+  BOOST_CHECK_EQUAL(histogram1D.GetSumw2N(), histogram1D.GetNcells());
+  for (int bin = 0; bin < histogram1D.GetNcells(); bin++) {
+    BOOST_CHECK_EQUAL(histogram1D.GetBinContent(bin), before->GetBinContent(bin));
+    BOOST_CHECK_EQUAL(histogram1D.GetBinError(bin), before->GetBinError(bin));
+  }
+
+  auto decoded = histogram_transport::decode(payload.data(), payload.size());
+  BOOST_CHECK_EQUAL(decoded->GetName(), std::string("task"));
+  BOOST_CHECK_EQUAL(decoded->GetEntries(), 4);
+  auto decoded1D = getObject<TH1F>(*decoded, "histogram1D");
+  checkSame(histogram1D, *decoded1D);
+  BOOST_CHECK_EQUAL(decoded1D->GetLineColor(), kRed);
+  BOOST_CHECK_EQUAL(dynamic_cast<MonitorObject*>(decoded->FindObject("histogram1D"))->getMetadataMap().at("key"), "value");
+  checkSame(histogram2D, *getObject<TH2D>(*decoded, "histogram2D"));
+  checkSame(profile, *getObject<TProfile>(*decoded, "profile"));
+  BOOST_CHECK_EQUAL(getObject<TObjString>(*decoded, "string")->GetString(), "string");
+  for (auto object : *decoded) {
+    BOOST_CHECK(dynamic_cast<MonitorObject*>(object)->isIsOwner());
+  }
+}
+
+BOOST_AUTO_TEST_CASE(test_invalid_payload)
+{
+  TH1F histogram("histogram", "histogram", 100, 0, 10);
+  MonitorObjectCollection collection;
+  auto mo = new MonitorObject(&histogram, "task", "class", "TST");
+  mo->setIsOwner(false);
+  collection.Add(mo);
+  collection.SetOwner(true);
+  auto payload = encodeToVector(collection);
+
+  std::vector<char> other(100, 'x');
+  BOOST_CHECK(!histogram_transport::isEncoded(other.data(), other.size()));
+  BOOST_CHECK(!histogram_transport::isEncoded(payload.data(), 3));
+  BOOST_CHECK_THROW(histogram_transport::decode(other.data(), other.size()), std::runtime_error);
+  BOOST_CHECK_THROW(histogram_transport::decode(payload.data(), payload.size() - 8), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(test_sparse_and_compressed)
+{
+  // a detector map with a few hot spots, mostly empty
+  TH2F map("map", "map", 1000, 0, 1000, 500, 0, 500);
+  for (int i = 0; i < 2000; i++) {
+    map.Fill(i % 40 + 100, i % 7 + 250);
+    map.Fill(900, i % 500);
+  }
+  map.Fill(-1, -1); // underflow
+  TH1D weighted("weighted", "weighted", 10000, 0, 10000);
+  weighted.Fill(10, 0.5);
+  weighted.Fill(9999, 2);
+  TH1F full("full", "full", 100, 0, 100);
+  for (int i = 0; i < 100; i++) {
+    full.Fill(i + 0.5);
+  }
+
+  MonitorObjectCollection collection;
+  collection.SetName("task");
+  for (TObject* object : std::vector<TObject*>{ &map, &weighted, &full }) {
+    auto mo = new MonitorObject(object, "task", "class", "TST");
+    mo->setIsOwner(false);
+    collection.Add(mo);
+  }
+  collection.SetOwner(true);
+
+  auto sparse = encodeToVector(collection);
+  BOOST_CHECK_LT(sparse.size(), map.GetNcells() * sizeof(float) / 10);
+  auto decoded = histogram_transport::decode(sparse.data(), sparse.size());
+  checkSame(map, *getObject<TH2F>(*decoded, "map"));
+  checkSame(weighted, *getObject<TH1D>(*decoded, "weighted"));
+  checkSame(full, *getObject<TH1F>(*decoded, "full"));
+
+  using Algorithm = histogram_transport::Compression::Algorithm;
+  for (auto algorithm : { Algorithm::Zlib, Algorithm::LZMA, Algorithm::LZ4, Algorithm::ZSTD }) {
+    auto compressed = encodeToVector(collection, { algorithm, 1 });
+    BOOST_CHECK_LT(compressed.size(), sparse.size());
+    auto decompressed = histogram_transport::decode(compressed.data(), compressed.size());
+    checkSame(map, *getObject<TH2F>(*decompressed, "map"));
+    checkSame(weighted, *getObject<TH1D>(*decompressed, "weighted"));
+    checkSame(full, *getObject<TH1F>(*decompressed, "full"));
+    BOOST_CHECK_THROW(histogram_transport::decode(compressed.data(), compressed.size() - 1), std::runtime_error);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(test_streamer_copied_bins)
+{
+  TH2F map("map", "map", 1000, 0, 1000, 500, 0, 500);
+  for (int i = 0; i < 2000; i++) {
+    map.Fill(i % 40 + 100, i % 7 + 250);
+  }
+  TH1D weighted("weighted", "weighted", 100, 0, 100);
+  weighted.Fill(10, 0.5);
+  TProfile profile("profile", "profile", 10, 0, 10);
+  profile.Fill(1, 2);
+
+  MonitorObjectCollection collection;
+  collection.SetName("task");
+  for (TObject* object : std::vector<TObject*>{ &map, &weighted, &profile }) {
+    auto mo = new MonitorObject(object, "task", "class", "TST");
+    mo->setIsOwner(false);
+    collection.Add(mo);
+  }
+  collection.SetOwner(true);
+
+  // as a Merger would receive it
+  auto streamAndRead = [&collection]() {
+    TBufferFile buffer(TBuffer::kWrite);
+    buffer.WriteObject(&collection);
+    buffer.SetReadMode();
+    buffer.SetBufferOffset(0);
+    std::unique_ptr<MonitorObjectCollection> read(dynamic_cast<MonitorObjectCollection*>(buffer.ReadObject(MonitorObjectCollection::Class())));
+    BOOST_REQUIRE(read != nullptr);
+    read->postDeserialization();
+    read->SetOwner(true);
+    BOOST_CHECK_EQUAL(read->GetName(), std::string("task"));
+    checkSame(map, *getObject<TH2F>(*read, "map"));
+    checkSame(weighted, *getObject<TH1D>(*read, "weighted"));
+    checkSame(profile, *getObject<TProfile>(*read, "profile"));
+    return collection.getLastStreamedSize();
+  };
+
+  auto streamed = streamAndRead();
+  BOOST_CHECK_EQUAL(streamed.payload, streamed.uncompressed);
+  collection.setCopyHistogramBins(true);
+  auto copied = streamAndRead();
+  BOOST_CHECK_EQUAL(copied.payload, copied.uncompressed);
+  BOOST_CHECK_EQUAL(map.GetSumw2N(), 0);
+  BOOST_CHECK_EQUAL(weighted.GetSumw2N(), weighted.GetNcells());
+  collection.setCopyHistogramBins(true, { histogram_transport::Compression::Algorithm::ZSTD, 1 });
+  auto compressed = streamAndRead();
+  BOOST_CHECK_LT(compressed.payload, copied.payload / 10);
+  BOOST_CHECK_EQUAL(compressed.uncompressed, copied.payload);
+}
+
+BOOST_AUTO_TEST_CASE(test_compression_from_string)
+{
+  using Algorithm = histogram_transport::Compression::Algorithm;
+  BOOST_CHECK(histogram_transport::Compression::fromString("none").algorithm == Algorithm::None);
+  auto compression = histogram_transport::Compression::fromString("zstd", 5);
+  BOOST_CHECK(compression.algorithm == Algorithm::ZSTD);
+  BOOST_CHECK_EQUAL(compression.level, 5);
+  BOOST_CHECK_THROW(histogram_transport::Compression::fromString("gzip"), std::invalid_argument);
+  BOOST_CHECK_THROW(histogram_transport::Compression::fromString("lz4", 0), std::invalid_argument);
+}
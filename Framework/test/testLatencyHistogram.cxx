@@ -0,0 +1,110 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   testLatencyHistogram.cxx
+///
+
+#include "QualityControl/LatencyHistogram.h"
+
+#define BOOST_TEST_MODULE LatencyHistogram test
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+#include <thread>
+
+using namespace o2::quality_control::core;
+
+BOOST_AUTO_TEST_CASE(test_latency_histogram_buckets)
+{
+  size_t previousIndex = 0;
+  for (uint64_t value = 0; value < 1000000; value += 7) {
+    auto index = LatencyHistogram::bucketIndex(value);
+    BOOST_REQUIRE_LT(index, LatencyHistogram::kBuckets);
+    BOOST_REQUIRE_GE(index, previousIndex);
+    auto upperBound = LatencyHistogram::bucketUpperBound(index);
+    BOOST_REQUIRE_GE(upperBound, value);
+    BOOST_REQUIRE_LE(upperBound - value, value / LatencyHistogram::kSubBuckets);
+    previousIndex = index;
+  }
+  BOOST_CHECK_EQUAL(LatencyHistogram::bucketIndex(UINT64_MAX), LatencyHistogram::kBuckets - 1);
+  BOOST_CHECK_EQUAL(LatencyHistogram::bucketUpperBound(LatencyHistogram::kBuckets - 1), UINT64_MAX);
+}
+
+BOOST_AUTO_TEST_CASE(test_latency_histogram_summary)
+{
+  LatencyHistogram histogram;
+  BOOST_CHECK_EQUAL(histogram.getAndReset().count, 0);
+
+  for (uint64_t value = 1; value <= 1000; value++) {
+    histogram.record(value);
+  }
+  auto summary = histogram.getAndReset();
+  BOOST_CHECK_EQUAL(summary.count, 1000);
+  BOOST_CHECK_EQUAL(summary.max, 1000);
+  BOOST_CHECK_GE(summary.p50, 500);
+  BOOST_CHECK_LE(summary.p50, 500 + 500 / LatencyHistogram::kSubBuckets);
+  BOOST_CHECK_GE(summary.p99, 990);
+  BOOST_CHECK_LE(summary.p99, 1000);
+
+  // it was reset
+  BOOST_CHECK_EQUAL(histogram.getAndReset().count, 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_latency_histogram_threads)
+{
+  LatencyHistograms histograms;
+  auto& histogram = histograms.get("test");
+  BOOST_CHECK_EQUAL(&histogram, &histograms.get("test"));
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; t++) {
+    threads.emplace_back([&histogram, t]() {
+      for (int i = 0; i < 1000; i++) {
+        histogram.record(t * 1000 + i);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  {
+    LatencyTimer timer(&histogram);
+  }
+
+  auto summaries = histograms.getAndResetSummaries();
+  BOOST_REQUIRE_EQUAL(summaries.size(), 1);
+  BOOST_CHECK_EQUAL(summaries[0].first, "test");
+  BOOST_CHECK_EQUAL(summaries[0].second.count, 4001);
+  BOOST_CHECK_EQUAL(summaries[0].second.max, 3999);
+  BOOST_CHECK(histograms.getAndResetSummaries().empty());
+}
+
+BOOST_AUTO_TEST_CASE(test_latency_histograms_per_actor)
+{
+  // two actors in the same process with histograms of the same name
+  LatencyHistograms first;
+  LatencyHistograms second;
+  BOOST_CHECK_NE(&first.get("deserialize"), &second.get("deserialize"));
+  first.get("deserialize").record(10);
+  second.get("deserialize").record(20);
+  second.get("deserialize").record(30);
+
+  // reading one set does not reset the other one
+  auto firstSummaries = first.getAndResetSummaries();
+  BOOST_REQUIRE_EQUAL(firstSummaries.size(), 1);
+  BOOST_CHECK_EQUAL(firstSummaries[0].second.count, 1);
+  auto secondSummaries = second.getAndResetSummaries();
+  BOOST_REQUIRE_EQUAL(secondSummaries.size(), 1);
+  BOOST_CHECK_EQUAL(secondSummaries[0].second.count, 2);
+  BOOST_CHECK_EQUAL(secondSummaries[0].second.max, 30);
+}
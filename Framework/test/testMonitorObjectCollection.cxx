@@ -0,0 +1,124 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   testMonitorObjectCollection.cxx
+///
+
+#include "QualityControl/MonitorObjectCollection.h"
+#include "QualityControl/MonitorObject.h"
+#include <TBufferFile.h>
+#include <TH1F.h>
+
+#define BOOST_TEST_MODULE MonitorObjectCollection test
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+
+using namespace o2::quality_control::core;
+using namespace std;
+
+namespace
+{
+
+MonitorObject* makeMO(const string& name, int entries = 0)
+{
+  auto histo = new TH1F(name.c_str(), name.c_str(), 10, 0, 10);
+  histo->SetDirectory(nullptr);
+  for (int i = 0; i < entries; i++) {
+    histo->Fill(1);
+  }
+  auto mo = new MonitorObject(histo, "task", "class", "TST");
+  mo->setIsOwner(true);
+  return mo;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(test_lookup)
+{
+  MonitorObjectCollection collection;
+  collection.SetOwner(true);
+  BOOST_CHECK(collection.FindObject("histo1") == nullptr);
+
+  auto histo1 = makeMO("histo1");
+  auto histo2 = makeMO("histo2");
+  collection.Add(histo1);
+  collection.Add(histo2);
+  BOOST_CHECK_EQUAL(collection.FindObject("histo1"), histo1);
+  BOOST_CHECK_EQUAL(collection.FindObject("histo2"), histo2);
+
+  // the first object with a given name is found, as in TObjArray
+  auto duplicate = makeMO("histo1");
+  collection.Add(duplicate);
+  BOOST_CHECK_EQUAL(collection.FindObject("histo1"), histo1);
+  collection.Remove(histo1);
+  BOOST_CHECK_EQUAL(collection.FindObject("histo1"), duplicate);
+  delete histo1;
+  auto first = makeMO("histo2");
+  collection.AddFirst(first);
+  BOOST_CHECK_EQUAL(collection.FindObject("histo2"), first);
+
+  // a renamed object is detected when looking for its old name
+  dynamic_cast<TH1*>(first->getObject())->SetName("histo3");
+  BOOST_CHECK_EQUAL(collection.FindObject("histo2"), histo2);
+  BOOST_CHECK_EQUAL(collection.FindObject("histo3"), first);
+
+  BOOST_CHECK(collection.FindObject("histo5") == nullptr);
+
+  collection.Delete();
+  BOOST_CHECK(collection.FindObject("histo1") == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(test_streaming)
+{
+  MonitorObjectCollection collection;
+  collection.SetOwner(true);
+  collection.SetName("task");
+  collection.Add(makeMO("histo1"));
+  collection.Add(makeMO("histo2"));
+  BOOST_REQUIRE(collection.FindObject("histo2") != nullptr);
+
+  TBufferFile buffer(TBuffer::kWrite);
+  buffer.WriteObject(&collection);
+  buffer.SetReadMode();
+  buffer.SetBufferOffset(0);
+  unique_ptr<MonitorObjectCollection> read(dynamic_cast<MonitorObjectCollection*>(buffer.ReadObject(MonitorObjectCollection::Class())));
+  BOOST_REQUIRE(read != nullptr);
+  read->postDeserialization();
+  BOOST_CHECK_EQUAL(read->GetEntries(), 2);
+  BOOST_REQUIRE(read->FindObject("histo2") != nullptr);
+  BOOST_CHECK_NE(read->FindObject("histo2"), collection.FindObject("histo2"));
+}
+
+BOOST_AUTO_TEST_CASE(test_merge)
+{
+  MonitorObjectCollection target;
+  target.SetOwner(true);
+  target.Add(makeMO("histo1", 1));
+  target.Add(makeMO("histo2", 2));
+
+  auto other = new MonitorObjectCollection();
+  other->SetOwner(true);
+  other->Add(makeMO("histo2", 3));
+  other->Add(makeMO("histo3", 4));
+  target.merge(other);
+  delete other;
+
+  BOOST_REQUIRE_EQUAL(target.GetEntries(), 3);
+  auto entries = [&](const char* name) {
+    return dynamic_cast<TH1*>(dynamic_cast<MonitorObject*>(target.FindObject(name))->getObject())->GetEntries();
+  };
+  BOOST_CHECK_EQUAL(entries("histo1"), 1);
+  BOOST_CHECK_EQUAL(entries("histo2"), 5);
+  BOOST_CHECK_EQUAL(entries("histo3"), 4);
+}
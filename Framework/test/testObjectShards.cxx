@@ -0,0 +1,148 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   testObjectShards.cxx
+///
+
+#include "QualityControl/ObjectShards.h"
+#include "QualityControl/ObjectsManager.h"
+#include "QualityControl/ThreadPool.h"
+#include <TH1F.h>
+#include <TH2F.h>
+#include <TObjString.h>
+#include <TROOT.h>
+
+#define BOOST_TEST_MODULE ObjectShards test
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+#include <set>
+#include <stdexcept>
+
+using namespace o2::quality_control::core;
+
+BOOST_AUTO_TEST_CASE(test_fill_in_parallel)
+{
+  ROOT::EnableThreadSafety();
+  ObjectsManager objectsManager("test", "TestClass", "TST", "", 0, true);
+  TH1F histogram1D("histogram1D", "histogram1D", 10, 0, 10);
+  TH2F histogram2D("histogram2D", "histogram2D", 10, 0, 10, 10, 0, 10);
+  TObjString string("string");
+  objectsManager.startPublishing(&histogram1D);
+  objectsManager.startPublishing(&histogram2D);
+  objectsManager.startPublishing(&string);
+  histogram1D.Fill(1);
+
+  const size_t nShards = 4;
+  ObjectShards shards(nShards);
+  shards.update(objectsManager);
+  BOOST_CHECK_EQUAL(shards.size(), nShards);
+  BOOST_CHECK_EQUAL(shards.getNumberObjects(), 2);
+
+  // the assertions are not thread-safe, the copies are checked afterwards
+  ThreadPool pool(nShards);
+  std::vector<std::future<TObject*>> results;
+  for (size_t shard = 0; shard < nShards; shard++) {
+    results.push_back(pool.submit([&shards, &histogram1D, &histogram2D, shard]() {
+      TObject* copy = nullptr;
+      shards.runWith(shard, [&]() {
+        auto copy1D = static_cast<TH1F*>(ObjectShards::get(&histogram1D));
+        auto copy2D = static_cast<TH2F*>(ObjectShards::get(&histogram2D));
+        copy = copy1D;
+        for (int i = 0; i < 1000; i++) {
+          copy1D->Fill(shard);
+          copy2D->Fill(shard, i % 10);
+        }
+      });
+      return copy;
+    }));
+  }
+  std::set<TObject*> copies;
+  for (auto& result : results) {
+    auto copy = result.get();
+    BOOST_CHECK(copy != &histogram1D);
+    BOOST_CHECK_EQUAL(static_cast<TH1*>(copy)->GetEntries(), 1000);
+    copies.insert(copy);
+  }
+  BOOST_CHECK_EQUAL(copies.size(), nShards);
+  BOOST_CHECK_EQUAL(histogram1D.GetEntries(), 1);
+
+  shards.merge();
+  BOOST_CHECK_EQUAL(histogram1D.GetEntries(), 4001);
+  BOOST_CHECK_EQUAL(histogram1D.GetBinContent(2), 1001);
+  BOOST_CHECK_EQUAL(histogram1D.GetBinContent(4), 1000);
+  BOOST_CHECK_EQUAL(histogram2D.GetEntries(), 4000);
+  BOOST_CHECK_EQUAL(histogram2D.GetBinContent(4, 5), 100);
+
+  // the copies are empty after merging
+  shards.merge();
+  BOOST_CHECK_EQUAL(histogram1D.GetEntries(), 4001);
+}
+
+BOOST_AUTO_TEST_CASE(test_get)
+{
+  ObjectsManager objectsManager("test", "TestClass", "TST", "", 0, true);
+  TH1F published("published", "published", 10, 0, 10);
+  TH1F unpublished("unpublished", "unpublished", 10, 0, 10);
+  objectsManager.startPublishing(&published);
+  ObjectShards shards(2);
+  shards.update(objectsManager);
+
+  // outside of a shard, the objects themselves are used
+  BOOST_CHECK_EQUAL(ObjectShards::get(&published), &published);
+  BOOST_CHECK_EQUAL(ObjectShards::get(&unpublished), &unpublished);
+
+  shards.runWith(1, [&]() {
+    BOOST_CHECK_NE(ObjectShards::get(&published), &published);
+    BOOST_CHECK_THROW(ObjectShards::get(&unpublished), std::runtime_error);
+  });
+  BOOST_CHECK_THROW(shards.runWith(2, []() {}), std::out_of_range);
+  BOOST_CHECK_EQUAL(ObjectShards::get(&published), &published);
+
+  // the copies are dropped when the objects are not published anymore
+  objectsManager.stopPublishing(&published);
+  objectsManager.startPublishing(&unpublished);
+  shards.update(objectsManager);
+  BOOST_CHECK_EQUAL(shards.getNumberObjects(), 1);
+  shards.runWith(0, [&]() {
+    BOOST_CHECK_NE(ObjectShards::get(&unpublished), &unpublished);
+    BOOST_CHECK_THROW(ObjectShards::get(&published), std::runtime_error);
+  });
+
+  // reset() drops the content of the copies
+  shards.runWith(0, [&]() { static_cast<TH1*>(ObjectShards::get(&unpublished))->Fill(1); });
+  shards.reset();
+  shards.merge();
+  BOOST_CHECK_EQUAL(unpublished.GetEntries(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_merge_bin_content)
+{
+  // AddBinContent() does not count entries, the copies are not empty though
+  ObjectsManager objectsManager("test", "TestClass", "TST", "", 0, true);
+  TH1F histogram("histogram", "histogram", 10, 0, 10);
+  objectsManager.startPublishing(&histogram);
+  ObjectShards shards(2);
+  shards.update(objectsManager);
+
+  shards.runWith(0, [&]() { static_cast<TH1*>(ObjectShards::get(&histogram))->AddBinContent(3, 2); });
+  shards.runWith(1, [&]() { static_cast<TH1*>(ObjectShards::get(&histogram))->SetBinContent(5, 4); });
+  shards.merge();
+  BOOST_CHECK_EQUAL(histogram.GetBinContent(3), 2);
+  BOOST_CHECK_EQUAL(histogram.GetBinContent(5), 4);
+
+  // the copies are reset after merging
+  shards.merge();
+  BOOST_CHECK_EQUAL(histogram.GetBinContent(3), 2);
+  BOOST_CHECK_EQUAL(histogram.GetBinContent(5), 4);
+}
@@ -0,0 +1,135 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   testObjectWatcher.cxx
+///
+
+#include "QualityControl/ObjectWatcher.h"
+
+#define BOOST_TEST_MODULE ObjectWatcher test
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+#include <atomic>
+#include <stdexcept>
+
+using namespace o2::quality_control::postprocessing;
+using namespace std::chrono_literals;
+
+namespace
+{
+
+/// A database with one version of each object, which counts the requests.
+struct FakeDatabase {
+  std::mutex mutex;
+  std::map<std::string, std::pair<std::string, std::string>> objects; // path -> md5, valid from
+  std::atomic<size_t> requests = 0;
+
+  void set(const std::string& path, const std::string& md5, const std::string& validFrom)
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    objects[path] = { md5, validFrom };
+  }
+
+  ObjectWatcher::HeadersFetcher fetcher()
+  {
+    return [this](const std::string& path, const std::map<std::string, std::string>&) {
+      requests++;
+      std::lock_guard<std::mutex> lock(mutex);
+      std::map<std::string, std::string> headers;
+      if (auto object = objects.find(path); object != objects.end()) {
+        headers["Content-MD5"] = object->second.first;
+        headers["Valid-From"] = object->second.second;
+      } else if (path == "broken") {
+        throw std::runtime_error("broken");
+      }
+      return headers;
+    };
+  }
+};
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(test_watch_and_refresh)
+{
+  FakeDatabase database;
+  database.set("qc/TST/existing", "md5-1", "100");
+  ObjectWatcher watcher(database.fetcher(), 1h);
+
+  // the current versions are not changes
+  auto existing = watcher.watch("qc/TST/existing", {});
+  auto missing = watcher.watch("qc/TST/missing", {});
+  auto broken = watcher.watch("broken", {});
+  auto existingVersion = existing->getState().version;
+  BOOST_CHECK_EQUAL(existingVersion, 1);
+  BOOST_CHECK_EQUAL(existing->getState().validFrom, 100);
+  BOOST_CHECK_EQUAL(missing->getState().version, 0);
+  BOOST_CHECK_EQUAL(broken->getState().version, 0);
+
+  watcher.refresh();
+  BOOST_CHECK_EQUAL(existing->getState().version, existingVersion);
+  BOOST_CHECK_EQUAL(missing->getState().version, 0);
+
+  database.set("qc/TST/existing", "md5-2", "200");
+  database.set("qc/TST/missing", "md5-1", "300");
+  watcher.refresh();
+  BOOST_CHECK_EQUAL(existing->getState().version, existingVersion + 1);
+  BOOST_CHECK_EQUAL(existing->getState().validFrom, 200);
+  BOOST_CHECK_EQUAL(missing->getState().version, 1);
+  BOOST_CHECK_EQUAL(missing->getState().validFrom, 300);
+}
+
+BOOST_AUTO_TEST_CASE(test_shared_watches)
+{
+  FakeDatabase database;
+  database.set("qc/TST/object", "md5-1", "100");
+  ObjectWatcher watcher(database.fetcher(), 1h);
+
+  auto first = watcher.watch("qc/TST/object", { { "RunNumber", "1" } });
+  auto second = watcher.watch("qc/TST/object", { { "RunNumber", "1" } });
+  auto otherRun = watcher.watch("qc/TST/object", { { "RunNumber", "2" } });
+  BOOST_CHECK_EQUAL(first, second);
+  BOOST_CHECK_NE(first, otherRun);
+  BOOST_CHECK_EQUAL(watcher.getNumberWatches(), 2);
+
+  // each distinct object is checked once
+  database.requests = 0;
+  watcher.refresh();
+  BOOST_CHECK_EQUAL(database.requests, 2);
+
+  // the objects which are not watched anymore are not checked
+  first.reset();
+  second.reset();
+  BOOST_CHECK_EQUAL(watcher.getNumberWatches(), 1);
+  database.requests = 0;
+  watcher.refresh();
+  BOOST_CHECK_EQUAL(database.requests, 1);
+}
+
+BOOST_AUTO_TEST_CASE(test_background_polling)
+{
+  FakeDatabase database;
+  ObjectWatcher watcher(database.fetcher(), 1h);
+  auto watch = watcher.watch("qc/TST/object", {});
+  watcher.requestInterval(10ms);
+  BOOST_CHECK(watcher.getInterval() == 10ms);
+  watcher.requestInterval(1s);
+  BOOST_CHECK(watcher.getInterval() == 10ms);
+
+  database.set("qc/TST/object", "md5-1", "100");
+  for (int i = 0; i < 500 && watch->getState().version == 0; i++) {
+    std::this_thread::sleep_for(10ms);
+  }
+  BOOST_CHECK_EQUAL(watch->getState().version, 1);
+  BOOST_CHECK_EQUAL(watch->getState().validFrom, 100);
+}
@@ -22,6 +22,7 @@
 #include <TObjString.h>
 #include <TObjArray.h>
 #include <TH1F.h>
+#include <TH2F.h>
 #include <boost/test/unit_test.hpp>
 
 using namespace std;
@@ -157,4 +158,154 @@ BOOST_AUTO_TEST_CASE(drawOptions_test)
   BOOST_CHECK_EQUAL(objectsManager.getMonitorObject("histo")->getMetadataMap().at(ObjectsManager::gDisplayHintsKey), "gridy logy");
 }
 
+BOOST_AUTO_TEST_CASE(change_tracking_test)
+{
+  Config config;
+  config.taskName = "test";
+  config.consulUrl = "";
+  ObjectsManager objectsManager(config.taskName, config.taskClass, config.detectorName, config.consulUrl, 0, true);
+
+  TH1F h1("histo1", "h1", 100, 0, 99);
+  TH1F h2("histo2", "h2", 100, 0, 99);
+  TObjString s("content");
+  objectsManager.startPublishing(&h1);
+  objectsManager.startPublishing(&h2);
+  objectsManager.startPublishing(&s);
+
+  // everything is new at the beginning
+  unique_ptr<MonitorObjectCollection> changed(objectsManager.getNonOwningArrayOfChanged());
+  BOOST_CHECK_EQUAL(changed->GetEntries(), 3);
+
+  // nothing was filled, only the unsupported type is returned
+  changed.reset(objectsManager.getNonOwningArrayOfChanged());
+  BOOST_REQUIRE_EQUAL(changed->GetEntries(), 1);
+  BOOST_CHECK(changed->FindObject("content") != nullptr);
+
+  h1.Fill(5);
+  h2.SetBinContent(3, 10);
+  changed.reset(objectsManager.getNonOwningArrayOfChanged());
+  BOOST_CHECK_EQUAL(changed->GetEntries(), 3);
+
+  objectsManager.setChanged("histo2");
+  changed.reset(objectsManager.getNonOwningArrayOfChanged());
+  BOOST_CHECK_EQUAL(changed->GetEntries(), 2);
+  BOOST_CHECK(changed->FindObject("histo2") != nullptr);
+
+  objectsManager.setDisplayHint("histo1", "logy");
+  changed.reset(objectsManager.getNonOwningArrayOfChanged());
+  BOOST_CHECK(changed->FindObject("histo1") != nullptr);
+
+  objectsManager.resetChangeTracking();
+  changed.reset(objectsManager.getNonOwningArrayOfChanged());
+  BOOST_CHECK_EQUAL(changed->GetEntries(), 3);
+
+  BOOST_CHECK_THROW(objectsManager.setChanged("missing"), ObjectNotFoundError);
+}
+
+BOOST_AUTO_TEST_CASE(change_tracking_after_reset_test)
+{
+  Config config;
+  config.taskName = "test";
+  config.consulUrl = "";
+  ObjectsManager objectsManager(config.taskName, config.taskClass, config.detectorName, config.consulUrl, 0, true);
+
+  TH1F h1("histo1", "h1", 100, 0, 99);
+  TH1F h2("histo2", "h2", 100, 0, 99);
+  objectsManager.startPublishing(&h1);
+  objectsManager.startPublishing(&h2);
+  h1.Fill(5);
+  h2.Fill(5);
+  unique_ptr<MonitorObjectCollection> changed(objectsManager.getNonOwningArrayOfChanged());
+  BOOST_CHECK_EQUAL(changed->GetEntries(), 2);
+
+  // as in the delta merging mode: the task is reset after each cycle and refills its objects
+  h1.Reset();
+  h2.Reset();
+  objectsManager.setChangeTrackingReference();
+  h1.Fill(5);
+  changed.reset(objectsManager.getNonOwningArrayOfChanged());
+  BOOST_REQUIRE_EQUAL(changed->GetEntries(), 1);
+  BOOST_CHECK(changed->FindObject("histo1") != nullptr);
+
+  // a forced change survives the reset
+  h1.Reset();
+  objectsManager.setChanged("histo2");
+  objectsManager.setChangeTrackingReference();
+  changed.reset(objectsManager.getNonOwningArrayOfChanged());
+  BOOST_REQUIRE_EQUAL(changed->GetEntries(), 1);
+  BOOST_CHECK(changed->FindObject("histo2") != nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(derived_objects_test)
+{
+  Config config;
+  config.consulUrl = "";
+  ObjectsManager objectsManager(config.taskName, config.taskClass, config.detectorName, config.consulUrl, 0, true);
+
+  TH1F numerator("numerator", "numerator", 10, 0, 10);
+  TH1F denominator("denominator", "denominator", 10, 0, 10);
+  TH1F ratio("ratio", "ratio", 10, 0, 10);
+  objectsManager.startPublishing(&numerator);
+  objectsManager.startPublishing(&denominator);
+  objectsManager.startPublishing(&ratio);
+  BOOST_CHECK_THROW(objectsManager.setDerived("ratio", "unknown", { "numerator", "denominator" }), std::runtime_error);
+  BOOST_CHECK_THROW(objectsManager.setDerived("ratio", "ratio", { "numerator", "missing" }), ObjectNotFoundError);
+  objectsManager.setDerived("ratio", "ratio", { "numerator", "denominator" });
+
+  numerator.Fill(1);
+  denominator.Fill(1);
+  denominator.Fill(1);
+  BOOST_CHECK_EQUAL(ratio.GetBinContent(2), 0);
+  objectsManager.computeDerivedObjects();
+  BOOST_CHECK_CLOSE(ratio.GetBinContent(2), 0.5, 0.001);
+
+  // after merging, the derived object is computed out of the merged sources
+  unique_ptr<MonitorObjectCollection> published(objectsManager.getNonOwningArray());
+  unique_ptr<MonitorObjectCollection> target(dynamic_cast<MonitorObjectCollection*>(published->Clone()));
+  unique_ptr<MonitorObjectCollection> other(dynamic_cast<MonitorObjectCollection*>(published->Clone()));
+  target->postDeserialization();
+  other->postDeserialization();
+  dynamic_cast<TH1*>(dynamic_cast<MonitorObject*>(other->FindObject("numerator"))->getObject())->Fill(1);
+  target->merge(other.get());
+  auto mergedRatio = dynamic_cast<TH1*>(dynamic_cast<MonitorObject*>(target->FindObject("ratio"))->getObject());
+  BOOST_CHECK_CLOSE(mergedRatio->GetBinContent(2), 0.75, 0.001);
+
+  objectsManager.stopPublishing("ratio");
+  objectsManager.computeDerivedObjects();
+}
+
+BOOST_AUTO_TEST_CASE(fill_buffers_test)
+{
+  Config config;
+  config.consulUrl = "";
+  ObjectsManager objectsManager(config.taskName, config.taskClass, config.detectorName, config.consulUrl, 0, true);
+
+  TH1F histogram1D("histogram1D", "histogram1D", 10, 0, 10);
+  TH2F histogram2D("histogram2D", "histogram2D", 10, 0, 10, 10, 0, 10);
+  BOOST_CHECK_THROW(objectsManager.getFillBuffer(&histogram1D), ObjectNotFoundError);
+  objectsManager.startPublishing(&histogram1D);
+  objectsManager.startPublishing(&histogram2D);
+
+  auto& buffer1D = objectsManager.getFillBuffer(&histogram1D);
+  BOOST_CHECK_EQUAL(&buffer1D, &objectsManager.getFillBuffer(&histogram1D));
+  BOOST_CHECK_THROW(objectsManager.getFillBuffer(static_cast<TH1*>(&histogram2D)), std::invalid_argument);
+  auto& buffer2D = objectsManager.getFillBuffer(&histogram2D);
+  buffer1D.fill(1);
+  buffer2D.fill(1, 2);
+  BOOST_CHECK_EQUAL(histogram1D.GetEntries(), 0);
+  objectsManager.flushFillBuffers();
+  BOOST_CHECK_EQUAL(histogram1D.GetBinContent(2), 1);
+  BOOST_CHECK_EQUAL(histogram2D.GetBinContent(2, 3), 1);
+
+  buffer1D.fill(1);
+  buffer1D.clear();
+  objectsManager.flushFillBuffers();
+  BOOST_CHECK_EQUAL(histogram1D.GetEntries(), 1);
+
+  // the remaining entries are filled when the histogram stops being published
+  buffer1D.fill(1);
+  objectsManager.stopPublishing(&histogram1D);
+  BOOST_CHECK_EQUAL(histogram1D.GetEntries(), 2);
+}
+
 } // namespace o2::quality_control::core
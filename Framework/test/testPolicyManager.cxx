@@ -361,3 +361,64 @@ BOOST_AUTO_TEST_CASE(test_errors)
   BOOST_CHECK_EQUAL(updatePolicyManager.isReady("actor2"), false);
   updatePolicyManager.updateGlobalRevision();
 }
+
+BOOST_AUTO_TEST_CASE(test_ready_actors)
+{
+  UpdatePolicyManager updatePolicyManager;
+
+  // init
+  updatePolicyManager.addPolicy("actor1", UpdatePolicyType::OnAny, { "object1", "object2" }, false, false);
+  updatePolicyManager.addPolicy("actor2", UpdatePolicyType::OnAll, { "object2", "object3", "object3" }, false, false);
+  updatePolicyManager.addPolicy("actor3", UpdatePolicyType::OnGlobalAny, {}, true, false);
+
+  // the actors which are always ready are returned even without new data
+  BOOST_CHECK(updatePolicyManager.getReadyActors() == vector<string>({ "actor3" }));
+
+  // iteration 1 of run() : get object2 and object3 (twice)
+  updatePolicyManager.updateObjectRevision("object2");
+  updatePolicyManager.updateObjectRevision("object3");
+  updatePolicyManager.updateObjectRevision("object3");
+  BOOST_CHECK(updatePolicyManager.getReadyActors() == vector<string>({ "actor1", "actor2", "actor3" }));
+  // a ready actor which was not triggered stays ready
+  updatePolicyManager.updateActorRevision("actor2");
+  updatePolicyManager.updateActorRevision("actor3");
+  BOOST_CHECK(updatePolicyManager.getReadyActors() == vector<string>({ "actor1", "actor3" }));
+  updatePolicyManager.updateActorRevision("actor1");
+  updatePolicyManager.updateGlobalRevision();
+
+  // iteration 2 of run() : get object3 only
+  updatePolicyManager.updateObjectRevision("object3");
+  BOOST_CHECK(updatePolicyManager.getReadyActors() == vector<string>({ "actor3" }));
+  BOOST_CHECK_EQUAL(updatePolicyManager.isReady("actor2"), false);
+  updatePolicyManager.updateGlobalRevision();
+
+  // iteration 3 of run() : get object2, now actor2 has both of its inputs updated
+  updatePolicyManager.updateObjectRevision("object2");
+  BOOST_CHECK(updatePolicyManager.getReadyActors() == vector<string>({ "actor1", "actor2", "actor3" }));
+
+  // replacing a policy removes the old dependencies
+  updatePolicyManager.addPolicy("actor1", UpdatePolicyType::OnAny, { "object4" }, false, false);
+  BOOST_CHECK_EQUAL(updatePolicyManager.isReady("actor1"), false);
+  updatePolicyManager.updateObjectRevision("object4");
+  BOOST_CHECK_EQUAL(updatePolicyManager.isReady("actor1"), true);
+
+  updatePolicyManager.reset();
+  BOOST_CHECK(updatePolicyManager.getReadyActors().empty());
+  BOOST_CHECK_THROW(updatePolicyManager.isReady("actor1"), ObjectNotFoundError);
+}
+
+BOOST_AUTO_TEST_CASE(test_object_ids)
+{
+  UpdatePolicyManager updatePolicyManager;
+
+  auto object1 = updatePolicyManager.getObjectId("object1");
+  updatePolicyManager.addPolicy("actor1", UpdatePolicyType::OnAll, { "object1", "object2" }, false, false);
+  auto object2 = updatePolicyManager.getObjectId("object2");
+  BOOST_CHECK_NE(object1, object2);
+  BOOST_CHECK_EQUAL(updatePolicyManager.getObjectId("object1"), object1);
+
+  updatePolicyManager.updateObjectRevision(object1);
+  BOOST_CHECK_EQUAL(updatePolicyManager.isReady("actor1"), false);
+  updatePolicyManager.updateObjectRevision(object2);
+  BOOST_CHECK_EQUAL(updatePolicyManager.isReady("actor1"), true);
+}
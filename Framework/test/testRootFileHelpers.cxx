@@ -0,0 +1,96 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   testRootFileHelpers.cxx
+///
+
+#include "QualityControl/RootFileHelpers.h"
+#include "QualityControl/MonitorObject.h"
+#include "QualityControl/MonitorObjectCollection.h"
+#include <TFile.h>
+#include <TH1F.h>
+#include <filesystem>
+#include <unistd.h>
+
+#define BOOST_TEST_MODULE RootFileHelpers test
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+
+using namespace o2::quality_control::core;
+using namespace std;
+
+namespace
+{
+
+MonitorObject* makeMO(const string& name, double entries)
+{
+  auto histo = new TH1F(name.c_str(), name.c_str(), 10, 0, 10);
+  histo->SetDirectory(nullptr);
+  for (int i = 0; i < entries; i++) {
+    histo->Fill(1);
+  }
+  auto mo = new MonitorObject(histo, "task", "class", "TST");
+  mo->setIsOwner(true);
+  return mo;
+}
+
+double entries(MonitorObjectCollection& collection, const string& name)
+{
+  auto mo = dynamic_cast<MonitorObject*>(collection.FindObject(name.c_str()));
+  BOOST_REQUIRE(mo != nullptr);
+  return dynamic_cast<TH1*>(mo->getObject())->GetEntries();
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(test_both_layouts)
+{
+  auto path = filesystem::temp_directory_path() / ("qc-test-root-file-helpers-" + to_string(getpid()) + ".root");
+  TFile file(path.c_str(), "RECREATE");
+
+  MonitorObjectCollection collection;
+  collection.SetOwner(true);
+  collection.SetName("task");
+  collection.Add(makeMO("histo1", 1));
+  collection.Add(makeMO("histo2", 2));
+  root_file_helpers::writeMonitorObjectCollection(file, collection);
+  BOOST_CHECK(!root_file_helpers::isStoredPerObject(file, "task"));
+
+  auto stored = root_file_helpers::readMonitorObjectCollection(file, "task");
+  BOOST_REQUIRE(stored != nullptr);
+  BOOST_CHECK_EQUAL(stored->GetEntries(), 2);
+  BOOST_CHECK(root_file_helpers::readMonitorObjectCollection(file, "missing") == nullptr);
+
+  // switching to the layout with one key per object, only the modified object is written afterwards
+  std::vector<TObject*> objects{ stored->At(0), stored->At(1) };
+  root_file_helpers::writeMonitorObjects(file, "task", objects);
+  BOOST_CHECK(root_file_helpers::isStoredPerObject(file, "task"));
+  std::unique_ptr<MonitorObject> updated(makeMO("histo2", 5));
+  root_file_helpers::writeMonitorObjects(file, "task", { updated.get() });
+
+  BOOST_CHECK_EQUAL(root_file_helpers::listMonitorObjectCollections(file).size(), 1);
+  auto perObject = root_file_helpers::readMonitorObjectCollection(file, "task");
+  BOOST_REQUIRE(perObject != nullptr);
+  BOOST_CHECK_EQUAL(perObject->GetEntries(), 2);
+  BOOST_CHECK_EQUAL(entries(*perObject, "histo1"), 1);
+  BOOST_CHECK_EQUAL(entries(*perObject, "histo2"), 5);
+
+  // and back to one key
+  root_file_helpers::writeMonitorObjectCollection(file, *perObject);
+  BOOST_CHECK(!root_file_helpers::isStoredPerObject(file, "task"));
+  BOOST_CHECK_EQUAL(root_file_helpers::listMonitorObjectCollections(file).size(), 1);
+
+  file.Close();
+  filesystem::remove(path);
+}
@@ -0,0 +1,62 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   testThreadPool.cxx
+///
+
+#include "QualityControl/ThreadPool.h"
+
+#define BOOST_TEST_MODULE ThreadPool test
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+#include <atomic>
+#include <stdexcept>
+
+using namespace o2::quality_control::core;
+
+BOOST_AUTO_TEST_CASE(test_thread_pool)
+{
+  ThreadPool pool(4);
+  BOOST_CHECK_EQUAL(pool.size(), 4);
+
+  std::atomic<int> executed = 0;
+  std::vector<std::future<int>> results;
+  for (int i = 0; i < 100; i++) {
+    results.push_back(pool.submit([i, &executed]() {
+      executed++;
+      return i * i;
+    }));
+  }
+  for (int i = 0; i < 100; i++) {
+    BOOST_CHECK_EQUAL(results[i].get(), i * i);
+  }
+  BOOST_CHECK_EQUAL(executed, 100);
+
+  auto failing = pool.submit([]() { throw std::runtime_error("error in a task"); });
+  BOOST_CHECK_THROW(failing.get(), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(test_thread_pool_destruction)
+{
+  // the tasks already submitted are executed before the threads are stopped
+  std::atomic<int> executed = 0;
+  {
+    ThreadPool pool(0); // at least one thread is created
+    BOOST_CHECK_EQUAL(pool.size(), 1);
+    for (int i = 0; i < 10; i++) {
+      pool.submit([&executed]() { executed++; });
+    }
+  }
+  BOOST_CHECK_EQUAL(executed, 10);
+}
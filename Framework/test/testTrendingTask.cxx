@@ -20,10 +20,17 @@
 #include "QualityControl/MonitorObject.h"
 #include "QualityControl/Triggers.h"
 #include "QualityControl/PostProcessingRunner.h"
+#include "QualityControl/DummyDatabase.h"
+#include "QualityControl/TrendingTaskConfig.h"
 #include <Framework/ServiceRegistry.h>
 
+#include <Common/Exceptions.h>
 #include <Configuration/ConfigurationFactory.h>
+#include <boost/property_tree/json_parser.hpp>
+#include <TCanvas.h>
+#include <TGraphErrors.h>
 #include <TH1I.h>
+#include <sstream>
 
 #define BOOST_TEST_MODULE TrendingTask test
 #define BOOST_TEST_MAIN
@@ -36,6 +43,7 @@ using namespace o2::quality_control::postprocessing;
 using namespace o2::quality_control::repository;
 using namespace o2::configuration;
 using namespace o2::framework;
+using namespace AliceO2::Common;
 
 const std::string CCDB_ENDPOINT = "ccdb-test.cern.ch:8080";
 
@@ -113,4 +121,149 @@ BOOST_AUTO_TEST_CASE(test_task)
       BOOST_CHECK_CLOSE(qualityLevels[i], 3, 0.01);
     }
   }
-}
\ No newline at end of file
+}
+
+namespace
+{
+// Gives a different histogram for each second of the timestamp, so the trended values change at each update.
+class TrendSourceDatabase : public DummyDatabase
+{
+ public:
+  std::shared_ptr<MonitorObject> retrieveMO(std::string, std::string objectName, long timestamp, const Activity&) override
+  {
+    const long second = timestamp / 1000;
+    auto* histo = new TH1I(objectName.c_str(), objectName.c_str(), 10, 0, 10.0);
+    for (long fill = 0; fill <= second % 5; fill++) {
+      histo->Fill((second * 3 + fill) % 10);
+    }
+    return std::make_shared<MonitorObject>(histo, "TestTrendingTask", "TestClass", "TST");
+  }
+};
+
+boost::property_tree::ptree makeIncrementalConfig(const std::string& plots)
+{
+  std::stringstream json;
+  json << R"({ "qc": {
+    "config": { "database": { "implementation": "Dummy", "host": "" } },
+    "postprocessing": { "TestTrendingTask": {
+      "className": "o2::quality_control::postprocessing::TrendingTask",
+      "moduleName": "QualityControl",
+      "detectorName": "TST",
+      "incrementalPlots": "true",
+      "dataSources": [ {
+        "type": "repository",
+        "path": "TST/MO/TestTrendingTask",
+        "name": "testHistoTrending",
+        "reductorName": "o2::quality_control_modules::common::TH1Reductor",
+        "moduleName": "QcCommon"
+      } ],
+      "plots": )"
+       << plots << R"(,
+      "initTrigger": [], "updateTrigger": [], "stopTrigger": []
+    } }
+  } })";
+  boost::property_tree::ptree config;
+  boost::property_tree::read_json(json, config);
+  return config;
+}
+
+// Compares an incrementally updated plot with what TTree::Draw gives for the whole trend.
+void checkPlotMatchesTree(ObjectsManager& objectsManager, TTree& trend, const TrendingTaskConfig::Plot& plot)
+{
+  auto* canvas = dynamic_cast<TCanvas*>(objectsManager.getMonitorObject(plot.name)->getObject());
+  BOOST_REQUIRE(canvas != nullptr);
+  const std::string varexp = plot.graphErrors.empty() ? plot.varexp : plot.varexp + ":" + plot.graphErrors;
+  const Long64_t rows = trend.Draw(varexp.c_str(), plot.selection.c_str(), "goff");
+
+  if (auto* histogram = dynamic_cast<TH1*>(canvas->GetPrimitive(plot.name.c_str()))) {
+    double sum = 0;
+    for (Long64_t row = 0; row < rows; row++) {
+      sum += trend.GetVal(0)[row];
+    }
+    BOOST_CHECK_EQUAL(histogram->GetEntries(), rows);
+    if (rows > 0) {
+      BOOST_CHECK_CLOSE(histogram->GetMean(), sum / rows, 0.0001);
+    }
+    return;
+  }
+
+  auto* graph = dynamic_cast<TGraph*>(canvas->GetPrimitive(plot.name.c_str()));
+  BOOST_REQUIRE(graph != nullptr);
+  BOOST_REQUIRE_EQUAL(graph->GetN(), rows);
+  auto* graphErrors = dynamic_cast<TGraphErrors*>(graph);
+  BOOST_REQUIRE_EQUAL(graphErrors != nullptr, !plot.graphErrors.empty());
+  for (Long64_t row = 0; row < rows; row++) {
+    BOOST_CHECK_EQUAL(graph->GetX()[row], trend.GetVal(1)[row]);
+    BOOST_CHECK_EQUAL(graph->GetY()[row], trend.GetVal(0)[row]);
+    if (graphErrors != nullptr) {
+      BOOST_CHECK_EQUAL(graphErrors->GetEX()[row], trend.GetVal(2)[row]);
+      BOOST_CHECK_EQUAL(graphErrors->GetEY()[row], trend.GetVal(3)[row]);
+    }
+  }
+}
+
+// Runs a few updates and checks after each of them that the plots are appended to and match the whole trend.
+void runIncrementalUpdates(TrendingTask& task, ObjectsManager& objectsManager, ServiceRegistry& services,
+                           const boost::property_tree::ptree& config, uint64_t firstSecond, size_t updates)
+{
+  const std::string taskName = "TestTrendingTask";
+  task.configure(taskName, config);
+  task.initialize({ TriggerType::Once, false, { 0, 0, "", "", "qc" }, firstSecond * 1000 }, services);
+  const TrendingTaskConfig taskConfig(taskName, config);
+
+  std::map<std::string, TObject*> firstCanvases;
+  for (size_t i = 0; i < updates; i++) {
+    task.update({ TriggerType::Always, false, { 0, 0, "", "", "qc" }, (firstSecond + i) * 1000 + 50 }, services);
+    auto* trend = dynamic_cast<TTree*>(objectsManager.getMonitorObject(taskName)->getObject());
+    BOOST_REQUIRE(trend != nullptr);
+    BOOST_REQUIRE_EQUAL(trend->GetEntries(), static_cast<Long64_t>(i + 1));
+
+    for (const auto& plot : taskConfig.plots) {
+      auto* canvas = objectsManager.getMonitorObject(plot.name)->getObject();
+      if (firstCanvases.count(plot.name) == 0) {
+        firstCanvases[plot.name] = canvas;
+      }
+      // the plot was appended to, not drawn again
+      BOOST_CHECK_EQUAL(canvas, firstCanvases[plot.name]);
+      checkPlotMatchesTree(objectsManager, *trend, plot);
+    }
+  }
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(test_incremental_plots)
+{
+  const std::string taskName = "TestTrendingTask";
+  TrendSourceDatabase repository;
+  ServiceRegistry services;
+  services.registerService<DatabaseInterface>(&repository);
+  auto objectsManager = std::make_shared<ObjectsManager>(taskName, "o2::quality_control::postprocessing::TrendingTask", "TST", "");
+
+  TrendingTask task;
+  task.setName(taskName);
+  task.setObjectsManager(objectsManager);
+
+  const auto config = makeIncrementalConfig(R"([
+    { "name": "mean_trend", "varexp": "testHistoTrending.mean:time", "option": "*L" },
+    { "name": "entries_histogram", "varexp": "testHistoTrending.entries" },
+    { "name": "selected_trend", "varexp": "testHistoTrending.entries:time", "selection": "testHistoTrending.entries > 2" }
+  ])");
+  runIncrementalUpdates(task, *objectsManager, services, config, 1, 12);
+
+  // The plot configuration changes, the plots are rebuilt for the new trend and appended to again.
+  const auto changedConfig = makeIncrementalConfig(R"([
+    { "name": "mean_trend", "varexp": "testHistoTrending.stddev:time", "selection": "testHistoTrending.entries > 1" },
+    { "name": "entries_histogram", "varexp": "testHistoTrending.mean" },
+    { "name": "errors_trend", "varexp": "testHistoTrending.mean:time", "graphErrors": "testHistoTrending.entries:testHistoTrending.stddev" }
+  ])");
+  runIncrementalUpdates(task, *objectsManager, services, changedConfig, 100, 12);
+  BOOST_CHECK_THROW(objectsManager->getMonitorObject("selected_trend"), ObjectNotFoundError);
+
+  // The final plots are drawn from the complete trend with TTree::Draw.
+  task.finalize({ TriggerType::UserOrControl, false, { 0, 0, "", "", "qc" }, 112 * 1000 }, services);
+  for (const auto& plot : TrendingTaskConfig(taskName, changedConfig).plots) {
+    auto* canvas = dynamic_cast<TCanvas*>(objectsManager->getMonitorObject(plot.name)->getObject());
+    BOOST_REQUIRE(canvas != nullptr);
+    BOOST_CHECK(canvas->GetPrimitive("htemp") != nullptr);
+  }
+}
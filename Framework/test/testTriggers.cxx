@@ -24,6 +24,7 @@
 #include "QualityControl/DatabaseFactory.h"
 #include "QualityControl/CcdbDatabase.h"
 #include "QualityControl/RepoPathUtils.h"
+#include "QualityControl/ObjectWatcher.h"
 
 #include <boost/test/unit_test.hpp>
 #include <TH1F.h>
@@ -109,6 +110,9 @@ BOOST_AUTO_TEST_CASE(test_trigger_new_object)
   repository->connect(CCDB_ENDPOINT, "", "", "");
   auto currentTimestamp = CcdbDatabase::getCurrentTimestamp();
   repository->storeMO(mo, currentTimestamp);
+  // the objects are checked in the background, we do not wait for it
+  auto watcher = ObjectWatcher::getInstance(CCDB_ENDPOINT, std::chrono::seconds(10));
+  watcher->refresh();
 
   // Check after sending
   BOOST_CHECK_EQUAL(newObjectTrigger(), Trigger(TriggerType::NewObject, currentTimestamp));
@@ -118,6 +122,7 @@ BOOST_AUTO_TEST_CASE(test_trigger_new_object)
   // Update the object
   obj->Fill(10);
   repository->storeMO(mo, currentTimestamp);
+  watcher->refresh();
 
   // Check after the update
   BOOST_CHECK_EQUAL(newObjectTrigger(), Trigger(TriggerType::NewObject, currentTimestamp));
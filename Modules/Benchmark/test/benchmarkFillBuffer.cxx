@@ -0,0 +1,118 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   benchmarkFillBuffer.cxx
+///
+/// Compares filling histograms entry by entry with Fill() and in bulk with a FillBuffer.
+///
+/// Usage: benchmarkQcFillBuffer [number of entries] [repetitions]
+///
+
+#include "QualityControl/FillBuffer.h"
+
+#include <TH1F.h>
+#include <TH2F.h>
+#include <TRandom3.h>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace o2::quality_control::core;
+
+namespace
+{
+
+template <typename Fill>
+double measure(int repetitions, Fill fill)
+{
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < repetitions; i++) {
+    fill();
+  }
+  std::chrono::duration<double, std::milli> duration = std::chrono::steady_clock::now() - start;
+  return duration.count() / repetitions;
+}
+
+bool same(const TH1& a, const TH1& b)
+{
+  for (int bin = 0; bin < a.GetNcells(); bin++) {
+    if (std::abs(a.GetBinContent(bin) - b.GetBinContent(bin)) > 1e-3 * std::abs(a.GetBinContent(bin))) {
+      return false;
+    }
+  }
+  return a.GetEntries() == b.GetEntries() && std::abs(a.GetMean() - b.GetMean()) < 1e-6 * (1 + std::abs(a.GetMean()));
+}
+
+void print(const std::string& name, size_t entries, double time)
+{
+  std::cout << "  " << std::left << std::setw(22) << name << ": " << time << " ms, " << entries / time / 1e3 << " M entries/s" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+  size_t nEntries = argc > 1 ? std::stoul(argv[1]) : 1000000;
+  int repetitions = argc > 2 ? std::stoi(argv[2]) : 10;
+
+  std::vector<double> x(nEntries), y(nEntries);
+  TRandom3 random(42);
+  for (size_t i = 0; i < nEntries; i++) {
+    x[i] = random.Gaus(50, 20);
+    y[i] = random.Gaus(50, 20);
+  }
+
+  TH1F fill1D("fill1D", "fill1D", 100, 0, 100);
+  TH1F buffer1D("buffer1D", "buffer1D", 100, 0, 100);
+  TH2F fill2D("fill2D", "fill2D", 100, 0, 100, 100, 0, 100);
+  TH2F buffer2D("buffer2D", "buffer2D", 100, 0, 100, 100, 0, 100);
+  FillBuffer1D fillBuffer1D(&buffer1D);
+  FillBuffer2D fillBuffer2D(&buffer2D);
+
+  double fill1DTime = measure(repetitions, [&]() {
+    for (size_t i = 0; i < nEntries; i++) {
+      fill1D.Fill(x[i]);
+    }
+  });
+  double buffer1DTime = measure(repetitions, [&]() {
+    for (size_t i = 0; i < nEntries; i++) {
+      fillBuffer1D.fill(x[i]);
+    }
+    fillBuffer1D.flush();
+  });
+  double fill2DTime = measure(repetitions, [&]() {
+    for (size_t i = 0; i < nEntries; i++) {
+      fill2D.Fill(x[i], y[i]);
+    }
+  });
+  double buffer2DTime = measure(repetitions, [&]() {
+    for (size_t i = 0; i < nEntries; i++) {
+      fillBuffer2D.fill(x[i], y[i]);
+    }
+    fillBuffer2D.flush();
+  });
+
+  std::cout << "Filling " << nEntries << " entries" << std::endl;
+  std::cout << std::fixed << std::setprecision(3);
+  print("TH1F::Fill", nEntries, fill1DTime);
+  print("FillBuffer1D", nEntries, buffer1DTime);
+  print("TH2F::Fill", nEntries, fill2DTime);
+  print("FillBuffer2D", nEntries, buffer2DTime);
+  if (!same(fill1D, buffer1D) || !same(fill2D, buffer2D)) {
+    std::cerr << "The histograms differ" << std::endl;
+    return 1;
+  }
+  return 0;
+}
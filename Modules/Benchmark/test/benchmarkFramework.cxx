@@ -0,0 +1,372 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   benchmarkFramework.cxx
+///
+/// Measures the hot paths of the framework on one machine, without DPL, databases or network, to track regressions.
+/// The inputs are generated with fixed seeds, so that the results of two versions can be compared.
+/// The results are printed and optionally written in a JSON file.
+///
+/// Usage: benchmarkQcFramework [repetitions] [JSON output file] [name filter]
+///
+
+#include "QualityControl/Activity.h"
+#include "QualityControl/HistogramTransport.h"
+#include "QualityControl/MonitorObject.h"
+#include "QualityControl/MonitorObjectCollection.h"
+#include "QualityControl/ObjectsManager.h"
+#include "QualityControl/UpdatePolicyManager.h"
+#include "Common/TH1Reductor.h"
+#include "Common/TH2Reductor.h"
+
+#include <TBufferFile.h>
+#include <TH1F.h>
+#include <TH2F.h>
+#include <TRandom3.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace o2::quality_control::core;
+using namespace o2::quality_control::checker;
+
+namespace
+{
+
+constexpr size_t NHistograms1D = 100;
+constexpr size_t NHistograms2D = 10;
+
+struct Result {
+  std::string name;
+  size_t operations;             // per repetition
+  std::vector<double> durations; // in ns, one per repetition
+
+  double perOperation(double duration) const { return duration / operations; }
+  double min() const { return perOperation(*std::min_element(durations.begin(), durations.end())); }
+  double mean() const { return perOperation(std::accumulate(durations.begin(), durations.end(), 0.0) / durations.size()); }
+  double median() const
+  {
+    auto sorted = durations;
+    std::sort(sorted.begin(), sorted.end());
+    auto middle = sorted.size() / 2;
+    return perOperation(sorted.size() % 2 ? sorted[middle] : (sorted[middle - 1] + sorted[middle]) / 2);
+  }
+  double stddev() const
+  {
+    auto average = mean();
+    double sum = 0;
+    for (auto duration : durations) {
+      sum += std::pow(perOperation(duration) - average, 2);
+    }
+    return std::sqrt(sum / durations.size());
+  }
+};
+
+/// Runs the benchmarks matching the filter and keeps their results.
+class Suite
+{
+ public:
+  Suite(int repetitions, std::string filter) : mRepetitions(repetitions), mFilter(std::move(filter)) {}
+
+  /// \brief Measures body(), which does the given number of operations. prepare() is called before each repetition, untimed.
+  void run(const std::string& name, size_t operations, const std::function<void()>& body, const std::function<void()>& prepare = [] {})
+  {
+    if (name.find(mFilter) == std::string::npos) {
+      return;
+    }
+    Result result{ name, operations, {} };
+    prepare();
+    body(); // warm-up
+    for (int i = 0; i < mRepetitions; i++) {
+      prepare();
+      auto start = std::chrono::steady_clock::now();
+      body();
+      std::chrono::duration<double, std::nano> duration = std::chrono::steady_clock::now() - start;
+      result.durations.push_back(duration.count());
+    }
+    std::cout << "  " << std::left << std::setw(44) << name << std::right
+              << std::setw(12) << result.median() << " ns/op (mean " << result.mean() << ", min " << result.min() << ")" << std::endl;
+    mResults.push_back(std::move(result));
+  }
+
+  void writeJson(const std::string& path) const
+  {
+    std::ofstream file(path);
+    file << std::setprecision(6) << "{\n  \"repetitions\": " << mRepetitions << ",\n  \"benchmarks\": [";
+    for (size_t i = 0; i < mResults.size(); i++) {
+      const auto& result = mResults[i];
+      file << (i == 0 ? "\n" : ",\n")
+           << "    { \"name\": \"" << result.name << "\", \"operations\": " << result.operations
+           << ", \"median_ns\": " << result.median() << ", \"mean_ns\": " << result.mean()
+           << ", \"min_ns\": " << result.min() << ", \"stddev_ns\": " << result.stddev() << " }";
+    }
+    file << "\n  ]\n}\n";
+    if (!file) {
+      throw std::runtime_error("Could not write the results in " + path);
+    }
+  }
+
+ private:
+  const int mRepetitions;
+  const std::string mFilter;
+  std::vector<Result> mResults;
+};
+
+/// Histograms similar to the ones of a typical task, with reproducible contents.
+std::vector<std::unique_ptr<TH1>> makeHistograms(const std::string& prefix, int seed)
+{
+  TRandom3 random(seed);
+  std::vector<std::unique_ptr<TH1>> histograms;
+  for (size_t i = 0; i < NHistograms1D; i++) {
+    auto histogram = std::make_unique<TH1F>((prefix + "_1D_" + std::to_string(i)).c_str(), "1D", 1000, 0, 100);
+    for (int entry = 0; entry < 10000; entry++) {
+      histogram->Fill(random.Gaus(50, 10));
+    }
+    histograms.push_back(std::move(histogram));
+  }
+  for (size_t i = 0; i < NHistograms2D; i++) {
+    auto histogram = std::make_unique<TH2F>((prefix + "_2D_" + std::to_string(i)).c_str(), "2D", 200, 0, 100, 200, 0, 100);
+    for (int entry = 0; entry < 100000; entry++) {
+      histogram->Fill(random.Gaus(50, 10), random.Gaus(50, 10));
+    }
+    histograms.push_back(std::move(histogram));
+  }
+  return histograms;
+}
+
+std::unique_ptr<MonitorObjectCollection> makeCollection(const std::vector<std::unique_ptr<TH1>>& histograms)
+{
+  auto collection = std::make_unique<MonitorObjectCollection>();
+  collection->SetOwner(true);
+  for (const auto& histogram : histograms) {
+    auto mo = new MonitorObject(histogram->Clone(), "task", "class", "TST");
+    mo->setIsOwner(true);
+    collection->Add(mo);
+  }
+  return collection;
+}
+
+/// Deletes a collection received by a consumer with its objects, as the CheckRunner does.
+void release(std::unique_ptr<TObject> received)
+{
+  auto collection = dynamic_cast<MonitorObjectCollection*>(received.get());
+  if (collection == nullptr) {
+    throw std::runtime_error("The received object is not a MonitorObjectCollection");
+  }
+  for (auto object : *collection) {
+    dynamic_cast<MonitorObject*>(object)->setIsOwner(true);
+  }
+  collection->SetOwner(true);
+}
+
+void benchmarkMerge(Suite& suite)
+{
+  auto histograms = makeHistograms("merge", 1);
+  auto target = makeCollection(histograms);
+  auto other = makeCollection(makeHistograms("merge", 2));
+  suite.run("MonitorObjectCollection::merge", histograms.size(), [&]() { target->merge(other.get()); });
+}
+
+void benchmarkObjectsManager(Suite& suite)
+{
+  std::vector<std::unique_ptr<TH1F>> histograms;
+  std::vector<std::string> names;
+  for (size_t i = 0; i < 1000; i++) {
+    names.push_back("histogram_" + std::to_string(i));
+    histograms.push_back(std::make_unique<TH1F>(names.back().c_str(), "histogram", 10, 0, 10));
+  }
+
+  std::unique_ptr<ObjectsManager> manager;
+  suite.run(
+    "ObjectsManager::startPublishing", histograms.size(),
+    [&]() {
+      for (const auto& histogram : histograms) {
+        manager->startPublishing(histogram.get());
+      }
+    },
+    [&]() { manager = std::make_unique<ObjectsManager>("task", "class", "TST", "", 0, true); });
+
+  std::shuffle(names.begin(), names.end(), std::mt19937(42));
+  suite.run("ObjectsManager::getMonitorObject", names.size(), [&]() {
+    for (const auto& name : names) {
+      if (manager->getMonitorObject(name) == nullptr) {
+        throw std::runtime_error("Object " + name + " not found");
+      }
+    }
+  });
+}
+
+void benchmarkPublication(Suite& suite)
+{
+  auto histograms = makeHistograms("publish", 3);
+  ObjectsManager manager("task", "class", "TST", "", 0, true);
+  for (const auto& histogram : histograms) {
+    manager.startPublishing(histogram.get());
+  }
+  std::unique_ptr<MonitorObjectCollection> array(manager.getNonOwningArray());
+
+  // streamed with ROOT, as DataAllocator::snapshot() does
+  TBufferFile streamed(TBuffer::kWrite);
+  suite.run("TaskRunner::publish streamed", array->GetEntries(), [&]() {
+    streamed.Reset();
+    streamed.WriteObjectAny(array.get(), array->IsA());
+  });
+
+  std::vector<char> copied;
+  auto allocate = [&copied](size_t size) {
+    copied.resize(size);
+    return copied.data();
+  };
+  suite.run("TaskRunner::publish copied bins", array->GetEntries(), [&]() { histogram_transport::encode(*array, allocate); });
+  std::vector<char> compressed;
+  suite.run("TaskRunner::publish copied bins zstd", array->GetEntries(), [&]() {
+    histogram_transport::encode(
+      *array, [&compressed](size_t size) {
+        compressed.resize(size);
+        return compressed.data();
+      },
+      { histogram_transport::Compression::Algorithm::ZSTD, 1 });
+  });
+
+  // received by the CheckRunner in prepareCacheData()
+  suite.run("CheckRunner::prepareCacheData streamed", array->GetEntries(), [&]() {
+    TBufferFile buffer(TBuffer::kRead, streamed.Length(), streamed.Buffer(), false);
+    release(std::unique_ptr<TObject>(static_cast<MonitorObjectCollection*>(buffer.ReadObjectAny(MonitorObjectCollection::Class()))));
+  });
+  suite.run("CheckRunner::prepareCacheData copied bins", array->GetEntries(), [&]() {
+    release(histogram_transport::decode(copied.data(), copied.size()));
+  });
+  suite.run("CheckRunner::prepareCacheData copied bins zstd", array->GetEntries(), [&]() {
+    release(histogram_transport::decode(compressed.data(), compressed.size()));
+  });
+}
+
+void benchmarkUpdatePolicyManager(Suite& suite)
+{
+  // 100 checks with 10 inputs each, among 1000 objects, and 50 objects received per cycle
+  constexpr size_t nObjects = 1000;
+  constexpr size_t nActors = 100;
+  std::mt19937 generator(42);
+  std::uniform_int_distribution<size_t> object(0, nObjects - 1);
+  std::vector<UpdatePolicyType> policies = { UpdatePolicyType::OnAny, UpdatePolicyType::OnAnyNonZero, UpdatePolicyType::OnAll, UpdatePolicyType::OnEachSeparately };
+  UpdatePolicyManager manager;
+  std::vector<std::string> actors;
+  for (size_t actor = 0; actor < nActors; actor++) {
+    std::vector<std::string> inputs;
+    for (int i = 0; i < 10; i++) {
+      inputs.push_back("object_" + std::to_string(object(generator)));
+    }
+    actors.push_back("check_" + std::to_string(actor));
+    manager.addPolicy(actors.back(), policies[actor % policies.size()], inputs, false, false);
+  }
+  std::vector<std::string> received;
+  for (int i = 0; i < 50; i++) {
+    received.push_back("object_" + std::to_string(object(generator)));
+  }
+
+  suite.run("UpdatePolicyManager::isReady", nActors, [&]() {
+    for (const auto& name : received) {
+      manager.updateObjectRevision(name);
+    }
+    for (const auto& actor : actors) {
+      if (manager.isReady(actor)) {
+        manager.updateActorRevision(actor);
+      }
+    }
+    manager.updateGlobalRevision();
+  });
+}
+
+void benchmarkReductors(Suite& suite)
+{
+  auto histograms = makeHistograms("reductor", 4);
+  o2::quality_control_modules::common::TH1Reductor reductor1D;
+  o2::quality_control_modules::common::TH2Reductor reductor2D;
+  suite.run("Reductor::update TH1", NHistograms1D, [&]() {
+    for (size_t i = 0; i < NHistograms1D; i++) {
+      reductor1D.update(histograms[i].get());
+    }
+  });
+  suite.run("Reductor::update TH2", NHistograms2D, [&]() {
+    for (size_t i = NHistograms1D; i < histograms.size(); i++) {
+      reductor2D.update(histograms[i].get());
+    }
+  });
+}
+
+void benchmarkActivity(Suite& suite)
+{
+  std::mt19937 generator(42);
+  std::uniform_int_distribution<int> run(500000, 500100);
+  std::uniform_int_distribution<int> index(0, 3);
+  const std::vector<std::string> periods = { "LHC23a", "LHC23b", "LHC23c", "" };
+  const std::vector<std::string> passes = { "apass1", "apass2", "cpass0", "" };
+  std::vector<Activity> activities;
+  for (int i = 0; i < 10000; i++) {
+    activities.emplace_back(run(generator), index(generator), periods[index(generator)], passes[index(generator)], "qc");
+  }
+  const Activity filter{ 0, 0, "LHC23a", "apass1", "qc" };
+
+  size_t matching = 0;
+  suite.run("Activity::matches", activities.size(), [&]() {
+    for (const auto& activity : activities) {
+      matching += filter.matches(activity);
+    }
+  });
+  suite.run("Activity::same", activities.size(), [&]() {
+    for (const auto& activity : activities) {
+      matching += activities.front().same(activity);
+    }
+  });
+  if (matching == 0) {
+    throw std::runtime_error("No activity matched, the inputs are wrong");
+  }
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+  int repetitions = argc > 1 ? std::stoi(argv[1]) : 20;
+  if (repetitions < 1) {
+    std::cerr << "The number of repetitions should be at least 1, got " << repetitions << std::endl;
+    return 1;
+  }
+  std::string jsonPath = argc > 2 ? argv[2] : "";
+  std::string filter = argc > 3 ? argv[3] : "";
+
+  TH1::AddDirectory(false);
+  Suite suite(repetitions, filter);
+  std::cout << std::fixed << std::setprecision(1) << "Median time per operation over " << repetitions << " repetitions" << std::endl;
+  benchmarkMerge(suite);
+  benchmarkObjectsManager(suite);
+  benchmarkPublication(suite);
+  benchmarkUpdatePolicyManager(suite);
+  benchmarkReductors(suite);
+  benchmarkActivity(suite);
+
+  if (!jsonPath.empty()) {
+    suite.writeJson(jsonPath);
+    std::cout << "Results written in " << jsonPath << std::endl;
+  }
+  return 0;
+}
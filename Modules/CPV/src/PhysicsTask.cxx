@@ -62,7 +62,10 @@ void PhysicsTask::initialize(o2::framework::InitContext& /*ctx*/)
   }
   initHistograms();
   mNEventsTotal = 0;
-  loadCcdb(); // initialize ccdb.
+  // the conditions which are not given by the DPL fetcher are retrieved in the background
+  prefetchCondition<o2::cpv::CalibParams>("CPV/Calib/Gains");
+  prefetchCondition<o2::cpv::BadChannelMap>("CPV/Calib/BadChannelMap");
+  prefetchCondition<o2::cpv::Pedestals>("CPV/Calib/Pedestals");
 }
 
 void PhysicsTask::startOfActivity(Activity& activity)
@@ -232,8 +235,7 @@ void PhysicsTask::monitorData(o2::framework::ProcessingContext& ctx)
     }
   }
 
-  // 3. Access CCDB. If it is enough to retrieve it once, do it in initialize().
-  // Remember to delete the object when the pointer goes out of scope or it is no longer needed.
+  // 3. Access CCDB. The conditions are prefetched in initialize() and refreshed in the background when their validity ends.
 
   // !!!todo
   // we need somehow to extract timestamp from data when there are no ccdb dpl fetcher inputs available
@@ -253,15 +255,13 @@ void PhysicsTask::monitorData(o2::framework::ProcessingContext& ctx)
 
   if (checkCcdbEntries) {
     // retrieve gains
-    const o2::cpv::CalibParams* gains = nullptr;
+    std::shared_ptr<const o2::cpv::CalibParams> gains;
     if (hasGains) {
       LOG(info) << "Retrieving CPV/Calib/Gains from DPL fetcher (i.e. internal-dpl-ccdb-backend)";
-      std::decay_t<decltype(ctx.inputs().get<o2::cpv::CalibParams*>("gains"))> gainsPtr{};
-      gainsPtr = ctx.inputs().get<o2::cpv::CalibParams*>("gains");
-      gains = gainsPtr.get();
+      gains = ctx.inputs().get<o2::cpv::CalibParams*>("gains");
     } else {
-      LOG(info) << "Retrieving CPV/Calib/Gains directly from CCDB";
-      gains = TaskInterface::retrieveConditionAny<o2::cpv::CalibParams>("CPV/Calib/Gains");
+      LOG(info) << "Retrieving CPV/Calib/Gains from the conditions shared by the tasks";
+      gains = getCondition<o2::cpv::CalibParams>("CPV/Calib/Gains");
     }
     if (gains) {
       LOG(info) << "Retrieved CPV/Calib/Gains";
@@ -274,23 +274,18 @@ void PhysicsTask::monitorData(o2::framework::ProcessingContext& ctx)
         }
         mIntensiveHist2D[H2DGainsM2 + iMod]->setCycleNumber(mCycleNumber);
       }
-      if (!hasGains) {
-        delete gains; // delete object only if is retrieved from CCDB directly. DPL fetcher owns
-      }
     } else {
       LOG(info) << "failed to retrieve CPV/Calib/Gains";
     }
 
     // retrieve bad channel map
-    const o2::cpv::BadChannelMap* bcm = nullptr;
+    std::shared_ptr<const o2::cpv::BadChannelMap> bcm;
     if (hasBadChannelMap) {
       LOG(info) << "Retrieving CPV/Calib/BadChannelMap from DPL fetcher (i.e. internal-dpl-ccdb-backend)";
-      std::decay_t<decltype(ctx.inputs().get<o2::cpv::BadChannelMap*>("badmap"))> bcmPtr{};
-      bcmPtr = ctx.inputs().get<o2::cpv::BadChannelMap*>("badmap");
-      bcm = bcmPtr.get();
+      bcm = ctx.inputs().get<o2::cpv::BadChannelMap*>("badmap");
     } else {
-      LOG(info) << "Retrieving CPV/Calib/BadChannelMap directly from CCDB";
-      bcm = TaskInterface::retrieveConditionAny<o2::cpv::BadChannelMap>("CPV/Calib/BadChannelMap");
+      LOG(info) << "Retrieving CPV/Calib/BadChannelMap from the conditions shared by the tasks";
+      bcm = getCondition<o2::cpv::BadChannelMap>("CPV/Calib/BadChannelMap");
     }
     if (bcm) {
       LOG(info) << "Retrieved CPV/Calib/BadChannelMap";
@@ -303,23 +298,18 @@ void PhysicsTask::monitorData(o2::framework::ProcessingContext& ctx)
         }
         mIntensiveHist2D[H2DBadChannelMapM2 + iMod]->setCycleNumber(mCycleNumber);
       }
-      if (!hasBadChannelMap) {
-        delete bcm; // delete object only if is retrieved from CCDB directly. DPL fetcher owns
-      }
     } else {
       LOG(info) << "failed to retrieve CPV/Calib/BadChannelMap";
     }
 
     // retrieve pedestals
-    const o2::cpv::Pedestals* peds = nullptr;
+    std::shared_ptr<const o2::cpv::Pedestals> peds;
     if (hasPedestals) {
       LOG(info) << "Retrieving CPV/Calib/Pedestals from DPL fetcher (i.e. internal-dpl-ccdb-backend)";
-      std::decay_t<decltype(ctx.inputs().get<o2::cpv::Pedestals*>("peds"))> pedsPtr{};
-      pedsPtr = ctx.inputs().get<o2::cpv::Pedestals*>("peds");
-      peds = pedsPtr.get();
+      peds = ctx.inputs().get<o2::cpv::Pedestals*>("peds");
     } else {
-      LOG(info) << "Retrieving CPV/Calib/Pedestals directly from CCDB";
-      peds = TaskInterface::retrieveConditionAny<o2::cpv::Pedestals>("CPV/Calib/Pedestals");
+      LOG(info) << "Retrieving CPV/Calib/Pedestals from the conditions shared by the tasks";
+      peds = getCondition<o2::cpv::Pedestals>("CPV/Calib/Pedestals");
     }
     if (peds) {
       LOG(info) << "Retrieved CPV/Calib/Pedestals";
@@ -334,9 +324,6 @@ void PhysicsTask::monitorData(o2::framework::ProcessingContext& ctx)
         mIntensiveHist2D[H2DPedestalValueM2 + iMod]->setCycleNumber(mCycleNumber);
         mIntensiveHist2D[H2DPedestalSigmaM2 + iMod]->setCycleNumber(mCycleNumber);
       }
-      if (!hasPedestals) {
-        delete peds; // delete object only if is retrieved from CCDB directly. DPL fetcher owns
-      }
     } else {
       LOG(info) << "failed to retrieve CPV/Calib/Pedestals";
     }
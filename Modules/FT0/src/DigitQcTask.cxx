@@ -248,7 +248,11 @@ void DigitQcTask::initialize(o2::framework::InitContext& /*ctx*/)
   getObjectsManager()->startPublishing(mHistAverageTimeA.get());
   getObjectsManager()->startPublishing(mHistAverageTimeC.get());
   getObjectsManager()->startPublishing(mHistChannelID.get());
+  getObjectsManager()->startPublishing(mHistNumADC.get());
+  getObjectsManager()->startPublishing(mHistNumCFD.get());
   getObjectsManager()->startPublishing(mHistCFDEff.get());
+  // computed once before publication rather than for each digit
+  getObjectsManager()->setDerived(mHistCFDEff->GetName(), "ratio", { mHistNumADC->GetName(), mHistNumCFD->GetName() });
   getObjectsManager()->startPublishing(mHistTriggersCorrelation.get());
   getObjectsManager()->startPublishing(mHistTimeSum2Diff.get());
   getObjectsManager()->startPublishing(mHistCycleDuration.get());
@@ -408,8 +412,6 @@ void DigitQcTask::monitorData(o2::framework::ProcessingContext& ctx)
         }
       }
     }
-    mHistCFDEff->Reset();
-    mHistCFDEff->Divide(mHistNumADC.get(), mHistNumCFD.get());
   }
   mTimeSum += curTfTimeMax - curTfTimeMin;
 }
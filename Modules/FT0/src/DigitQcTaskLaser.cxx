@@ -249,7 +249,11 @@ void DigitQcTaskLaser::initialize(o2::framework::InitContext& /*ctx*/)
   getObjectsManager()->startPublishing(mHistAverageTimeA.get());
   getObjectsManager()->startPublishing(mHistAverageTimeC.get());
   getObjectsManager()->startPublishing(mHistChannelID.get());
+  getObjectsManager()->startPublishing(mHistNumADC.get());
+  getObjectsManager()->startPublishing(mHistNumCFD.get());
   getObjectsManager()->startPublishing(mHistCFDEff.get());
+  // computed once before publication rather than for each digit
+  getObjectsManager()->setDerived(mHistCFDEff->GetName(), "ratio", { mHistNumADC->GetName(), mHistNumCFD->GetName() });
   getObjectsManager()->startPublishing(mHistTriggersCorrelation.get());
   getObjectsManager()->startPublishing(mHistTimeSum2Diff.get());
   getObjectsManager()->startPublishing(mHistCycleDuration.get());
@@ -409,8 +413,6 @@ void DigitQcTaskLaser::monitorData(o2::framework::ProcessingContext& ctx)
         }
       }
     }
-    mHistCFDEff->Reset();
-    mHistCFDEff->Divide(mHistNumADC.get(), mHistNumCFD.get());
   }
   mTimeSum += curTfTimeMax - curTfTimeMin;
 }
@@ -0,0 +1,193 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   ChipHitCounter.h
+///
+
+#ifndef QC_MODULE_ITS_CHIPHITCOUNTER_H
+#define QC_MODULE_ITS_CHIPHITCOUNTER_H
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace o2::quality_control_modules::its
+{
+
+/// \brief Counts the hits of each pixel of one ALPIDE chip, without hashing.
+///
+/// The chip is divided into regions of 32x32 pixels, which are created at their first hit and looked up in a table.
+/// A region keeps its first few fired pixels in a short list of (pixel, counter) pairs, which is enough for the noise
+/// scattered over a chip. Once the list is full, the region switches to a dense array of counters with a bitmap of
+/// the fired pixels, which is what a cluster of hits or a hot region needs. Only the fired pixels are visited when
+/// iterating. Resetting clears the touched regions and keeps the allocated memory for the next cycle.
+/// An object must be filled by one thread at a time, different chips can be filled in parallel.
+class ChipHitCounter
+{
+ public:
+  static constexpr int NCols = 1024;
+  static constexpr int NRows = 512;
+  static constexpr int RegionSide = 32;
+  static constexpr int RegionSize = RegionSide * RegionSide;
+  static constexpr int NRegions = (NCols / RegionSide) * (NRows / RegionSide);
+  static constexpr int SparseCapacity = 8;
+
+  /// Adds hits to the pixel, the coordinates are expected to be within the chip.
+  void add(int col, int row, uint32_t hits = 1)
+  {
+    int regionIndex = (col / RegionSide) * (NRows / RegionSide) + row / RegionSide;
+    auto pixel = static_cast<uint16_t>((col % RegionSide) * RegionSide + row % RegionSide);
+    auto& entry = mRegionTable[regionIndex];
+    if (entry == 0) {
+      mRegions.emplace_back();
+      entry = static_cast<uint16_t>(mRegions.size());
+      mTouchedRegions[regionIndex / 64] |= uint64_t(1) << (regionIndex % 64);
+    }
+    auto& region = mRegions[entry - 1];
+    if (region.dense != nullptr) {
+      region.dense->counts[pixel] += hits;
+      region.dense->fired[pixel / 64] |= uint64_t(1) << (pixel % 64);
+      return;
+    }
+    for (int i = 0; i < region.size; i++) {
+      if (region.pixels[i] == pixel) {
+        region.counts[i] += hits;
+        return;
+      }
+    }
+    if (region.size < SparseCapacity) {
+      region.pixels[region.size] = pixel;
+      region.counts[region.size] = hits;
+      region.size++;
+      return;
+    }
+    makeDense(region);
+    region.dense->counts[pixel] += hits;
+    region.dense->fired[pixel / 64] |= uint64_t(1) << (pixel % 64);
+  }
+
+  uint32_t get(int col, int row) const
+  {
+    auto entry = mRegionTable[(col / RegionSide) * (NRows / RegionSide) + row / RegionSide];
+    if (entry == 0) {
+      return 0;
+    }
+    const auto& region = mRegions[entry - 1];
+    auto pixel = static_cast<uint16_t>((col % RegionSide) * RegionSide + row % RegionSide);
+    if (region.dense != nullptr) {
+      return region.dense->counts[pixel];
+    }
+    for (int i = 0; i < region.size; i++) {
+      if (region.pixels[i] == pixel) {
+        return region.counts[i];
+      }
+    }
+    return 0;
+  }
+
+  /// Calls f(col, row, hits) for each pixel which was hit since the last reset, in no particular order.
+  template <typename F>
+  void forEachFired(F&& f) const
+  {
+    for (int w = 0; w < NRegions / 64; w++) {
+      for (uint64_t word = mTouchedRegions[w]; word != 0; word &= word - 1) {
+        int regionIndex = w * 64 + __builtin_ctzll(word);
+        int colOffset = (regionIndex / (NRows / RegionSide)) * RegionSide;
+        int rowOffset = (regionIndex % (NRows / RegionSide)) * RegionSide;
+        const auto& region = mRegions[mRegionTable[regionIndex] - 1];
+        if (region.dense == nullptr) {
+          for (int i = 0; i < region.size; i++) {
+            f(colOffset + region.pixels[i] / RegionSide, rowOffset + region.pixels[i] % RegionSide, region.counts[i]);
+          }
+          continue;
+        }
+        for (int d = 0; d < RegionSize / 64; d++) {
+          for (uint64_t fired = region.dense->fired[d]; fired != 0; fired &= fired - 1) {
+            int pixel = d * 64 + __builtin_ctzll(fired);
+            f(colOffset + pixel / RegionSide, rowOffset + pixel % RegionSide, region.dense->counts[pixel]);
+          }
+        }
+      }
+    }
+  }
+
+  /// \brief Clears the counters, keeping the allocated memory.
+  void reset()
+  {
+    for (int w = 0; w < NRegions / 64; w++) {
+      for (uint64_t word = mTouchedRegions[w]; word != 0; word &= word - 1) {
+        mRegionTable[w * 64 + __builtin_ctzll(word)] = 0;
+      }
+    }
+    mTouchedRegions.fill(0);
+    for (auto& region : mRegions) {
+      if (region.dense != nullptr) {
+        region.dense->counts.fill(0);
+        region.dense->fired.fill(0);
+        mSpareDense.push_back(std::move(region.dense));
+      }
+    }
+    mRegions.clear();
+  }
+
+  /// \brief Clears the counters and releases the memory.
+  void clear()
+  {
+    reset();
+    mRegions.shrink_to_fit();
+    mSpareDense.clear();
+    mSpareDense.shrink_to_fit();
+  }
+
+  bool empty() const
+  {
+    return mRegions.empty();
+  }
+
+ private:
+  struct DenseRegion {
+    std::array<uint32_t, RegionSize> counts{};
+    std::array<uint64_t, RegionSize / 64> fired{};
+  };
+
+  struct Region {
+    std::unique_ptr<DenseRegion> dense;
+    std::array<uint32_t, SparseCapacity> counts;
+    std::array<uint16_t, SparseCapacity> pixels;
+    uint8_t size = 0;
+  };
+
+  void makeDense(Region& region)
+  {
+    if (mSpareDense.empty()) {
+      region.dense = std::make_unique<DenseRegion>();
+    } else {
+      region.dense = std::move(mSpareDense.back());
+      mSpareDense.pop_back();
+    }
+    for (int i = 0; i < region.size; i++) {
+      region.dense->counts[region.pixels[i]] = region.counts[i];
+      region.dense->fired[region.pixels[i] / 64] |= uint64_t(1) << (region.pixels[i] % 64);
+    }
+    region.size = 0;
+  }
+
+  std::array<uint16_t, NRegions> mRegionTable{};         // index + 1 of the region in mRegions, 0 if not hit
+  std::array<uint64_t, NRegions / 64> mTouchedRegions{}; // bitmap of the non-zero entries of mRegionTable
+  std::vector<Region> mRegions;
+  std::vector<std::unique_ptr<DenseRegion>> mSpareDense; // dense regions released by reset(), to be reused
+};
+
+} // namespace o2::quality_control_modules::its
+
+#endif // QC_MODULE_ITS_CHIPHITCOUNTER_H
@@ -18,6 +18,7 @@
 #define QC_MODULE_ITS_ITSNOISYPIXELTASK_H
 
 #include "QualityControl/TaskInterface.h"
+#include "ITS/NoisyPixelTracker.h"
 #include <TH1.h>
 #include <TH2.h>
 #include <THnSparse.h>
@@ -29,7 +30,6 @@
 #include <map>
 #include <string>
 #include <unordered_set>
-#include <unordered_map>
 
 class TH1D;
 class TH2D;
@@ -62,17 +62,19 @@ class ITSNoisyPixelTask : public TaskInterface
   void createAllHistos();
   void NormalizeOccupancyPlots(int n_cycle);
   std::vector<int> MapOverHIC(int col, int row, int chip);
+  void fillOrderedHits(TH1D* histogram, const NoisyPixelTracker& tracker);
+  int getLayerGroup(int layer);
 
   static constexpr int NLayer = 7;
   static constexpr int NLayerIB = 3;
 
   int mROFcounter = 0;
   int mROFcycle = 0;
-  std::unordered_map<uint64_t, int> hashtable;
+  NoisyPixelTracker mNoisyPixels[3]; //! IB, ML, OL
 
   std::vector<TObject*> mPublishedObjects;
 
-  int nmostnoisy = 25; // number of bins for the following three histograms. It can be configured from config file.
+  int nmostnoisy = 25; // default number of bins for the following three histograms. It can be configured from config file, also per layer group.
   TH1D* hOrderedHitsAddressIB;
   TH1D* hOrderedHitsAddressML;
   TH1D* hOrderedHitsAddressOL;
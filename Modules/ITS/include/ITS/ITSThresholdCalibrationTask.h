@@ -18,10 +18,12 @@
 #define QC_MODULE_ITS_ITSTHRESHOLDCALIBRATIONTASK_H
 
 #include "QualityControl/TaskInterface.h"
+#include "ITS/ThresholdCalibrationResult.h"
 #include <TH1D.h>
 #include <TH2D.h>
 #include <ITSBase/GeometryTGeo.h>
 #include <TTree.h>
+#include <gsl/span>
 
 class TH1D;
 class TH2D;
@@ -38,23 +40,6 @@ class ITSThresholdCalibrationTask : public TaskInterface
   ITSThresholdCalibrationTask();
   ~ITSThresholdCalibrationTask() override;
 
-  struct CalibrationResStruct {
-    int Layer;
-    int Stave;
-    int Hs;
-    int HIC;
-    int ChipID;
-    float VCASN;
-    float RMS;
-    float ITHR;
-    float THR;
-    float Noise;
-    float NoiseRMS;
-    int status;
-    bool isDeadPixel = false;
-    bool isDeadColumn = false;
-  };
-
   void initialize(o2::framework::InitContext& ctx) override;
   void startOfActivity(Activity& activity) override;
   void startOfCycle() override;
@@ -62,7 +47,6 @@ class ITSThresholdCalibrationTask : public TaskInterface
   void endOfCycle() override;
   void endOfActivity(Activity& activity) override;
   void reset() override;
-  std::vector<std::string> splitString(std::string, std::string);
 
  private:
   void publishHistos();
@@ -73,7 +57,8 @@ class ITSThresholdCalibrationTask : public TaskInterface
   Int_t getBarrel(Int_t iLayer);
   int getCurrentChip(int barrel, int chipid, int hic, int hs);
 
-  CalibrationResStruct CalibrationParser(string input);
+  void fillResults(gsl::span<const ChipCalibrationResult> results, char scanType, int iScan);
+  void fillChipsDone(gsl::span<const ChipCalibrationResult> results);
 
   std::vector<TObject*> mPublishedObjects;
 
@@ -0,0 +1,85 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   NoisyPixelTracker.h
+///
+
+#ifndef QC_MODULE_ITS_NOISYPIXELTRACKER_H
+#define QC_MODULE_ITS_NOISYPIXELTRACKER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace o2::quality_control_modules::its
+{
+
+/// \brief Keeps track of the pixels with the most hits, as the hits are counted.
+///
+/// The hits are counted for at most maxPixels pixels, which bounds the memory. As long as fewer pixels are hit, the
+/// counts are exact. Above that, the pixel with the fewest hits makes room for the new one, which inherits its count
+/// (the "space saving" algorithm): the counts of the noisy pixels are then overestimated by at most getError().
+/// The counters are kept in a min-heap, and the nTop pixels with the most hits are updated at each hit, so that
+/// getting them does not depend on the number of pixels which were hit.
+class NoisyPixelTracker
+{
+ public:
+  struct Pixel {
+    uint64_t address;
+    uint32_t hits;
+    uint32_t error; // the hits counted for other pixels before this one took their place, 0 if the count is exact
+  };
+
+  NoisyPixelTracker(size_t nTop = 25, size_t maxPixels = 100000);
+
+  void add(uint64_t address);
+  /// \brief Returns the nTop pixels with the most hits, in decreasing order.
+  std::vector<Pixel> getTop() const;
+  void clear();
+
+  size_t getNTop() const { return mNTop; }
+  size_t getMaxPixels() const { return mMaxPixels; }
+  /// \brief Number of pixels for which the hits are counted.
+  size_t size() const { return mCounters.size(); }
+  /// \brief Tells if some pixels were dropped, i.e. if the counts are approximate.
+  bool isSaturated() const { return mSaturated; }
+
+ private:
+  struct Counter {
+    uint64_t address;
+    uint32_t hits;
+    uint32_t error;
+    uint32_t heapPosition;
+    int32_t topPosition; // position in mTop, -1 if not there
+  };
+
+  void siftUp(uint32_t position);
+  void siftDown(uint32_t position);
+  void swapInHeap(uint32_t a, uint32_t b);
+  void updateTop(uint32_t counter);
+  void removeFromTop(uint32_t counter);
+  void findTopMinimum();
+
+  size_t mNTop;
+  size_t mMaxPixels;
+  bool mSaturated = false;
+  std::unordered_map<uint64_t, uint32_t> mIndex; // address -> index in mCounters
+  std::vector<Counter> mCounters;                 // the indices are stable, a counter is reused when its pixel is dropped
+  std::vector<uint32_t> mHeap;                    // indices in mCounters, the pixel with the fewest hits first
+  std::vector<uint32_t> mTop;                     // indices in mCounters
+  size_t mTopMinimum = 0;                         // position in mTop of the pixel with the fewest hits
+};
+
+} // namespace o2::quality_control_modules::its
+
+#endif // QC_MODULE_ITS_NOISYPIXELTRACKER_H
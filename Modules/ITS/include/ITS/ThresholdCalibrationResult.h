@@ -0,0 +1,66 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   ThresholdCalibrationResult.h
+///
+
+#ifndef QC_MODULE_ITS_THRESHOLDCALIBRATIONRESULT_H
+#define QC_MODULE_ITS_THRESHOLDCALIBRATIONRESULT_H
+
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace o2::quality_control_modules::its
+{
+
+/// \brief Result of a threshold, VCASN, ITHR or digital/analogue scan for one chip.
+///
+/// The structure is sent as is, as an array with one entry per chip (e.g. a gsl::span on the sender side), thus it
+/// must stay trivially copyable and its layout must be the same on both sides.
+struct ChipCalibrationResult {
+  enum Flags : uint8_t {
+    DeadPixel = 1 << 0,
+    DeadColumn = 1 << 1
+  };
+
+  int16_t layer = 0;
+  int16_t stave = 0;
+  int16_t hs = 0; // half stave, only in OB
+  int16_t hic = 0;
+  int16_t chipID = 0;
+  int8_t status = 0; // 1 if the scan succeeded
+  uint8_t flags = 0;
+  float vcasn = 0;
+  float ithr = 0;
+  float thr = 0;
+  float rms = 0;
+  float noise = 0;
+  float noiseRMS = 0;
+
+  bool isDeadPixel() const { return flags & DeadPixel; }
+  bool isDeadColumn() const { return flags & DeadColumn; }
+};
+
+static_assert(std::is_trivially_copyable_v<ChipCalibrationResult>, "ChipCalibrationResult is sent as raw bytes");
+static_assert(sizeof(ChipCalibrationResult) == 36, "the layout of ChipCalibrationResult is shared with the sender");
+
+/// \brief Parses the results of one chip in the text format, e.g. "L3_05,Hs_pos:1,Hic_Pos:2,ChipID:4,THR:101.2,..."
+ChipCalibrationResult parseChipCalibrationResult(std::string_view input);
+
+/// \brief Parses the results of all the chips in the text format, where each chip is preceded by "Stave:".
+std::vector<ChipCalibrationResult> parseCalibrationResults(std::string_view input);
+
+} // namespace o2::quality_control_modules::its
+
+#endif // QC_MODULE_ITS_THRESHOLDCALIBRATIONRESULT_H
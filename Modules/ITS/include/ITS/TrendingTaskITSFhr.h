@@ -19,6 +19,7 @@
 
 #include "ITS/TrendingTaskConfigITS.h"
 #include "QualityControl/PostProcessingInterface.h"
+#include "QualityControl/ConcurrentRetriever.h"
 #include "QualityControl/Reductor.h"
 
 #include <TAxis.h>
@@ -88,6 +89,7 @@ class TrendingTaskITSFhr : public PostProcessingInterface
   std::vector<std::string> runlist;
   std::unique_ptr<TTree> mTrend;
   std::unordered_map<std::string, std::unique_ptr<Reductor>> mReductors;
+  std::unique_ptr<ConcurrentRetriever> mRetriever;
 
   const int col[7] = { 1, 2, 3, 4, 5, 6, 7 };
   const int mkr[8] = { 20, 21, 22, 29, 24, 25, 26, 30 };
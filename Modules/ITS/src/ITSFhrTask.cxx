@@ -127,7 +127,7 @@ void ITSFhrTask::initialize(o2::framework::InitContext& /*ctx*/)
 
   if (mLayer != -1) {
     // define the hitnumber, occupancy, errorcount array
-    mHitPixelID_InStave = new std::unordered_map<unsigned int, int>**[NStaves[mLayer]];
+    mHitPixelID_InStave = new ChipHitCounter**[NStaves[mLayer]];
     mHitnumberLane = new int*[NStaves[mLayer]];
     mOccupancyLane = new double*[NStaves[mLayer]];
     mChipPhi = new double*[NStaves[mLayer]];
@@ -180,9 +180,9 @@ void ITSFhrTask::initialize(o2::framework::InitContext& /*ctx*/)
         mChipPhi[istave] = new double[nChipsPerHic[mLayer]];
         mChipEta[istave] = new double[nChipsPerHic[mLayer]];
         mChipStat[istave] = new int[nChipsPerHic[mLayer]];
-        mHitPixelID_InStave[istave] = new std::unordered_map<unsigned int, int>*[nHicPerStave[mLayer]];
+        mHitPixelID_InStave[istave] = new ChipHitCounter*[nHicPerStave[mLayer]];
         for (int ihic = 0; ihic < nHicPerStave[mLayer]; ihic++) {
-          mHitPixelID_InStave[istave][ihic] = new std::unordered_map<unsigned int, int>[nChipsPerHic[mLayer]];
+          mHitPixelID_InStave[istave][ihic] = new ChipHitCounter[nChipsPerHic[mLayer]];
         }
         for (int ichip = 0; ichip < nChipsPerHic[mLayer]; ichip++) {
           mHitnumberLane[istave][ichip] = 0;
@@ -201,9 +201,9 @@ void ITSFhrTask::initialize(o2::framework::InitContext& /*ctx*/)
         mChipPhi[istave] = new double[nHicPerStave[mLayer] * nChipsPerHic[mLayer]];
         mChipEta[istave] = new double[nHicPerStave[mLayer] * nChipsPerHic[mLayer]];
         mChipStat[istave] = new int[nHicPerStave[mLayer] * nChipsPerHic[mLayer]];
-        mHitPixelID_InStave[istave] = new std::unordered_map<unsigned int, int>*[nHicPerStave[mLayer]];
+        mHitPixelID_InStave[istave] = new ChipHitCounter*[nHicPerStave[mLayer]];
         for (int ihic = 0; ihic < nHicPerStave[mLayer]; ihic++) {
-          mHitPixelID_InStave[istave][ihic] = new std::unordered_map<unsigned int, int>[nChipsPerHic[mLayer]];
+          mHitPixelID_InStave[istave][ihic] = new ChipHitCounter[nChipsPerHic[mLayer]];
         }
         for (int ichip = 0; ichip < nHicPerStave[mLayer] * nChipsPerHic[mLayer]; ichip++) {
           mChipPhi[istave][ichip] = 0;
@@ -634,20 +634,20 @@ void ITSFhrTask::monitorData(o2::framework::ProcessingContext& ctx)
   omp_set_num_threads(mNThreads);
 #pragma omp parallel for schedule(dynamic)
 #endif
-  // save digit hit vector to unordered_map by openMP multiple threads
+  // count the hits of each pixel by openMP multiple threads, each thread fills the chips of its own staves
   // the reason of this step is: it will spend many time If we THnSparse::Fill the THnspase hit by hit.
-  // So we want save hit information to undordered_map and fill THnSparse by THnSparse::SetBinContent (pixel by pixel)
+  // So we want count the hits per pixel first and fill THnSparse by THnSparse::SetBinContent (pixel by pixel)
   for (int i = 0; i < (int)activeStaves.size(); i++) {
     int istave = activeStaves[i];
     if (lay < NLayerIB) {
       for (auto& digit : digVec[istave][0]) {
-        mHitPixelID_InStave[istave][0][digit.getChipIndex() % 9][1000 * digit.getColumn() + digit.getRow()]++;
+        mHitPixelID_InStave[istave][0][digit.getChipIndex() % 9].add(digit.getColumn(), digit.getRow());
       }
     } else {
       for (int ihic = 0; ihic < nHicPerStave[lay]; ihic++) {
         for (auto& digit : digVec[istave][ihic]) {
           int chip = ((digit.getChipIndex() - ChipBoundary[lay]) % (14 * nHicPerStave[lay])) % 14;
-          mHitPixelID_InStave[istave][ihic][chip][1000 * digit.getColumn() + digit.getRow()]++;
+          mHitPixelID_InStave[istave][ihic][chip].add(digit.getColumn(), digit.getRow());
         }
       }
     }
@@ -694,20 +694,19 @@ void ITSFhrTask::monitorData(o2::framework::ProcessingContext& ctx)
         }
 
         for (int ichip = 0 + (ilink * 3); ichip < (ilink * 3) + 3; ichip++) {
-          std::unordered_map<unsigned int, int>::iterator iter;
-          for (iter = mHitPixelID_InStave[istave][0][ichip].begin(); iter != mHitPixelID_InStave[istave][0][ichip].end(); iter++) {
-            if ((iter->second > mHitCutForNoisyPixel) &&
-                (iter->second / (double)GBTLinkInfo->statistics.nTriggers) > mOccupancyCutForNoisyPixel &&
+          mHitPixelID_InStave[istave][0][ichip].forEachFired([&](int col, int row, uint32_t hits) {
+            if (((int)hits > mHitCutForNoisyPixel) &&
+                (hits / (double)GBTLinkInfo->statistics.nTriggers) > mOccupancyCutForNoisyPixel &&
                 ((double)GBTLinkInfo->statistics.nTriggers >= 1e6 && (double)GBTLinkInfo->statistics.nTriggers < 1e6 + 10000)) {
               mNoisyPixelNumber[lay][istave]++; // count only in 10000 events as soon as nTriggers is 1e6
             }
-            int pixelPos[2] = { (int)(iter->first / 1000) + (1024 * ichip) + 1, (int)(iter->first % 1000) + 1 };
+            int pixelPos[2] = { col + (1024 * ichip) + 1, row + 1 };
             if ((double)GBTLinkInfo->statistics.nTriggers <= mCutTrgForSparse) {
-              mStaveHitmap[lay][istave]->SetBinContent(pixelPos, (double)iter->second);
+              mStaveHitmap[lay][istave]->SetBinContent(pixelPos, (double)hits);
             }
-            totalhit += (int)iter->second;
-            occupancyPlotTmp[i]->Fill(log10((double)iter->second / GBTLinkInfo->statistics.nTriggers));
-          }
+            totalhit += (int)hits;
+            occupancyPlotTmp[i]->Fill(log10((double)hits / GBTLinkInfo->statistics.nTriggers));
+          });
           mOccupancyLane[istave][ichip] = mHitnumberLane[istave][ichip] / (GBTLinkInfo->statistics.nTriggers * 1024. * 512.);
         }
         for (int ierror = 0; ierror < o2::itsmft::GBTLinkDecodingStat::NErrorsDefined; ierror++) {
@@ -729,27 +728,26 @@ void ITSFhrTask::monitorData(o2::framework::ProcessingContext& ctx)
         for (int ihic = 0; ihic < ((nHicPerStave[lay] / NSubStave[lay])); ihic++) {
           for (int ichip = 0; ichip < nChipsPerHic[lay]; ichip++) {
             if (GBTLinkInfo->statistics.nTriggers > 0) {
-              std::unordered_map<unsigned int, int>::iterator iter;
-              for (iter = mHitPixelID_InStave[istave][ihic + ilink * ((nHicPerStave[lay] / NSubStave[lay]))][ichip].begin(); iter != mHitPixelID_InStave[istave][ihic + ilink * ((nHicPerStave[lay] / NSubStave[lay]))][ichip].end(); iter++) {
-                if ((iter->second > mHitCutForNoisyPixel) &&
-                    (iter->second / (double)GBTLinkInfo->statistics.nTriggers) > mOccupancyCutForNoisyPixel &&
+              mHitPixelID_InStave[istave][ihic + ilink * ((nHicPerStave[lay] / NSubStave[lay]))][ichip].forEachFired([&](int col, int row, uint32_t hits) {
+                if (((int)hits > mHitCutForNoisyPixel) &&
+                    (hits / (double)GBTLinkInfo->statistics.nTriggers) > mOccupancyCutForNoisyPixel &&
                     ((double)GBTLinkInfo->statistics.nTriggers >= 1e6 && (double)GBTLinkInfo->statistics.nTriggers < 1e6 + 10000)) {
                   mNoisyPixelNumber[lay][istave]++;
                 }
-                double pixelOccupancy = (double)iter->second;
+                double pixelOccupancy = (double)hits;
                 occupancyPlotTmp[i]->Fill(log10(pixelOccupancy / GBTLinkInfo->statistics.nTriggers));
                 if (ichip < 7) {
-                  int pixelPos[2] = { (ihic * ((nChipsPerHic[lay] / 2) * NCols)) + ichip * NCols + (int)(iter->first / 1000) + 1, NRows - ((int)iter->first % 1000) - 1 + (1024 * ilink) + 1 };
+                  int pixelPos[2] = { (ihic * ((nChipsPerHic[lay] / 2) * NCols)) + ichip * NCols + col + 1, NRows - row - 1 + (1024 * ilink) + 1 };
                   if ((double)GBTLinkInfo->statistics.nTriggers <= mCutTrgForSparse) {
                     mStaveHitmap[lay][istave]->SetBinContent(pixelPos, pixelOccupancy);
                   }
                 } else {
-                  int pixelPos[2] = { (ihic * ((nChipsPerHic[lay] / 2) * NCols)) + (nChipsPerHic[lay] / 2) * NCols - (ichip - 7) * NCols - ((int)iter->first / 1000), NRows + ((int)iter->first % 1000) + (1024 * ilink) + 1 };
+                  int pixelPos[2] = { (ihic * ((nChipsPerHic[lay] / 2) * NCols)) + (nChipsPerHic[lay] / 2) * NCols - (ichip - 7) * NCols - col, NRows + row + (1024 * ilink) + 1 };
                   if ((double)GBTLinkInfo->statistics.nTriggers <= mCutTrgForSparse) {
                     mStaveHitmap[lay][istave]->SetBinContent(pixelPos, pixelOccupancy);
                   }
                 }
-              }
+              });
             }
           }
           if (lay == 3 || lay == 4) {
@@ -933,7 +931,7 @@ void ITSFhrTask::reset()
       for (int ichip = 0; ichip < nChipsPerHic[mLayer]; ichip++) {
         mHitnumberLane[istave][ichip] = 0;
         mOccupancyLane[istave][ichip] = 0;
-        mHitPixelID_InStave[istave][0][ichip].clear();
+        mHitPixelID_InStave[istave][0][ichip].reset();
       }
     }
   } else {
@@ -949,7 +947,7 @@ void ITSFhrTask::reset()
         mOccupancyLane[istave][2 * ihic] = 0;
         mOccupancyLane[istave][2 * ihic + 1] = 0;
         for (int ichip = 0; ichip < nChipsPerHic[mLayer]; ichip++) {
-          mHitPixelID_InStave[istave][ihic][ichip].clear();
+          mHitPixelID_InStave[istave][ihic][ichip].reset();
         }
       }
     }
@@ -136,15 +136,15 @@ void ITSNoisyPixelTask::monitorData(o2::framework::ProcessingContext& ctx)
         col = hit.getCol();
         row = hit.getRow();
 
-        if (mEnableOrderedHitsObject) {
+        mGeom->getChipId(ChipID, lay, sta, hsta, mod, chip);
+
+        if (mEnableOrderedHitsObject && mEnableLayers[lay]) {
 
           label = 1024 * 512;
           label = label * ChipID + 1024 * row + col;
-          hashtable[label]++;
+          mNoisyPixels[getLayerGroup(lay)].add(label);
         }
 
-        mGeom->getChipId(ChipID, lay, sta, hsta, mod, chip);
-
         if (lay < 3) {
 
           Double_t Addr[3] = { (double)col, (double)row, (double)chip };
@@ -179,15 +179,15 @@ void ITSNoisyPixelTask::monitorData(o2::framework::ProcessingContext& ctx)
       col = hit.getColumn();
       row = hit.getRow();
 
-      if (mEnableOrderedHitsObject) {
+      mGeom->getChipId(ChipID, lay, sta, hsta, mod, chip);
+
+      if (mEnableOrderedHitsObject && mEnableLayers[lay]) {
 
         label = 1024 * 512;
         label = label * ChipID + 1024 * row + col;
-        hashtable[label]++;
+        mNoisyPixels[getLayerGroup(lay)].add(label);
       }
 
-      mGeom->getChipId(ChipID, lay, sta, hsta, mod, chip);
-
       if (lay < 3) {
 
         Double_t Addr[3] = { (double)col, (double)row, (double)chip };
@@ -217,85 +217,13 @@ void ITSNoisyPixelTask::monitorData(o2::framework::ProcessingContext& ctx)
     hOrderedHitsAddressML->Reset();
     hOrderedHitsAddressOL->Reset();
 
-    std::multimap<int, uint64_t, std::greater<int>> orderedHitsIB;
-    std::multimap<int, uint64_t, std::greater<int>> orderedHitsML;
-    std::multimap<int, uint64_t, std::greater<int>> orderedHitsOL;
-
-    for (auto [key, value] : hashtable) {
-
-      int chipid_ = (int)(key / (1024 * 512));
-
-      mGeom->getChipId(chipid_, lay, sta, hsta, mod, chip);
-
-      if (!mEnableLayers[lay])
-        continue;
-
-      if (lay < 3)
-        orderedHitsIB.insert({ value, key });
-      else if (lay < 5)
-        orderedHitsML.insert({ value, key });
-      else
-        orderedHitsOL.insert({ value, key });
-    }
-
-    int counterbin = 1;
-    for (auto [kkey, vvalue] : orderedHitsIB) {
-
-      int chipid_ = (int)(vvalue / (1024 * 512));
-      mGeom->getChipId(chipid_, lay, sta, hsta, mod, chip);
-
-      int column_ = (int)((vvalue % (1024 * 512)) % 1024);
-      int row_ = (int)((vvalue % (1024 * 512)) / 1024);
-      hOrderedHitsAddressIB->GetXaxis()->SetBinLabel(counterbin, Form("L%d_%d-%d;%d;%d", lay, sta, chip, column_, row_));
-
-      hOrderedHitsAddressIB->SetBinContent(counterbin, 1. * kkey / mROFcycle);
-
-      if (counterbin == nmostnoisy) {
-        counterbin = 1;
-        break;
-      } else
-        counterbin++;
-    }
-
-    for (auto [kkey, vvalue] : orderedHitsML) {
-
-      int chipid_ = (int)(vvalue / (1024 * 512));
-      mGeom->getChipId(chipid_, lay, sta, hsta, mod, chip);
-
-      int column_ = (int)((vvalue % (1024 * 512)) % 1024);
-      int row_ = (int)((vvalue % (1024 * 512)) / 1024);
-      int mod_offset = (int)(hsta * mNHicPerStave[lay] / 2);
-      hOrderedHitsAddressML->GetXaxis()->SetBinLabel(counterbin, Form("L%d_%d-%d-%d;%d;%d", lay, sta, mod + mod_offset, chip, column_, row_));
-
-      hOrderedHitsAddressML->SetBinContent(counterbin, 1. * kkey / mROFcycle);
-
-      if (counterbin == nmostnoisy) {
-        counterbin = 1;
-        break;
-      } else
-        counterbin++;
-    }
-
-    for (auto [kkey, vvalue] : orderedHitsOL) {
+    fillOrderedHits(hOrderedHitsAddressIB, mNoisyPixels[0]);
+    fillOrderedHits(hOrderedHitsAddressML, mNoisyPixels[1]);
+    fillOrderedHits(hOrderedHitsAddressOL, mNoisyPixels[2]);
 
-      int chipid_ = (int)(vvalue / (1024 * 512));
-      mGeom->getChipId(chipid_, lay, sta, hsta, mod, chip);
-
-      int column_ = (int)((vvalue % (1024 * 512)) % 1024);
-      int row_ = (int)((vvalue % (1024 * 512)) / 1024);
-      int mod_offset = (int)(hsta * mNHicPerStave[lay] / 2);
-      hOrderedHitsAddressOL->GetXaxis()->SetBinLabel(counterbin, Form("L%d_%d-%d-%d;%d;%d", lay, sta, mod + mod_offset, chip, column_, row_));
-
-      hOrderedHitsAddressOL->SetBinContent(counterbin, 1. * kkey / mROFcycle);
-
-      if (counterbin == nmostnoisy) {
-        counterbin = 1;
-        break;
-      } else
-        counterbin++;
+    for (auto& tracker : mNoisyPixels) {
+      tracker.clear();
     }
-
-    hashtable.clear();
     mROFcycle = 0;
   }
 
@@ -322,6 +250,37 @@ void ITSNoisyPixelTask::monitorData(o2::framework::ProcessingContext& ctx)
   ILOG(Info) << "Time in QC Noisy Pixel Task:  " << difference << ENDM;
 }
 
+void ITSNoisyPixelTask::fillOrderedHits(TH1D* histogram, const NoisyPixelTracker& tracker)
+{
+  int lay, sta, hsta, mod, chip;
+  int counterbin = 1;
+  for (const auto& pixel : tracker.getTop()) {
+
+    int chipid_ = (int)(pixel.address / (1024 * 512));
+    mGeom->getChipId(chipid_, lay, sta, hsta, mod, chip);
+
+    int column_ = (int)((pixel.address % (1024 * 512)) % 1024);
+    int row_ = (int)((pixel.address % (1024 * 512)) / 1024);
+    if (lay < 3) {
+      histogram->GetXaxis()->SetBinLabel(counterbin, Form("L%d_%d-%d;%d;%d", lay, sta, chip, column_, row_));
+    } else {
+      int mod_offset = (int)(hsta * mNHicPerStave[lay] / 2);
+      histogram->GetXaxis()->SetBinLabel(counterbin, Form("L%d_%d-%d-%d;%d;%d", lay, sta, mod + mod_offset, chip, column_, row_));
+    }
+
+    histogram->SetBinContent(counterbin, 1. * pixel.hits / mROFcycle);
+    counterbin++;
+  }
+  if (tracker.isSaturated()) {
+    ILOG(Warning, Support) << "More than " << tracker.getMaxPixels() << " pixels were hit in " << histogram->GetName() << ", the hits of the noisiest pixels are approximate" << ENDM;
+  }
+}
+
+int ITSNoisyPixelTask::getLayerGroup(int layer)
+{
+  return layer < 3 ? 0 : (layer < 5 ? 1 : 2);
+}
+
 void ITSNoisyPixelTask::endOfCycle()
 {
   ILOG(Info, Support) << "endOfCycle" << AliceO2::InfoLogger::InfoLogger::endm;
@@ -369,17 +328,17 @@ void ITSNoisyPixelTask::createAllHistos()
 {
 
   if (mEnableOrderedHitsObject) {
-    hOrderedHitsAddressIB = new TH1D("OrderedHitsAddressIB", "OrderedHitsAddresIB", nmostnoisy, 0, nmostnoisy);
+    hOrderedHitsAddressIB = new TH1D("OrderedHitsAddressIB", "OrderedHitsAddresIB", mNoisyPixels[0].getNTop(), 0, mNoisyPixels[0].getNTop());
     hOrderedHitsAddressIB->SetTitle("Noisiest pixels in IB - <Lx_yy-chip col row>");
     formatAxes(hOrderedHitsAddressIB, "#", "Hits/ROF");
     addObject(hOrderedHitsAddressIB);
 
-    hOrderedHitsAddressML = new TH1D("OrderedHitsAddressML", "OrderedHitsAddresML", nmostnoisy, 0, nmostnoisy);
+    hOrderedHitsAddressML = new TH1D("OrderedHitsAddressML", "OrderedHitsAddresML", mNoisyPixels[1].getNTop(), 0, mNoisyPixels[1].getNTop());
     hOrderedHitsAddressML->SetTitle("Noisiest pixels in ML - <Lx_yy-mod-chip col row>");
     formatAxes(hOrderedHitsAddressML, "#", "Hits/ROF");
     addObject(hOrderedHitsAddressML);
 
-    hOrderedHitsAddressOL = new TH1D("OrderedHitsAddressOL", "OrderedHitsAddresOL", nmostnoisy, 0, nmostnoisy);
+    hOrderedHitsAddressOL = new TH1D("OrderedHitsAddressOL", "OrderedHitsAddresOL", mNoisyPixels[2].getNTop(), 0, mNoisyPixels[2].getNTop());
     hOrderedHitsAddressOL->SetTitle("Noisiest pixels in OL - <Lx_yy-mod-chip col row>");
     formatAxes(hOrderedHitsAddressOL, "#", "Hits/ROF");
     addObject(hOrderedHitsAddressOL);
@@ -447,6 +406,24 @@ void ITSNoisyPixelTask::getJsonParameters()
     nmostnoisy = request_nmostnoisy;
   mEnableOrderedHitsObject = (mOccUpdateFrequency >= 0 && request_nmostnoisy > 0);
 
+  // the number of pixels shown and the number of pixels tracked can be set per layer group, as they are hit differently
+  size_t maxPixels = 100000;
+  if (auto param = mCustomParameters.find("orderedPlotsMaxPixels"); param != mCustomParameters.end()) {
+    maxPixels = std::stoul(param->second);
+  }
+  const char* groups[3] = { "IB", "ML", "OL" };
+  for (int igroup = 0; igroup < 3; igroup++) {
+    int nTop = nmostnoisy;
+    if (auto param = mCustomParameters.find(std::string("orderedPlotsBinNumber") + groups[igroup]); param != mCustomParameters.end() && std::stoi(param->second) > 0) {
+      nTop = std::stoi(param->second);
+    }
+    size_t groupMaxPixels = maxPixels;
+    if (auto param = mCustomParameters.find(std::string("orderedPlotsMaxPixels") + groups[igroup]); param != mCustomParameters.end()) {
+      groupMaxPixels = std::stoul(param->second);
+    }
+    mNoisyPixels[igroup] = NoisyPixelTracker(nTop, groupMaxPixels);
+  }
+
   for (int ilayer = 0; ilayer < NLayer; ilayer++) {
 
     if (mCustomParameters["layer"][ilayer] != '0') {
@@ -16,6 +16,7 @@
 
 #include "QualityControl/QcInfoLogger.h"
 #include "ITS/ITSThresholdCalibrationTask.h"
+#include "ITS/ThresholdCalibrationResult.h"
 #include <DataFormatsITS/TrackITS.h>
 #include <DataFormatsITSMFT/ROFRecord.h>
 #include <Framework/InputRecord.h>
@@ -86,16 +87,9 @@ void ITSThresholdCalibrationTask::startOfCycle()
 
 void ITSThresholdCalibrationTask::monitorData(o2::framework::ProcessingContext& ctx)
 {
-
-  const auto tunString = ctx.inputs().get<gsl::span<char>>("tunestring");
-  const auto chipDoneString = ctx.inputs().get<gsl::span<char>>("chipdonestring");
   const auto scanType = ctx.inputs().get<char>("scantype");
 
-  string inString(tunString.begin(), tunString.end());
-  string inStringChipDone(chipDoneString.begin(), chipDoneString.end());
-
   Int_t iScan;
-  Double_t calibrationValue;
   if (scanType == 'V')
     iScan = 0;
   else if (scanType == 'I')
@@ -104,57 +98,19 @@ void ITSThresholdCalibrationTask::monitorData(o2::framework::ProcessingContext&
     iScan = 2;
   else if (scanType == 'A' || scanType == 'D')
     iScan = 3;
-  auto splitRes = splitString(inString, "Stave:");
-  auto splitResChipDone = splitString(inStringChipDone, "Stave:");
-
-  for (auto StaveStr : splitRes) {
-    if (StaveStr.size() > 0) {
-      CalibrationResStruct result = CalibrationParser(StaveStr);
-
-      int currentStave = StaveBoundary[result.Layer] + result.Stave + 1;
-      int iBarrel = getBarrel(result.Layer);
-      int currentChip = getCurrentChip(iBarrel, result.ChipID, result.HIC, result.Hs);
-
-      if (iScan < 3) {
-
-        if (scanType == 'V') {
-          calibrationValue = result.VCASN;
-        } else if (scanType == 'I') {
-          calibrationValue = result.ITHR;
-        } else if (scanType == 'T') {
-          calibrationValue = result.THR;
-          hCalibrationThrNoiseChipAverage[iBarrel]->SetBinContent(currentChip, currentStave, result.Noise);
-          hCalibrationThrNoiseRMSChipAverage[iBarrel]->Fill(currentChip, currentStave, result.NoiseRMS);
-        }
-
-        hCalibrationChipAverage[iScan][iBarrel]->SetBinContent(currentChip, currentStave, calibrationValue);
-        hCalibrationRMSChipAverage[iScan][iBarrel]->SetBinContent(currentChip, currentStave, result.RMS);
-      } else {
-        if (result.isDeadPixel)
-          hCalibrationDeadPixels[iBarrel]->Fill(currentChip, currentStave);
-        if (result.isDeadColumn)
-          hCalibrationDeadColumns[iBarrel]->Fill(currentChip, currentStave);
-      }
 
-      if (result.status == 1)
-        SuccessStatus[result.Layer]++;
-      TotalStatus[result.Layer]++;
-    }
+  // the results are read directly from the binary payload when it is sent, otherwise they are parsed from the strings
+  if (ctx.inputs().getPos("tuneresults") >= 0 && ctx.inputs().isValid("tuneresults")) {
+    fillResults(ctx.inputs().get<gsl::span<ChipCalibrationResult>>("tuneresults"), scanType, iScan);
+  } else {
+    const auto tunString = ctx.inputs().get<gsl::span<char>>("tunestring");
+    fillResults(parseCalibrationResults(std::string_view(tunString.data(), tunString.size())), scanType, iScan);
   }
-
-  // Fill chips for which scan is completed
-  for (auto StaveStr : splitResChipDone) {
-    if (StaveStr.size() > 0) {
-      CalibrationResStruct result = CalibrationParser(StaveStr);
-
-      int currentStave = StaveBoundary[result.Layer] + result.Stave + 1;
-      int iBarrel = getBarrel(result.Layer);
-      int currentChip = getCurrentChip(iBarrel, result.ChipID, result.HIC, result.Hs);
-      if (hCalibrationChipDone[iBarrel]->GetBinContent(currentChip, currentStave) > 0) {
-        continue; // chip may appear >twice here
-      }
-      hCalibrationChipDone[iBarrel]->Fill(currentChip - 1, currentStave - 1);
-    }
+  if (ctx.inputs().getPos("chipdoneresults") >= 0 && ctx.inputs().isValid("chipdoneresults")) {
+    fillChipsDone(ctx.inputs().get<gsl::span<ChipCalibrationResult>>("chipdoneresults"));
+  } else {
+    const auto chipDoneString = ctx.inputs().get<gsl::span<char>>("chipdonestring");
+    fillChipsDone(parseCalibrationResults(std::string_view(chipDoneString.data(), chipDoneString.size())));
   }
 
   for (int iLayer; iLayer < 7; iLayer++) {
@@ -190,6 +146,55 @@ void ITSThresholdCalibrationTask::monitorData(o2::framework::ProcessingContext&
   }
 }
 
+void ITSThresholdCalibrationTask::fillResults(gsl::span<const ChipCalibrationResult> results, char scanType, int iScan)
+{
+  Double_t calibrationValue;
+  for (const auto& result : results) {
+    int currentStave = StaveBoundary[result.layer] + result.stave + 1;
+    int iBarrel = getBarrel(result.layer);
+    int currentChip = getCurrentChip(iBarrel, result.chipID, result.hic, result.hs);
+
+    if (iScan < 3) {
+
+      if (scanType == 'V') {
+        calibrationValue = result.vcasn;
+      } else if (scanType == 'I') {
+        calibrationValue = result.ithr;
+      } else if (scanType == 'T') {
+        calibrationValue = result.thr;
+        hCalibrationThrNoiseChipAverage[iBarrel]->SetBinContent(currentChip, currentStave, result.noise);
+        hCalibrationThrNoiseRMSChipAverage[iBarrel]->Fill(currentChip, currentStave, result.noiseRMS);
+      }
+
+      hCalibrationChipAverage[iScan][iBarrel]->SetBinContent(currentChip, currentStave, calibrationValue);
+      hCalibrationRMSChipAverage[iScan][iBarrel]->SetBinContent(currentChip, currentStave, result.rms);
+    } else {
+      if (result.isDeadPixel())
+        hCalibrationDeadPixels[iBarrel]->Fill(currentChip, currentStave);
+      if (result.isDeadColumn())
+        hCalibrationDeadColumns[iBarrel]->Fill(currentChip, currentStave);
+    }
+
+    if (result.status == 1)
+      SuccessStatus[result.layer]++;
+    TotalStatus[result.layer]++;
+  }
+}
+
+void ITSThresholdCalibrationTask::fillChipsDone(gsl::span<const ChipCalibrationResult> results)
+{
+  // Fill chips for which scan is completed
+  for (const auto& result : results) {
+    int currentStave = StaveBoundary[result.layer] + result.stave + 1;
+    int iBarrel = getBarrel(result.layer);
+    int currentChip = getCurrentChip(iBarrel, result.chipID, result.hic, result.hs);
+    if (hCalibrationChipDone[iBarrel]->GetBinContent(currentChip, currentStave) > 0) {
+      continue; // chip may appear >twice here
+    }
+    hCalibrationChipDone[iBarrel]->Fill(currentChip - 1, currentStave - 1);
+  }
+}
+
 int ITSThresholdCalibrationTask::getCurrentChip(int barrel, int chipid, int hic, int hs)
 {
   int currentChip;
@@ -210,52 +215,6 @@ int ITSThresholdCalibrationTask::getCurrentChip(int barrel, int chipid, int hic,
   return currentChip;
 }
 
-ITSThresholdCalibrationTask::CalibrationResStruct ITSThresholdCalibrationTask::CalibrationParser(string input)
-{
-  CalibrationResStruct result;
-  auto StaveINFO = splitString(input, ",");
-
-  for (string info : StaveINFO) {
-    if (info.size() == 0)
-      continue;
-
-    if (info.substr(0, 1) == "L") {
-      result.Layer = std::stod(info.substr(1, 1));
-      result.Stave = std::stod(info.substr(3, 2));
-    } else {
-
-      std::string name = splitString(info, ":")[0];
-      string data = splitString(info, ":")[1];
-      if (name == "Hs_pos") {
-        result.Hs = std::stod(data);
-      } else if (name == "Hic_Pos") {
-        result.HIC = std::stod(data);
-      } else if (name == "ChipID") {
-        result.ChipID = std::stod(data);
-      } else if (name == "VCASN") {
-        result.VCASN = std::stof(data);
-      } else if (name == "Rms") {
-        result.RMS = std::stof(data);
-      } else if (name == "Status") {
-        result.status = std::stod(data);
-      } else if (name == "Noise") {
-        result.Noise = std::stof(data);
-      } else if (name == "NoiseRms") {
-        result.NoiseRMS = std::stof(data);
-      } else if (name == "ITHR") {
-        result.ITHR = std::stof(data);
-      } else if (name == "THR") {
-        result.THR = std::stof(data);
-      } else if (name == "Dcol" && std::stof(data) != -1) {
-        result.isDeadColumn = true;
-      } else if (name == "Row" && std::stof(data) != -1) {
-        result.isDeadPixel = true;
-      }
-    }
-  }
-  return result;
-}
-
 void ITSThresholdCalibrationTask::endOfCycle()
 {
   ILOG(Info, Support) << "endOfCycle" << ENDM;
@@ -494,20 +453,4 @@ void ITSThresholdCalibrationTask::publishHistos()
   }
 }
 
-std::vector<std::string> ITSThresholdCalibrationTask::splitString(std::string s, std::string delimiter)
-{
-  size_t pos_start = 0, pos_end, delim_len = delimiter.length();
-  std::string token;
-  std::vector<std::string> res;
-
-  while ((pos_end = s.find(delimiter, pos_start)) != string::npos) {
-    token = s.substr(pos_start, pos_end - pos_start);
-    pos_start = pos_end + delim_len;
-    res.push_back(token);
-  }
-
-  res.push_back(s.substr(pos_start));
-  return res;
-}
-
 } // namespace o2::quality_control_modules::its
@@ -0,0 +1,181 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   NoisyPixelTracker.cxx
+///
+
+#include "ITS/NoisyPixelTracker.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace o2::quality_control_modules::its
+{
+
+NoisyPixelTracker::NoisyPixelTracker(size_t nTop, size_t maxPixels)
+  : mNTop(nTop), mMaxPixels(std::max(maxPixels, nTop))
+{
+}
+
+void NoisyPixelTracker::add(uint64_t address)
+{
+  if (mNTop == 0 || mMaxPixels == 0) {
+    return;
+  }
+
+  auto found = mIndex.find(address);
+  if (found != mIndex.end()) {
+    auto& counter = mCounters[found->second];
+    counter.hits++;
+    siftDown(counter.heapPosition);
+    updateTop(found->second);
+    return;
+  }
+
+  if (mCounters.size() < mMaxPixels) {
+    auto index = static_cast<uint32_t>(mCounters.size());
+    mCounters.push_back({ address, 1, 0, static_cast<uint32_t>(mHeap.size()), -1 });
+    mHeap.push_back(index);
+    mIndex.emplace(address, index);
+    siftUp(mCounters[index].heapPosition);
+    updateTop(index);
+    return;
+  }
+
+  // the pixel with the fewest hits makes room for the new one
+  mSaturated = true;
+  auto index = mHeap.front();
+  auto& counter = mCounters[index];
+  if (counter.topPosition >= 0) {
+    removeFromTop(index);
+  }
+  mIndex.erase(counter.address);
+  mIndex.emplace(address, index);
+  counter.address = address;
+  counter.error = counter.hits;
+  counter.hits++;
+  siftDown(0);
+  updateTop(index);
+}
+
+std::vector<NoisyPixelTracker::Pixel> NoisyPixelTracker::getTop() const
+{
+  std::vector<Pixel> top;
+  top.reserve(mTop.size());
+  for (auto index : mTop) {
+    const auto& counter = mCounters[index];
+    top.push_back({ counter.address, counter.hits, counter.error });
+  }
+  std::sort(top.begin(), top.end(), [](const Pixel& a, const Pixel& b) {
+    return a.hits != b.hits ? a.hits > b.hits : a.address < b.address;
+  });
+  return top;
+}
+
+void NoisyPixelTracker::clear()
+{
+  mIndex.clear();
+  mCounters.clear();
+  mHeap.clear();
+  mTop.clear();
+  mTopMinimum = 0;
+  mSaturated = false;
+}
+
+void NoisyPixelTracker::siftUp(uint32_t position)
+{
+  while (position > 0) {
+    auto parent = (position - 1) / 2;
+    if (mCounters[mHeap[parent]].hits <= mCounters[mHeap[position]].hits) {
+      return;
+    }
+    swapInHeap(parent, position);
+    position = parent;
+  }
+}
+
+void NoisyPixelTracker::siftDown(uint32_t position)
+{
+  const auto size = mHeap.size();
+  while (true) {
+    auto smallest = position;
+    auto left = 2 * position + 1;
+    auto right = left + 1;
+    if (left < size && mCounters[mHeap[left]].hits < mCounters[mHeap[smallest]].hits) {
+      smallest = left;
+    }
+    if (right < size && mCounters[mHeap[right]].hits < mCounters[mHeap[smallest]].hits) {
+      smallest = right;
+    }
+    if (smallest == position) {
+      return;
+    }
+    swapInHeap(position, smallest);
+    position = smallest;
+  }
+}
+
+void NoisyPixelTracker::swapInHeap(uint32_t a, uint32_t b)
+{
+  std::swap(mHeap[a], mHeap[b]);
+  mCounters[mHeap[a]].heapPosition = a;
+  mCounters[mHeap[b]].heapPosition = b;
+}
+
+// The hits only increase one by one, so a pixel can only enter the top when it gets more hits than its last entry.
+void NoisyPixelTracker::updateTop(uint32_t index)
+{
+  auto& counter = mCounters[index];
+  if (counter.topPosition >= 0) {
+    if (static_cast<size_t>(counter.topPosition) == mTopMinimum) {
+      findTopMinimum();
+    }
+    return;
+  }
+  if (mTop.size() < mNTop) {
+    counter.topPosition = static_cast<int32_t>(mTop.size());
+    mTop.push_back(index);
+    findTopMinimum();
+    return;
+  }
+  auto& last = mCounters[mTop[mTopMinimum]];
+  if (counter.hits > last.hits) {
+    last.topPosition = -1;
+    mTop[mTopMinimum] = index;
+    counter.topPosition = static_cast<int32_t>(mTopMinimum);
+    findTopMinimum();
+  }
+}
+
+void NoisyPixelTracker::removeFromTop(uint32_t index)
+{
+  auto position = static_cast<size_t>(mCounters[index].topPosition);
+  mCounters[index].topPosition = -1;
+  mTop[position] = mTop.back();
+  mTop.pop_back();
+  if (position < mTop.size()) {
+    mCounters[mTop[position]].topPosition = static_cast<int32_t>(position);
+  }
+  findTopMinimum();
+}
+
+void NoisyPixelTracker::findTopMinimum()
+{
+  mTopMinimum = 0;
+  for (size_t i = 1; i < mTop.size(); i++) {
+    if (mCounters[mTop[i]].hits < mCounters[mTop[mTopMinimum]].hits) {
+      mTopMinimum = i;
+    }
+  }
+}
+
+} // namespace o2::quality_control_modules::its
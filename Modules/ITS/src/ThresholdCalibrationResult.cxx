@@ -0,0 +1,112 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   ThresholdCalibrationResult.cxx
+///
+
+#include "ITS/ThresholdCalibrationResult.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+namespace o2::quality_control_modules::its
+{
+
+namespace
+{
+
+float toFloat(std::string_view data)
+{
+  // strtof needs a null-terminated string, the fields are short enough to be copied on the stack
+  char buffer[32];
+  auto length = std::min(data.size(), sizeof(buffer) - 1);
+  std::memcpy(buffer, data.data(), length);
+  buffer[length] = '\0';
+  return std::strtof(buffer, nullptr);
+}
+
+template <typename F>
+void forEachToken(std::string_view input, std::string_view delimiter, F f)
+{
+  size_t start = 0;
+  while (true) {
+    auto end = input.find(delimiter, start);
+    f(input.substr(start, end == std::string_view::npos ? std::string_view::npos : end - start));
+    if (end == std::string_view::npos) {
+      return;
+    }
+    start = end + delimiter.size();
+  }
+}
+
+} // namespace
+
+ChipCalibrationResult parseChipCalibrationResult(std::string_view input)
+{
+  ChipCalibrationResult result;
+  forEachToken(input, ",", [&result](std::string_view info) {
+    if (info.empty()) {
+      return;
+    }
+    if (info[0] == 'L') {
+      result.layer = static_cast<int16_t>(toFloat(info.substr(1, 1)));
+      result.stave = static_cast<int16_t>(toFloat(info.substr(3, 2)));
+      return;
+    }
+    auto separator = info.find(':');
+    if (separator == std::string_view::npos) {
+      return;
+    }
+    auto name = info.substr(0, separator);
+    auto data = info.substr(separator + 1, info.find(':', separator + 1) - separator - 1);
+    if (name == "Hs_pos") {
+      result.hs = static_cast<int16_t>(toFloat(data));
+    } else if (name == "Hic_Pos") {
+      result.hic = static_cast<int16_t>(toFloat(data));
+    } else if (name == "ChipID") {
+      result.chipID = static_cast<int16_t>(toFloat(data));
+    } else if (name == "VCASN") {
+      result.vcasn = toFloat(data);
+    } else if (name == "Rms") {
+      result.rms = toFloat(data);
+    } else if (name == "Status") {
+      result.status = static_cast<int8_t>(toFloat(data));
+    } else if (name == "Noise") {
+      result.noise = toFloat(data);
+    } else if (name == "NoiseRms") {
+      result.noiseRMS = toFloat(data);
+    } else if (name == "ITHR") {
+      result.ithr = toFloat(data);
+    } else if (name == "THR") {
+      result.thr = toFloat(data);
+    } else if (name == "Dcol" && toFloat(data) != -1) {
+      result.flags |= ChipCalibrationResult::DeadColumn;
+    } else if (name == "Row" && toFloat(data) != -1) {
+      result.flags |= ChipCalibrationResult::DeadPixel;
+    }
+  });
+  return result;
+}
+
+std::vector<ChipCalibrationResult> parseCalibrationResults(std::string_view input)
+{
+  std::vector<ChipCalibrationResult> results;
+  forEachToken(input, "Stave:", [&results](std::string_view chip) {
+    if (!chip.empty()) {
+      results.push_back(parseChipCalibrationResult(chip));
+    }
+  });
+  return results;
+}
+
+} // namespace o2::quality_control_modules::its
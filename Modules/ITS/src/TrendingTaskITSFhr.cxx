@@ -57,6 +57,7 @@ void TrendingTaskITSFhr::initialize(Trigger, framework::ServiceRegistry&)
                    reductor->getBranchLeafList());
     mReductors[source.name] = std::move(reductor);
   }
+  mRetriever = std::make_unique<ConcurrentRetriever>(mConfig.retrievalConcurrency);
 }
 
 // todo: see if OptimizeBaskets() indeed helps after some time
@@ -99,34 +100,38 @@ void TrendingTaskITSFhr::trendValues(const Trigger& t, repository::DatabaseInter
   // monitor object's metadata (this might be not
   //  enough if we trend across runs).
   mMetaData.runNumber = 0;
-  int count = 0;
+  std::vector<ConcurrentRetriever::Request> requests;
+  std::vector<std::string> requestNames;
   for (auto& dataSource : mConfig.dataSources) {
 
     // todo: make it agnostic to MOs, QOs or other objects. Let the reductor
     // cast to whatever it needs.
     if (dataSource.type == "repository") {
       // auto mo = qcdb.retrieveMO(dataSource.path, dataSource.name);
-      auto mo = qcdb.retrieveMO(dataSource.path, "", t.timestamp, t.activity);
-      if (!count) {
-        std::map<std::string, std::string> entryMetadata = mo->getMetadataMap(); // full list of metadata as a map
-        mMetaData.runNumber = std::stoi(entryMetadata["RunNumber"]);             // get and set run number
-        ntreeentries = (Int_t)mTrend->GetEntries() + 1;
-        runlist.push_back(std::to_string(mMetaData.runNumber));
-      }
-      TObject* obj = mo ? mo->getObject() : nullptr;
-      if (obj) {
-        mReductors[dataSource.name]->update(obj);
-      }
+      requests.push_back({ ConcurrentRetriever::Request::Type::MonitorObject, dataSource.path, "", static_cast<long>(t.timestamp), t.activity });
     } else if (dataSource.type == "repository-quality") {
-      auto qo = qcdb.retrieveQO(dataSource.path + "/" + dataSource.name);
-      if (qo) {
-        mReductors[dataSource.name]->update(qo.get());
-      }
+      requests.push_back({ ConcurrentRetriever::Request::Type::QualityObject, dataSource.path + "/" + dataSource.name });
     } else {
       ILOGE << "Unknown type of data source '" << dataSource.type << "'.";
+      continue;
     }
-    count++;
+    requestNames.push_back(dataSource.name);
   }
+
+  // The objects may arrive in any order, the run number is taken from the first data source.
+  mRetriever->retrieve(qcdb, requests, [&](size_t index, ConcurrentRetriever::Result& result) {
+    if (index == 0 && requests[0].type == ConcurrentRetriever::Request::Type::MonitorObject) {
+      std::map<std::string, std::string> entryMetadata = result.mo->getMetadataMap(); // full list of metadata as a map
+      mMetaData.runNumber = std::stoi(entryMetadata["RunNumber"]);                    // get and set run number
+      ntreeentries = (Int_t)mTrend->GetEntries() + 1;
+      runlist.push_back(std::to_string(mMetaData.runNumber));
+    }
+    if (TObject* obj = result.mo ? result.mo->getObject() : nullptr) {
+      mReductors[requestNames[index]]->update(obj);
+    } else if (result.qo) {
+      mReductors[requestNames[index]]->update(result.qo.get());
+    }
+  });
   mTrend->Fill();
 }
 
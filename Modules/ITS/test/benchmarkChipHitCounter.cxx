@@ -0,0 +1,157 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   benchmarkChipHitCounter.cxx
+///
+/// Compares the ChipHitCounter used by ITSFhrTask with the unordered_map it replaced, for the pattern of one cycle:
+/// counting the hits of several TFs, iterating over the fired pixels and resetting.
+///
+/// Usage: benchmarkQcITSChipHitCounter [hits per chip per TF] [number of TFs]
+///
+
+#include "ITS/ChipHitCounter.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace o2::quality_control_modules::its;
+
+namespace
+{
+
+struct Hit {
+  uint16_t col;
+  uint16_t row;
+};
+
+constexpr int NChips = 9; // one IB stave
+
+/// Hits of one TF for each chip. A fraction of them comes from a few hot pixels, the rest is spread over clusters.
+std::vector<std::vector<Hit>> generateHits(size_t hitsPerChip, std::mt19937& generator)
+{
+  std::uniform_int_distribution<int> col(0, ChipHitCounter::NCols - 1);
+  std::uniform_int_distribution<int> row(0, ChipHitCounter::NRows - 1);
+  std::uniform_int_distribution<int> spread(-2, 2);
+  std::uniform_int_distribution<int> hot(0, 15);
+  std::vector<std::vector<Hit>> hits(NChips);
+  for (auto& chip : hits) {
+    std::vector<Hit> hotPixels;
+    for (int i = 0; i < 16; i++) {
+      hotPixels.push_back({ (uint16_t)col(generator), (uint16_t)row(generator) });
+    }
+    chip.reserve(hitsPerChip);
+    while (chip.size() < hitsPerChip) {
+      if (chip.size() % 4 == 0) {
+        chip.push_back(hotPixels[hot(generator)]);
+        continue;
+      }
+      int c = col(generator), r = row(generator);
+      for (int i = 0; i < 4 && chip.size() < hitsPerChip; i++) {
+        int cc = std::clamp(c + spread(generator), 0, ChipHitCounter::NCols - 1);
+        int rr = std::clamp(r + spread(generator), 0, ChipHitCounter::NRows - 1);
+        chip.push_back({ (uint16_t)cc, (uint16_t)rr });
+      }
+    }
+  }
+  return hits;
+}
+
+template <typename Fill, typename Iterate, typename Reset>
+double measure(const std::vector<std::vector<std::vector<Hit>>>& tfs, int cycles, Fill fill, Iterate iterate, Reset reset, uint64_t& checksum)
+{
+  auto start = std::chrono::steady_clock::now();
+  for (int cycle = 0; cycle < cycles; cycle++) {
+    for (const auto& tf : tfs) {
+      for (int chip = 0; chip < NChips; chip++) {
+        for (const auto& hit : tf[chip]) {
+          fill(chip, hit);
+        }
+      }
+      for (int chip = 0; chip < NChips; chip++) {
+        checksum += iterate(chip);
+      }
+    }
+    reset();
+  }
+  std::chrono::duration<double, std::milli> duration = std::chrono::steady_clock::now() - start;
+  return duration.count() / cycles;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+  size_t hitsPerChip = argc > 1 ? std::stoul(argv[1]) : 20000;
+  size_t nTFs = argc > 2 ? std::stoul(argv[2]) : 10;
+  const int cycles = 5;
+
+  std::mt19937 generator(42);
+  std::vector<std::vector<std::vector<Hit>>> tfs;
+  for (size_t i = 0; i < nTFs; i++) {
+    tfs.push_back(generateHits(hitsPerChip, generator));
+  }
+
+  uint64_t mapChecksum = 0;
+  std::vector<std::unordered_map<unsigned int, int>> maps(NChips);
+  double mapTime = measure(
+    tfs, cycles,
+    [&](int chip, const Hit& hit) { maps[chip][1000 * hit.col + hit.row]++; },
+    [&](int chip) {
+      uint64_t sum = 0;
+      for (const auto& [key, hits] : maps[chip]) {
+        sum += (key / 1000) + (key % 1000) + hits;
+      }
+      return sum;
+    },
+    [&]() {
+      for (auto& map : maps) {
+        map.clear();
+      }
+    },
+    mapChecksum);
+
+  uint64_t counterChecksum = 0;
+  std::vector<ChipHitCounter> counters(NChips);
+  double counterTime = measure(
+    tfs, cycles,
+    [&](int chip, const Hit& hit) { counters[chip].add(hit.col, hit.row); },
+    [&](int chip) {
+      uint64_t sum = 0;
+      counters[chip].forEachFired([&](int col, int row, uint32_t hits) { sum += col + row + hits; });
+      return sum;
+    },
+    [&]() {
+      for (auto& counter : counters) {
+        counter.reset();
+      }
+    },
+    counterChecksum);
+
+  std::cout << "Counting " << hitsPerChip << " hits per chip in " << NChips << " chips for " << nTFs << " TFs per cycle" << std::endl;
+  std::cout << std::fixed << std::setprecision(2);
+  std::cout << "  unordered_map  : " << mapTime << " ms per cycle" << std::endl;
+  std::cout << "  ChipHitCounter : " << counterTime << " ms per cycle" << std::endl;
+  std::cout << "  speedup        : " << mapTime / counterTime << std::endl;
+  if (mapChecksum != counterChecksum) {
+    std::cerr << "The checksums differ: " << mapChecksum << " vs " << counterChecksum << std::endl;
+    return 1;
+  }
+  return 0;
+}
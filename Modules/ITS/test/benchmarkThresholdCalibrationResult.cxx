@@ -0,0 +1,179 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   benchmarkThresholdCalibrationResult.cxx
+///
+/// Compares the ways ITSThresholdCalibrationTask can get the results of a full-detector scan:
+/// the previous string parser, the current string parser (fallback) and the binary payload.
+///
+/// Usage: benchmarkQcITSThresholdCalibrationResult [number of chips] [repetitions]
+///
+
+#include "ITS/ThresholdCalibrationResult.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace o2::quality_control_modules::its;
+
+namespace
+{
+
+// The parser used by ITSThresholdCalibrationTask before the binary payload was introduced, kept as a reference.
+std::vector<std::string> splitString(std::string s, std::string delimiter)
+{
+  size_t pos_start = 0, pos_end, delim_len = delimiter.length();
+  std::string token;
+  std::vector<std::string> res;
+
+  while ((pos_end = s.find(delimiter, pos_start)) != std::string::npos) {
+    token = s.substr(pos_start, pos_end - pos_start);
+    pos_start = pos_end + delim_len;
+    res.push_back(token);
+  }
+
+  res.push_back(s.substr(pos_start));
+  return res;
+}
+
+ChipCalibrationResult legacyParser(std::string input)
+{
+  ChipCalibrationResult result;
+  auto StaveINFO = splitString(input, ",");
+
+  for (std::string info : StaveINFO) {
+    if (info.size() == 0)
+      continue;
+
+    if (info.substr(0, 1) == "L") {
+      result.layer = std::stod(info.substr(1, 1));
+      result.stave = std::stod(info.substr(3, 2));
+    } else {
+      std::string name = splitString(info, ":")[0];
+      std::string data = splitString(info, ":")[1];
+      if (name == "Hs_pos") {
+        result.hs = std::stod(data);
+      } else if (name == "Hic_Pos") {
+        result.hic = std::stod(data);
+      } else if (name == "ChipID") {
+        result.chipID = std::stod(data);
+      } else if (name == "Rms") {
+        result.rms = std::stof(data);
+      } else if (name == "Status") {
+        result.status = std::stod(data);
+      } else if (name == "Noise") {
+        result.noise = std::stof(data);
+      } else if (name == "NoiseRms") {
+        result.noiseRMS = std::stof(data);
+      } else if (name == "THR") {
+        result.thr = std::stof(data);
+      }
+    }
+  }
+  return result;
+}
+
+// stands for the gsl::span given by the InputRecord
+struct PayloadView {
+  const ChipCalibrationResult* first;
+  const ChipCalibrationResult* last;
+  const ChipCalibrationResult* begin() const { return first; }
+  const ChipCalibrationResult* end() const { return last; }
+};
+
+template <typename Parse>
+double measure(int repetitions, Parse parse, double& checksum)
+{
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < repetitions; i++) {
+    for (const auto& result : parse()) {
+      checksum += result.layer + result.stave + result.chipID + result.thr + result.noise;
+    }
+  }
+  std::chrono::duration<double, std::milli> duration = std::chrono::steady_clock::now() - start;
+  return duration.count() / repetitions;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+  size_t nChips = argc > 1 ? std::stoul(argv[1]) : 24120; // the full detector
+  int repetitions = argc > 2 ? std::stoi(argv[2]) : 10;
+
+  // a threshold scan result for each chip, in both formats
+  std::mt19937 generator(42);
+  std::normal_distribution<float> threshold(100, 10);
+  std::string text;
+  std::vector<ChipCalibrationResult> binary;
+  for (size_t i = 0; i < nChips; i++) {
+    ChipCalibrationResult chip;
+    chip.layer = i % 7;
+    chip.stave = i % 12;
+    chip.hs = i % 2;
+    chip.hic = 1 + i % 8;
+    chip.chipID = i % 14;
+    chip.status = 1;
+    chip.thr = threshold(generator);
+    chip.rms = 1 + threshold(generator) / 100;
+    chip.noise = 5 + threshold(generator) / 100;
+    chip.noiseRMS = 1 + threshold(generator) / 1000;
+    binary.push_back(chip);
+
+    char buffer[256];
+    snprintf(buffer, sizeof(buffer), "Stave:L%d_%02d,Hs_pos:%d,Hic_Pos:%d,ChipID:%d,THR:%.6g,Rms:%.6g,Status:%d,Noise:%.6g,NoiseRms:%.6g,",
+             chip.layer, chip.stave, chip.hs, chip.hic, chip.chipID, chip.thr, chip.rms, chip.status, chip.noise, chip.noiseRMS);
+    text += buffer;
+  }
+  // what arrives in the message, the binary payload is read in place
+  std::vector<char> message(binary.size() * sizeof(ChipCalibrationResult));
+  std::memcpy(message.data(), binary.data(), message.size());
+
+  double legacyChecksum = 0, stringChecksum = 0, binaryChecksum = 0;
+  double legacyTime = measure(
+    repetitions, [&]() {
+      std::vector<ChipCalibrationResult> results;
+      for (const auto& chip : splitString(text, "Stave:")) {
+        if (chip.size() > 0) {
+          results.push_back(legacyParser(chip));
+        }
+      }
+      return results;
+    },
+    legacyChecksum);
+  double stringTime = measure(
+    repetitions, [&]() { return parseCalibrationResults(text); }, stringChecksum);
+  double binaryTime = measure(
+    repetitions, [&]() {
+      auto begin = reinterpret_cast<const ChipCalibrationResult*>(message.data());
+      return PayloadView{ begin, begin + message.size() / sizeof(ChipCalibrationResult) };
+    },
+    binaryChecksum);
+
+  std::cout << "Reading the results of " << nChips << " chips (" << text.size() << " bytes as text, " << message.size() << " bytes as binary)" << std::endl;
+  std::cout << std::fixed << std::setprecision(3);
+  std::cout << "  previous string parser : " << legacyTime << " ms, " << nChips / legacyTime / 1e3 << " M chips/s" << std::endl;
+  std::cout << "  string parser          : " << stringTime << " ms, " << nChips / stringTime / 1e3 << " M chips/s" << std::endl;
+  std::cout << "  binary payload         : " << binaryTime << " ms, " << nChips / binaryTime / 1e3 << " M chips/s" << std::endl;
+  if (std::abs(legacyChecksum - stringChecksum) > 1e-6 * std::abs(legacyChecksum) || std::abs(stringChecksum - binaryChecksum) > 1e-3 * std::abs(stringChecksum)) {
+    std::cerr << "The results differ: " << legacyChecksum << ", " << stringChecksum << ", " << binaryChecksum << std::endl;
+    return 1;
+  }
+  return 0;
+}
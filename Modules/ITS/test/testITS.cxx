@@ -15,6 +15,10 @@
 ///
 
 #include "QualityControl/TaskFactory.h"
+#include "ITS/ChipHitCounter.h"
+#include "ITS/NoisyPixelTracker.h"
+#include "ITS/ThresholdCalibrationResult.h"
+#include <map>
 
 #define BOOST_TEST_MODULE Publisher test
 #define BOOST_TEST_MAIN
@@ -31,6 +35,113 @@ namespace itstaskraw
 
 BOOST_AUTO_TEST_CASE(instantiate_task) { BOOST_CHECK(true); }
 
+BOOST_AUTO_TEST_CASE(chip_hit_counter)
+{
+  using o2::quality_control_modules::its::ChipHitCounter;
+  ChipHitCounter counter;
+  BOOST_CHECK(counter.empty());
+
+  // a sparse region, a region which becomes dense and the corners of the chip
+  std::map<std::pair<int, int>, uint32_t> expected;
+  auto add = [&](int col, int row, uint32_t hits) {
+    counter.add(col, row, hits);
+    expected[{ col, row }] += hits;
+  };
+  add(0, 0, 1);
+  add(1023, 511, 2);
+  add(100, 200, 3);
+  add(100, 200, 1);
+  for (int i = 0; i < 20; i++) {
+    add(64 + i, 64 + i % 3, 1);
+  }
+  add(64, 64, 5);
+  BOOST_CHECK_EQUAL(counter.get(100, 200), 4);
+  BOOST_CHECK_EQUAL(counter.get(64, 64), 6);
+  BOOST_CHECK_EQUAL(counter.get(101, 200), 0);
+
+  std::map<std::pair<int, int>, uint32_t> fired;
+  counter.forEachFired([&](int col, int row, uint32_t hits) { fired[{ col, row }] += hits; });
+  BOOST_CHECK(fired == expected);
+
+  counter.reset();
+  BOOST_CHECK(counter.empty());
+  BOOST_CHECK_EQUAL(counter.get(64, 64), 0);
+  int nFired = 0;
+  counter.forEachFired([&](int, int, uint32_t) { nFired++; });
+  BOOST_CHECK_EQUAL(nFired, 0);
+
+  // the memory kept by reset() is reused
+  counter.add(70, 70);
+  BOOST_CHECK_EQUAL(counter.get(70, 70), 1);
+}
+
+BOOST_AUTO_TEST_CASE(calibration_result_parser)
+{
+  using namespace o2::quality_control_modules::its;
+  auto results = parseCalibrationResults("Stave:L3_05,Hs_pos:1,Hic_Pos:2,ChipID:4,THR:101.5,Rms:2.5,Status:1,Noise:5.25,NoiseRms:1.5,"
+                                         "Stave:L0_11,ChipID:8,Dcol:-1,Row:12,");
+  BOOST_REQUIRE_EQUAL(results.size(), 2);
+  BOOST_CHECK_EQUAL(results[0].layer, 3);
+  BOOST_CHECK_EQUAL(results[0].stave, 5);
+  BOOST_CHECK_EQUAL(results[0].hs, 1);
+  BOOST_CHECK_EQUAL(results[0].hic, 2);
+  BOOST_CHECK_EQUAL(results[0].chipID, 4);
+  BOOST_CHECK_EQUAL(results[0].status, 1);
+  BOOST_CHECK_EQUAL(results[0].thr, 101.5f);
+  BOOST_CHECK_EQUAL(results[0].rms, 2.5f);
+  BOOST_CHECK_EQUAL(results[0].noise, 5.25f);
+  BOOST_CHECK_EQUAL(results[0].noiseRMS, 1.5f);
+  BOOST_CHECK_EQUAL(results[1].layer, 0);
+  BOOST_CHECK_EQUAL(results[1].stave, 11);
+  BOOST_CHECK_EQUAL(results[1].chipID, 8);
+  BOOST_CHECK(results[1].isDeadPixel());
+  BOOST_CHECK(!results[1].isDeadColumn());
+  BOOST_CHECK(parseCalibrationResults("").empty());
+}
+
+BOOST_AUTO_TEST_CASE(noisy_pixel_tracker)
+{
+  using o2::quality_control_modules::its::NoisyPixelTracker;
+
+  // pixel i gets i hits, in an interleaved order
+  NoisyPixelTracker tracker(3, 100);
+  for (int round = 1; round <= 20; round++) {
+    for (uint64_t pixel = round; pixel <= 20; pixel++) {
+      tracker.add(pixel);
+    }
+  }
+  BOOST_CHECK(!tracker.isSaturated());
+  auto top = tracker.getTop();
+  BOOST_REQUIRE_EQUAL(top.size(), 3);
+  for (int i = 0; i < 3; i++) {
+    BOOST_CHECK_EQUAL(top[i].address, 20 - i);
+    BOOST_CHECK_EQUAL(top[i].hits, 20 - i);
+    BOOST_CHECK_EQUAL(top[i].error, 0);
+  }
+
+  // with room for 20 pixels only, the noisy ones are still found among many pixels hit once
+  NoisyPixelTracker bounded(2, 20);
+  for (uint64_t pixel = 1000; pixel < 2000; pixel++) {
+    bounded.add(pixel);
+    if (pixel % 10 == 0) {
+      bounded.add(1);
+      bounded.add(1);
+      bounded.add(2);
+    }
+  }
+  BOOST_CHECK(bounded.isSaturated());
+  BOOST_CHECK_EQUAL(bounded.size(), 20);
+  top = bounded.getTop();
+  BOOST_REQUIRE_EQUAL(top.size(), 2);
+  BOOST_CHECK_EQUAL(top[0].address, 1);
+  BOOST_CHECK_EQUAL(top[1].address, 2);
+  BOOST_CHECK_LE(top[0].hits - top[0].error, 200);
+  BOOST_CHECK_GE(top[0].hits, 200);
+
+  bounded.clear();
+  BOOST_CHECK(bounded.getTop().empty());
+}
+
 } // namespace itstaskraw
 } // namespace quality_control_modules
 } // namespace o2
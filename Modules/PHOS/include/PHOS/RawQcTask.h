@@ -187,8 +187,9 @@ class RawQcTask final : public TaskInterface
   std::array<TH2FMean*, kNhist2DMean> mHist2DMean = { nullptr };          ///< Array of 2D mean histograms
   std::array<TH2SBitmask*, kNhist2DBitmask> mHist2DBitmask = { nullptr }; ///< Array of 2D mean histograms
 
-  bool mInitBadMap = true;                           //! BadMap had to be initialized
-  const o2::phos::BadChannelsMap* mBadMap = nullptr; //! Bad map for comparison
+  bool mInitBadMap = true;                                 //! BadMap had to be initialized
+  bool mBadMapRequested = false;                           //! the first retrieval of the BadMap was waited for
+  std::shared_ptr<const o2::phos::BadChannelsMap> mBadMap; //! Bad map for comparison, shared with the other tasks
   std::unique_ptr<TSpectrum> mSpSearcher;
   std::vector<TH1S> mSpectra;
 };
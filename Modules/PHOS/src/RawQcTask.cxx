@@ -104,6 +104,8 @@ void RawQcTask::initialize(o2::framework::InitContext& /*ctx*/)
   }
 
   InitHistograms();
+  // retrieved in the background, ready for the first monitorData()
+  prefetchCondition<o2::phos::BadChannelsMap>("PHS/Calib/BadMap");
 }
 
 void RawQcTask::InitHistograms()
@@ -235,16 +237,19 @@ void RawQcTask::monitorData(o2::framework::ProcessingContext& ctx)
   }
   // Bad Map
   //  Read current bad map if not read yet
+  //  If the first retrieval timed out, it goes on in the background and the next calls do not wait for it
   if (mInitBadMap) {
-    mInitBadMap = false;
-    ILOG(Info, Support) << "Getting bad map" << AliceO2::InfoLogger::InfoLogger::endm;
-    loadCcdb();
-    std::map<std::string, std::string> metadata;
-    mBadMap = retrieveConditionAny<o2::phos::BadChannelsMap>("PHS/Calib/BadMap", metadata);
+    if (!mBadMapRequested) {
+      ILOG(Info, Support) << "Getting bad map" << AliceO2::InfoLogger::InfoLogger::endm;
+    }
+    mBadMap = getCondition<o2::phos::BadChannelsMap>("PHS/Calib/BadMap", {}, mBadMapRequested ? std::chrono::milliseconds(0) : ConditionsService::defaultTimeout);
     if (!mBadMap) {
-      ILOG(Error, Support) << "Can not get bad map" << AliceO2::InfoLogger::InfoLogger::endm;
-      mHist1D[kBadMapSummary]->Reset();
+      if (!mBadMapRequested) {
+        ILOG(Error, Support) << "Can not get bad map, will try again" << AliceO2::InfoLogger::InfoLogger::endm;
+        mHist1D[kBadMapSummary]->Reset();
+      }
     } else {
+      mInitBadMap = false;
       unsigned short nbm[4] = { 0 };
       for (short absId = 1973; absId <= o2::phos::Mapping::NCHANNELS; absId++) {
         if (!mBadMap->isChannelGood(absId)) {
@@ -256,6 +261,7 @@ void RawQcTask::monitorData(o2::framework::ProcessingContext& ctx)
       }
       ILOG(Info, Support) << "Bad channels:[" << nbm[0] << "," << nbm[1] << "," << nbm[2] << "," << nbm[3] << "]" << AliceO2::InfoLogger::InfoLogger::endm;
     }
+    mBadMapRequested = true;
   }
 
   // Chi2: not hardware errors but unusual/correpted sample
@@ -73,6 +73,7 @@ void TrendingTaskTPC::initialize(Trigger, framework::ServiceRegistry&)
     }
     mReductors[source.name] = std::move(reductor);
   }
+  mRetriever = std::make_unique<ConcurrentRetriever>(mConfig.retrievalConcurrency);
   if (mConfig.producePlotsOnUpdate) {
     getObjectsManager()->startPublishing(mTrend.get());
   }
@@ -101,29 +102,34 @@ void TrendingTaskTPC::trendValues(const Trigger& t,
   mTime = t.timestamp / 1000; // ROOT expects seconds since epoch.
   mMetaData.runNumber = -1;
 
+  std::vector<ConcurrentRetriever::Request> requests;
+  std::vector<const TrendingTaskConfigTPC::DataSource*> requestSources;
   for (auto& dataSource : mConfig.dataSources) {
     mNumberPads[dataSource.name] = 0;
     if (dataSource.type == "repository") {
-      auto mo = qcdb.retrieveMO(dataSource.path, dataSource.name, t.timestamp, t.activity);
-      TObject* obj = mo ? mo->getObject() : nullptr;
-
       mAxisDivision[dataSource.name] = dataSource.axisDivision;
-
-      if (obj) {
-        mReductors[dataSource.name]->update(obj, mSources[dataSource.name],
-                                            dataSource.axisDivision, mNumberPads[dataSource.name]);
-      }
-
+      requests.push_back({ ConcurrentRetriever::Request::Type::MonitorObject, dataSource.path, dataSource.name, static_cast<long>(t.timestamp), t.activity });
     } else if (dataSource.type == "repository-quality") {
-      if (auto qo = qcdb.retrieveQO(dataSource.path + "/" + dataSource.name, t.timestamp, t.activity)) {
-        mReductors[dataSource.name]->updateQuality(qo.get(), mSourcesQuality[dataSource.name]);
-        mNumberPads[dataSource.name] = 1;
-      }
+      requests.push_back({ ConcurrentRetriever::Request::Type::QualityObject, dataSource.path + "/" + dataSource.name, "", static_cast<long>(t.timestamp), t.activity });
     } else {
       ILOG(Error, Support) << "Data source '" << dataSource.type << "' unknown." << ENDM;
+      continue;
     }
+    requestSources.push_back(&dataSource);
   }
 
+  // Each reductor runs as soon as its object arrives.
+  mRetriever->retrieve(qcdb, requests, [&](size_t index, ConcurrentRetriever::Result& result) {
+    const auto& dataSource = *requestSources[index];
+    if (TObject* obj = result.mo ? result.mo->getObject() : nullptr) {
+      mReductors[dataSource.name]->update(obj, mSources[dataSource.name],
+                                          dataSource.axisDivision, mNumberPads[dataSource.name]);
+    } else if (result.qo) {
+      mReductors[dataSource.name]->updateQuality(result.qo.get(), mSourcesQuality[dataSource.name]);
+      mNumberPads[dataSource.name] = 1;
+    }
+  });
+
   mTrend->Fill();
 } // void TrendingTaskTPC::trendValues(uint64_t timestamp, repository::DatabaseInterface& qcdb)
 